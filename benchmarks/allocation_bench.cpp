@@ -0,0 +1,130 @@
+#include "../tests/AllocationCounter.h"
+#include "../third_party/nlohmann_json.hpp"
+#include "ApiJson.h"
+#include "ReservationSystem.h"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Heap allocations and bytes per operation on the booking hot path (create, swap, cancel)
+// and for seat-map serialization, measured in steady state with a counting operator new.
+// The seat map is serialized both the old way (nlohmann DOM, as the API used to) and with
+// writeSeatMapJson into a reused buffer.
+// Usage: ./bench_allocation
+
+namespace {
+
+constexpr int kRows = 200;
+constexpr int kSeatsPerRow = 6;
+constexpr int kOps = 500;
+
+void report(const char* label, const allocation_counter::Stats& stats, int ops) {
+    std::cout << std::left << std::setw(22) << label
+              << std::setw(14) << std::fixed << std::setprecision(2) << static_cast<double>(stats.allocations) / ops
+              << static_cast<double>(stats.bytes) / ops << std::endl;
+}
+
+std::string seatLabel(int index) {
+    return std::to_string(index / kSeatsPerRow + 1) + static_cast<char>('A' + index % kSeatsPerRow);
+}
+
+} // namespace
+
+int main() {
+    std::ostringstream sink; // Swallow ReservationSystem console output
+    std::istringstream noInput;
+    ReservationSystem system(noInput, sink);
+    system.resetSystemForTest();
+    Customer* customer = system.addCustomerInternal("Alloc Customer", 40, 1e9, false);
+    std::string customerId = customer->getPersonId();
+    std::string flightNumber = "AL100";
+    std::string error;
+    error.reserve(256); // Callers that reuse their message buffer should not pay for it
+
+    std::ostringstream admin; // Add the airplane through the admin menu, like the console does
+    admin << "7\n1\n" << flightNumber << "\n" << kRows << "\n" << kSeatsPerRow << "\n0\n";
+    std::istringstream adminInput(admin.str());
+    system.setInputStreamForTest(adminInput);
+    system.run();
+
+    std::vector<std::string> seats;
+    for (int i = 0; i < kRows * kSeatsPerRow; ++i) seats.push_back(seatLabel(i));
+
+    // Warm up: the first bookings grow the indexes; steady state is what we budget for
+    std::vector<std::string> ids;
+    for (int i = 0; i < kOps; ++i) {
+        ids.push_back(system.createBookingInternal(customerId, flightNumber, seats[i], error)->getBookingId());
+    }
+    for (int i = 0; i < kOps; ++i) {
+        system.cancelBookingInternal(ids[i], error);
+    }
+
+    std::cout << std::left << std::setw(22) << "operation" << std::setw(14) << "allocs/op" << "bytes/op" << std::endl;
+
+    allocation_counter::start();
+    for (int i = 0; i < kOps; ++i) {
+        Booking* booking = system.createBookingInternal(customerId, flightNumber, seats[kOps + i], error);
+        if (!booking) return 1;
+    }
+    report("createBooking", allocation_counter::stop(), kOps);
+
+    ids.clear();
+    for (int i = 0; i < kOps; ++i) {
+        ids.push_back(system.findBookingForSeat(flightNumber, seats[kOps + i])->getBookingId());
+    }
+
+    allocation_counter::start();
+    for (int i = 0; i + 1 < kOps; i += 2) {
+        system.swapSeatsInternal(ids[i], ids[i + 1], error);
+    }
+    report("swapSeats", allocation_counter::stop(), kOps / 2);
+
+    const Airplane& plane = *system.findAirplaneByFlightNumber(flightNumber);
+    std::vector<const Booking*> seatBookings;
+    std::string body;
+    size_t bytesOut = 0;
+    for (int warm = 0; warm < 2; ++warm) { // Second round runs with warmed-up buffers
+        allocation_counter::start();
+        for (int i = 0; i < 100; ++i) {
+            system.getSeatBookings(flightNumber, seatBookings);
+            body.clear();
+            writeSeatMapJson(body, plane, seatBookings);
+            bytesOut += body.size();
+        }
+        allocation_counter::Stats stats = allocation_counter::stop();
+        if (warm) report("seatMap writer", stats, 100);
+    }
+
+    allocation_counter::start();
+    for (int i = 0; i < 10; ++i) {
+        nlohmann::json seatMap;
+        seatMap["flightNumber"] = plane.getFlightNumber();
+        seatMap["capacity"] = plane.getCapacity();
+        seatMap["bookedSeatsCount"] = plane.getBookedSeatsCount();
+        seatMap["isFull"] = plane.isFull();
+        nlohmann::json seatArray = nlohmann::json::array();
+        std::vector<const Booking*> perSeat = system.getSeatBookings(flightNumber);
+        for (size_t s = 0; s < plane.getAllSeats().size(); ++s) {
+            const Seat& seat = plane.getAllSeats()[s];
+            nlohmann::json seatJson = {{"seatId", seat.getSeatId()}, {"isBooked", seat.getIsBooked()},
+                                       {"price", seat.getPrice()}, {"seatClass", seat.getSeatClassString()}};
+            if (perSeat[s]) {
+                seatJson["bookedByCustomerId"] = perSeat[s]->getCustomerId();
+                seatJson["bookingId"] = perSeat[s]->getBookingId();
+            }
+            seatArray.push_back(seatJson);
+        }
+        seatMap["seats"] = seatArray;
+        bytesOut += seatMap.dump(4).size();
+    }
+    report("seatMap nlohmann", allocation_counter::stop(), 10);
+
+    allocation_counter::start();
+    for (int i = 0; i < kOps; ++i) {
+        system.cancelBookingInternal(ids[i], error);
+    }
+    report("cancelBooking", allocation_counter::stop(), kOps);
+    return bytesOut == 0 ? 1 : 0;
+}
@@ -0,0 +1,249 @@
+#include "ApiRoutes.h"
+#include "EpollHttpServer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// airline_api_server's two backends side by side: cpp-httplib (thread pool, blocking keep-alive
+// connections) versus EpollHttpServer, each serving the full API in its own child process.
+// Per run, `idle` GUI-like clients connect, fetch /api/airplanes once and keep the connection open;
+// then kActiveClients clients fetch the FL101 seat map back to back for kRunSeconds. Reported:
+// how many idle clients got their response, active requests/s and latency, and connections the
+// server dropped. Usage: ./bench_api_server [maxIdleConnections] (default 10000)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kActiveClients = 32;
+constexpr int kRunSeconds = 5;
+const std::string kIdleRequest = "GET /api/airplanes HTTP/1.1\r\nHost: bench\r\n\r\n";
+const std::string kActiveRequest = "GET /api/airplanes/FL101 HTTP/1.1\r\nHost: bench\r\n\r\n";
+
+enum class Backend { HTTPLIB, EPOLL };
+
+void raiseDescriptorLimit() {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+// Forks a child serving the API on a free loopback port; returns its pid and sets port
+pid_t startServer(Backend backend, int& port) {
+    int portPipe[2];
+    if (::pipe(portPipe) != 0) return -1;
+    pid_t child = ::fork();
+    if (child != 0) {
+        ::close(portPipe[1]);
+        port = -1;
+        if (::read(portPipe[0], &port, sizeof(port)) != sizeof(port)) port = -1;
+        ::close(portPipe[0]);
+        return child;
+    }
+
+    ::close(portPipe[0]);
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    auto execute = [&system](Command command) { return CommandPipeline::apply(system, command); };
+    int boundPort = -1;
+    if (backend == Backend::HTTPLIB) {
+        httplib::Server server;
+        registerApiRoutes(server, system, execute);
+        boundPort = server.bind_to_any_port("127.0.0.1");
+        ssize_t written = ::write(portPipe[1], &boundPort, sizeof(boundPort));
+        (void)written;
+        server.listen_after_bind();
+    } else {
+        EpollHttpServer server;
+        registerApiRoutes(server, system, execute);
+        boundPort = server.bindToPort("127.0.0.1", 0);
+        ssize_t written = ::write(portPipe[1], &boundPort, sizeof(boundPort));
+        (void)written;
+        server.listenAfterBind();
+    }
+    ::_exit(0);
+}
+
+struct ClientConnection {
+    int fd = -1;
+    bool active = false;
+    bool connected = false;
+    int responses = 0;
+    std::string in;
+    Clock::time_point sentAt;
+};
+
+struct RunResult {
+    int idleServed = 0;
+    int dropped = 0;  // Connection failures and server-side closes
+    long activeRequests = 0;
+    double p50Ms = 0, p99Ms = 0;
+};
+
+bool sendRequest(ClientConnection& connection) {
+    const std::string& request = connection.active ? kActiveRequest : kIdleRequest;
+    connection.sentAt = Clock::now();
+    return ::send(connection.fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size());
+}
+
+// Counts and removes complete responses at the front of connection.in
+int takeResponses(ClientConnection& connection) {
+    int complete = 0;
+    for (;;) {
+        std::size_t headerEnd = connection.in.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) return complete;
+        std::size_t lengthAt = connection.in.find("Content-Length: ");
+        std::size_t length = lengthAt < headerEnd ? std::stoul(connection.in.substr(lengthAt + 16, 20)) : 0;
+        if (connection.in.size() < headerEnd + 4 + length) return complete;
+        connection.in.erase(0, headerEnd + 4 + length);
+        ++complete;
+    }
+}
+
+RunResult drive(int port, int idleCount) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int epollFd = ::epoll_create1(0);
+    std::vector<std::unique_ptr<ClientConnection>> connections;
+    RunResult result;
+    auto open = [&](bool active) {
+        std::unique_ptr<ClientConnection> connection(new ClientConnection());
+        connection->active = active;
+        connection->fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        int yes = 1;
+        ::setsockopt(connection->fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        if (connection->fd < 0 || (::connect(connection->fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 && errno != EINPROGRESS)) {
+            if (connection->fd >= 0) ::close(connection->fd);
+            ++result.dropped;
+            return;
+        }
+        epoll_event event{};
+        event.events = EPOLLOUT; // Connect completion
+        event.data.ptr = connection.get();
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, connection->fd, &event);
+        connections.push_back(std::move(connection));
+    };
+    for (int i = 0; i < idleCount; ++i) open(false);
+    for (int i = 0; i < kActiveClients; ++i) open(true);
+
+    std::vector<double> latencies;
+    std::vector<epoll_event> events(1024);
+    char buffer[65536];
+    auto close = [&](ClientConnection& connection) {
+        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.fd, nullptr);
+        ::close(connection.fd);
+        connection.fd = -1;
+        ++result.dropped;
+    };
+    auto deadline = Clock::now() + std::chrono::seconds(kRunSeconds);
+    while (Clock::now() < deadline) {
+        int count = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 10);
+        for (int i = 0; i < count; ++i) {
+            ClientConnection& connection = *static_cast<ClientConnection*>(events[i].data.ptr);
+            if (connection.fd < 0) continue;
+            if (!connection.connected) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                ::getsockopt(connection.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                if (error != 0 || !sendRequest(connection)) {
+                    close(connection);
+                    continue;
+                }
+                connection.connected = true;
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLRDHUP;
+                event.data.ptr = &connection;
+                ::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+                continue;
+            }
+            ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                close(connection);
+                continue;
+            }
+            connection.in.append(buffer, static_cast<std::size_t>(received));
+            int complete = takeResponses(connection);
+            if (complete == 0) continue;
+            if (!connection.active) {
+                result.idleServed += connection.responses == 0;
+                connection.responses += complete;
+                continue;
+            }
+            latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - connection.sentAt).count());
+            connection.responses += complete;
+            if (!sendRequest(connection)) close(connection);
+        }
+    }
+
+    for (auto& connection : connections) {
+        if (connection->fd >= 0) ::close(connection->fd);
+    }
+    ::close(epollFd);
+    result.activeRequests = static_cast<long>(latencies.size());
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        result.p50Ms = latencies[latencies.size() / 2];
+        result.p99Ms = latencies[static_cast<std::size_t>(0.99 * (latencies.size() - 1))];
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int maxIdle = argc > 1 ? std::atoi(argv[1]) : 10000;
+    if (maxIdle <= 0) maxIdle = 10000;
+    raiseDescriptorLimit();
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+              << ", active clients: " << kActiveClients << ", " << kRunSeconds << " s per run" << std::endl;
+    std::cout << std::left << std::setw(9) << "server" << std::setw(8) << "idle"
+              << std::setw(14) << "idle served" << std::setw(12) << "active r/s"
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms" << "dropped" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::vector<int> idleCounts;
+    for (int idle = 100; idle < maxIdle; idle *= 10) idleCounts.push_back(idle);
+    idleCounts.push_back(maxIdle);
+    for (int idle : idleCounts) {
+        for (Backend backend : {Backend::HTTPLIB, Backend::EPOLL}) {
+            int port = -1;
+            pid_t server = startServer(backend, port);
+            if (server < 0 || port <= 0) {
+                std::cerr << "Could not start the server" << std::endl;
+                return 1;
+            }
+            RunResult result = drive(port, idle);
+            ::kill(server, SIGKILL);
+            ::waitpid(server, nullptr, 0);
+            std::cout << std::left << std::setw(9) << (backend == Backend::HTTPLIB ? "httplib" : "epoll")
+                      << std::setw(8) << idle
+                      << std::setw(14) << (std::to_string(result.idleServed) + "/" + std::to_string(idle))
+                      << std::setw(12) << result.activeRequests / static_cast<double>(kRunSeconds)
+                      << std::setw(10) << result.p50Ms << std::setw(10) << result.p99Ms << result.dropped << std::endl;
+        }
+    }
+    return 0;
+}
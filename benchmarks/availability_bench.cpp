@@ -0,0 +1,100 @@
+#include "Airplane.h"
+#include <chrono>
+#include <deque> // Airplane is not movable (atomic occupancy)
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Compares per-class free-seat counting and first-free-seat search over many flights:
+// walking the vector<Seat> (the old layout) versus the packed occupancy bitsets.
+// Usage: ./bench_availability [flights] (default 10000)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPasses = 20;
+
+struct ScanResult {
+    long long freeEconomy = 0;
+    long long freeBusiness = 0;
+    long long firstFreeSum = 0;
+};
+
+ScanResult scanSeatObjects(const std::deque<Airplane>& fleet) {
+    ScanResult result;
+    for (const auto& plane : fleet) {
+        const auto& seats = plane.getAllSeats();
+        int firstFree = -1;
+        for (size_t i = 0; i < seats.size(); ++i) {
+            const Seat& seat = seats[i];
+            if (seat.getIsBooked()) continue;
+            if (firstFree < 0) firstFree = static_cast<int>(i);
+            if (seat.getSeatClass() == SeatClass::ECONOMY) {
+                ++result.freeEconomy;
+            } else {
+                ++result.freeBusiness;
+            }
+        }
+        result.firstFreeSum += firstFree;
+    }
+    return result;
+}
+
+ScanResult scanBitsets(const std::deque<Airplane>& fleet) {
+    ScanResult result;
+    for (const auto& plane : fleet) {
+        result.freeEconomy += plane.getAvailableSeatCount(SeatClass::ECONOMY);
+        result.freeBusiness += plane.getAvailableSeatCount(SeatClass::BUSINESS);
+        result.firstFreeSum += plane.findFirstAvailableSeat();
+    }
+    return result;
+}
+
+template<typename Scan>
+double millisPerPass(Scan scan, const std::deque<Airplane>& fleet, ScanResult& out) {
+    auto start = Clock::now();
+    for (int pass = 0; pass < kPasses; ++pass) {
+        out = scan(fleet);
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kPasses;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int flightCount = argc > 1 ? std::atoi(argv[1]) : 10000;
+    if (flightCount <= 0) flightCount = 10000;
+
+    std::mt19937 gen(1234);
+    std::bernoulli_distribution occupied(0.6);
+
+    std::deque<Airplane> fleet;
+    for (int f = 0; f < flightCount; ++f) {
+        fleet.emplace_back("FL" + std::to_string(f), 50, 6);
+        Airplane& plane = fleet.back();
+        for (int i = 0; i < plane.getCapacity(); ++i) {
+            if (occupied(gen)) plane.bookSeatAt(i);
+        }
+    }
+
+    ScanResult objects;
+    ScanResult bits;
+    double objectMs = millisPerPass(scanSeatObjects, fleet, objects);
+    double bitsetMs = millisPerPass(scanBitsets, fleet, bits);
+
+    if (objects.freeEconomy != bits.freeEconomy || objects.freeBusiness != bits.freeBusiness ||
+        objects.firstFreeSum != bits.firstFreeSum) {
+        std::cerr << "Scan results disagree!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "flights: " << flightCount << " (300 seats each, ~60% booked)" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "vector<Seat> scan: " << objectMs << " ms/pass" << std::endl;
+    std::cout << "bitset scan:       " << bitsetMs << " ms/pass" << std::endl;
+    std::cout << "speedup:           " << std::setprecision(1) << objectMs / bitsetMs << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "Booking.h"
+#include "BookingIdGenerator.h"
+#include <chrono>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Booking ID generation throughput: the old random_device + mt19937 + ostringstream scheme
+// versus BookingIdGenerator::next() plus fixed-width formatting, for 1..maxThreads threads.
+// Usage: ./bench_booking_id [maxThreads] (default 8)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kIdsPerThread = 1000000;
+constexpr int kLegacyIds = 50000; // The old scheme is too slow for the full count
+
+// The generator Booking used before BookingIdGenerator
+std::string legacyBookingId() {
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> distrib(100, 999);
+    std::ostringstream oss;
+    oss << "BK" << seconds << "-" << distrib(gen);
+    return oss.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 8;
+    if (maxThreads <= 0) maxThreads = 8;
+
+    size_t checksum = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < kLegacyIds; ++i) {
+        checksum += legacyBookingId().size();
+    }
+    double legacyNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kLegacyIds;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "legacy (1 thread): " << legacyNs << " ns/id" << std::endl;
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(16) << "ns/id" << "M ids/s" << std::endl;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        BookingIdGenerator generator;
+        std::vector<size_t> sums(threads, 0);
+        std::vector<std::thread> workers;
+        start = Clock::now();
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&generator, &sums, t]() {
+                char buffer[Booking::BOOKING_ID_LENGTH];
+                size_t sum = 0;
+                for (int i = 0; i < kIdsPerThread; ++i) {
+                    Booking::formatBookingId(generator.next(), buffer);
+                    sum += static_cast<unsigned char>(buffer[Booking::BOOKING_ID_LENGTH - 1]);
+                }
+                sums[t] = sum;
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        double total = static_cast<double>(threads) * kIdsPerThread;
+        for (size_t sum : sums) checksum += sum;
+
+        std::cout << std::left << std::setw(10) << threads
+                  << std::setw(16) << seconds * 1e9 / total
+                  << total / seconds / 1e6 << std::endl;
+    }
+    return checksum == 0 ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+#include "Booking.h"
+#include <chrono>
+#include <cstdlib> // For std::strtoull
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h> // For sysconf
+#include <vector>
+
+// Memory and scan cost of N bookings: the old all-strings Booking layout versus the
+// interned/compact one. Usage: ./bench_booking_memory [bookings] (default 10000000)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kCustomers = 100000;
+constexpr int kFlights = 500;
+
+// Field-for-field copy of Booking before identifiers were interned
+struct LegacyBooking {
+    std::string bookingId;
+    std::string customerId;
+    std::string flightNumber;
+    std::string seatId;
+    std::chrono::system_clock::time_point bookingDate;
+    BookingStatus status;
+};
+
+size_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+std::string customerName(int i) {
+    std::ostringstream oss;
+    oss << "CUST" << std::setfill('0') << std::setw(4) << i + 1;
+    return oss.str();
+}
+
+std::string flightName(int i) { return "FL" + std::to_string(100 + i); }
+
+std::string seatName(size_t i) { return std::to_string(1 + i % 40) + static_cast<char>('A' + i % 6); }
+
+void report(const char* label, size_t count, size_t bytes, double buildMs, double scanMs) {
+    std::cout << std::left << std::setw(10) << label
+              << std::setw(16) << bytes / count
+              << std::setw(14) << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0)
+              << std::setw(14) << buildMs
+              << scanMs << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = 10000000;
+    if (argc > 1) {
+        count = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (count == 0) {
+        std::cerr << "Need at least one booking." << std::endl;
+        return 1;
+    }
+
+    std::cout << "bookings: " << count << ", sizeof(Booking) = " << sizeof(Booking)
+              << ", sizeof(LegacyBooking) = " << sizeof(LegacyBooking) << std::endl;
+    std::cout << std::left << std::setw(10) << "layout"
+              << std::setw(16) << "bytes/booking"
+              << std::setw(14) << "total MiB"
+              << std::setw(14) << "build ms"
+              << "scan ms" << std::endl;
+
+    std::vector<InternedId> customerRefs(kCustomers);
+    std::vector<InternedId> flightRefs(kFlights);
+    for (int i = 0; i < kCustomers; ++i) customerRefs[i] = customerIdInterner().intern(customerName(i));
+    for (int i = 0; i < kFlights; ++i) flightRefs[i] = flightNumberInterner().intern(flightName(i));
+    const std::string& probeFlight = flightNumberInterner().lookup(flightRefs[7]);
+
+    // Compact first: its single large block is handed back to the OS when freed,
+    // so it does not distort the legacy measurement that follows.
+    size_t matches = 0;
+    {
+        size_t before = residentBytes();
+        auto start = Clock::now();
+        std::vector<Booking> compact;
+        compact.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            compact.emplace_back(customerRefs[i % kCustomers], flightRefs[i % kFlights],
+                                 SeatCodec::toKey(static_cast<int>(1 + i % 40), static_cast<int>(i % 6)));
+        }
+        double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        size_t bytes = residentBytes() - before;
+
+        InternedId probe = flightRefs[7];
+        start = Clock::now();
+        for (const Booking& booking : compact) {
+            matches += booking.getFlightRef() == probe;
+        }
+        double scanMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        report("compact", count, bytes, buildMs, scanMs);
+    }
+    {
+        size_t before = residentBytes();
+        auto start = Clock::now();
+        std::vector<LegacyBooking> legacy;
+        legacy.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            Booking source(customerRefs[i % kCustomers], flightRefs[i % kFlights], SeatCodec::INVALID_KEY);
+            legacy.push_back({source.getBookingId(), customerName(static_cast<int>(i % kCustomers)),
+                              flightName(static_cast<int>(i % kFlights)), seatName(i),
+                              std::chrono::system_clock::now(), BookingStatus::CONFIRMED});
+        }
+        double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        size_t bytes = residentBytes() - before;
+
+        start = Clock::now();
+        for (const LegacyBooking& booking : legacy) {
+            matches += booking.flightNumber == probeFlight;
+        }
+        double scanMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        report("legacy", count, bytes, buildMs, scanMs);
+    }
+
+    if (matches != 2 * ((count + kFlights - 1 - 7) / kFlights)) {
+        std::cerr << "Scan results disagree." << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "BulkImporter.h"
+#include <chrono>
+#include <cstdio>  // For std::remove
+#include <cstdlib> // For std::strtoull
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Bulk import throughput: airplanes, customers and bookings files of a partner-sized state are
+// written as CSV and as JSON Lines, then each is loaded into a fresh system with BulkImporter.
+// Reports rows per second for every file and the process's peak RSS after each format, which stays
+// near the state's own size because the files are read a chunk at a time.
+// Usage: ./bench_bulk_import [bookings] [directory] [threads]
+//   (default 1000000, current directory, one worker per hardware thread)
+
+namespace {
+
+constexpr int kRows = 30;
+constexpr int kSeatsPerRow = 6;
+
+std::string seatId(int seat) { return std::to_string(seat / kSeatsPerRow + 1) + static_cast<char>('A' + seat % kSeatsPerRow); }
+
+double peakMegabytes() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::atof(line.c_str() + 6) / 1024;
+    }
+    return 0;
+}
+
+// Flights filled to about 5/6, one customer per 10 bookings
+void writeFiles(const std::string& prefix, bool csv, std::uint64_t bookingCount) {
+    const std::uint64_t flights = bookingCount / 150 + 1;
+    const std::uint64_t customerCount = bookingCount / 10 + 1;
+    const char* extension = csv ? ".csv" : ".jsonl";
+    std::ofstream airplanes(prefix + "airplanes" + extension), customers(prefix + "customers" + extension),
+        bookings(prefix + "bookings" + extension);
+    if (csv) {
+        airplanes << "flightNumber,rows,seatsPerRow\n";
+        customers << "customerId,name,age,money\n";
+        bookings << "customerId,flightNumber,seatId\n";
+    }
+    for (std::uint64_t f = 0; f < flights; ++f) {
+        std::string flight = "FL" + std::to_string(100000 + f);
+        if (csv) airplanes << flight << ',' << kRows << ',' << kSeatsPerRow << '\n';
+        else airplanes << "{\"flightNumber\":\"" << flight << "\",\"rows\":" << kRows << ",\"seatsPerRow\":" << kSeatsPerRow << "}\n";
+    }
+    for (std::uint64_t c = 0; c < customerCount; ++c) {
+        std::string id = "P" + std::to_string(c + 1);
+        int age = 20 + static_cast<int>(c % 60);
+        if (csv) customers << id << ",Customer " << c + 1 << ',' << age << ",1000000\n";
+        else customers << "{\"customerId\":\"" << id << "\",\"name\":\"Customer " << c + 1 << "\",\"age\":" << age << ",\"money\":1000000}\n";
+    }
+    std::uint64_t state = 88172645463325252ull;
+    for (std::uint64_t i = 0; i < bookingCount; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        std::string customer = "P" + std::to_string(state % customerCount + 1);
+        std::string flight = "FL" + std::to_string(100000 + i % flights);
+        std::string seat = seatId(static_cast<int>(i / flights));
+        if (csv) bookings << customer << ',' << flight << ',' << seat << '\n';
+        else bookings << "{\"customerId\":\"" << customer << "\",\"flightNumber\":\"" << flight << "\",\"seatId\":\"" << seat << "\"}\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t bookingCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    if (bookingCount == 0) bookingCount = 1000000;
+    std::string prefix = (argc > 2 ? std::string(argv[2]) + "/" : "") + "bench_bulk_import_";
+    int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    WorkStealingExecutor executor(threads);
+
+    std::cout << bookingCount << " bookings, " << bookingCount / 10 + 1 << " customers, " << bookingCount / 150 + 1 << " airplanes; "
+              << executor.getWorkerCount() << " worker thread(s)" << std::endl;
+    std::cout << std::fixed << std::left << std::setw(22) << "file" << std::right << std::setw(12) << "rows" << std::setw(10) << "seconds"
+              << std::setw(14) << "rows/s" << std::setw(10) << "peak MB" << std::endl;
+    for (bool csv : {true, false}) {
+        writeFiles(prefix, csv, bookingCount);
+        std::ostringstream sink;
+        ReservationSystem system(std::cin, sink);
+        system.resetSystemForTest();
+        BulkImporter importer(system, BulkImporter::Options(), executor);
+        for (const char* kind : {"airplanes", "customers", "bookings"}) {
+            std::string path = prefix + kind + (csv ? ".csv" : ".jsonl");
+            BulkImporter::Kind importKind = BulkImporter::Kind::AIRPLANES;
+            BulkImporter::parseKind(kind, importKind);
+            BulkImporter::Report report;
+            std::string message;
+            if (!importer.importFile(path, importKind, csv ? BulkImporter::Format::CSV : BulkImporter::Format::JSONL, report, message) ||
+                report.imported != report.rows) {
+                std::cerr << message << (report.errors.empty() ? "" : " " + report.errors[0].message) << std::endl;
+                return 1;
+            }
+            std::cout << std::left << std::setw(22) << path.substr(prefix.size()) << std::right << std::setw(12) << report.rows
+                      << std::setw(10) << std::setprecision(3) << report.seconds << std::setw(14) << std::setprecision(0)
+                      << report.rowsPerSecond() << std::setw(10) << peakMegabytes() << std::endl;
+            std::remove(path.c_str());
+        }
+    }
+    return 0;
+}
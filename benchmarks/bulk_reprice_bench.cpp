@@ -0,0 +1,98 @@
+#include "ReservationSystem.h"
+#include <chrono>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Re-pricing every seat of a 10,000-flight fleet (180 seats each, a third booked): the per-flight
+// loop a request thread runs (repriceFlightInternal on each flight in turn) versus
+// repriceAllFlightsInternal fanned out over a WorkStealingExecutor of 1..maxWorkers workers. Each pass
+// moves every fare, so every flight republishes its snapshot. Speedups are against the serial loop;
+// they can only exceed 1x as far as there are hardware threads to run the workers.
+// Usage: ./bench_bulk_reprice [maxWorkers] (default 16)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kFlights = 10000;
+constexpr int kRows = 30;
+constexpr int kSeatsPerRow = 6;
+constexpr int kPasses = 5;
+
+// Fare for a seat in a given pass: changes every pass, and costs a little arithmetic like a real rule
+double fareFor(int pass, int seatIndex, double current) {
+    return current * (pass % 2 ? 1.05 : 0.95) + (seatIndex % kSeatsPerRow == 0 ? 5.0 : 0.0) * (pass % 2 ? 1 : -1);
+}
+
+template<typename Pass>
+double millisPerPass(Pass pass) {
+    auto start = Clock::now();
+    for (int i = 0; i < kPasses; ++i) {
+        pass(i);
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kPasses;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int maxWorkers = argc > 1 ? std::atoi(argv[1]) : 16;
+    if (maxWorkers <= 0) maxWorkers = 16;
+
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest();
+    std::string error;
+    std::vector<std::string> flightNumbers;
+    Customer* customer = system.addCustomerInternal("Bulk Customer", 40, 1e9, false);
+    for (int f = 0; f < kFlights; ++f) {
+        flightNumbers.push_back("BK" + std::to_string(10000 + f));
+        system.addAirplaneInternal(flightNumbers.back(), kRows, kSeatsPerRow, error);
+        for (int row = 1; row <= kRows; row += 3) {
+            for (char letter = 'A'; letter < 'A' + kSeatsPerRow; ++letter) {
+                system.createBookingInternal(customer->getPersonId(), flightNumbers.back(), std::to_string(row) + letter, error);
+            }
+        }
+    }
+
+    double serialMs = millisPerPass([&](int pass) {
+        std::size_t changed = 0;
+        for (const std::string& flightNumber : flightNumbers) {
+            system.repriceFlightInternal(flightNumber, [pass](const Airplane& airplane, int seatIndex) {
+                return fareFor(pass, seatIndex, airplane.getSeatPrice(seatIndex));
+            }, changed, error);
+        }
+    });
+
+    std::cout << "flights: " << kFlights << " (" << kRows * kSeatsPerRow << " seats each), hardware threads: "
+              << std::thread::hardware_concurrency() << ", " << kPasses << " passes per row" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << std::left << std::setw(14) << "workers" << std::setw(12) << "ms/pass"
+              << std::setw(16) << "flights/s" << "speedup" << std::endl;
+    std::cout << std::setw(14) << "serial loop" << std::setw(12) << serialMs
+              << std::setw(16) << std::setprecision(0) << kFlights / (serialMs / 1000.0)
+              << std::setprecision(2) << 1.0 << "x" << std::endl;
+
+    for (int workers = 1; workers <= maxWorkers; workers *= 2) {
+        WorkStealingExecutor executor(workers);
+        std::size_t changed = 0;
+        double ms = millisPerPass([&](int pass) {
+            system.repriceAllFlightsInternal([pass](const Airplane& airplane, int seatIndex) {
+                return fareFor(pass, seatIndex, airplane.getSeatPrice(seatIndex));
+            }, changed, error, executor);
+        });
+        if (changed != static_cast<std::size_t>(kFlights) * kRows * kSeatsPerRow) {
+            std::cerr << "Only " << changed << " fares changed!" << std::endl;
+            return 1;
+        }
+        std::cout << std::setw(14) << workers << std::setw(12) << ms
+                  << std::setw(16) << std::setprecision(0) << kFlights / (ms / 1000.0)
+                  << std::setprecision(2) << serialMs / ms << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include "ReservationSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>  // For std::remove
+#include <cstdlib> // For std::strtoull
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Booking latency while checkpoints run. A state of the given size is built and a write-ahead log
+// opened on it; booker threads then book and cancel seats on flights of their own, first alone and
+// then while the main thread checkpoints back to back (rotate the log, copy the state out with
+// copy-on-write, write the snapshot, drop the covered segments). Each phase reports the bookers'
+// p50, p99 and longest latency and their throughput.
+// Usage: ./bench_checkpoint [bookings] [directory] [durability] (default 200000, current directory, group)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRows = 30;
+constexpr int kSeatsPerRow = 6;
+constexpr int kBookers = 2;
+
+std::string seatId(int seat) { return std::to_string(seat / kSeatsPerRow + 1) + static_cast<char>('A' + seat % kSeatsPerRow); }
+
+// Flights filled to about 5/6, one customer per 10 bookings, every 20th booking cancelled
+bool populate(ReservationSystem& system, std::uint64_t bookingCount) {
+    const std::uint64_t flights = bookingCount / 150 + 1;
+    const std::uint64_t customerCount = bookingCount / 10 + 1;
+    std::string message;
+    for (std::uint64_t f = 0; f < flights; ++f) {
+        if (!system.addAirplaneInternal("FL" + std::to_string(100000 + f), kRows, kSeatsPerRow, message)) return false;
+    }
+    std::vector<std::string> customerIds;
+    for (std::uint64_t c = 0; c < customerCount; ++c) {
+        Customer* customer = system.addCustomerInternal("Customer " + std::to_string(c + 1), 20 + static_cast<int>(c % 60), 1000000.0, false);
+        if (!customer) return false;
+        customerIds.push_back(customer->getPersonId());
+    }
+    for (int b = 0; b < kBookers; ++b) {
+        if (!system.addAirplaneInternal("BENCH" + std::to_string(b), kRows, kSeatsPerRow, message)) return false;
+    }
+    std::uint64_t state = 88172645463325252ull;
+    for (std::uint64_t i = 0; i < bookingCount; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        Booking* booking = system.createBookingInternal(customerIds[state % customerCount], "FL" + std::to_string(100000 + i % flights),
+                                                        seatId(static_cast<int>(i / flights)), message);
+        if (!booking) {
+            std::cerr << message << std::endl;
+            return false;
+        }
+        if (i % 20 == 19) system.cancelBookingInternal(booking->getBookingId(), message);
+    }
+    return true;
+}
+
+struct Phase {
+    std::vector<double> latencies; // Seconds per booking, sorted
+    double seconds = 0;
+    int checkpoints = 0;
+    double checkpointSeconds = 0; // Longest
+};
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(sorted.size())))];
+}
+
+// Bookers book and cancel on their own flight for duration; checkpoint, if set, runs meanwhile
+Phase run(ReservationSystem& system, std::chrono::milliseconds duration, const std::string& checkpointPath) {
+    Phase phase;
+    std::atomic<bool> stop{false};
+    std::vector<std::vector<double>> perBooker(kBookers);
+    std::vector<std::thread> bookers;
+    Clock::time_point start = Clock::now();
+    for (int b = 0; b < kBookers; ++b) {
+        bookers.emplace_back([&, b]() {
+            std::string message;
+            const std::string flight = "BENCH" + std::to_string(b);
+            for (int seat = 0; !stop.load(std::memory_order_relaxed); seat = (seat + 1) % (kRows * kSeatsPerRow)) {
+                Clock::time_point before = Clock::now();
+                Booking* booking = system.createBookingInternal("CUST0001", flight, seatId(seat), message);
+                perBooker[b].push_back(std::chrono::duration<double>(Clock::now() - before).count());
+                if (booking) system.cancelBookingInternal(booking->getBookingId(), message);
+            }
+        });
+    }
+    if (!checkpointPath.empty()) {
+        while (Clock::now() - start < duration) {
+            std::string message;
+            Clock::time_point before = Clock::now();
+            if (!system.saveSnapshot(checkpointPath, message)) {
+                std::cerr << message << std::endl;
+                break;
+            }
+            phase.checkpointSeconds = std::max(phase.checkpointSeconds, std::chrono::duration<double>(Clock::now() - before).count());
+            ++phase.checkpoints;
+        }
+    } else {
+        std::this_thread::sleep_for(duration);
+    }
+    stop = true;
+    for (std::thread& booker : bookers) {
+        booker.join();
+    }
+    phase.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (const std::vector<double>& latencies : perBooker) {
+        phase.latencies.insert(phase.latencies.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(phase.latencies.begin(), phase.latencies.end());
+    return phase;
+}
+
+void report(const char* name, const Phase& phase) {
+    std::cout << std::left << std::setw(24) << name << std::right << std::setw(12) << std::setprecision(0)
+              << phase.latencies.size() / phase.seconds << std::setprecision(1) << std::setw(10) << percentile(phase.latencies, 0.5) * 1e6
+              << std::setw(10) << percentile(phase.latencies, 0.99) * 1e6 << std::setw(12)
+              << (phase.latencies.empty() ? 0 : phase.latencies.back() * 1e6) << std::setw(13) << phase.checkpoints << std::setprecision(3)
+              << std::setw(16) << phase.checkpointSeconds << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t bookingCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    if (bookingCount == 0) bookingCount = 200000;
+    std::string directory = argc > 2 ? std::string(argv[2]) + "/" : "";
+    WriteAheadLog::Options options;
+    if (argc > 3 && !WriteAheadLog::parseDurability(argv[3], options.durability)) {
+        std::cerr << "Durability is per-op, group or async." << std::endl;
+        return 1;
+    }
+    const std::string walPath = directory + "bench_checkpoint.wal";
+    const std::string snapPath = directory + "bench_checkpoint.snap";
+    std::remove(walPath.c_str());
+
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest(); // No seeded data
+    std::string message;
+    if (!system.addCustomerInternal("Bench Booker", 40, 1e9, false) || !populate(system, bookingCount) ||
+        !system.openWriteAheadLog(walPath, options, message)) {
+        std::cerr << "Cannot build the state: " << message << std::endl;
+        return 1;
+    }
+    std::cout << bookingCount << " bookings, " << kBookers << " booker threads" << std::endl;
+    std::cout << std::fixed << std::left << std::setw(24) << "phase" << std::right << std::setw(12) << "bookings/s" << std::setw(10)
+              << "p50 us" << std::setw(10) << "p99 us" << std::setw(12) << "max us" << std::setw(13) << "checkpoints" << std::setw(16)
+              << "checkpoint s" << std::endl;
+
+    const std::chrono::milliseconds duration(2000);
+    report("no checkpoint", run(system, duration, ""));
+    report("checkpoints running", run(system, duration, snapPath));
+
+    system.resetSystemForTest(); // Closes the log
+    std::remove(walPath.c_str());
+    std::remove(snapPath.c_str());
+    return 0;
+}
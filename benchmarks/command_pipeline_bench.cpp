@@ -0,0 +1,180 @@
+#include "CommandPipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Mutation throughput and per-request latency, locked mode versus single-writer pipeline mode.
+// Each client thread plays an API handler thread: it books a seat and cancels that booking,
+// over and over, on two shared 300-seat flights. Locked mode calls ReservationSystem directly
+// (CommandPipeline::apply, as the locked API server does); pipeline mode submits the same
+// commands and waits on each future. Then what the pipeline's writer pays for keeping
+// ReservationSystem's locks: the cost of one applied command on a single thread (every lock
+// uncontended, as on the writer) next to an uncontended lock round trip, of which a book or a
+// cancel takes two or three. Usage: ./bench_command_pipeline [maxThreads] (default 16)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRequestsPerThread = 20000; // Book + cancel pairs count as two requests
+
+struct RunResult {
+    double requestsPerSecond;
+    double p50, p99, p999; // Microseconds
+};
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    return sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+}
+
+RunResult run(int threads, bool pipelineMode) {
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest();
+    std::string error;
+    const std::vector<std::string> flights = {"PIPE01", "PIPE02"};
+    std::vector<std::string> seatIds;
+    for (const std::string& flight : flights) {
+        Airplane* plane = system.addAirplaneInternal(flight, 50, 6, error);
+        if (seatIds.empty()) {
+            for (int i = 0; i < plane->getCapacity(); ++i) {
+                seatIds.push_back(plane->getSeatId(i));
+            }
+        }
+    }
+    std::vector<std::string> customerIds;
+    for (int t = 0; t < threads; ++t) {
+        customerIds.push_back(system.addCustomerInternal("Bench Client", 30, 1e12, false)->getPersonId());
+    }
+
+    std::unique_ptr<CommandPipeline> pipeline;
+    if (pipelineMode) {
+        pipeline = std::make_unique<CommandPipeline>(system);
+    }
+    auto execute = [&](Command command) {
+        return pipeline ? pipeline->submit(std::move(command)).get() : CommandPipeline::apply(system, command);
+    };
+
+    std::vector<std::vector<double>> samples(threads);
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            samples[t].reserve(kRequestsPerThread);
+            size_t seat = static_cast<size_t>(t) * 7;
+            for (int i = 0; i < kRequestsPerThread / 2; ++i) {
+                Command book;
+                book.type = Command::Type::BOOK;
+                book.customerId = customerIds[t];
+                book.flightNumber = flights[i % 2];
+                book.seatId = seatIds[seat++ % seatIds.size()];
+                auto requestStart = Clock::now();
+                CommandResult booked = execute(std::move(book));
+                auto requestEnd = Clock::now();
+                samples[t].push_back(std::chrono::duration<double, std::micro>(requestEnd - requestStart).count());
+                if (!booked.success) {
+                    continue; // Another client holds the seat right now
+                }
+                Command cancel;
+                cancel.type = Command::Type::CANCEL;
+                cancel.bookingId = booked.booking->getBookingId();
+                requestStart = Clock::now();
+                execute(std::move(cancel));
+                samples[t].push_back(std::chrono::duration<double, std::micro>(Clock::now() - requestStart).count());
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const auto& threadSamples : samples) {
+        all.insert(all.end(), threadSamples.begin(), threadSamples.end());
+    }
+    std::sort(all.begin(), all.end());
+    return {all.size() / seconds, percentile(all, 0.50), percentile(all, 0.99), percentile(all, 0.999)};
+}
+
+// Book + cancel on one thread with no per-request clock: the writer's own cost per command
+double applyNanosPerCommand() {
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest();
+    std::string error;
+    Airplane* plane = system.addAirplaneInternal("PIPE01", 50, 6, error);
+    std::string customerId = system.addCustomerInternal("Bench Client", 30, 1e12, false)->getPersonId();
+    const int rounds = 200000;
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        Command book;
+        book.type = Command::Type::BOOK;
+        book.customerId = customerId;
+        book.flightNumber = "PIPE01";
+        book.seatId = plane->getSeatId(i % plane->getCapacity());
+        CommandResult booked = CommandPipeline::apply(system, book);
+        Command cancel;
+        cancel.type = Command::Type::CANCEL;
+        cancel.bookingId = booked.booking->getBookingId();
+        CommandPipeline::apply(system, cancel);
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / (2.0 * rounds);
+}
+
+template<typename Lock>
+double lockRoundTripNanos(Lock lockOnce) {
+    const int rounds = 10000000;
+    auto start = Clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        lockOnce();
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / rounds;
+}
+
+void print(const char* mode, int threads, const RunResult& result) {
+    std::cout << std::left << std::setw(10) << threads << std::setw(10) << mode
+              << std::setw(14) << result.requestsPerSecond / 1e3
+              << std::setw(12) << result.p50
+              << std::setw(12) << result.p99
+              << result.p999 << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 16;
+    if (maxThreads <= 0) maxThreads = 16;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(10) << "mode"
+              << std::setw(14) << "k req/s"
+              << std::setw(12) << "p50 us"
+              << std::setw(12) << "p99 us"
+              << "p99.9 us" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    run(1, false); // Warm-up: fills the string interners and the allocator caches
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        print("locked", threads, run(threads, false));
+        print("pipeline", threads, run(threads, true));
+    }
+
+    std::shared_mutex registry;
+    std::mutex shard;
+    std::cout << "\nwriter apply, locks uncontended: " << applyNanosPerCommand() << " ns/command" << std::endl;
+    std::cout << "uncontended shared_lock round trip: "
+              << lockRoundTripNanos([&registry]() { std::shared_lock<std::shared_mutex> lock(registry); }) << " ns" << std::endl;
+    std::cout << "uncontended mutex round trip: "
+              << lockRoundTripNanos([&shard]() { std::lock_guard<std::mutex> lock(shard); }) << " ns" << std::endl;
+    return 0;
+}
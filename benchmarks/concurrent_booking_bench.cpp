@@ -0,0 +1,118 @@
+#include "ReservationSystem.h"
+#include <chrono>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bookings/sec through createBookingInternal for 1..maxThreads threads. Each thread has its own
+// customer and books every seat of its own slice of the flights, so with per-flight/per-customer
+// lock shards the threads only meet on the shared registry lock and the booking-map insert.
+// The "global mutex" column serializes the same calls behind one lock, as a single big lock
+// around ReservationSystem would. Usage: ./bench_concurrent_booking [maxThreads] (default 32)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kFlights = 256;
+constexpr int kRows = 50;
+constexpr int kSeatsPerRow = 6;
+
+struct Workload {
+    std::vector<std::string> flightNumbers;
+    std::vector<std::string> seatIds;
+};
+
+Workload makeWorkload() {
+    Workload workload;
+    for (int f = 0; f < kFlights; ++f) {
+        std::ostringstream flight;
+        flight << "BF" << std::setfill('0') << std::setw(4) << f;
+        workload.flightNumbers.push_back(flight.str());
+    }
+    for (int row = 1; row <= kRows; ++row) {
+        for (int column = 0; column < kSeatsPerRow; ++column) {
+            workload.seatIds.push_back(std::to_string(row) + static_cast<char>('A' + column));
+        }
+    }
+    return workload;
+}
+
+// Returns bookings per second; exits if any booking fails
+double run(const Workload& workload, int threads, std::mutex* globalMutex) {
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest();
+    std::string error;
+    for (const std::string& flightNumber : workload.flightNumbers) {
+        system.addAirplaneInternal(flightNumber, kRows, kSeatsPerRow, error);
+    }
+    std::vector<std::string> customerIds;
+    for (int t = 0; t < threads; ++t) {
+        customerIds.push_back(system.addCustomerInternal("Bench Customer", 30, 1e12, false)->getPersonId());
+    }
+
+    std::vector<int> failures(threads, 0);
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::string message;
+            for (int f = t; f < kFlights; f += threads) {
+                for (const std::string& seatId : workload.seatIds) {
+                    Booking* booking;
+                    if (globalMutex) {
+                        std::lock_guard<std::mutex> lock(*globalMutex);
+                        booking = system.createBookingInternal(customerIds[t], workload.flightNumbers[f], seatId, message);
+                    } else {
+                        booking = system.createBookingInternal(customerIds[t], workload.flightNumbers[f], seatId, message);
+                    }
+                    failures[t] += booking == nullptr;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (int count : failures) {
+        if (count != 0) {
+            std::cerr << "Some bookings failed." << std::endl;
+            std::exit(1);
+        }
+    }
+    return static_cast<double>(kFlights) * kRows * kSeatsPerRow / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 32;
+    if (maxThreads <= 0) maxThreads = 32;
+
+    Workload workload = makeWorkload();
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+              << ", bookings per run: " << kFlights * kRows * kSeatsPerRow << std::endl;
+    std::cout << std::left << std::setw(10) << "threads"
+              << std::setw(18) << "sharded k/s"
+              << "global mutex k/s" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    run(workload, 1, nullptr); // Warm-up: fills the string interners and the allocator caches
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double sharded = run(workload, threads, nullptr);
+        std::mutex globalMutex;
+        double global = run(workload, threads, &globalMutex);
+        std::cout << std::left << std::setw(10) << threads
+                  << std::setw(18) << sharded / 1e3
+                  << global / 1e3 << std::endl;
+    }
+    return 0;
+}
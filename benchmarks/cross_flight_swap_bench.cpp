@@ -0,0 +1,132 @@
+#include "ReservationSystem.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib> // For std::atoi, std::abort
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Concurrent seat swaps between random pairs of bookings on four fully booked 300-seat flights,
+// for 1..maxThreads threads. Pairs are drawn independently per thread, so swaps between the same
+// two flights run in both directions at once, the case that deadlocks without a global lock order.
+// A watchdog aborts the run if no swap completes for kStallLimit; every run finishing is the
+// deadlock-freedom check. Money conservation and fare/seat consistency are verified after each run.
+// Usage: ./bench_cross_flight_swap [maxThreads] (default 16)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kSwapsPerThread = 50000;
+constexpr std::chrono::seconds kStallLimit{10};
+const std::vector<std::string> kFlights = {"SWAP01", "SWAP02", "SWAP03", "SWAP04"};
+
+struct RunResult {
+    double swapsPerSecond;
+    long succeeded;
+    bool consistent;
+};
+
+RunResult run(int threads) {
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest();
+    std::string error;
+    std::vector<std::string> customerIds;
+    for (int i = 0; i < 16; ++i) {
+        customerIds.push_back(system.addCustomerInternal("Swap Client", 30, 1e9, false)->getPersonId());
+    }
+    std::vector<std::string> bookingIds;
+    for (const std::string& flight : kFlights) {
+        Airplane* plane = system.addAirplaneInternal(flight, 50, 6, error);
+        for (int i = 0; i < plane->getCapacity(); ++i) {
+            const std::string& customerId = customerIds[bookingIds.size() % customerIds.size()];
+            bookingIds.push_back(system.createBookingInternal(customerId, flight, plane->getSeatId(i), error)->getBookingId());
+        }
+    }
+    Cents initialTotal = system.getRevenueCents();
+    for (const std::string& customerId : customerIds) {
+        initialTotal += system.findCustomerById(customerId)->getBalanceCents();
+    }
+
+    std::atomic<long> completed{0};
+    std::atomic<long> succeeded{0};
+    std::atomic<bool> finished{false};
+    std::thread watchdog([&]() {
+        long last = -1;
+        auto lastProgress = Clock::now();
+        while (!finished.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            long now = completed.load();
+            if (now != last) {
+                last = now;
+                lastProgress = Clock::now();
+            } else if (Clock::now() - lastProgress > kStallLimit) {
+                std::cerr << "No swap completed for " << kStallLimit.count() << " s with " << threads
+                          << " threads: deadlock" << std::endl;
+                std::abort();
+            }
+        }
+    });
+
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 gen(7 + t);
+            std::string message;
+            long mine = 0;
+            for (int i = 0; i < kSwapsPerThread; ++i) {
+                mine += system.swapSeatsInternal(bookingIds[gen() % bookingIds.size()], bookingIds[gen() % bookingIds.size()], message);
+                completed.fetch_add(1, std::memory_order_relaxed);
+            }
+            succeeded.fetch_add(mine);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    finished.store(true);
+    watchdog.join();
+
+    Cents finalTotal = system.getRevenueCents();
+    for (const std::string& customerId : customerIds) {
+        finalTotal += system.findCustomerById(customerId)->getBalanceCents();
+    }
+    bool consistent = finalTotal == initialTotal;
+    for (const std::string& bookingId : bookingIds) {
+        Booking* booking = system.findBookingById(bookingId);
+        Airplane* plane = system.findAirplaneByFlightNumber(booking->getFlightNumber());
+        int seatIndex = plane->seatIndexOf(booking->getSeatKey());
+        consistent = consistent && system.findBookingForSeat(booking->getFlightNumber(), booking->getSeatId()) == booking &&
+                     booking->getPaidCents() == toCents(plane->getSeatPrice(seatIndex));
+    }
+    return {completed.load() / seconds, succeeded.load(), consistent};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 16;
+    if (maxThreads <= 0) maxThreads = 16;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(16) << "k swaps/s"
+              << std::setw(14) << "succeeded" << "consistent" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    bool allConsistent = true;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        RunResult result = run(threads);
+        allConsistent = allConsistent && result.consistent;
+        std::cout << std::left << std::setw(10) << threads << std::setw(16) << result.swapsPerSecond / 1e3
+                  << std::setw(14) << result.succeeded << (result.consistent ? "yes" : "NO") << std::endl;
+    }
+    std::cout << "Every run completed without stalling: no deadlock." << std::endl;
+    return allConsistent ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include "ApiRoutes.h"
+#include <chrono>
+#include <cstdlib> // For std::strtoull
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// GET /api/bookings and /api/customers on a large state, streamed (the API's routes: rows written a
+// page at a time into a reused buffer and sent as chunks) versus built the previous way (a json DOM
+// of every row, dumped into one string). A client on another thread reads each body and discards
+// it. Reported per list: time to first byte, total time, body size and how far the server's peak
+// RSS rose while it was served. The streamed lists run first since peak RSS only grows.
+// Usage: ./bench_list_stream [bookings] (default 1000000)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRows = 30;
+constexpr int kSeatsPerRow = 6;
+
+std::string seatId(int seat) { return std::to_string(seat / kSeatsPerRow + 1) + static_cast<char>('A' + seat % kSeatsPerRow); }
+
+double peakMegabytes() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::atof(line.c_str() + 6) / 1024;
+    }
+    return 0;
+}
+
+// Flights filled to about 5/6, one customer per 10 bookings
+bool populate(ReservationSystem& system, std::uint64_t bookingCount) {
+    const std::uint64_t flights = bookingCount / 150 + 1;
+    const std::uint64_t customerCount = bookingCount / 10 + 1;
+    std::string message;
+    for (std::uint64_t f = 0; f < flights; ++f) {
+        if (!system.addAirplaneInternal("FL" + std::to_string(100000 + f), kRows, kSeatsPerRow, message)) return false;
+    }
+    std::vector<std::string> customerIds;
+    for (std::uint64_t c = 0; c < customerCount; ++c) {
+        Customer* customer = system.addCustomerInternal("Customer " + std::to_string(c + 1), 20 + static_cast<int>(c % 60), 1000000.0, false);
+        if (!customer) return false;
+        customerIds.push_back(customer->getPersonId());
+    }
+    for (std::uint64_t i = 0; i < bookingCount; ++i) {
+        if (!system.createBookingInternal(customerIds[i * 7919 % customerCount], "FL" + std::to_string(100000 + i % flights),
+                                          seatId(static_cast<int>(i / flights)), message)) {
+            std::cerr << message << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void fetch(httplib::Client& client, const char* name, const std::string& path) {
+    double peakBefore = peakMegabytes();
+    Clock::time_point start = Clock::now();
+    double firstByte = -1;
+    std::size_t bytes = 0;
+    auto response = client.Get(path, [&](const char*, std::size_t length) {
+        if (firstByte < 0) firstByte = std::chrono::duration<double>(Clock::now() - start).count();
+        bytes += length;
+        return true;
+    });
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (!response || response->status != 200) {
+        std::cerr << path << " failed" << std::endl;
+        return;
+    }
+    std::cout << std::left << std::setw(22) << name << std::right << std::setprecision(3) << std::setw(12) << firstByte
+              << std::setw(10) << seconds << std::setprecision(1) << std::setw(12) << bytes / 1048576.0 << std::setw(16)
+              << peakMegabytes() - peakBefore << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t bookingCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    if (bookingCount == 0) bookingCount = 1000000;
+
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest(); // No seeded data
+    if (!populate(system, bookingCount)) return 1;
+
+    httplib::Server server;
+    auto execute = [&system](Command command) { return CommandPipeline::apply(system, command); };
+    registerApiRoutes(server, system, execute);
+    // The handlers as they were before streaming, for comparison
+    server.Get("/dom/bookings", [&system](const httplib::Request&, httplib::Response& res) {
+        json list = json::array();
+        system.forEachBooking([&list](const Booking& booking) { list.push_back(booking); });
+        res.set_content(list.dump(4), "application/json");
+    });
+    server.Get("/dom/customers", [&system](const httplib::Request&, httplib::Response& res) {
+        json list = json::array();
+        system.forEachCustomer([&list](const Customer& customer) { list.push_back(customer); });
+        res.set_content(list.dump(4), "application/json");
+    });
+    int port = server.bind_to_any_port("127.0.0.1");
+    std::thread serverThread([&server]() { server.listen_after_bind(); });
+    server.wait_until_ready();
+
+    std::cout << bookingCount << " bookings, " << bookingCount / 10 + 1 << " customers" << std::endl;
+    std::cout << std::fixed << std::left << std::setw(22) << "list" << std::right << std::setw(12) << "first byte s" << std::setw(10)
+              << "total s" << std::setw(12) << "body MB" << std::setw(16) << "peak rise MB" << std::endl;
+    httplib::Client client("127.0.0.1", port);
+    client.set_read_timeout(600, 0);
+    fetch(client, "streamed bookings", "/api/bookings");
+    fetch(client, "streamed customers", "/api/customers");
+    fetch(client, "DOM bookings", "/dom/bookings");
+    fetch(client, "DOM customers", "/dom/customers");
+
+    server.stop();
+    serverThread.join();
+    return 0;
+}
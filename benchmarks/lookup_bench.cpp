@@ -0,0 +1,107 @@
+#include "ReservationSystem.h"
+#include <chrono>
+#include <cstdlib> // For std::strtoull
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures ReservationSystem::findCustomerById / findAirplaneByFlightNumber as the
+// number of customers grows. Usage: ./bench_lookup [maxCustomers] (default 10000000)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kLookupsPerRound = 1000000;
+constexpr size_t kLinearScanLimit = 100000; // Linear reference scan gets too slow beyond this
+
+double nanosPerOp(Clock::duration elapsed, int ops) {
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+}
+
+// Reference: what findCustomerById cost before the index existed
+const Customer* linearFind(const SlotMap<Customer>& customers, const std::string& id) {
+    for (const auto& customer : customers) {
+        if (customer.getPersonId() == id) {
+            return &customer;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxCustomers = 10000000;
+    if (argc > 1) {
+        maxCustomers = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    std::ostringstream sink; // Swallow ReservationSystem console output
+    std::mt19937 gen(42);
+
+    std::cout << std::left << std::setw(12) << "customers"
+              << std::setw(18) << "customer ns/op"
+              << std::setw(18) << "flight ns/op"
+              << "linear ns/op" << std::endl;
+
+    for (size_t count = 1000; count <= maxCustomers; count *= 10) {
+        ReservationSystem system(std::cin, sink);
+        system.resetSystemForTest();
+        for (size_t i = 0; i < count; ++i) {
+            system.addCustomerInternal("Bench Customer", 30, 500.0, false);
+        }
+
+        // Pre-build the probe keys so string formatting is not part of the timing.
+        // IDs are CUST0001.. in insertion order after resetSystemForTest().
+        std::uniform_int_distribution<size_t> pick(1, count);
+        std::vector<std::string> probes;
+        probes.reserve(1024);
+        for (int i = 0; i < 1024; ++i) {
+            std::ostringstream id;
+            id << "CUST" << std::setfill('0') << std::setw(4) << pick(gen);
+            probes.push_back(id.str());
+        }
+
+        size_t hits = 0;
+        auto start = Clock::now();
+        for (int i = 0; i < kLookupsPerRound; ++i) {
+            hits += system.findCustomerById(probes[i & 1023]) != nullptr;
+        }
+        double customerNs = nanosPerOp(Clock::now() - start, kLookupsPerRound);
+
+        start = Clock::now();
+        for (int i = 0; i < kLookupsPerRound; ++i) {
+            hits += system.findAirplaneByFlightNumber((i & 1) ? "FL101" : "FL202") != nullptr;
+        }
+        double flightNs = nanosPerOp(Clock::now() - start, kLookupsPerRound);
+
+        std::string linearColumn = "-";
+        if (count <= kLinearScanLimit) {
+            const int linearOps = 1000;
+            start = Clock::now();
+            for (int i = 0; i < linearOps; ++i) {
+                hits += linearFind(system.getCustomersForTest(), probes[i & 1023]) != nullptr;
+            }
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(1) << nanosPerOp(Clock::now() - start, linearOps);
+            linearColumn = oss.str();
+        }
+
+        std::cout << std::left << std::setw(12) << count
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(18) << customerNs
+                  << std::setw(18) << flightNs
+                  << linearColumn << std::endl;
+        std::cout << std::setfill(' ');
+
+        if (hits == 0) {
+            std::cerr << "No lookups succeeded." << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "Airplane.h"
+#include "ReservationSystem.h"
+#include <chrono>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Flash-sale contention on a single flight, for 1..maxThreads threads.
+//  - claim/release: every thread books and releases seats of one 12-seat flight as fast as it can,
+//    lock-free (Airplane::bookSeatAt/unbookSeatAt) versus the same calls behind a per-flight mutex.
+//  - sell-out: every thread has its own customer and tries to book every seat of one 300-seat
+//    flight through ReservationSystem; reports the time to sell the flight out.
+// Usage: ./bench_seat_contention [maxThreads] (default 32)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kOpsPerThread = 400000;
+
+// Returns claim+release attempts per second across all threads
+double claimRelease(int threads, std::mutex* flightMutex) {
+    Airplane plane("HOT001", 2, 6);
+    const int capacity = plane.getCapacity();
+    std::vector<long> wins(threads, 0);
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            long won = 0;
+            unsigned seat = static_cast<unsigned>(t) * 5;
+            for (int i = 0; i < kOpsPerThread; ++i) {
+                int seatIndex = static_cast<int>(seat++ % capacity);
+                if (flightMutex) {
+                    std::lock_guard<std::mutex> lock(*flightMutex);
+                    if (plane.bookSeatAt(seatIndex)) {
+                        ++won;
+                        plane.unbookSeatAt(seatIndex);
+                    }
+                } else if (plane.bookSeatAt(seatIndex)) {
+                    ++won;
+                    plane.unbookSeatAt(seatIndex);
+                }
+            }
+            wins[t] = won;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    long total = 0;
+    for (long won : wins) total += won;
+    if (total == 0 || plane.getBookedSeatsCount() != 0) {
+        std::cerr << "Inconsistent claim/release run." << std::endl;
+        std::exit(1);
+    }
+    return static_cast<double>(threads) * kOpsPerThread / seconds;
+}
+
+// Returns milliseconds until the flight is sold out; exits if a seat is sold twice or left unsold
+double sellOut(int threads) {
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest();
+    std::string error;
+    Airplane* plane = system.addAirplaneInternal("HOT300", 50, 6, error);
+    std::vector<std::string> customerIds;
+    for (int t = 0; t < threads; ++t) {
+        customerIds.push_back(system.addCustomerInternal("Bench Customer", 30, 1e9, false)->getPersonId());
+    }
+    std::vector<std::string> seatIds;
+    for (int i = 0; i < plane->getCapacity(); ++i) {
+        seatIds.push_back(plane->getSeatId(i));
+    }
+
+    std::vector<int> sold(threads, 0);
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::string message;
+            for (size_t i = 0; i < seatIds.size(); ++i) {
+                const std::string& seatId = seatIds[(i + t * 37) % seatIds.size()];
+                sold[t] += system.createBookingInternal(customerIds[t], "HOT300", seatId, message) != nullptr;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    int total = 0;
+    for (int count : sold) total += count;
+    if (total != plane->getCapacity() || plane->getBookedSeatsCount() != plane->getCapacity()) {
+        std::cerr << "Sold " << total << " of " << plane->getCapacity() << " seats." << std::endl;
+        std::exit(1);
+    }
+    return ms;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : 32;
+    if (maxThreads <= 0) maxThreads = 32;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::left << std::setw(10) << "threads"
+              << std::setw(18) << "lock-free M/s"
+              << std::setw(18) << "mutex M/s"
+              << "sell-out ms (300 seats)" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    sellOut(1); // Warm-up: fills the string interners and the allocator caches
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        double lockFree = claimRelease(threads, nullptr);
+        std::mutex flightMutex;
+        double locked = claimRelease(threads, &flightMutex);
+        double ms = sellOut(threads);
+        std::cout << std::left << std::setw(10) << threads
+                  << std::setw(18) << lockFree / 1e6
+                  << std::setw(18) << locked / 1e6
+                  << ms << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "Airplane.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Measures Airplane::findSeat and book/unbook round trips for airplanes of increasing
+// row counts; with seat-ID decoding the cost should not depend on the row count.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kOpsPerRound = 2000000;
+
+double nanosPerOp(Clock::duration elapsed, int ops) {
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 gen(7);
+    const int seatsPerRow = 10;
+
+    std::cout << std::left << std::setw(8) << "rows"
+              << std::setw(18) << "findSeat ns/op"
+              << "book+unbook ns/op" << std::endl;
+
+    for (int rows : {60, 150, 300, 600}) {
+        Airplane plane("BENCH", rows, seatsPerRow);
+
+        std::uniform_int_distribution<size_t> pick(0, plane.getAllSeats().size() - 1);
+        std::vector<std::string> probes;
+        for (int i = 0; i < 1024; ++i) {
+            probes.push_back(plane.getAllSeats()[pick(gen)].getSeatId());
+        }
+
+        size_t found = 0;
+        auto start = Clock::now();
+        for (int i = 0; i < kOpsPerRound; ++i) {
+            found += plane.findSeat(probes[i & 1023]) != nullptr;
+        }
+        double findNs = nanosPerOp(Clock::now() - start, kOpsPerRound);
+
+        start = Clock::now();
+        for (int i = 0; i < kOpsPerRound; ++i) {
+            const std::string& id = probes[i & 1023];
+            found += plane.bookSpecificSeat(id);
+            found += plane.unbookSpecificSeat(id);
+        }
+        double roundTripNs = nanosPerOp(Clock::now() - start, kOpsPerRound);
+
+        std::cout << std::left << std::setw(8) << rows
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(18) << findNs
+                  << roundTripNs << std::endl;
+
+        if (found == 0) {
+            std::cerr << "No seats found." << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
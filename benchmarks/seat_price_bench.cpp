@@ -0,0 +1,112 @@
+#include "Airplane.h"
+#include <algorithm>
+#include <chrono>
+#include <deque> // Airplane is not movable (atomic occupancy)
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// "Cheapest N free seats under a budget" over many flights: the old approach (walk
+// vector<Seat>, collect pointers, sort them all) versus the columnar price scan used by
+// suggestLowerPriceSeats and the bounded findCheapestAvailableSeats batch query.
+// Usage: ./bench_seat_price [flights] (default 5000)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPasses = 10;
+constexpr int kWanted = 5;
+constexpr double kBudget = 400.0;
+
+long long pointerSort(const std::deque<Airplane>& fleet) {
+    long long checksum = 0;
+    for (const auto& plane : fleet) {
+        std::vector<const Seat*> matches;
+        for (const auto& seat : plane.getAllSeats()) {
+            if (!seat.getIsBooked() && seat.getPrice() <= kBudget) {
+                matches.push_back(&seat);
+            }
+        }
+        std::stable_sort(matches.begin(), matches.end(), [](const Seat* a, const Seat* b) {
+            return a->getPrice() < b->getPrice();
+        });
+        for (size_t i = 0; i < matches.size() && i < static_cast<size_t>(kWanted); ++i) {
+            checksum += static_cast<long long>(matches[i]->getPrice() * 100);
+        }
+    }
+    return checksum;
+}
+
+long long columnarSuggest(const std::deque<Airplane>& fleet, const Customer& customer) {
+    long long checksum = 0;
+    for (const auto& plane : fleet) {
+        std::vector<const Seat*> matches = plane.suggestLowerPriceSeats(&customer, kBudget);
+        for (size_t i = 0; i < matches.size() && i < static_cast<size_t>(kWanted); ++i) {
+            checksum += static_cast<long long>(matches[i]->getPrice() * 100);
+        }
+    }
+    return checksum;
+}
+
+long long cheapestBatch(const std::deque<Airplane>& fleet) {
+    long long checksum = 0;
+    for (const auto& plane : fleet) {
+        for (int index : plane.findCheapestAvailableSeats(kWanted, kBudget)) {
+            checksum += static_cast<long long>(plane.getSeatPrice(index) * 100);
+        }
+    }
+    return checksum;
+}
+
+template<typename Query>
+double millisPerPass(Query query, long long& checksum) {
+    auto start = Clock::now();
+    for (int pass = 0; pass < kPasses; ++pass) {
+        checksum = query();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kPasses;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int flightCount = argc > 1 ? std::atoi(argv[1]) : 5000;
+    if (flightCount <= 0) flightCount = 5000;
+
+    std::mt19937 gen(1234);
+    std::bernoulli_distribution occupied(0.6);
+    std::uniform_int_distribution<int> cents(5000, 60000);
+
+    std::deque<Airplane> fleet;
+    for (int f = 0; f < flightCount; ++f) {
+        fleet.emplace_back("FL" + std::to_string(f), 50, 6);
+        Airplane& plane = fleet.back();
+        for (int i = 0; i < plane.getCapacity(); ++i) {
+            plane.setSeatPrice(i, cents(gen) / 100.0);
+            if (occupied(gen)) plane.bookSeatAt(i);
+        }
+    }
+    Customer customer("Bench Customer", 30, "CUST0001", 1000000.0);
+
+    long long sorted = 0, suggested = 0, batched = 0;
+    double sortMs = millisPerPass([&]() { return pointerSort(fleet); }, sorted);
+    double suggestMs = millisPerPass([&]() { return columnarSuggest(fleet, customer); }, suggested);
+    double batchMs = millisPerPass([&]() { return cheapestBatch(fleet); }, batched);
+
+    if (sorted != suggested || sorted != batched) {
+        std::cerr << "Query results disagree!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "flights: " << flightCount << " (300 seats each, ~60% booked), cheapest "
+              << kWanted << " under $" << kBudget << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "pointer sort:          " << sortMs << " ms/pass" << std::endl;
+    std::cout << "columnar suggest:      " << suggestMs << " ms/pass" << std::endl;
+    std::cout << "cheapest-N batch:      " << batchMs << " ms/pass" << std::endl;
+    std::cout << "batch speedup:         " << std::setprecision(1) << sortMs / batchMs << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "AdaptiveTaskQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// An overloaded airline_api_server: `clients` closed-loop clients (new connection per request)
+// against a handler that holds its worker for 20 ms, as a slow downstream call would. Compares
+// httplib's default fixed ThreadPool, which queues without bound so latency grows with the backlog,
+// to AdaptiveTaskQueue, which grows the pool up to its cap and answers 503 quickly past it.
+// Reports successful requests/s and their p50/p99, and how many 503s came back and how fast.
+// Usage: ./bench_server_backpressure [clients] [seconds] (default 200 clients, 3 s per server)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kHandlerTime = std::chrono::milliseconds(20);
+
+struct Samples {
+    std::mutex mutex;
+    std::vector<double> okMs, busyMs;
+    int failed = 0;
+};
+
+double percentile(std::vector<double>& values, double fraction) {
+    if (values.empty()) return 0.0;
+    std::size_t at = static_cast<std::size_t>(fraction * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + at, values.end());
+    return values[at];
+}
+
+void runServer(const char* name, bool adaptive, int clients, int seconds) {
+    httplib::Server server;
+    if (adaptive) {
+        AdaptiveTaskQueue::Settings settings;
+        settings.minWorkers = 4;
+        settings.maxWorkers = 64;
+        settings.maxQueued = 64;
+        settings.targetWait = std::chrono::milliseconds(10);
+        settings.maxWait = std::chrono::milliseconds(100);
+        server.new_task_queue = [settings]() { return new AdaptiveTaskQueue(settings); };
+        server.set_pre_routing_handler([](const httplib::Request&, httplib::Response& res) {
+            if (!AdaptiveTaskQueue::isShedding()) return httplib::Server::HandlerResponse::Unhandled;
+            AdaptiveTaskQueue::writeShedResponse(res);
+            return httplib::Server::HandlerResponse::Handled;
+        });
+    }
+    server.Get("/work", [](const httplib::Request&, httplib::Response& res) {
+        std::this_thread::sleep_for(kHandlerTime);
+        res.set_content("{}", "application/json");
+    });
+    int port = server.bind_to_any_port("127.0.0.1");
+    std::thread serverThread([&server]() { server.listen_after_bind(); });
+
+    Samples samples;
+    std::atomic<bool> running{true};
+    std::vector<std::thread> clientThreads;
+    for (int c = 0; c < clients; ++c) {
+        clientThreads.emplace_back([&]() {
+            std::vector<double> okMs, busyMs;
+            int failed = 0;
+            httplib::Client client("127.0.0.1", port);
+            client.set_read_timeout(30, 0);
+            while (running.load(std::memory_order_relaxed)) {
+                auto start = Clock::now();
+                httplib::Result result = client.Get("/work");
+                double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                if (result && result->status == 200) {
+                    okMs.push_back(ms);
+                } else if (result && result->status == 503) {
+                    busyMs.push_back(ms);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // A polite client backs off
+                } else {
+                    ++failed;
+                }
+            }
+            std::lock_guard<std::mutex> lock(samples.mutex);
+            samples.okMs.insert(samples.okMs.end(), okMs.begin(), okMs.end());
+            samples.busyMs.insert(samples.busyMs.end(), busyMs.begin(), busyMs.end());
+            samples.failed += failed;
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running = false;
+    for (std::thread& thread : clientThreads) {
+        thread.join();
+    }
+    server.stop();
+    serverThread.join();
+
+    std::size_t ok = samples.okMs.size(), busy = samples.busyMs.size();
+    std::cout << std::left << std::setw(16) << name << std::setw(10) << ok / static_cast<double>(seconds)
+              << std::setw(10) << percentile(samples.okMs, 0.5) << std::setw(10) << percentile(samples.okMs, 0.99)
+              << std::setw(10) << busy << std::setw(10) << percentile(samples.busyMs, 0.5)
+              << samples.failed << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int clients = argc > 1 ? std::atoi(argv[1]) : 200;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 3;
+    if (clients <= 0) clients = 200;
+    if (seconds <= 0) seconds = 3;
+
+    std::cout << clients << " clients, " << kHandlerTime.count() << " ms handler, " << seconds << " s per server, default pool "
+              << CPPHTTPLIB_THREAD_POOL_COUNT << " threads" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(16) << "server" << std::setw(10) << "ok/s" << std::setw(10) << "ok p50"
+              << std::setw(10) << "ok p99" << std::setw(10) << "503s" << std::setw(10) << "503 p50" << "errors" << std::endl;
+    runServer("default pool", false, clients, seconds);
+    runServer("adaptive", true, clients, seconds);
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include "JsonWriter.h"
+#include "ReservationSystem.h"
+#include "../third_party/nlohmann_json.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>  // For std::remove
+#include <cstdlib> // For std::strtoull
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h> // For fork
+#include <vector>
+
+// Startup and save cost of a large state: a binary snapshot (mapped, restored customers and
+// bookings looked up in the file) against a JSON dump of the same airplanes, fares, customers and
+// bookings. Each step runs in a forked child so its peak RSS is its own. The JSON load is only a
+// SAX parse that builds nothing, so it is a lower bound on restoring from JSON.
+// While the live state is saved, another thread books and cancels seats and reports its longest
+// wait: the exclusive lock held for the copy.
+// Usage: ./bench_snapshot [bookings] [directory] (default 1000000, current directory; keep it off tmpfs)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kRows = 30;
+constexpr int kSeatsPerRow = 6;
+
+double secondsSince(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+// Current and peak resident set, in MB
+void residentMegabytes(double& current, double& peak) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    current = peak = 0;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) current = std::atof(line.c_str() + 6) / 1024;
+        if (line.compare(0, 6, "VmHWM:") == 0) peak = std::atof(line.c_str() + 6) / 1024;
+    }
+}
+
+std::uint64_t fileBytes(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return in ? static_cast<std::uint64_t>(in.tellg()) : 0;
+}
+
+// Flights filled to about 5/6, one customer per 10 bookings, every 20th booking cancelled
+SnapshotFile::Image makeImage(std::uint64_t bookingCount) {
+    SnapshotFile::Image image;
+    const std::uint64_t flights = bookingCount / 150 + 1;
+    const std::uint64_t customerCount = bookingCount / 10 + 1;
+    const int capacity = kRows * kSeatsPerRow;
+    for (std::uint64_t f = 0; f < flights; ++f) {
+        image.airplanes.push_back({image.addString("FL" + std::to_string(100000 + f)), kRows, kSeatsPerRow, image.seatPrices.size()});
+        for (int seat = 0; seat < capacity; ++seat) {
+            image.seatPrices.push_back(seat < 6 * kSeatsPerRow ? 200.0 : 50.0);
+        }
+    }
+    image.seatBookings.assign(image.seatPrices.size(), 0);
+    std::vector<std::uint32_t> perCustomer(customerCount, 0);
+    std::uint64_t state = 88172645463325252ull;
+    for (std::uint64_t i = 0; i < bookingCount; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        std::uint32_t customer = static_cast<std::uint32_t>(state % customerCount);
+        std::uint32_t flight = static_cast<std::uint32_t>(i % flights);
+        int seat = static_cast<int>(i / flights);
+        bool cancelled = i % 20 == 19;
+        Cents fare = seat < 6 * kSeatsPerRow ? 20000 : 5000;
+        image.bookings.push_back({(1ull << 40) + i, cancelled ? 0 : fare, customer, flight, seat,
+                                  static_cast<std::uint8_t>(cancelled ? BookingStatus::CANCELLED : BookingStatus::CONFIRMED), {}});
+        if (!cancelled) image.seatBookings[flight * capacity + seat] = static_cast<std::uint32_t>(i + 1);
+        ++perCustomer[customer];
+        image.revenueCents += cancelled ? 0 : fare;
+    }
+    std::uint64_t next = 0;
+    for (std::uint64_t c = 0; c < customerCount; ++c) {
+        std::ostringstream id;
+        id << "CUST" << std::setfill('0') << std::setw(8) << c + 1;
+        image.customers.push_back({image.addString(id.str()), image.addString("Customer " + std::to_string(c + 1)), 100000000, next,
+                                   perCustomer[c], 20 + static_cast<int>(c % 60)});
+        next += perCustomer[c];
+    }
+    image.customerBookings.resize(bookingCount);
+    std::vector<std::uint32_t> filled(customerCount, 0);
+    for (std::uint64_t i = 0; i < bookingCount; ++i) { // Grouped by customer, oldest first
+        std::uint32_t customer = image.bookings[i].customer;
+        image.customerBookings[image.customers[customer].firstBooking + filled[customer]++] = static_cast<std::uint32_t>(i);
+    }
+    image.nextCustomerNumber = customerCount + 1;
+    return image;
+}
+
+// Runs step in a child process and waits for it; the child prints its own results
+template<typename Fn>
+void inChild(Fn step) {
+    std::cout.flush();
+    pid_t child = ::fork();
+    if (child == 0) {
+        int status = step() ? 0 : 1;
+        std::cout.flush();
+        ::_exit(status);
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+}
+
+bool load(ReservationSystem& system, const std::string& path, double& seconds) {
+    std::string message;
+    Clock::time_point start = Clock::now();
+    bool loaded = system.loadSnapshot(path, message);
+    seconds = secondsSince(start);
+    if (!loaded) std::cerr << message << std::endl;
+    return loaded;
+}
+
+void report(const char* step, double seconds, std::uint64_t bytes) {
+    double current = 0, peak = 0;
+    residentMegabytes(current, peak);
+    std::cout << std::left << std::setw(30) << step << std::right << std::setw(10) << std::setprecision(3) << seconds
+              << std::setw(12) << std::setprecision(0) << bytes / 1e6 << std::setw(10) << current << std::setw(10) << peak << std::endl;
+}
+
+// The same data through JsonWriter, flushed to the file every megabyte
+bool dumpJson(ReservationSystem& system, const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::string buffer;
+    JsonWriter json(buffer);
+    auto flush = [&]() {
+        if (buffer.size() >= (1u << 20)) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    };
+    json.beginObject().key("airplanes").beginArray();
+    system.forEachAirplane([&](const Airplane& airplane) {
+        json.beginObject().key("flightNumber").value(airplane.getFlightNumber())
+            .key("rows").value(airplane.getCapacity() / airplane.getSeatsPerRow()).key("seatsPerRow").value(airplane.getSeatsPerRow())
+            .key("prices").beginArray();
+        for (int seat = 0; seat < airplane.getCapacity(); ++seat) json.value(airplane.getSeatPrice(seat));
+        json.endArray().endObject();
+        flush();
+    });
+    json.endArray().key("customers").beginArray();
+    system.forEachCustomer([&](const Customer& customer) {
+        json.beginObject().key("customerId").value(customer.getPersonId()).key("name").value(customer.getName())
+            .key("age").value(customer.getAge()).key("balanceCents").value(static_cast<long long>(customer.getBalanceCents())).endObject();
+        flush();
+    });
+    json.endArray().key("bookings").beginArray();
+    system.forEachBooking([&](const Booking& booking) {
+        json.beginObject().key("bookingId").value(booking.getBookingId()).key("customerId").value(booking.getCustomerId())
+            .key("flightNumber").value(booking.getFlightNumber()).key("seatId").value(booking.getSeatId())
+            .key("paidCents").value(static_cast<long long>(booking.getPaidCents())).key("status").value(booking.getStatusString()).endObject();
+        flush();
+    });
+    json.endArray().endObject();
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(out.flush());
+}
+
+// Counts values without building anything
+struct CountingSax : nlohmann::json::json_sax_t {
+    std::uint64_t values = 0;
+    bool null() override { ++values; return true; }
+    bool boolean(bool) override { ++values; return true; }
+    bool number_integer(number_integer_t) override { ++values; return true; }
+    bool number_unsigned(number_unsigned_t) override { ++values; return true; }
+    bool number_float(number_float_t, const string_t&) override { ++values; return true; }
+    bool string(string_t&) override { ++values; return true; }
+    bool binary(binary_t&) override { ++values; return true; }
+    bool start_object(std::size_t) override { return true; }
+    bool key(string_t&) override { return true; }
+    bool end_object() override { return true; }
+    bool start_array(std::size_t) override { return true; }
+    bool end_array() override { return true; }
+    bool parse_error(std::size_t, const std::string&, const nlohmann::json::exception&) override { return false; }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::uint64_t bookingCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    if (bookingCount == 0) bookingCount = 1000000;
+    std::string directory = argc > 2 ? std::string(argv[2]) + "/" : "";
+    const std::string seedPath = directory + "bench_snapshot.seed";
+    const std::string savedPath = directory + "bench_snapshot.snap";
+    const std::string jsonPath = directory + "bench_snapshot.json";
+
+    {
+        SnapshotFile::Image image = makeImage(bookingCount);
+        std::string error;
+        if (!SnapshotFile::write(seedPath, image, error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        std::cout << bookingCount << " bookings, " << image.customers.size() << " customers, " << image.airplanes.size()
+                  << " airplanes (" << image.seatPrices.size() << " seats)" << std::endl;
+    }
+    std::cout << std::fixed << std::left << std::setw(30) << "step" << std::right << std::setw(10) << "seconds" << std::setw(12)
+              << "file MB" << std::setw(10) << "RSS MB" << std::setw(10) << "peak MB" << std::endl;
+
+    inChild([&]() {
+        std::ostringstream sink;
+        ReservationSystem system(std::cin, sink);
+        double seconds = 0;
+        if (!load(system, seedPath, seconds)) return false;
+        report("snapshot load", seconds, fileBytes(seedPath));
+
+        // Serving straight away: restored entities are found through the mapped file
+        Clock::time_point start = Clock::now();
+        std::string message;
+        const Booking* booking = system.findBookingById(Booking::formatBookingId((1ull << 40) + bookingCount / 2));
+        std::vector<const Booking*> customerBookings = system.getBookingsForCustomer("CUST00000001");
+        Booking* made = system.createBookingInternal("CUST00000001", "FL100000", "30F", message);
+        if (!booking || customerBookings.empty() || !made) {
+            std::cerr << "Restored state is not usable: " << message << std::endl;
+            return false;
+        }
+        report("first lookups and a booking", secondsSince(start), 0);
+
+        // Save the live state while another thread keeps booking
+        std::atomic<bool> saving{true};
+        double longestWait = 0;
+        std::thread booker([&]() {
+            std::string bookingMessage;
+            while (saving.load()) {
+                Clock::time_point before = Clock::now();
+                Booking* cycle = system.createBookingInternal("CUST00000002", "FL100000", "29F", bookingMessage);
+                if (cycle) system.cancelBookingInternal(cycle->getBookingId(), bookingMessage);
+                longestWait = std::max(longestWait, secondsSince(before));
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        start = Clock::now();
+        bool saved = system.saveSnapshot(savedPath, message);
+        double saveSeconds = secondsSince(start);
+        saving = false;
+        booker.join();
+        if (!saved) {
+            std::cerr << message << std::endl;
+            return false;
+        }
+        report("snapshot save (live)", saveSeconds, fileBytes(savedPath));
+        std::cout << std::left << std::setw(30) << "  longest booking wait" << std::right << std::setw(10) << std::setprecision(3)
+                  << longestWait << std::endl;
+        return true;
+    });
+
+    inChild([&]() {
+        std::ostringstream sink;
+        ReservationSystem system(std::cin, sink);
+        double seconds = 0;
+        if (!load(system, seedPath, seconds)) return false;
+        Clock::time_point start = Clock::now();
+        if (!dumpJson(system, jsonPath)) return false;
+        report("json dump", secondsSince(start), fileBytes(jsonPath));
+        return true;
+    });
+
+    inChild([&]() {
+        Clock::time_point start = Clock::now();
+        std::ifstream in(jsonPath, std::ios::binary);
+        CountingSax counter;
+        if (!nlohmann::json::sax_parse(in, &counter)) return false;
+        report("json load (parse only)", secondsSince(start), fileBytes(jsonPath));
+        return true;
+    });
+
+    std::remove(seedPath.c_str());
+    std::remove(savedPath.c_str());
+    std::remove(jsonPath.c_str());
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "ApiJson.h"
+#include "ReservationSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Seat-map read latency while writer threads churn bookings on the same flight.
+// Each reader serializes the seat map of one 300-seat flight as the /api/airplanes/{id} handler does,
+// either from the published FlightSnapshot (no locks) or through visitFlight (registry + flight lock).
+// Reports p50/p99/p99.9 per read. Usage: ./bench_snapshot_read [writers] (default 4)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kReaders = 2;
+constexpr int kReadsPerReader = 20000;
+constexpr int kRows = 50;
+constexpr int kSeatsPerRow = 6;
+
+struct Latencies {
+    double p50, p99, p999;
+};
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1));
+    return sorted[index];
+}
+
+// Returns read latencies in microseconds; writers book/cancel until every reader is done
+Latencies run(int writers, bool useSnapshot) {
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest();
+    std::string error;
+    Airplane* plane = system.addAirplaneInternal("READ300", kRows, kSeatsPerRow, error);
+    std::vector<std::string> seatIds;
+    for (int i = 0; i < plane->getCapacity(); ++i) {
+        seatIds.push_back(plane->getSeatId(i));
+    }
+    std::vector<std::string> customerIds;
+    for (int w = 0; w < writers; ++w) {
+        customerIds.push_back(system.addCustomerInternal("Bench Writer", 30, 1e12, false)->getPersonId());
+    }
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            std::string message;
+            size_t next = static_cast<size_t>(w) * 37;
+            while (!done.load(std::memory_order_relaxed)) {
+                const std::string& seatId = seatIds[next++ % seatIds.size()];
+                Booking* booking = system.createBookingInternal(customerIds[w], "READ300", seatId, message);
+                if (booking) {
+                    std::string bookingId = booking->getBookingId();
+                    system.cancelBookingInternal(bookingId, message);
+                }
+            }
+        });
+    }
+
+    std::vector<std::vector<double>> samples(kReaders);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < kReaders; ++r) {
+        readers.emplace_back([&, r]() {
+            std::string body;
+            std::vector<const Booking*> seatBookings;
+            samples[r].reserve(kReadsPerReader);
+            for (int i = 0; i < kReadsPerReader; ++i) {
+                auto start = Clock::now();
+                body.clear();
+                if (useSnapshot) {
+                    system.readFlightSnapshot("READ300", [&](const FlightSnapshot& snapshot) {
+                        writeSeatMapJson(body, snapshot);
+                    });
+                } else {
+                    system.visitFlight("READ300", seatBookings, [&](const Airplane& airplane, const std::vector<const Booking*>& owners) {
+                        writeSeatMapJson(body, airplane, owners);
+                    });
+                }
+                samples[r].push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    done = true;
+    for (auto& writer : threads) {
+        writer.join();
+    }
+
+    std::vector<double> all;
+    for (const auto& readerSamples : samples) {
+        all.insert(all.end(), readerSamples.begin(), readerSamples.end());
+    }
+    std::sort(all.begin(), all.end());
+    return {percentile(all, 0.50), percentile(all, 0.99), percentile(all, 0.999)};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int writers = argc > 1 ? std::atoi(argv[1]) : 4;
+    if (writers < 0) writers = 4;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+              << ", readers: " << kReaders << ", writers: " << writers << std::endl;
+    std::cout << std::left << std::setw(12) << "path"
+              << std::setw(12) << "p50 us"
+              << std::setw(12) << "p99 us"
+              << "p99.9 us" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    run(writers, true); // Warm-up: fills the string interners, snapshot pool and allocator caches
+    for (bool useSnapshot : {true, false}) {
+        Latencies latencies = run(writers, useSnapshot);
+        std::cout << std::left << std::setw(12) << (useSnapshot ? "snapshot" : "locked")
+                  << std::setw(12) << latencies.p50
+                  << std::setw(12) << latencies.p99
+                  << latencies.p999 << std::endl;
+    }
+    return 0;
+}
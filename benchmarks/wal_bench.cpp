@@ -0,0 +1,140 @@
+#include "CommandPipeline.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>  // For std::remove
+#include <cstdlib> // For std::atof
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Cost of durability on the booking path: threads book a seat and cancel it again (two logged
+// mutations per cycle, each on the thread's own flight and customer) for a fixed time, with no log,
+// then with each WriteAheadLog durability mode. Reports mutations/s and how many records shared
+// each fsync. "pipeline" is group mode with the mutations submitted to a CommandPipeline, whose
+// writer waits once per drained batch. The log goes to the current directory unless a path is
+// given; keep it off tmpfs, where fsync costs nothing.
+// Usage: ./bench_wal [seconds per run] [log path] (default 1 s, ./bench_wal.log)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Mode {
+    const char* name;
+    bool logged;
+    WriteAheadLog::Durability durability;
+    bool pipelined;
+};
+
+void run(const Mode& mode, int threads, double seconds, const std::string& path) {
+    std::remove(path.c_str());
+    std::ostringstream sink;
+    ReservationSystem system(std::cin, sink);
+    system.resetSystemForTest();
+    std::string error;
+    if (mode.logged) {
+        WriteAheadLog::Options options;
+        options.durability = mode.durability;
+        if (!system.openWriteAheadLog(path, options, error)) {
+            std::cerr << error << std::endl;
+            return;
+        }
+    }
+    std::vector<std::string> customerIds;
+    for (int t = 0; t < threads; ++t) {
+        system.addAirplaneInternal("WB" + std::to_string(100 + t), 10, 6, error);
+        customerIds.push_back(system.addCustomerInternal("Bench " + std::to_string(t), 40, 1e9, false)->getPersonId());
+    }
+
+    std::unique_ptr<CommandPipeline> pipeline;
+    if (mode.pipelined) pipeline = std::make_unique<CommandPipeline>(system);
+    std::atomic<bool> running{true};
+    std::atomic<std::uint64_t> mutations{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::string flight = "WB" + std::to_string(100 + t);
+            const std::string& customer = customerIds[t];
+            std::string message;
+            std::uint64_t done = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                Booking* booking;
+                bool cancelled;
+                if (pipeline) {
+                    Command command;
+                    command.customerId = customer;
+                    command.flightNumber = flight;
+                    command.seatId = "5C";
+                    CommandResult booked = pipeline->submit(command).get();
+                    booking = booked.booking;
+                    message = booked.message;
+                    command.type = Command::Type::CANCEL;
+                    command.bookingId = booking ? booking->getBookingId() : "";
+                    CommandResult cancel = booking ? pipeline->submit(command).get() : CommandResult();
+                    cancelled = cancel.success;
+                    if (booking) message = cancel.message;
+                } else {
+                    booking = system.createBookingInternal(customer, flight, "5C", message);
+                    cancelled = booking && system.cancelBookingInternal(booking->getBookingId(), message);
+                }
+                if (!booking || !cancelled) {
+                    std::cerr << "Unexpected failure: " << message << std::endl;
+                    break;
+                }
+                done += 2;
+            }
+            mutations.fetch_add(done, std::memory_order_relaxed);
+        });
+    }
+    auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    pipeline.reset();
+
+    std::cout << std::left << std::setw(10) << mode.name << std::setw(10) << threads << std::setw(14)
+              << std::setprecision(0) << mutations.load() / elapsed;
+    if (const WriteAheadLog* log = system.getWriteAheadLog()) {
+        WriteAheadLog::Stats stats = log->getStats();
+        std::cout << std::setw(12) << stats.syncs << std::setprecision(1)
+                  << (stats.syncs ? static_cast<double>(stats.records) / static_cast<double>(stats.syncs) : 0.0);
+    } else {
+        std::cout << std::setw(12) << "-" << "-";
+    }
+    std::cout << std::endl;
+    system.resetSystemForTest(); // Closes the log before the file is removed
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+    if (seconds <= 0) seconds = 1.0;
+    std::string path = argc > 2 ? argv[2] : "bench_wal.log";
+
+    const Mode modes[] = {
+        {"off", false, WriteAheadLog::Durability::GROUP, false},
+        {"per-op", true, WriteAheadLog::Durability::PER_OP, false},
+        {"group", true, WriteAheadLog::Durability::GROUP, false},
+        {"async", true, WriteAheadLog::Durability::ASYNC, false},
+        {"pipeline", true, WriteAheadLog::Durability::GROUP, true},
+    };
+    std::cout << "book + cancel cycles for " << seconds << " s per run, log at " << path
+              << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::fixed << std::left << std::setw(10) << "mode" << std::setw(10) << "threads" << std::setw(14)
+              << "mutations/s" << std::setw(12) << "fsyncs" << "records/fsync" << std::endl;
+    for (const Mode& mode : modes) {
+        for (int threads : {1, 4, 16, 64}) {
+            run(mode, threads, seconds, path);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include "AdaptiveTaskQueue.h"
+#include <algorithm>
+
+namespace {
+
+thread_local bool sheddingConnection = false;
+
+double millisSince(AdaptiveTaskQueue::Clock::time_point start, AdaptiveTaskQueue::Clock::time_point now) {
+    return std::chrono::duration<double, std::milli>(now - start).count();
+}
+
+} // namespace
+
+AdaptiveTaskQueue::AdaptiveTaskQueue(const Settings& initial) : settings(initial) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int i = 0; i < std::max(1, settings.minWorkers); ++i) {
+        startWorkerLocked();
+    }
+    minIdleWorkers = workerCount;
+    for (int i = 0; i < std::max(1, settings.shedWorkers); ++i) {
+        shedThreads.emplace_back(&AdaptiveTaskQueue::shedLoop, this);
+    }
+    controller = std::thread(&AdaptiveTaskQueue::controllerLoop, this);
+}
+
+AdaptiveTaskQueue::~AdaptiveTaskQueue() {
+    shutdown();
+}
+
+bool AdaptiveTaskQueue::isShedding() {
+    return sheddingConnection;
+}
+
+void AdaptiveTaskQueue::writeShedResponse(httplib::Response& res) {
+    res.status = 503;
+    res.set_header("Retry-After", "1");
+    res.set_header("Connection", "close"); // Well-behaved clients hang up, which frees the shed thread
+    res.set_content(R"({"error":"Server is busy. Please retry shortly."})", "application/json");
+}
+
+void AdaptiveTaskQueue::startWorkerLocked() {
+    workerThreads.emplace_back(&AdaptiveTaskQueue::workerLoop, this);
+    ++workerCount;
+}
+
+bool AdaptiveTaskQueue::enqueue(std::function<void()> fn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping) return false;
+    ++accepted;
+    if (jobs.size() < std::max<std::size_t>(1, settings.maxQueued)) {
+        jobs.push_back({std::move(fn), Clock::now()});
+        workAvailable.notify_one();
+        return true;
+    }
+    if (shedJobs.size() < settings.maxShedQueued) {
+        ++shed;
+        shedJobs.push_back({std::move(fn), Clock::now()});
+        shedAvailable.notify_one();
+        return true;
+    }
+    ++dropped;
+    return false;
+}
+
+void AdaptiveTaskQueue::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        workAvailable.wait(lock, [this]() { return stopping || retireRequests > 0 || !jobs.empty(); });
+        if (jobs.empty()) { // Stopping, or asked to retire
+            if (!stopping) {
+                --retireRequests;
+                exitedWorkers.push_back(std::this_thread::get_id());
+            }
+            --workerCount;
+            return;
+        }
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        Clock::time_point now = Clock::now();
+        double waitedMs = millisSince(job.queuedAt, now);
+        waitSamples.push_back(waitedMs);
+        bool stale = waitedMs > static_cast<double>(settings.maxWait.count());
+        if (stale) ++shed;
+        ++busyWorkers;
+        minIdleWorkers = std::min(minIdleWorkers, workerCount - busyWorkers);
+        lock.unlock();
+        sheddingConnection = stale; // Too late to be worth serving: answer 503 instead
+        job.fn();
+        sheddingConnection = false;
+        job.fn = nullptr; // Release what the task captured outside the lock
+        lock.lock();
+        --busyWorkers;
+    }
+}
+
+void AdaptiveTaskQueue::shedLoop() {
+    sheddingConnection = true;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        shedAvailable.wait(lock, [this]() { return stopping || !shedJobs.empty(); });
+        if (shedJobs.empty()) return; // Stopping
+        Job job = std::move(shedJobs.front());
+        shedJobs.pop_front();
+        lock.unlock();
+        job.fn();
+        job.fn = nullptr;
+        lock.lock();
+    }
+}
+
+void AdaptiveTaskQueue::controllerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        controllerWake.wait_for(lock, settings.adjustInterval, [this]() { return stopping; });
+        if (stopping) break;
+        adjustLocked();
+        // Join retired workers; they have left workerLoop, so this does not wait on real work
+        std::vector<std::thread::id> exited;
+        exited.swap(exitedWorkers);
+        for (std::thread::id id : exited) {
+            auto it = std::find_if(workerThreads.begin(), workerThreads.end(),
+                                   [id](const std::thread& thread) { return thread.get_id() == id; });
+            if (it != workerThreads.end()) {
+                std::thread retired = std::move(*it);
+                workerThreads.erase(it);
+                lock.unlock();
+                retired.join();
+                lock.lock();
+            }
+        }
+    }
+}
+
+void AdaptiveTaskQueue::adjustLocked() {
+    Clock::time_point now = Clock::now();
+    if (waitSamples.empty()) {
+        waitP50Ms = waitP99Ms = waitMaxMs = 0;
+    } else {
+        std::vector<double>& samples = waitSamples;
+        std::size_t p50 = samples.size() / 2;
+        std::size_t p99 = static_cast<std::size_t>(0.99 * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + p99, samples.end());
+        waitP99Ms = samples[p99];
+        waitMaxMs = *std::max_element(samples.begin() + p99, samples.end());
+        std::nth_element(samples.begin(), samples.begin() + p50, samples.begin() + p99);
+        waitP50Ms = p50 < p99 ? samples[p50] : waitP99Ms;
+        samples.clear();
+    }
+    // A queue no worker is draining yields no samples, so the head's age counts as well
+    double oldestMs = jobs.empty() ? 0.0 : millisSince(jobs.front().queuedAt, now);
+    double pressureMs = std::max(waitP99Ms, oldestMs);
+    int activeWorkers = workerCount - retireRequests;
+
+    if (pressureMs > static_cast<double>(settings.targetWait.count()) && activeWorkers < settings.maxWorkers) {
+        if (retireRequests > 0) { // Cancel pending retirements first
+            --retireRequests;
+        } else {
+            int grow = std::min(settings.maxWorkers - activeWorkers, std::max(1, activeWorkers / 2));
+            for (int i = 0; i < grow; ++i) {
+                startWorkerLocked();
+            }
+        }
+    } else if (jobs.empty() && waitMaxMs <= static_cast<double>(settings.targetWait.count()) / 2 &&
+               minIdleWorkers > 0 && activeWorkers > settings.minWorkers) {
+        // Give back half of the workers that were idle for the whole interval
+        int retire = std::min(activeWorkers - settings.minWorkers, (minIdleWorkers + 1) / 2);
+        retireRequests += retire;
+        for (int i = 0; i < retire; ++i) {
+            workAvailable.notify_one();
+        }
+    }
+    minIdleWorkers = workerCount - retireRequests - busyWorkers;
+}
+
+void AdaptiveTaskQueue::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopped) return;
+        stopped = true;
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    shedAvailable.notify_all();
+    controllerWake.notify_all();
+    controller.join();
+    // Nothing starts or retires workers any more, so the lists are stable
+    for (std::thread& worker : workerThreads) {
+        worker.join();
+    }
+    for (std::thread& shedThread : shedThreads) {
+        shedThread.join();
+    }
+}
+
+AdaptiveTaskQueue::Stats AdaptiveTaskQueue::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats stats;
+    stats.queueDepth = jobs.size();
+    stats.shedQueueDepth = shedJobs.size();
+    stats.workers = workerCount - retireRequests;
+    stats.busyWorkers = busyWorkers;
+    stats.accepted = accepted;
+    stats.shed = shed;
+    stats.dropped = dropped;
+    stats.waitP50Ms = waitP50Ms;
+    stats.waitP99Ms = waitP99Ms;
+    stats.waitMaxMs = waitMaxMs;
+    stats.oldestWaitMs = jobs.empty() ? 0.0 : millisSince(jobs.front().queuedAt, Clock::now());
+    return stats;
+}
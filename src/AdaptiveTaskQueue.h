@@ -0,0 +1,102 @@
+#ifndef ADAPTIVETASKQUEUE_H
+#define ADAPTIVETASKQUEUE_H
+
+#include "../third_party/httplib.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker pool for httplib::Server (install through Server::new_task_queue) that sizes itself from
+// how long connections wait for a worker. A controller thread looks at the queue waits once per
+// adjust interval: above targetWait it adds workers (half as many again, up to maxWorkers); when
+// workers sat idle the whole interval and nothing waited it retires some (down to minWorkers).
+// Backpressure: at most maxQueued connections wait; the rest, and any connection that waited longer
+// than maxWait by the time a worker picks it up, are served in shedding mode, where isShedding()
+// is true and the server is expected to answer 503 at once (see writeShedResponse). Shed
+// connections have their own few threads so they never queue behind real work; beyond
+// maxShedQueued they are closed unanswered.
+class AdaptiveTaskQueue : public httplib::TaskQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings {
+        int minWorkers = 4;
+        int maxWorkers = 64;
+        std::size_t maxQueued = 256;     // Connections waiting for a worker (at least 1)
+        std::chrono::milliseconds targetWait{10};
+        std::chrono::milliseconds maxWait{250};
+        std::chrono::milliseconds adjustInterval{100};
+        int shedWorkers = 2;
+        std::size_t maxShedQueued = 1024;
+    };
+
+    struct Stats {
+        std::size_t queueDepth = 0;
+        std::size_t shedQueueDepth = 0;
+        int workers = 0;
+        int busyWorkers = 0;
+        std::uint64_t accepted = 0; // Jobs handed to the queue: connections on httplib, requests on epoll
+        std::uint64_t shed = 0;     // Of those, served in shedding mode
+        std::uint64_t dropped = 0;  // Of those, closed unanswered
+        double waitP50Ms = 0, waitP99Ms = 0, waitMaxMs = 0; // Queue waits over the last adjust interval
+        double oldestWaitMs = 0;    // Age of the connection at the head of the queue
+    };
+
+private:
+    struct Job {
+        std::function<void()> fn;
+        Clock::time_point queuedAt;
+    };
+
+    const Settings settings;
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable shedAvailable;
+    std::condition_variable controllerWake;
+    std::deque<Job> jobs;
+    std::deque<Job> shedJobs;
+    std::list<std::thread> workerThreads;
+    std::vector<std::thread::id> exitedWorkers; // Retired, waiting for the controller to join them
+    std::vector<std::thread> shedThreads;
+    std::thread controller;
+    int workerCount = 0;    // Running workers, including ones asked to retire
+    int busyWorkers = 0;
+    int retireRequests = 0; // Idle workers that should exit
+    int minIdleWorkers = 0; // Fewest idle workers seen this interval
+    bool stopping = false;
+    bool stopped = false;
+    std::vector<double> waitSamples; // Milliseconds, this interval
+    std::uint64_t accepted = 0, shed = 0, dropped = 0;
+    double waitP50Ms = 0, waitP99Ms = 0, waitMaxMs = 0;
+
+    void startWorkerLocked();
+    void workerLoop();
+    void shedLoop();
+    void controllerLoop();
+    void adjustLocked(); // One controller step; caller holds mutex
+
+public:
+    explicit AdaptiveTaskQueue(const Settings& settings);
+    ~AdaptiveTaskQueue() override;
+
+    AdaptiveTaskQueue(const AdaptiveTaskQueue&) = delete;
+    AdaptiveTaskQueue& operator=(const AdaptiveTaskQueue&) = delete;
+
+    bool enqueue(std::function<void()> fn) override; // false: over every limit, httplib closes the socket
+    void shutdown() override; // Serves what is queued, then joins every thread
+
+    Stats getStats() const;
+    const Settings& getSettings() const { return settings; }
+
+    static bool isShedding(); // True while the calling thread serves a shed connection
+    static void writeShedResponse(httplib::Response& res); // 503 with Retry-After, closing the connection
+};
+
+#endif // ADAPTIVETASKQUEUE_H
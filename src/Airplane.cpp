@@ -1,5 +1,6 @@
 #include "Airplane.h"
-#include <algorithm> // For std::find_if
+#include <algorithm> // For std::sort, heap operations
+#include <utility>   // For std::pair
 
 // Constructor
 Airplane::Airplane(const std::string& flightNum, int rows, int sPerRow)
@@ -18,6 +19,11 @@ Airplane::~Airplane() {
 // Helper to create seats
 void Airplane::initializeSeats() {
     seats.clear(); // Clear any existing seats if this method were called again
+    seats.reserve(static_cast<size_t>(totalRows) * seatsPerRow);
+    seatPrices.reset(new std::atomic<double>[static_cast<size_t>(totalRows) * seatsPerRow]);
+    occupiedSeats.resize(totalRows * seatsPerRow);
+    businessSeats.resize(totalRows * seatsPerRow);
+    economySeats.resize(totalRows * seatsPerRow);
     char seatLetter = 'A';
     double economyBasePrice = 50.0;  // Default base price for economy
     double businessBasePrice = 100.0; // Default base price for business (or use a multiplier)
@@ -27,19 +33,27 @@ void Airplane::initializeSeats() {
     if (businessRows == 0 && totalRows > 0) businessRows = 1; // At least one business row if plane is small but has business class
 
     for (int i = 1; i <= totalRows; ++i) {
+        std::string id = std::to_string(i) + seatLetter; // The letter is replaced for each seat of the row
         for (int j = 0; j < seatsPerRow; ++j) {
-            std::string id = std::to_string(i) + static_cast<char>(seatLetter + j);
+            id.back() = static_cast<char>(seatLetter + j);
             SeatClass sc = (i <= businessRows) ? SeatClass::BUSINESS : SeatClass::ECONOMY;
             double price = (sc == SeatClass::BUSINESS) ? businessBasePrice : economyBasePrice;
             // Adjust price based on row or seat position if desired (e.g. window seats more expensive)
             // For simplicity, using fixed base prices per class for now.
             seats.emplace_back(id, sc, price);
+            seats.back().bindOccupancy(&occupiedSeats, static_cast<int>(seats.size()) - 1); // seats never reallocates: reserved above
+            seatPrices[seats.size() - 1].store(seats.back().getPrice(), std::memory_order_relaxed); // Seat applies the business multiplier
+            if (sc == SeatClass::BUSINESS) {
+                businessSeats.set(static_cast<int>(seats.size()) - 1);
+            } else {
+                economySeats.set(static_cast<int>(seats.size()) - 1);
+            }
         }
     }
 }
 
 // Getters
-std::string Airplane::getFlightNumber() const {
+const std::string& Airplane::getFlightNumber() const {
     return flightNumber;
 }
 
@@ -47,48 +61,139 @@ int Airplane::getCapacity() const {
     return totalRows * seatsPerRow;
 }
 
+int Airplane::getSeatsPerRow() const {
+    return seatsPerRow;
+}
+
 int Airplane::getBookedSeatsCount() const {
-    return bookedSeatsCount;
+    return bookedSeatsCount.load(std::memory_order_relaxed);
 }
 
 bool Airplane::isFull() const {
-    return bookedSeatsCount >= getCapacity();
+    return getBookedSeatsCount() >= getCapacity();
 }
 
 const std::vector<Seat>& Airplane::getAllSeats() const {
     return seats;
 }
 
+// Availability queries
+const SeatBitset& Airplane::classMask(SeatClass sc) const {
+    return sc == SeatClass::BUSINESS ? businessSeats : economySeats;
+}
+
+bool Airplane::isSeatBooked(int seatIndex) const {
+    return seatIndex >= 0 && seatIndex < occupiedSeats.size() && occupiedSeats.test(seatIndex);
+}
+
+int Airplane::getAvailableSeatCount() const {
+    return occupiedSeats.size() - occupiedSeats.count();
+}
+
+int Airplane::getAvailableSeatCount(SeatClass sc) const {
+    return occupiedSeats.countAndNot(classMask(sc));
+}
+
+int Airplane::findFirstAvailableSeat() const {
+    return occupiedSeats.findFirstClear();
+}
+
+int Airplane::findFirstAvailableSeat(SeatClass sc) const {
+    return occupiedSeats.findFirstClearIn(classMask(sc));
+}
+
+// Seat addressing
+int Airplane::seatIndexOf(const std::string& seatId) const {
+    int row = 0;
+    int column = 0;
+    if (!SeatCodec::parse(seatId, row, column)) {
+        return -1;
+    }
+    if (row > totalRows || column >= seatsPerRow) {
+        return -1;
+    }
+    return (row - 1) * seatsPerRow + column;
+}
+
+int Airplane::seatIndexOf(SeatKey key) const {
+    if (key == SeatCodec::INVALID_KEY) {
+        return -1;
+    }
+    int row = SeatCodec::rowOf(key);
+    int column = SeatCodec::columnOf(key);
+    if (row > totalRows || column >= seatsPerRow) {
+        return -1;
+    }
+    return (row - 1) * seatsPerRow + column;
+}
+
+SeatKey Airplane::getSeatKey(int seatIndex) const {
+    if (seatIndex < 0 || seatIndex >= getCapacity()) {
+        return SeatCodec::INVALID_KEY;
+    }
+    return SeatCodec::toKey(seatIndex / seatsPerRow + 1, seatIndex % seatsPerRow);
+}
+
+double Airplane::getSeatPrice(int seatIndex) const {
+    return seatPrices[seatIndex].load(std::memory_order_relaxed);
+}
+
+SeatClass Airplane::getSeatClass(int seatIndex) const {
+    return businessSeats.test(seatIndex) ? SeatClass::BUSINESS : SeatClass::ECONOMY;
+}
+
+std::string Airplane::getSeatId(int seatIndex) const {
+    return SeatCodec::toSeatId(getSeatKey(seatIndex));
+}
+
+bool Airplane::setSeatPrice(int seatIndex, double newPrice) {
+    if (seatIndex < 0 || seatIndex >= getCapacity() || newPrice < 0) {
+        return false;
+    }
+    seatPrices[seatIndex].store(newPrice, std::memory_order_relaxed);
+    seats[seatIndex].setPrice(newPrice);
+    return true;
+}
+
 // Seat operations
 Seat* Airplane::findSeat(const std::string& seatId) {
-    for (size_t i = 0; i < seats.size(); ++i) {
-        if (seats[i].getSeatId() == seatId) {
-            return &seats[i];
-        }
-    }
-    return nullptr; // Not found
+    int index = seatIndexOf(seatId);
+    return index >= 0 ? &seats[index] : nullptr; // nullptr if not found
+}
+
+Seat* Airplane::findSeat(SeatKey key) {
+    int index = seatIndexOf(key);
+    return index >= 0 ? &seats[index] : nullptr;
 }
 
 bool Airplane::bookSpecificSeat(const std::string& seatId) {
-    Seat* seatToBook = findSeat(seatId);
-    if (seatToBook && !seatToBook->getIsBooked()) {
-        if (seatToBook->bookSeat()) {
-            bookedSeatsCount++;
-            return true;
-        }
-    }
-    return false; // Seat not found or already booked
+    return bookSeatAt(seatIndexOf(seatId));
 }
 
 bool Airplane::unbookSpecificSeat(const std::string& seatId) {
-    Seat* seatToUnbook = findSeat(seatId);
-    if (seatToUnbook && seatToUnbook->getIsBooked()) {
-        if (seatToUnbook->unbookSeat()) {
-            bookedSeatsCount--;
-            return true;
-        }
+    return unbookSeatAt(seatIndexOf(seatId));
+}
+
+bool Airplane::bookSeatAt(int seatIndex) {
+    if (seatIndex < 0 || seatIndex >= static_cast<int>(seats.size())) {
+        return false; // Seat not found
+    }
+    if (!occupiedSeats.trySet(seatIndex)) {
+        return false; // Already booked, possibly by a thread that won the race just now
+    }
+    bookedSeatsCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool Airplane::unbookSeatAt(int seatIndex) {
+    if (seatIndex < 0 || seatIndex >= static_cast<int>(seats.size())) {
+        return false; // Seat not found
     }
-    return false; // Seat not found or not booked
+    if (!occupiedSeats.tryReset(seatIndex)) {
+        return false; // Not booked
+    }
+    bookedSeatsCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
 }
 
 // Display
@@ -105,8 +210,8 @@ void Airplane::displaySeatingMap() const {
         std::cout << i << (i < 10 ? "  " : " "); // Row number
         for (int j = 0; j < seatsPerRow; ++j) {
             if (seatIndex < seats.size()) {
-                const Seat& s = seats[seatIndex++];
-                char displayChar = s.getIsBooked() ? 'X' : (s.getSeatClass() == SeatClass::BUSINESS ? 'B' : 'E');
+                int bit = static_cast<int>(seatIndex++);
+                char displayChar = occupiedSeats.test(bit) ? 'X' : (businessSeats.test(bit) ? 'B' : 'E');
                 std::cout << displayChar << " ";
             } else {
                 std::cout << "  "; // Should not happen if initialized correctly
@@ -120,12 +225,10 @@ void Airplane::displaySeatingMap() const {
 void Airplane::displayAvailableSeats() const {
     std::cout << "\n--- Available Seats for Flight " << flightNumber << " ---" << std::endl;
     bool found = false;
-    for (const auto& seat : seats) {
-        if (!seat.getIsBooked()) {
-            seat.displaySeatInfo();
-            found = true;
-        }
-    }
+    occupiedSeats.forEachClear([&](int index) {
+        seats[index].displaySeatInfo();
+        found = true;
+    });
     if (!found) {
         std::cout << "No seats available." << std::endl;
     }
@@ -146,11 +249,10 @@ void Airplane::displayAllSeatDetails() const {
 // Advanced features
 std::vector<const Seat*> Airplane::getAvailableSeatsByClass(SeatClass sc) const {
     std::vector<const Seat*> available;
-    for (const auto& seat : seats) { // Iterate over const Seat objects
-        if (!seat.getIsBooked() && seat.getSeatClass() == sc) {
-            available.push_back(&seat); // Push const Seat*
-        }
-    }
+    available.reserve(getAvailableSeatCount(sc));
+    occupiedSeats.forEachClearIn(classMask(sc), [&](int index) {
+        available.push_back(&seats[index]); // Push const Seat*
+    });
     return available;
 }
 
@@ -158,14 +260,71 @@ std::vector<const Seat*> Airplane::suggestLowerPriceSeats(const Customer* custom
     std::vector<const Seat*> suggestions;
     if (!customer) return suggestions;
 
-    for (const auto& seat : seats) { // Iterate over const Seat objects
-        if (!seat.getIsBooked() && seat.getPrice() <= maxPrice && seat.getPrice() <= customer->getMoney()) {
-            suggestions.push_back(&seat); // Push const Seat*
-        }
-    }
-    // Optionally sort suggestions by price
-    std::sort(suggestions.begin(), suggestions.end(), [](const Seat* a, const Seat* b) {
-        return a->getPrice() < b->getPrice();
+    double limit = std::min(maxPrice, customer->getMoney());
+    std::vector<int> matches;
+    forEachAvailableAtMost(limit, nullptr, [&](int index) { // Only free, affordable seats are visited
+        matches.push_back(index);
     });
+    // Sort by price using the price column rather than chasing Seat pointers
+    std::stable_sort(matches.begin(), matches.end(), [this](int a, int b) {
+        return getSeatPrice(a) < getSeatPrice(b);
+    });
+    suggestions.reserve(matches.size());
+    for (int index : matches) {
+        suggestions.push_back(&seats[index]); // Push const Seat*
+    }
     return suggestions;
 }
+
+namespace {
+
+// Bounded max-heap of (price, index): the root is the worst of the best `limit` candidates so far
+class CheapestSeats {
+private:
+    std::vector<std::pair<double, int>> heap;
+    std::size_t limit;
+
+public:
+    explicit CheapestSeats(int count) : limit(count > 0 ? static_cast<std::size_t>(count) : 0) {
+        heap.reserve(limit);
+    }
+
+    void offer(double price, int index) {
+        if (heap.size() < limit) {
+            heap.emplace_back(price, index);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (limit > 0 && std::make_pair(price, index) < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = std::make_pair(price, index);
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    std::vector<int> take() {
+        std::sort_heap(heap.begin(), heap.end()); // Ascending (price, index)
+        std::vector<int> indexes;
+        indexes.reserve(heap.size());
+        for (const auto& entry : heap) {
+            indexes.push_back(entry.second);
+        }
+        return indexes;
+    }
+};
+
+} // namespace
+
+std::vector<int> Airplane::findCheapestAvailableSeats(int count, double maxPrice) const {
+    CheapestSeats best(count);
+    if (count > 0) {
+        forEachAvailableAtMost(maxPrice, nullptr, [&](int index) { best.offer(getSeatPrice(index), index); });
+    }
+    return best.take();
+}
+
+std::vector<int> Airplane::findCheapestAvailableSeats(int count, double maxPrice, SeatClass sc) const {
+    CheapestSeats best(count);
+    if (count > 0) {
+        forEachAvailableAtMost(maxPrice, &classMask(sc), [&](int index) { best.offer(getSeatPrice(index), index); });
+    }
+    return best.take();
+}
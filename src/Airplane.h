@@ -2,7 +2,13 @@
 #define AIRPLANE_H
 
 #include "Seat.h"
+#include "SeatCodec.h"
+#include "SeatBitset.h"
+#include "AtomicSeatBitset.h"
 #include "Customer.h" // For suggesting seats based on customer money
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 #include <iostream> // For display methods
@@ -13,10 +19,48 @@ private:
     std::vector<Seat> seats;
     int totalRows;
     int seatsPerRow; // e.g. 6 for A-F
-    int bookedSeatsCount;
+    std::atomic<int> bookedSeatsCount; // Follows occupiedSeats; may briefly trail a racing claim
 
+    // Packed occupancy and class masks, indexed like seats. These answer availability
+    // queries; each Seat reads its isBooked from occupiedSeats, so there is no copy to fall out of step.
+    // Occupancy words are atomic: seats are claimed and released without a lock.
+    AtomicSeatBitset occupiedSeats;
+    SeatBitset businessSeats;
+    SeatBitset economySeats;
+
+    // Columnar seat table, indexed like seats: prices here, class and occupancy in the bitsets
+    // above. Seat IDs are derived from the index. The Seat objects mirror the prices and classes.
+    // Prices are relaxed atomics so a re-price can run while bookings read fares without a lock.
+    std::unique_ptr<std::atomic<double>[]> seatPrices;
+
+    const SeatBitset& classMask(SeatClass sc) const;
     void initializeSeats(); // Helper to create seats based on rows/seatsPerRow
 
+    // Calls fn(index) for every free seat priced at or below maxPrice (restricted to mask if given),
+    // in ascending index order. Prices are compared 64 seats at a time into a bit mask that is then
+    // combined with the occupancy word, so the inner loop is branch-free over a contiguous column.
+    template<typename Fn>
+    void forEachAvailableAtMost(double maxPrice, const SeatBitset* mask, Fn fn) const {
+        const std::atomic<double>* prices = seatPrices.get();
+        const int capacity = getCapacity();
+        for (std::size_t w = 0; w < occupiedSeats.wordCount(); ++w) {
+            const int base = static_cast<int>(w * 64);
+            const int count = capacity - base < 64 ? capacity - base : 64;
+            std::uint64_t affordable = 0;
+            for (int i = 0; i < count; ++i) {
+                affordable |= static_cast<std::uint64_t>(prices[base + i].load(std::memory_order_relaxed) <= maxPrice) << i;
+            }
+            std::uint64_t candidates = affordable & ~occupiedSeats.word(w);
+            if (mask) {
+                candidates &= mask->word(w);
+            }
+            while (candidates) {
+                fn(base + SeatBitset::countTrailingZeros(candidates));
+                candidates &= candidates - 1;
+            }
+        }
+    }
+
 public:
     // Constructor
     Airplane(const std::string& flightNum = "FL000", int rows = 10, int sPerRow = 6);
@@ -25,16 +69,42 @@ public:
     ~Airplane();
 
     // Getters
-    std::string getFlightNumber() const;
+    const std::string& getFlightNumber() const;
     int getCapacity() const;
+    int getSeatsPerRow() const;
     int getBookedSeatsCount() const;
     bool isFull() const;
     const std::vector<Seat>& getAllSeats() const; // To view all seats
 
+    // Availability queries (bitset scans)
+    bool isSeatBooked(int seatIndex) const;
+    int getAvailableSeatCount() const;
+    int getAvailableSeatCount(SeatClass sc) const;
+    int findFirstAvailableSeat() const;             // Seat index, or -1 if full
+    int findFirstAvailableSeat(SeatClass sc) const; // Seat index, or -1 if the class is full
+
+    // Seat addressing: seat IDs decode straight to a position in the row-major seat grid
+    int seatIndexOf(const std::string& seatId) const; // Returns -1 if malformed or not on this airplane
+    int seatIndexOf(SeatKey key) const;
+    SeatKey getSeatKey(int seatIndex) const; // SeatCodec::INVALID_KEY if out of range
+
+    // Columnar per-seat access; seatIndex must be in [0, getCapacity())
+    double getSeatPrice(int seatIndex) const;
+    SeatClass getSeatClass(int seatIndex) const;
+    std::string getSeatId(int seatIndex) const; // Built on demand from the index
+    // Keeps the Seat mirror in sync; rejects negative prices. Safe against concurrent fare reads
+    // (getSeatPrice, the price scans); the Seat mirror needs the flight's lock like other Seat access.
+    bool setSeatPrice(int seatIndex, double newPrice);
+
     // Seat operations
     Seat* findSeat(const std::string& seatId); // Returns pointer to seat, or nullptr if not found
+    Seat* findSeat(SeatKey key);
     bool bookSpecificSeat(const std::string& seatId); // Attempts to book a seat by ID
     bool unbookSpecificSeat(const std::string& seatId); // Attempts to unbook a seat by ID
+    // Same as bookSpecificSeat for an already decoded seat. Lock-free: the seat is claimed with one
+    // atomic read-modify-write, so of several threads racing for a free seat exactly one succeeds.
+    bool bookSeatAt(int seatIndex);
+    bool unbookSeatAt(int seatIndex); // Lock-free; only the caller that actually frees the seat gets true
 
     // Display
     void displaySeatingMap() const; // Visual representation of seats
@@ -44,6 +114,11 @@ public:
     // Advanced features
     std::vector<const Seat*> getAvailableSeatsByClass(SeatClass sc) const;
     std::vector<const Seat*> suggestLowerPriceSeats(const Customer* customer, double maxPrice) const;
+
+    // Batch query: indexes of up to `count` free seats priced at or below maxPrice, cheapest first
+    // (ties by seat index). Keeps only the best `count` candidates instead of sorting every match.
+    std::vector<int> findCheapestAvailableSeats(int count, double maxPrice) const;
+    std::vector<int> findCheapestAvailableSeats(int count, double maxPrice, SeatClass sc) const;
 };
 
 #endif // AIRPLANE_H
@@ -0,0 +1,81 @@
+#include "ApiJson.h"
+
+void writeSeatJson(JsonWriter& writer, const Seat& seat, const Booking* booking) {
+    writer.beginObject()
+          .key("seatId").value(seat.getSeatId())
+          .key("isBooked").value(seat.getIsBooked())
+          .key("price").value(seat.getPrice())
+          .key("seatClass").value(seat.getSeatClassString());
+    if (booking) {
+        char bookingId[Booking::BOOKING_ID_LENGTH];
+        Booking::formatBookingId(booking->getBookingNumber(), bookingId);
+        writer.key("bookedByCustomerId").value(booking->getCustomerId())
+              .key("bookingId").value(std::string_view(bookingId, Booking::BOOKING_ID_LENGTH));
+    }
+    writer.endObject();
+}
+
+void writeSeatMapJson(std::string& out, const Airplane& airplane, const std::vector<const Booking*>& seatBookings) {
+    JsonWriter writer(out);
+    writer.beginObject()
+          .key("flightNumber").value(airplane.getFlightNumber())
+          .key("capacity").value(airplane.getCapacity())
+          .key("bookedSeatsCount").value(airplane.getBookedSeatsCount())
+          .key("isFull").value(airplane.isFull())
+          .key("seats").beginArray();
+    const std::vector<Seat>& seats = airplane.getAllSeats();
+    for (std::size_t i = 0; i < seats.size(); ++i) {
+        writeSeatJson(writer, seats[i], i < seatBookings.size() ? seatBookings[i] : nullptr);
+    }
+    writer.endArray().endObject();
+}
+
+void writeSeatMapJson(std::string& out, const FlightSnapshot& snapshot) {
+    JsonWriter writer(out);
+    writer.beginObject()
+          .key("flightNumber").value(snapshot.getFlightNumber())
+          .key("capacity").value(snapshot.getCapacity())
+          .key("bookedSeatsCount").value(snapshot.getBookedSeatsCount())
+          .key("isFull").value(snapshot.isFull())
+          .key("seats").beginArray();
+    for (int i = 0; i < snapshot.getCapacity(); ++i) {
+        writer.beginObject()
+              .key("seatId").value(SeatCodec::toSeatId(snapshot.getSeatKey(i)))
+              .key("isBooked").value(snapshot.isSeatBooked(i))
+              .key("price").value(snapshot.getSeatPrice(i))
+              .key("seatClass").value(seatClassToString(snapshot.getSeatClass(i)));
+        const FlightSnapshot::SeatOwner& owner = snapshot.getSeatOwner(i);
+        if (owner.bookingNumber != 0) {
+            char bookingId[Booking::BOOKING_ID_LENGTH];
+            Booking::formatBookingId(owner.bookingNumber, bookingId);
+            writer.key("bookedByCustomerId").value(*owner.customerId)
+                  .key("bookingId").value(std::string_view(bookingId, Booking::BOOKING_ID_LENGTH));
+        }
+        writer.endObject();
+    }
+    writer.endArray().endObject();
+}
+
+void writeCustomerJson(JsonWriter& writer, const Customer& customer) {
+    writer.beginObject()
+          .key("personId").value(customer.getPersonId())
+          .key("name").value(customer.getName())
+          .key("age").value(customer.getAge())
+          .key("money").value(customer.getMoney())
+          .endObject();
+}
+
+void writeBookingJson(JsonWriter& writer, const Booking& booking) {
+    char bookingId[Booking::BOOKING_ID_LENGTH];
+    Booking::formatBookingId(booking.getBookingNumber(), bookingId);
+    char date[32];
+    std::size_t dateLength = Booking::formatBookingDate(booking.getBookingNumber(), date, sizeof(date)); // No string per row
+    writer.beginObject()
+          .key("bookingId").value(std::string_view(bookingId, Booking::BOOKING_ID_LENGTH))
+          .key("customerId").value(booking.getCustomerId())
+          .key("flightNumber").value(booking.getFlightNumber())
+          .key("seatId").value(booking.getSeatId())
+          .key("bookingDate").value(std::string_view(date, dateLength))
+          .key("status").value(booking.getStatusString())
+          .endObject();
+}
@@ -0,0 +1,29 @@
+#ifndef APIJSON_H
+#define APIJSON_H
+
+#include "Airplane.h"
+#include "Booking.h"
+#include "Customer.h"
+#include "FlightSnapshot.h"
+#include "JsonWriter.h"
+#include <string>
+#include <vector>
+
+// JSON bodies for the API server, written straight into a reusable buffer.
+// Field names match what the GUI reads.
+
+// One seat; bookedByCustomerId/bookingId are added when booking is non-null
+void writeSeatJson(JsonWriter& writer, const Seat& seat, const Booking* booking);
+
+// /api/airplanes/{flight}: airplane summary plus every seat. seatBookings is aligned with
+// airplane.getAllSeats() as returned by ReservationSystem::getSeatBookings.
+void writeSeatMapJson(std::string& out, const Airplane& airplane, const std::vector<const Booking*>& seatBookings);
+
+// Same body from a published snapshot, for lock-free readers
+void writeSeatMapJson(std::string& out, const FlightSnapshot& snapshot);
+
+// One element of the /api/customers and /api/bookings lists (the fields of their to_json forms)
+void writeCustomerJson(JsonWriter& writer, const Customer& customer);
+void writeBookingJson(JsonWriter& writer, const Booking& booking);
+
+#endif // APIJSON_H
@@ -0,0 +1,361 @@
+#ifndef APIROUTES_H
+#define APIROUTES_H
+
+#include "../third_party/httplib.h"
+#include "../third_party/nlohmann_json.hpp"
+#include "ReservationSystem.h"
+#include "Airplane.h"
+#include "Seat.h"
+#include "Customer.h"
+#include "Booking.h"
+#include "ApiJson.h"
+#include "FlightSnapshot.h"
+#include "CommandPipeline.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Use nlohmann::json
+using json = nlohmann::json;
+
+// --- JSON Serialization Functions ---
+inline void to_json(json& j, const Seat& s) {
+    j = json{
+        {"seatId", s.getSeatId()},
+        {"isBooked", s.getIsBooked()},
+        {"price", s.getPrice()},
+        {"seatClass", s.getSeatClassString()}
+    };
+    // bookedByCustomerId and bookingId will be added dynamically in the route handler if needed
+}
+
+inline void to_json(json& j, const Airplane& p) {
+    // This basic serialization is used by /api/airplanes (list)
+    // For /api/airplanes/{id}, we build it manually to include bookedByCustomerId & bookingId
+    j = json{
+        {"flightNumber", p.getFlightNumber()},
+        {"capacity", p.getCapacity()},
+        {"bookedSeatsCount", p.getBookedSeatsCount()},
+        {"isFull", p.isFull()}
+        // "seats" are handled by the specific route if details are needed
+    };
+}
+
+inline void to_json(json& j, const FlightSnapshot& p) {
+    // Same fields as the Airplane form, from a lock-free snapshot
+    j = json{
+        {"flightNumber", p.getFlightNumber()},
+        {"capacity", p.getCapacity()},
+        {"bookedSeatsCount", p.getBookedSeatsCount()},
+        {"isFull", p.isFull()}
+    };
+}
+
+inline void to_json(json& j, const Customer& c) {
+    j = json{
+        {"personId", c.getPersonId()},
+        {"name", c.getName()},
+        {"age", c.getAge()},
+        {"money", c.getMoney()}
+        // "bookings" are added dynamically in the route handler
+    };
+}
+
+inline void to_json(json& j, const Booking& b) {
+    j = json{
+        {"bookingId", b.getBookingId()},
+        {"customerId", b.getCustomerId()},
+        {"flightNumber", b.getFlightNumber()},
+        {"seatId", b.getSeatId()},
+        {"bookingDate", b.getBookingDateString()},
+        {"status", b.getStatusString()}
+    };
+}
+
+// Helper to set common response headers including CORS
+inline void set_common_headers(httplib::Response& res) {
+    res.set_header("Access-Control-Allow-Origin", "*");
+    res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
+}
+
+// Streams a JSON array with chunked transfer encoding. page(from, limit, writer) writes up to limit
+// elements from position `from` on and returns where to continue, or ReservationSystem::LIST_END
+// when done (see forEachCustomerFrom). Each chunk is one page, written into a buffer reused for the
+// next, so memory stays at about a page whatever the length of the list, and no lock is held while
+// a chunk waits on the client. Both backends call the provider on a worker thread, never on
+// EpollHttpServer's event loop, so a page waiting for the list's locks stalls only its own connection.
+template<typename Page>
+void streamJsonArray(httplib::Response& res, Page page) {
+    constexpr std::size_t ROWS_PER_CHUNK = 256;
+    struct Stream {
+        std::string buffer;
+        JsonWriter writer{buffer};
+        std::uint32_t next = 0;
+    };
+    auto stream = std::make_shared<Stream>();
+    stream->writer.beginArray();
+    res.set_chunked_content_provider("application/json", [stream, page](std::size_t, httplib::DataSink& sink) {
+        stream->next = page(stream->next, ROWS_PER_CHUNK, stream->writer);
+        bool done = stream->next == ReservationSystem::LIST_END;
+        if (done) stream->writer.endArray();
+        if (!stream->buffer.empty() && !sink.write(stream->buffer.data(), stream->buffer.size())) return false;
+        stream->buffer.clear();
+        if (done) sink.done();
+        return true;
+    });
+}
+
+// Registers every /api route on svr. Server is httplib::Server or EpollHttpServer: anything with
+// httplib-style Get/Post/Delete/Options(pattern, handler(const httplib::Request&, httplib::Response&)).
+// execute(Command) -> CommandResult applies the mutations (add customer, book, cancel, swap); reads
+// and holds always run on the handler thread. The handlers keep references to airlineSystem and
+// execute, which must outlive svr.
+template<typename Server, typename Execute>
+void registerApiRoutes(Server& svr, ReservationSystem& airlineSystem, const Execute& execute) {
+    svr.Get("/api/airplanes", [&](const httplib::Request& req, httplib::Response& res) {
+        (void)req; 
+        set_common_headers(res);
+        json airplane_list_json = json::array();
+        // Read from the published snapshots: no locks, never waits for a booking
+        airlineSystem.forEachFlightSnapshot([&](const FlightSnapshot& plane) {
+            json plane_json_item;
+            to_json(plane_json_item, plane); // Basic airplane info
+            airplane_list_json.push_back(plane_json_item);
+        });
+        res.set_content(airplane_list_json.dump(4), "application/json");
+    });
+
+    svr.Get(R"(/api/airplanes/(\w+))", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        std::string flightNumber = req.matches[1];
+        // Serialized from the flight's current snapshot without taking any lock, so polling
+        // seat maps never stalls bookings. The body is written without a JSON DOM.
+        std::string body;
+        bool found = airlineSystem.readFlightSnapshot(flightNumber, [&body](const FlightSnapshot& snapshot) {
+            body.reserve(128 + 96 * snapshot.getCapacity());
+            writeSeatMapJson(body, snapshot);
+        });
+        if (found) {
+            res.set_content(std::move(body), "application/json");
+        } else {
+            res.status = 404;
+            res.set_content(json{{"error", "Airplane not found"}}.dump(4), "application/json");
+        }
+    });
+    
+    svr.Get("/api/customers", [&](const httplib::Request& req, httplib::Response& res) {
+        (void)req; 
+        set_common_headers(res);
+        streamJsonArray(res, [&airlineSystem](std::uint32_t from, std::size_t limit, JsonWriter& writer) {
+            return airlineSystem.forEachCustomerFrom(from, limit, [&writer](const Customer& customer) {
+                writeCustomerJson(writer, customer);
+            });
+        });
+    });
+
+    svr.Get(R"(/api/customers/(\w+))", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        std::string customerId = req.matches[1];
+        json customer_json;
+        // Only this customer's bookings are visited, not every booking in the system
+        bool found = airlineSystem.visitCustomer(customerId,
+            [&customer_json](const Customer& customer, const std::vector<const Booking*>& bookings) {
+                to_json(customer_json, customer);
+                json bookings_json_for_customer = json::array();
+                for (const Booking* booking : bookings) {
+                    bookings_json_for_customer.push_back(*booking);
+                }
+                customer_json["bookings"] = bookings_json_for_customer;
+            });
+
+        if (found) {
+            res.set_content(customer_json.dump(4), "application/json");
+        } else {
+            res.status = 404;
+            res.set_content(json{{"error", "Customer not found"}}.dump(4), "application/json");
+        }
+    });
+
+    svr.Get("/api/bookings", [&](const httplib::Request& req, httplib::Response& res) {
+        (void)req; 
+        set_common_headers(res);
+        streamJsonArray(res, [&airlineSystem](std::uint32_t from, std::size_t limit, JsonWriter& writer) {
+            return airlineSystem.forEachBookingFrom(from, limit, [&writer](const Booking& booking) {
+                writeBookingJson(writer, booking);
+            });
+        });
+    });
+
+    svr.Post("/api/customers", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        try {
+            json j = json::parse(req.body);
+            Command command;
+            command.type = Command::Type::ADD_CUSTOMER;
+            command.name = j.value("name", "DefaultName"); 
+            command.age = j.value("age", 0);
+            command.money = j.value("money", 0.0);
+            command.autoGenerate = j.value("autoGenerate", false);
+            
+            Customer* new_customer = execute(std::move(command)).customer;
+            if (new_customer) {
+                json customer_json;
+                airlineSystem.visitCustomer(new_customer->getPersonId(), [&customer_json](const Customer& customer, const std::vector<const Booking*>&) {
+                    customer_json = customer; // Read under the customer's lock; bookings may already be racing in
+                });
+                res.status = 201; 
+                res.set_content(customer_json.dump(4), "application/json");
+            } else {
+                res.status = 500; 
+                res.set_content(json{{"error", "Failed to add customer internally"}}.dump(4), "application/json");
+            }
+        } catch (const std::exception& e) { 
+            res.status = 400; 
+            res.set_content(json{{"error", "Error processing customer data: " + std::string(e.what())}}.dump(4), "application/json");
+        }
+    });
+
+    svr.Post("/api/bookings", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        try {
+            json j = json::parse(req.body);
+            Command command;
+            command.type = Command::Type::BOOK;
+            command.customerId = j.at("customerId").get<std::string>();
+            command.flightNumber = j.at("flightNumber").get<std::string>();
+            command.seatId = j.at("seatId").get<std::string>();
+
+            CommandResult result = execute(std::move(command));
+            Booking* new_booking = result.booking;
+            const std::string& error_message = result.message;
+            
+            if (new_booking) {
+                json booking_json = *new_booking; 
+                res.status = 201; 
+                res.set_content(booking_json.dump(4), "application/json");
+            } else {
+                if (error_message.find("not found") != std::string::npos) res.status = 404; 
+                else if (error_message.find("already booked") != std::string::npos) res.status = 409; 
+                else if (error_message.find("Insufficient funds") != std::string::npos) res.status = 402; 
+                else res.status = 400; 
+                res.set_content(json{{"error", error_message}}.dump(4), "application/json");
+            }
+        } catch (const std::exception& e) {
+            res.status = 400; 
+            res.set_content(json{{"error", "Error processing booking data: " + std::string(e.what())}}.dump(4), "application/json");
+        }
+    });
+
+    svr.Delete(R"(/api/bookings/([A-Za-z0-9\-]+))", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        Command command;
+        command.type = Command::Type::CANCEL;
+        command.bookingId = req.matches[1];
+        CommandResult result = execute(std::move(command));
+        const std::string& error_message = result.message;
+        if (result.success) {
+            res.set_content(json{{"message", error_message}}.dump(4), "application/json");
+        } else {
+            if (error_message.find("not found") != std::string::npos) res.status = 404;
+            else if (error_message.find("already cancelled") != std::string::npos) res.status = 409;
+            else res.status = 500; 
+            res.set_content(json{{"error", error_message}}.dump(4), "application/json");
+        }
+    });
+
+    svr.Post("/api/bookings/swap", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        try {
+            json j = json::parse(req.body);
+            Command command;
+            command.type = Command::Type::SWAP;
+            command.bookingId = j.at("bookingId1").get<std::string>();
+            command.bookingId2 = j.at("bookingId2").get<std::string>();
+            CommandResult result = execute(std::move(command));
+            const std::string& error_message = result.message;
+            if (result.success) {
+                res.set_content(json{{"message", error_message}}.dump(4), "application/json");
+            } else {
+                 if (error_message.find("not found") != std::string::npos || error_message.find("not confirmed") != std::string::npos) res.status = 404;
+                 else if (error_message.find("Cannot swap a booking with itself") != std::string::npos) res.status = 400;
+                 else if (error_message.find("Insufficient funds") != std::string::npos) res.status = 402;
+                 else res.status = 500; 
+                res.set_content(json{{"error", error_message}}.dump(4), "application/json");
+            }
+        } catch (const std::exception& e) {
+            res.status = 400; 
+            res.set_content(json{{"error", "Error processing seat swap request: " + std::string(e.what())}}.dump(4), "application/json");
+        }
+    });
+    
+    // --- Checkout holds: a PENDING booking that frees its seat unless confirmed in time ---
+
+    svr.Post("/api/holds", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        try {
+            json j = json::parse(req.body);
+            std::string customerId = j.at("customerId").get<std::string>();
+            std::string flightNumber = j.at("flightNumber").get<std::string>();
+            std::string seatId = j.at("seatId").get<std::string>();
+            int holdSeconds = j.value("holdSeconds", 600);
+            std::string error_message;
+
+            Booking* hold = airlineSystem.holdSeatInternal(customerId, flightNumber, seatId, std::chrono::seconds(holdSeconds), error_message);
+            if (hold) {
+                json hold_json = *hold;
+                hold_json["holdSeconds"] = holdSeconds;
+                res.status = 201;
+                res.set_content(hold_json.dump(4), "application/json");
+            } else {
+                if (error_message.find("not found") != std::string::npos) res.status = 404;
+                else if (error_message.find("already booked") != std::string::npos) res.status = 409;
+                else if (error_message.find("Insufficient funds") != std::string::npos) res.status = 402;
+                else res.status = 400;
+                res.set_content(json{{"error", error_message}}.dump(4), "application/json");
+            }
+        } catch (const std::exception& e) {
+            res.status = 400;
+            res.set_content(json{{"error", "Error processing hold data: " + std::string(e.what())}}.dump(4), "application/json");
+        }
+    });
+
+    svr.Post(R"(/api/holds/([A-Za-z0-9\-]+)/confirm)", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        std::string bookingId = req.matches[1];
+        std::string error_message;
+        if (airlineSystem.confirmHoldInternal(bookingId, error_message)) {
+            res.set_content(json{{"message", error_message}}.dump(4), "application/json");
+        } else {
+            if (error_message.find("not found") != std::string::npos) res.status = 404;
+            else if (error_message.find("not an active hold") != std::string::npos) res.status = 409; // Expired, released or already confirmed
+            else if (error_message.find("Insufficient funds") != std::string::npos) res.status = 402;
+            else res.status = 500;
+            res.set_content(json{{"error", error_message}}.dump(4), "application/json");
+        }
+    });
+
+    svr.Delete(R"(/api/holds/([A-Za-z0-9\-]+))", [&](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        std::string bookingId = req.matches[1];
+        std::string error_message;
+        if (airlineSystem.releaseHoldInternal(bookingId, error_message)) {
+            res.set_content(json{{"message", error_message}}.dump(4), "application/json");
+        } else {
+            if (error_message.find("not found") != std::string::npos) res.status = 404;
+            else if (error_message.find("not an active hold") != std::string::npos) res.status = 409;
+            else res.status = 500;
+            res.set_content(json{{"error", error_message}}.dump(4), "application/json");
+        }
+    });
+    
+    svr.Options(R"((.*))", [](const httplib::Request& req, httplib::Response& res) {
+        (void)req; 
+        set_common_headers(res); 
+        res.status = 204;
+    });
+}
+
+#endif // APIROUTES_H
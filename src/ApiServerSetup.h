@@ -0,0 +1,126 @@
+#ifndef APISERVERSETUP_H
+#define APISERVERSETUP_H
+
+#include "ApiRoutes.h"
+#include "AdaptiveTaskQueue.h"
+#include "BulkImporter.h"
+#include "ServerConfig.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Startup and admin routes shared by airline_api_server (httplib) and airline_api_server_epoll, so
+// both binaries take the same ServerConfig and serve the same endpoints.
+
+// Loads snapshot_path if it exists, opens (and replays) wal_path and starts the checkpoints, as
+// config asks; progress goes to std::cout. false with errorMessage set if the state cannot be restored.
+inline bool restoreAndPersist(ReservationSystem& airlineSystem, const ServerConfig& config, std::string& errorMessage) {
+    if (!config.snapshotPath.empty() && std::ifstream(config.snapshotPath)) {
+        std::string snapshotMessage;
+        if (!airlineSystem.loadSnapshot(config.snapshotPath, snapshotMessage)) {
+            errorMessage = "Cannot restore: " + snapshotMessage;
+            return false;
+        }
+        std::cout << snapshotMessage << std::endl;
+    }
+    if (!config.walPath.empty()) {
+        std::string walMessage;
+        if (!airlineSystem.openWriteAheadLog(config.walPath, config.wal, walMessage)) {
+            errorMessage = "Cannot recover: " + walMessage;
+            return false;
+        }
+        std::cout << walMessage << std::endl;
+    }
+    if (config.checkpointIntervalSec > 0) {
+        airlineSystem.startCheckpoints(config.snapshotPath, std::chrono::seconds(config.checkpointIntervalSec),
+                                       [](bool saved, const std::string& message) {
+                                           (saved ? std::cout : std::cerr) << (saved ? "Checkpoint: " : "Checkpoint failed: ") << message << std::endl;
+                                       });
+    }
+    return true;
+}
+
+// Runs svr's handlers on an AdaptiveTaskQueue sized by config.pool; taskQueue is set once the server
+// creates it (svr owns it). Shed requests get a 503 before any routing or locking.
+template<typename Server>
+void useAdaptiveTaskQueue(Server& svr, const ServerConfig& config, AdaptiveTaskQueue*& taskQueue) {
+    svr.new_task_queue = [&config, &taskQueue]() {
+        taskQueue = new AdaptiveTaskQueue(config.pool);
+        return taskQueue;
+    };
+    svr.set_pre_routing_handler([](const httplib::Request&, httplib::Response& res) {
+        if (!AdaptiveTaskQueue::isShedding()) return httplib::Server::HandlerResponse::Unhandled;
+        set_common_headers(res);
+        AdaptiveTaskQueue::writeShedResponse(res);
+        return httplib::Server::HandlerResponse::Handled;
+    });
+}
+
+// GET /api/server/stats, POST /api/admin/snapshot and POST /api/admin/import. taskQueue is the one
+// useAdaptiveTaskQueue sets; config and taskQueue must outlive svr.
+template<typename Server>
+void registerAdminRoutes(Server& svr, ReservationSystem& airlineSystem, const ServerConfig& config, AdaptiveTaskQueue* const& taskQueue) {
+    svr.Get("/api/server/stats", [&config, &taskQueue](const httplib::Request&, httplib::Response& res) {
+        set_common_headers(res);
+        AdaptiveTaskQueue::Stats stats = taskQueue->getStats(); // Serving requests implies the server created it
+        json j = {
+            {"queueDepth", stats.queueDepth}, {"shedQueueDepth", stats.shedQueueDepth},
+            {"workers", stats.workers}, {"busyWorkers", stats.busyWorkers},
+            {"minWorkers", config.pool.minWorkers}, {"maxWorkers", config.pool.maxWorkers},
+            {"maxQueued", config.pool.maxQueued},
+            {"accepted", stats.accepted}, {"shed", stats.shed}, {"dropped", stats.dropped},
+            {"waitP50Ms", stats.waitP50Ms}, {"waitP99Ms", stats.waitP99Ms}, {"waitMaxMs", stats.waitMaxMs},
+            {"oldestWaitMs", stats.oldestWaitMs}
+        };
+        res.set_content(j.dump(), "application/json");
+    });
+
+    // Writes the whole state to snapshot_path; bookings keep going while it is written out
+    svr.Post("/api/admin/snapshot", [&airlineSystem, &config](const httplib::Request&, httplib::Response& res) {
+        set_common_headers(res);
+        if (config.snapshotPath.empty()) {
+            res.status = 404;
+            res.set_content(json{{"error", "No snapshot_path is configured."}}.dump(4), "application/json");
+            return;
+        }
+        std::string message;
+        if (airlineSystem.saveSnapshot(config.snapshotPath, message)) {
+            res.set_content(json{{"message", message}}.dump(4), "application/json");
+        } else {
+            res.status = 500;
+            res.set_content(json{{"error", message}}.dump(4), "application/json");
+        }
+    });
+
+    // Loads the body (CSV or JSON Lines) with BulkImporter: ?kind=airplanes|customers|bookings&format=csv|jsonl.
+    // Applied directly, like the snapshot, in either mode; refused rows are reported by line.
+    svr.Post("/api/admin/import", [&airlineSystem](const httplib::Request& req, httplib::Response& res) {
+        set_common_headers(res);
+        BulkImporter::Kind kind = BulkImporter::Kind::AIRPLANES;
+        BulkImporter::Format format = BulkImporter::Format::CSV;
+        if (!BulkImporter::parseKind(req.get_param_value("kind"), kind) ||
+            (req.has_param("format") && !BulkImporter::parseFormat(req.get_param_value("format"), format))) {
+            res.status = 400;
+            res.set_content(json{{"error", "kind must be airplanes, customers or bookings and format csv or jsonl."}}.dump(4),
+                            "application/json");
+            return;
+        }
+        std::istringstream body(req.body);
+        BulkImporter importer(airlineSystem);
+        BulkImporter::Report report;
+        std::string message;
+        bool imported = importer.importStream(body, kind, format, report, message);
+        json errors = json::array();
+        for (const BulkImporter::RowError& error : report.errors) {
+            errors.push_back({{"line", error.line}, {"error", error.message}});
+        }
+        json j = {{imported ? "message" : "error", message}, {"rows", report.rows}, {"imported", report.imported},
+                  {"failed", report.failed}, {"rowsPerSecond", report.rowsPerSecond()}, {"errors", errors}};
+        if (!imported) res.status = 400;
+        res.set_content(j.dump(4), "application/json");
+    });
+}
+
+#endif // APISERVERSETUP_H
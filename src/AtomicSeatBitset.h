@@ -0,0 +1,68 @@
+#ifndef ATOMICSEATBITSET_H
+#define ATOMICSEATBITSET_H
+
+#include "SeatBitset.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Occupancy bitset whose 64-bit words are atomics, so seats can be claimed and released from
+// several threads without a lock. trySet/tryReset are a single atomic read-modify-write on the
+// seat's word: exactly one of any number of racing trySet calls on a free seat returns true.
+// Scans load each word once; a scan that races with claims sees every word at some point
+// between its start and end, not one frozen instant of the whole flight.
+class AtomicSeatBitset {
+private:
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words;
+    std::size_t wordTotal;
+    int bitCount;
+
+    std::uint64_t validMask(std::size_t wordIndex) const; // Masks off bits past bitCount in the last word
+
+public:
+    explicit AtomicSeatBitset(int size = 0);
+
+    AtomicSeatBitset(const AtomicSeatBitset&) = delete;
+    AtomicSeatBitset& operator=(const AtomicSeatBitset&) = delete;
+
+    void resize(int size); // Clears all bits; not safe while other threads use the set
+    int size() const;
+
+    bool test(int index) const;
+    bool trySet(int index);   // True if this call changed the bit from clear to set
+    bool tryReset(int index); // True if this call changed the bit from set to clear
+
+    int count() const;
+    int countAndNot(const SeatBitset& mask) const;      // |mask & ~this|
+    int findFirstClear() const;                         // -1 if every bit is set
+    int findFirstClearIn(const SeatBitset& mask) const; // First bit set in mask but clear here, or -1
+
+    std::size_t wordCount() const { return wordTotal; }
+    std::uint64_t word(std::size_t wordIndex) const { return words[wordIndex].load(std::memory_order_acquire); }
+
+    // Calls fn(index) for every clear bit (restricted to mask if given), in ascending order
+    template<typename Fn>
+    void forEachClear(Fn fn) const {
+        for (std::size_t w = 0; w < wordTotal; ++w) {
+            std::uint64_t free = ~word(w) & validMask(w);
+            while (free) {
+                fn(static_cast<int>(w * 64 + SeatBitset::countTrailingZeros(free)));
+                free &= free - 1;
+            }
+        }
+    }
+
+    template<typename Fn>
+    void forEachClearIn(const SeatBitset& mask, Fn fn) const {
+        for (std::size_t w = 0; w < wordTotal; ++w) {
+            std::uint64_t free = mask.word(w) & ~word(w) & validMask(w);
+            while (free) {
+                fn(static_cast<int>(w * 64 + SeatBitset::countTrailingZeros(free)));
+                free &= free - 1;
+            }
+        }
+    }
+};
+
+#endif // ATOMICSEATBITSET_H
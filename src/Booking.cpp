@@ -1,8 +1,6 @@
 #include "Booking.h"
-#include <random> // For more unique ID generation (optional)
-#include <sstream> // For ID generation and date formatting
-#include <iomanip> // For date formatting (std::put_time)
-#include <ctime>   // For std::time_t, std::localtime
+#include "BookingIdGenerator.h"
+#include <ctime>   // For std::time_t, localtime_r, std::strftime
 
 // Helper to convert BookingStatus to string
 std::string bookingStatusToString(BookingStatus status) {
@@ -14,89 +12,164 @@ std::string bookingStatusToString(BookingStatus status) {
     }
 }
 
-// Helper to generate a somewhat unique booking ID
-// A more robust system would use a global counter or UUIDs
-std::string Booking::generateBookingId() {
-    // Simple ID: BK + timestamp (seconds since epoch) + random number
-    auto now = std::chrono::system_clock::now();
-    auto epoch = now.time_since_epoch();
-    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(epoch).count();
+namespace {
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(100, 999);
-    int randomNumber = distrib(gen);
+const char BASE32_DIGITS[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ"; // Crockford: ascending in ASCII
+constexpr int BASE32_LENGTH = Booking::BOOKING_ID_LENGTH - 2;  // 13 digits cover 65 bits
 
-    std::ostringstream oss;
-    oss << "BK" << seconds << "-" << randomNumber;
-    return oss.str();
+int base32Value(char c) {
+    for (int v = 0; v < 32; ++v) {
+        if (BASE32_DIGITS[v] == c) return v;
+    }
+    return -1;
+}
+
+} // namespace
+
+void Booking::formatBookingId(std::uint64_t bookingNumber, char* out) {
+    out[0] = 'B';
+    out[1] = 'K';
+    for (int i = BOOKING_ID_LENGTH - 1; i >= 2; --i) {
+        out[i] = BASE32_DIGITS[bookingNumber & 31];
+        bookingNumber >>= 5;
+    }
+}
+
+std::string Booking::formatBookingId(std::uint64_t bookingNumber) {
+    char buffer[BOOKING_ID_LENGTH];
+    formatBookingId(bookingNumber, buffer);
+    return std::string(buffer, BOOKING_ID_LENGTH);
+}
+
+bool Booking::parseBookingId(const std::string& bookingId, std::uint64_t& bookingNumber) {
+    if (bookingId.size() != static_cast<std::size_t>(BOOKING_ID_LENGTH) || bookingId[0] != 'B' || bookingId[1] != 'K') {
+        return false;
+    }
+    std::uint64_t value = 0;
+    for (int i = 2; i < BOOKING_ID_LENGTH; ++i) {
+        int digit = base32Value(bookingId[i]);
+        if (digit < 0 || (i == 2 && digit > 15)) { // Leading digit holds bits 64..60; bit 64 must be clear
+            return false;
+        }
+        value = (value << 5) | static_cast<std::uint64_t>(digit);
+    }
+    bookingNumber = value;
+    return true;
 }
 
-// Constructor
+// Constructors
 Booking::Booking(const std::string& custId, const std::string& flightNum, const std::string& seatNum)
-    : customerId(custId), flightNumber(flightNum), seatId(seatNum), 
-      bookingDate(std::chrono::system_clock::now()), status(BookingStatus::PENDING) {
-    this->bookingId = generateBookingId();
-    // std::cout << "Booking constructor called. ID: " << this->bookingId << std::endl; // Optional
+    : Booking(customerIdInterner().intern(custId), flightNumberInterner().intern(flightNum), SeatCodec::INVALID_KEY) {
+    setSeatId(seatNum);
+}
+
+Booking::Booking(InternedId customerRef, InternedId flightRef, SeatKey seatKey)
+    : Booking(BookingIdGenerator::global().next(), customerRef, flightRef, seatKey) {}
+
+Booking::Booking(std::uint64_t bookingNumber, InternedId customerRef, InternedId flightRef, SeatKey seatKey)
+    : bookingNumber(bookingNumber), paidCents(0),
+      customerRef(customerRef), flightRef(flightRef), seatRef(seatKey),
+      status(BookingStatus::PENDING), seatInterned(false) {
+    // std::cout << "Booking constructor called. ID: " << getBookingId() << std::endl; // Optional
+}
+
+Booking::Booking(const Booking& other)
+    : bookingNumber(other.bookingNumber), paidCents(other.paidCents.load(std::memory_order_relaxed)),
+      customerRef(other.customerRef), flightRef(other.flightRef.load(std::memory_order_relaxed)),
+      seatRef(other.seatRef.load(std::memory_order_relaxed)),
+      status(other.status.load(std::memory_order_relaxed)),
+      seatInterned(other.seatInterned.load(std::memory_order_relaxed)) {}
+
+Booking& Booking::operator=(const Booking& other) {
+    bookingNumber = other.bookingNumber;
+    paidCents.store(other.paidCents.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    customerRef = other.customerRef;
+    flightRef.store(other.flightRef.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    seatRef.store(other.seatRef.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    status.store(other.status.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    seatInterned.store(other.seatInterned.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
 }
 
 // Destructor
 Booking::~Booking() {
-    // std::cout << "Booking destructor called for ID: " << this->bookingId << std::endl; // Optional
+    // std::cout << "Booking destructor called for ID: " << getBookingId() << std::endl; // Optional
 }
 
 // Getters
 std::string Booking::getBookingId() const {
-    return bookingId;
+    return formatBookingId(bookingNumber);
 }
 
-std::string Booking::getCustomerId() const {
-    return customerId;
+const std::string& Booking::getCustomerId() const {
+    return customerIdInterner().lookup(customerRef);
 }
 
-std::string Booking::getFlightNumber() const {
-    return flightNumber;
+const std::string& Booking::getFlightNumber() const {
+    return flightNumberInterner().lookup(flightRef.load(std::memory_order_relaxed));
 }
 
 std::string Booking::getSeatId() const {
-    return seatId;
+    std::uint32_t ref = seatRef.load(std::memory_order_relaxed);
+    return seatInterned.load(std::memory_order_relaxed) ? seatLabelInterner().lookup(ref) : SeatCodec::toSeatId(ref);
 }
 
 std::string Booking::getBookingDateString() const {
-    std::time_t time = std::chrono::system_clock::to_time_t(bookingDate);
-    // Convert to tm struct for formatting
-    // Note: std::localtime is not thread-safe. For multithreaded apps, use localtime_s (Windows) or localtime_r (POSIX).
-    // For a simple console app, std::localtime is generally fine.
-    std::tm bt = *std::localtime(&time); 
-    std::ostringstream oss;
-    oss << std::put_time(&bt, "%Y-%m-%d %H:%M:%S"); // Format: YYYY-MM-DD HH:MM:SS
-    return oss.str();
+    char date[32];
+    return std::string(date, formatBookingDate(bookingNumber, date, sizeof(date)));
+}
+
+std::size_t Booking::formatBookingDate(std::uint64_t bookingNumber, char* out, std::size_t size) {
+    std::time_t time = static_cast<std::time_t>(BookingIdGenerator::timestampMillis(bookingNumber) / 1000);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local); // std::localtime shares one buffer between threads
+#endif
+    return std::strftime(out, size, "%Y-%m-%d %H:%M:%S", &local);
 }
 
 BookingStatus Booking::getStatus() const {
-    return status;
+    return status.load(std::memory_order_relaxed);
 }
 
 std::string Booking::getStatusString() const {
-    return bookingStatusToString(this->status);
+    return bookingStatusToString(getStatus());
 }
 
 // Setters
 void Booking::setStatus(BookingStatus newStatus) {
-    this->status = newStatus;
+    this->status.store(newStatus, std::memory_order_relaxed);
 }
 
 void Booking::setSeatId(const std::string& newSeatId) {
-    this->seatId = newSeatId;
+    SeatKey key = SeatCodec::parseKey(newSeatId);
+    bool interned = (key == SeatCodec::INVALID_KEY);
+    seatRef.store(interned ? seatLabelInterner().intern(newSeatId) : key, std::memory_order_relaxed);
+    seatInterned.store(interned, std::memory_order_relaxed);
+}
+
+void Booking::setFlightRef(InternedId newFlightRef) {
+    flightRef.store(newFlightRef, std::memory_order_relaxed);
+}
+
+void Booking::setSeatKey(SeatKey newSeatKey) {
+    seatRef.store(newSeatKey, std::memory_order_relaxed);
+    seatInterned.store(false, std::memory_order_relaxed);
+}
+
+void Booking::setPaidCents(Cents cents) {
+    paidCents.store(cents, std::memory_order_relaxed);
 }
 
 // Display
 void Booking::displayBookingDetails() const {
     std::cout << "Booking Details:" << std::endl;
-    std::cout << "  Booking ID: " << bookingId << std::endl;
-    std::cout << "  Customer ID: " << customerId << std::endl;
-    std::cout << "  Flight Number: " << flightNumber << std::endl;
-    std::cout << "  Seat ID: " << seatId << std::endl;
+    std::cout << "  Booking ID: " << getBookingId() << std::endl;
+    std::cout << "  Customer ID: " << getCustomerId() << std::endl;
+    std::cout << "  Flight Number: " << getFlightNumber() << std::endl;
+    std::cout << "  Seat ID: " << getSeatId() << std::endl;
     std::cout << "  Booking Date: " << getBookingDateString() << std::endl;
     std::cout << "  Status: " << getStatusString() << std::endl;
 }
@@ -2,50 +2,87 @@
 #define BOOKING_H
 
 #include <string>
+#include <atomic>
+#include <cstdint>
 #include <iostream> // For display
 #include <chrono>   // For bookingDate (optional, could use string)
 #include <sstream>  // For formatting date
 #include <iomanip>  // For formatting date
+#include "Money.h"
+#include "SeatCodec.h"
+#include "StringInterner.h"
 
-enum class BookingStatus {
+enum class BookingStatus : std::uint8_t {
     CONFIRMED,
     CANCELLED,
     PENDING
 };
 
+// Bookings hold compact references instead of strings: the booking ID is kept as a number,
+// customer and flight IDs are interned, and the seat is a SeatKey. Strings are only built
+// when a getter is called at the console/API boundary.
+// Only the status, flight, seat and paid amount change after construction; they are atomics so a booking
+// can be read from any thread while ReservationSystem updates it under the flight's lock (both flights'
+// locks when a swap moves it to another flight).
 class Booking {
 private:
-    std::string bookingId;
-    std::string customerId; // Link to Customer
-    std::string flightNumber; // Link to Airplane
-    std::string seatId;     // Link to Seat
-    std::chrono::system_clock::time_point bookingDate; // Or std::string for simplicity
-    BookingStatus status;
-
-    std::string generateBookingId(); // Helper to create a unique ID
+    std::uint64_t bookingNumber; // From BookingIdGenerator; rendered by getBookingId() and carries the booking date
+    std::atomic<Cents> paidCents;     // What the customer was charged; refunded on cancellation
+    InternedId customerRef;  // Link to Customer (customerIdInterner)
+    std::atomic<InternedId> flightRef;   // Link to Airplane (flightNumberInterner); cross-flight swaps change it
+    std::atomic<std::uint32_t> seatRef;  // Link to Seat: SeatKey, or a seatLabelInterner id if seatInterned
+    std::atomic<BookingStatus> status;
+    std::atomic<bool> seatInterned;      // Seat label could not be encoded by SeatCodec
 
 public:
-    // Constructor
+    // Constructors
     Booking(const std::string& custId, const std::string& flightNum, const std::string& seatNum);
+    Booking(InternedId customerRef, InternedId flightRef, SeatKey seatKey);
+    Booking(std::uint64_t bookingNumber, InternedId customerRef, InternedId flightRef, SeatKey seatKey); // Restoring a logged booking
+
+    Booking(const Booking& other);
+    Booking& operator=(const Booking& other);
 
     // Destructor
     ~Booking();
 
     // Getters
     std::string getBookingId() const;
-    std::string getCustomerId() const;
-    std::string getFlightNumber() const;
+    const std::string& getCustomerId() const;
+    const std::string& getFlightNumber() const;
     std::string getSeatId() const;
-    std::string getBookingDateString() const; // Returns formatted date string
+    std::string getBookingDateString() const; // Returns formatted date string (from the booking number's timestamp)
     BookingStatus getStatus() const;
     std::string getStatusString() const;
 
+    // Compact accessors for internal lookups and comparisons
+    std::uint64_t getBookingNumber() const { return bookingNumber; }
+    InternedId getCustomerRef() const { return customerRef; }
+    InternedId getFlightRef() const { return flightRef.load(std::memory_order_relaxed); }
+    Cents getPaidCents() const { return paidCents.load(std::memory_order_relaxed); }
+    SeatKey getSeatKey() const {
+        return seatInterned.load(std::memory_order_relaxed) ? SeatCodec::INVALID_KEY : seatRef.load(std::memory_order_relaxed);
+    }
+
     // Setters
     void setStatus(BookingStatus newStatus);
     void setSeatId(const std::string& newSeatId); // Added for seat swap
+    void setFlightRef(InternedId newFlightRef);
+    void setSeatKey(SeatKey newSeatKey);
+    void setPaidCents(Cents cents);
 
     // Display
     void displayBookingDetails() const;
+
+    // Conversion between the numeric and printed forms of a booking ID: "BK" followed by the
+    // number as 13 fixed-width Crockford base32 digits, so IDs sort like their numbers and fit
+    // in std::string's small buffer (no heap allocation).
+    static constexpr int BOOKING_ID_LENGTH = 15;
+    static void formatBookingId(std::uint64_t bookingNumber, char* out); // Writes BOOKING_ID_LENGTH chars, no terminator
+    static std::string formatBookingId(std::uint64_t bookingNumber);
+    static bool parseBookingId(const std::string& bookingId, std::uint64_t& bookingNumber);
+    // The booking number's timestamp as local "YYYY-MM-DD HH:MM:SS", thread-safe; returns the length written
+    static std::size_t formatBookingDate(std::uint64_t bookingNumber, char* out, std::size_t size);
 };
 
 #endif // BOOKING_H
@@ -0,0 +1,29 @@
+#include "BookingIdGenerator.h"
+#include <chrono>
+
+std::uint64_t BookingIdGenerator::next() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return nextAt(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count()));
+}
+
+std::uint64_t BookingIdGenerator::nextAt(std::uint64_t unixMillis) {
+    std::uint64_t sinceEpoch = unixMillis > EPOCH_MILLIS ? unixMillis - EPOCH_MILLIS : 0;
+    std::uint64_t floor = sinceEpoch << SEQUENCE_BITS; // First number of this millisecond
+    std::uint64_t previous = last.load(std::memory_order_relaxed);
+    std::uint64_t candidate;
+    do {
+        candidate = previous + 1 > floor ? previous + 1 : floor;
+    } while (!last.compare_exchange_weak(previous, candidate, std::memory_order_relaxed));
+    return candidate;
+}
+
+void BookingIdGenerator::advancePast(std::uint64_t bookingNumber) {
+    std::uint64_t previous = last.load(std::memory_order_relaxed);
+    while (previous < bookingNumber && !last.compare_exchange_weak(previous, bookingNumber, std::memory_order_relaxed)) {
+    }
+}
+
+BookingIdGenerator& BookingIdGenerator::global() {
+    static BookingIdGenerator generator;
+    return generator;
+}
@@ -0,0 +1,40 @@
+#ifndef BOOKINGIDGENERATOR_H
+#define BOOKINGIDGENERATOR_H
+
+#include <atomic>
+#include <cstdint>
+
+// Snowflake-style 64-bit booking numbers:
+//   bit 63      always 0
+//   bits 62..22 milliseconds since EPOCH_MILLIS (41 bits, ~69 years)
+//   bits 21..0  sequence within that millisecond (4M per ms)
+// Every number is strictly greater than the one before it across all threads, so numbers are
+// unique and sort by creation time. Generating one is a clock read and a CAS; no locks, no
+// allocation. If the sequence runs out (or the clock steps back) the generator keeps counting
+// past the current millisecond instead of reusing numbers.
+class BookingIdGenerator {
+public:
+    static constexpr std::uint64_t EPOCH_MILLIS = 1704067200000ULL; // 2024-01-01T00:00:00Z
+    static constexpr int SEQUENCE_BITS = 22;
+    static constexpr std::uint64_t SEQUENCE_MASK = (1ULL << SEQUENCE_BITS) - 1;
+
+private:
+    std::atomic<std::uint64_t> last;
+
+public:
+    BookingIdGenerator() : last(0) {}
+    BookingIdGenerator(const BookingIdGenerator&) = delete;
+    BookingIdGenerator& operator=(const BookingIdGenerator&) = delete;
+
+    std::uint64_t next();                         // Uses the system clock
+    std::uint64_t nextAt(std::uint64_t unixMillis); // Same, with the caller's clock reading
+    void advancePast(std::uint64_t bookingNumber);  // Later numbers exceed it, e.g. after restoring logged bookings
+
+    static std::uint64_t timestampMillis(std::uint64_t bookingNumber) { // Unix milliseconds
+        return (bookingNumber >> SEQUENCE_BITS) + EPOCH_MILLIS;
+    }
+
+    static BookingIdGenerator& global(); // Shared by all Booking objects
+};
+
+#endif // BOOKINGIDGENERATOR_H
@@ -0,0 +1,36 @@
+#include "BookingTransaction.h"
+
+BookingTransaction::BookingTransaction(Airplane& airplane, int seatIndex, Customer& customer, std::atomic<Cents>& revenue)
+    : airplane(airplane), customer(customer), revenue(revenue), seatIndex(seatIndex),
+      priceCents(0), seatClaimed(false), charged(false), committed(false) {}
+
+BookingTransaction::~BookingTransaction() {
+    if (committed) return;
+    if (charged) {
+        customer.creditCents(priceCents);
+    }
+    if (seatClaimed) {
+        airplane.unbookSeatAt(seatIndex);
+    }
+}
+
+BookingTransaction::Status BookingTransaction::prepare() {
+    // The seat goes first: it is the step most likely to lose a race, and losing it costs nothing
+    if (!airplane.bookSeatAt(seatIndex)) {
+        return Status::SEAT_TAKEN;
+    }
+    seatClaimed = true;
+    priceCents = toCents(airplane.getSeatPrice(seatIndex));
+    if (priceCents > 0) { // Free seats need no debit
+        if (!customer.tryDebitCents(priceCents)) {
+            return Status::INSUFFICIENT_FUNDS; // The destructor frees the seat
+        }
+        charged = true;
+    }
+    return Status::READY;
+}
+
+void BookingTransaction::commit() {
+    revenue.fetch_add(priceCents, std::memory_order_acq_rel);
+    committed = true;
+}
@@ -0,0 +1,46 @@
+#ifndef BOOKINGTRANSACTION_H
+#define BOOKINGTRANSACTION_H
+
+#include "Airplane.h"
+#include "Customer.h"
+#include "Money.h"
+#include <atomic>
+
+// One seat purchase as a unit: claiming the seat, debiting the customer and the caller's
+// booking append either all take effect or none does, without a global lock.
+// prepare() claims the seat and then debits its price, each with a single atomic operation;
+// the caller then appends its booking record and calls commit(), which books the payment as
+// revenue. A transaction destroyed before commit() (failed step, early return or exception)
+// refunds the debit and frees the seat again.
+class BookingTransaction {
+public:
+    enum class Status {
+        READY,              // Seat claimed and customer charged; append the booking, then commit()
+        SEAT_TAKEN,         // Nothing changed
+        INSUFFICIENT_FUNDS  // Nothing changed
+    };
+
+private:
+    Airplane& airplane;
+    Customer& customer;
+    std::atomic<Cents>& revenue;
+    int seatIndex;
+    Cents priceCents;
+    bool seatClaimed;
+    bool charged;
+    bool committed;
+
+public:
+    BookingTransaction(Airplane& airplane, int seatIndex, Customer& customer, std::atomic<Cents>& revenue);
+    ~BookingTransaction(); // Rolls back unless committed
+
+    BookingTransaction(const BookingTransaction&) = delete;
+    BookingTransaction& operator=(const BookingTransaction&) = delete;
+
+    Status prepare();
+    void commit();
+
+    Cents getPriceCents() const { return priceCents; } // The amount prepare() debited
+};
+
+#endif // BOOKINGTRANSACTION_H
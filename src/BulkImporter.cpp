@@ -0,0 +1,547 @@
+#include "BulkImporter.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstring> // For std::strerror
+#include <fstream>
+
+namespace {
+
+// Every field any kind reads; a row keeps one text value per field
+enum Field { FLIGHT_NUMBER, ROWS, SEATS_PER_ROW, CUSTOMER_ID, NAME, AGE, MONEY, SEAT_ID, FIELD_COUNT };
+
+const char* const FIELD_NAMES[FIELD_COUNT] = {"flightNumber", "rows", "seatsPerRow", "customerId", "name", "age", "money", "seatId"};
+
+struct FieldSpec {
+    Field field;
+    bool required;
+};
+
+std::vector<FieldSpec> fieldsOf(BulkImporter::Kind kind) {
+    switch (kind) {
+        case BulkImporter::Kind::AIRPLANES:
+            return {{FLIGHT_NUMBER, true}, {ROWS, true}, {SEATS_PER_ROW, true}};
+        case BulkImporter::Kind::CUSTOMERS:
+            return {{CUSTOMER_ID, false}, {NAME, true}, {AGE, true}, {MONEY, true}};
+        case BulkImporter::Kind::BOOKINGS:
+            break;
+    }
+    return {{CUSTOMER_ID, true}, {FLIGHT_NUMBER, true}, {SEAT_ID, true}};
+}
+
+int fieldNamed(const char* name, std::size_t length) {
+    for (int field = 0; field < FIELD_COUNT; ++field) {
+        if (std::strlen(FIELD_NAMES[field]) == length && std::memcmp(FIELD_NAMES[field], name, length) == 0) return field;
+    }
+    return -1;
+}
+
+// One line's values; the strings keep their capacity from line to line
+struct Fields {
+    std::string text[FIELD_COUNT];
+    bool present[FIELD_COUNT] = {};
+
+    void clear() { std::fill(std::begin(present), std::end(present), false); }
+    std::string& set(int field) {
+        present[field] = true;
+        text[field].clear();
+        return text[field];
+    }
+};
+
+// Splits one CSV line into cells; quoted cells may hold commas and "" for a quote, not line breaks
+bool splitCsv(const char* p, const char* end, std::vector<std::string>& cells, std::size_t& count, std::string& error) {
+    count = 0;
+    while (true) {
+        if (cells.size() <= count) cells.emplace_back();
+        std::string& cell = cells[count++];
+        cell.clear();
+        if (p < end && *p == '"') {
+            for (++p;; ++p) {
+                if (p == end) {
+                    error = "Unterminated quoted field.";
+                    return false;
+                }
+                if (*p == '"') {
+                    if (p + 1 < end && p[1] == '"') {
+                        cell.push_back('"');
+                        ++p;
+                    } else {
+                        ++p;
+                        break;
+                    }
+                } else {
+                    cell.push_back(*p);
+                }
+            }
+            if (p < end && *p != ',') {
+                error = "Unexpected text after a quoted field.";
+                return false;
+            }
+        } else {
+            const char* comma = static_cast<const char*>(std::memchr(p, ',', static_cast<std::size_t>(end - p)));
+            const char* cellEnd = comma ? comma : end;
+            cell.assign(p, cellEnd);
+            p = cellEnd;
+        }
+        if (p == end) return true;
+        ++p; // The comma
+    }
+}
+
+void appendUtf8(std::string& out, unsigned codePoint) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+bool readHex4(const char*& p, const char* end, unsigned& value) {
+    if (end - p < 4) return false;
+    auto result = std::from_chars(p, p + 4, value, 16);
+    if (result.ptr != p + 4) return false;
+    p += 4;
+    return true;
+}
+
+// A JSON string starting at p (on its opening quote), unescaped into out (null: skipped)
+bool readJsonString(const char*& p, const char* end, std::string* out) {
+    for (++p; p < end; ++p) {
+        if (*p == '"') {
+            ++p;
+            return true;
+        }
+        if (*p != '\\') {
+            if (out) out->push_back(*p);
+            continue;
+        }
+        if (++p == end) return false;
+        char escaped = *p;
+        unsigned codePoint = 0;
+        switch (escaped) {
+            case '"': case '\\': case '/': codePoint = static_cast<unsigned char>(escaped); break;
+            case 'b': codePoint = '\b'; break;
+            case 'f': codePoint = '\f'; break;
+            case 'n': codePoint = '\n'; break;
+            case 'r': codePoint = '\r'; break;
+            case 't': codePoint = '\t'; break;
+            case 'u': {
+                ++p;
+                if (!readHex4(p, end, codePoint)) return false;
+                if (codePoint >= 0xD800 && codePoint < 0xDC00) { // High surrogate: its pair must follow
+                    unsigned low = 0;
+                    if (end - p < 2 || p[0] != '\\' || p[1] != 'u') return false;
+                    p += 2;
+                    if (!readHex4(p, end, low) || low < 0xDC00 || low >= 0xE000) return false;
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                }
+                --p; // The loop steps past the last hex digit
+                break;
+            }
+            default:
+                return false;
+        }
+        if (out) appendUtf8(*out, codePoint);
+    }
+    return false;
+}
+
+void skipSpace(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+}
+
+// One flat JSON object per line: string and number values are kept as text, keys no kind reads
+// are ignored
+bool parseJsonLine(const char* p, const char* end, Fields& fields, std::string& key, std::string& error) {
+    error = "Not a JSON object of strings and numbers.";
+    skipSpace(p, end);
+    if (p == end || *p != '{') return false;
+    ++p;
+    skipSpace(p, end);
+    if (p < end && *p == '}') {
+        ++p;
+    } else {
+        while (true) {
+            key.clear();
+            if (p == end || *p != '"' || !readJsonString(p, end, &key)) return false;
+            skipSpace(p, end);
+            if (p == end || *p != ':') return false;
+            ++p;
+            skipSpace(p, end);
+            int field = fieldNamed(key.data(), key.size());
+            std::string* value = field >= 0 ? &fields.set(field) : nullptr;
+            if (p < end && *p == '"') {
+                if (!readJsonString(p, end, value)) return false;
+            } else {
+                const char* start = p;
+                while (p < end && (std::isdigit(static_cast<unsigned char>(*p)) || *p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E')) ++p;
+                if (p == start) return false; // Objects, arrays, booleans and null are not field values
+                if (value) value->assign(start, p);
+            }
+            skipSpace(p, end);
+            if (p < end && *p == ',') {
+                ++p;
+                skipSpace(p, end);
+                continue;
+            }
+            if (p < end && *p == '}') {
+                ++p;
+                break;
+            }
+            return false;
+        }
+    }
+    skipSpace(p, end);
+    return p == end;
+}
+
+bool toInt(const std::string& text, int& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool toDouble(const std::string& text, double& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool missing(const Fields& fields, Field field, std::string& error) {
+    if (fields.present[field] && !fields.text[field].empty()) return false;
+    error.assign("Missing ").append(FIELD_NAMES[field]).append(".");
+    return true;
+}
+
+// Fields to the row of each kind; false with error if a value is missing or malformed
+bool toRow(Fields& fields, ReservationSystem::ImportedAirplane& row, std::string& error) {
+    if (missing(fields, FLIGHT_NUMBER, error) || missing(fields, ROWS, error) || missing(fields, SEATS_PER_ROW, error)) return false;
+    if (!toInt(fields.text[ROWS], row.rows) || row.rows <= 0 || !toInt(fields.text[SEATS_PER_ROW], row.seatsPerRow) || row.seatsPerRow <= 0) {
+        error = "rows and seatsPerRow must be positive whole numbers.";
+        return false;
+    }
+    row.flightNumber.swap(fields.text[FLIGHT_NUMBER]);
+    return true;
+}
+
+bool toRow(Fields& fields, ReservationSystem::ImportedCustomer& row, std::string& error) {
+    if (missing(fields, NAME, error) || missing(fields, AGE, error) || missing(fields, MONEY, error)) return false;
+    if (!toInt(fields.text[AGE], row.age) || row.age < 0) {
+        error = "age must be a non-negative whole number.";
+        return false;
+    }
+    if (!toDouble(fields.text[MONEY], row.money) || !(row.money >= 0)) {
+        error = "money must be a non-negative number.";
+        return false;
+    }
+    if (fields.present[CUSTOMER_ID]) row.customerId.swap(fields.text[CUSTOMER_ID]);
+    row.name.swap(fields.text[NAME]);
+    return true;
+}
+
+bool toRow(Fields& fields, ReservationSystem::ImportedBooking& row, std::string& error) {
+    if (missing(fields, CUSTOMER_ID, error) || missing(fields, FLIGHT_NUMBER, error) || missing(fields, SEAT_ID, error)) return false;
+    row.customerId.swap(fields.text[CUSTOMER_ID]);
+    row.flightNumber.swap(fields.text[FLIGHT_NUMBER]);
+    row.seatId.swap(fields.text[SEAT_ID]);
+    return true;
+}
+
+bool apply(ReservationSystem& system, const std::vector<ReservationSystem::ImportedAirplane>& rows,
+           std::vector<ReservationSystem::RejectedRow>& rejected, std::string& errorMessage, WorkStealingExecutor&) {
+    return system.importAirplanes(rows, rejected, errorMessage);
+}
+
+bool apply(ReservationSystem& system, const std::vector<ReservationSystem::ImportedCustomer>& rows,
+           std::vector<ReservationSystem::RejectedRow>& rejected, std::string& errorMessage, WorkStealingExecutor&) {
+    return system.importCustomers(rows, rejected, errorMessage);
+}
+
+bool apply(ReservationSystem& system, const std::vector<ReservationSystem::ImportedBooking>& rows,
+           std::vector<ReservationSystem::RejectedRow>& rejected, std::string& errorMessage, WorkStealingExecutor& executor) {
+    return system.importBookings(rows, rejected, errorMessage, executor);
+}
+
+// What one task parsed out of its slice of a chunk
+template<typename Row>
+struct ParsedSlice {
+    std::vector<Row> rows;
+    std::vector<std::uint64_t> lines; // Of each row, counted from the slice's first line (0)
+    std::vector<BulkImporter::RowError> errors; // Likewise
+    std::uint64_t lineCount = 0;
+};
+
+// columns: the CSV header's field per column (-1: ignored); empty for JSONL
+template<typename Row>
+void parseSlice(const char* p, const char* end, BulkImporter::Format format, const std::vector<int>& columns, ParsedSlice<Row>& out) {
+    Fields fields;
+    std::vector<std::string> cells;
+    std::string scratch, error;
+    for (std::uint64_t line = 0; p < end; ++line) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        const char* lineEnd = newline ? newline : end;
+        const char* next = newline ? newline + 1 : end;
+        if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+        out.lineCount = line + 1;
+        if (lineEnd == p) {
+            p = next;
+            continue;
+        }
+        fields.clear();
+        bool parsed;
+        if (format == BulkImporter::Format::CSV) {
+            std::size_t count = 0;
+            parsed = splitCsv(p, lineEnd, cells, count, error);
+            if (parsed && count != columns.size()) {
+                error = "Expected " + std::to_string(columns.size()) + " field(s), found " + std::to_string(count) + ".";
+                parsed = false;
+            }
+            for (std::size_t column = 0; parsed && column < count; ++column) {
+                if (columns[column] >= 0) fields.set(columns[column]).swap(cells[column]);
+            }
+        } else {
+            parsed = parseJsonLine(p, lineEnd, fields, scratch, error);
+        }
+        Row row;
+        if (parsed && toRow(fields, row, error)) {
+            out.rows.push_back(std::move(row));
+            out.lines.push_back(line);
+        } else {
+            out.errors.push_back({line, error});
+        }
+        p = next;
+    }
+}
+
+template<typename Row>
+class Import {
+private:
+    ReservationSystem& system;
+    const BulkImporter::Options& options;
+    WorkStealingExecutor& executor;
+    BulkImporter::Format format;
+    std::vector<int> columns;
+    BulkImporter::Report& report;
+    std::uint64_t nextLine = 1; // Number of the next line to be read
+
+    void addErrors(std::vector<BulkImporter::RowError>& errors) {
+        std::sort(errors.begin(), errors.end(), [](const BulkImporter::RowError& a, const BulkImporter::RowError& b) { return a.line < b.line; });
+        for (BulkImporter::RowError& error : errors) {
+            if (report.errors.size() >= options.maxErrors) break;
+            report.errors.push_back(std::move(error));
+        }
+    }
+
+public:
+    Import(ReservationSystem& system, const BulkImporter::Options& options, WorkStealingExecutor& executor, BulkImporter::Format format,
+           BulkImporter::Report& report)
+        : system(system), options(options), executor(executor), format(format), report(report) {}
+
+    // The CSV header: every required field must have a column
+    bool readHeader(const char*& p, const char* end, const std::vector<FieldSpec>& specs, std::string& errorMessage) {
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+        const char* lineEnd = newline ? newline : end;
+        const char* next = newline ? newline + 1 : end;
+        if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+        std::vector<std::string> cells;
+        std::size_t count = 0;
+        if (!splitCsv(p, lineEnd, cells, count, errorMessage)) {
+            errorMessage = "The CSV header is malformed: " + errorMessage;
+            return false;
+        }
+        for (std::size_t column = 0; column < count; ++column) {
+            int field = fieldNamed(cells[column].data(), cells[column].size());
+            bool used = std::any_of(specs.begin(), specs.end(), [field](const FieldSpec& spec) { return spec.field == field; });
+            columns.push_back(used ? field : -1);
+        }
+        for (const FieldSpec& spec : specs) {
+            if (spec.required && std::find(columns.begin(), columns.end(), spec.field) == columns.end()) {
+                errorMessage = std::string("The CSV header has no ") + FIELD_NAMES[spec.field] + " column.";
+                return false;
+            }
+        }
+        p = next;
+        ++nextLine;
+        return true;
+    }
+
+    // Parses [p, end), whole lines, on the executor, then applies the rows in order
+    bool processChunk(const char* p, const char* end, std::string& errorMessage) {
+        std::vector<const char*> bounds{p};
+        while (end - bounds.back() > static_cast<std::ptrdiff_t>(options.sliceBytes)) {
+            const char* cut = bounds.back() + options.sliceBytes;
+            const char* newline = static_cast<const char*>(std::memchr(cut, '\n', static_cast<std::size_t>(end - cut)));
+            if (!newline || newline + 1 == end) break;
+            bounds.push_back(newline + 1);
+        }
+        bounds.push_back(end);
+        std::vector<ParsedSlice<Row>> slices(bounds.size() - 1);
+        executor.parallelFor(0, slices.size(), 1, [&](std::size_t i) {
+            parseSlice(bounds[i], bounds[i + 1], format, columns, slices[i]);
+        });
+
+        std::vector<BulkImporter::RowError> errors;
+        std::vector<Row> batch;
+        std::vector<std::uint64_t> batchLines;
+        std::vector<ReservationSystem::RejectedRow> rejected;
+        auto flush = [&]() {
+            rejected.clear();
+            bool logged = apply(system, batch, rejected, errorMessage, executor);
+            report.imported += batch.size() - rejected.size();
+            report.failed += rejected.size();
+            for (ReservationSystem::RejectedRow& row : rejected) {
+                errors.push_back({batchLines[row.index], std::move(row.reason)});
+            }
+            batch.clear();
+            batchLines.clear();
+            return logged;
+        };
+        for (ParsedSlice<Row>& slice : slices) {
+            report.rows += slice.rows.size() + slice.errors.size();
+            report.failed += slice.errors.size();
+            for (BulkImporter::RowError& error : slice.errors) {
+                errors.push_back({nextLine + error.line, std::move(error.message)});
+            }
+            for (std::size_t i = 0; i < slice.rows.size(); ++i) {
+                batch.push_back(std::move(slice.rows[i]));
+                batchLines.push_back(nextLine + slice.lines[i]);
+                if (batch.size() >= options.batchRows && !flush()) {
+                    addErrors(errors);
+                    return false;
+                }
+            }
+            nextLine += slice.lineCount;
+            slice = ParsedSlice<Row>(); // Frees its rows before the next slice's are batched
+        }
+        bool logged = batch.empty() || flush();
+        addErrors(errors);
+        return logged;
+    }
+};
+
+template<typename Row>
+bool run(ReservationSystem& system, const BulkImporter::Options& options, WorkStealingExecutor& executor, std::istream& in,
+         BulkImporter::Kind kind, BulkImporter::Format format, BulkImporter::Report& report, std::string& errorMessage) {
+    Import<Row> import(system, options, executor, format, report);
+    std::string buffer;
+    std::size_t carried = 0; // Bytes of an incomplete last line kept from the previous chunk
+    bool header = format == BulkImporter::Format::CSV;
+    const std::size_t chunkBytes = std::max<std::size_t>(options.chunkBytes, 1);
+    while (true) {
+        buffer.resize(carried + chunkBytes);
+        in.read(&buffer[carried], static_cast<std::streamsize>(chunkBytes));
+        std::size_t filled = carried + static_cast<std::size_t>(in.gcount());
+        bool last = !in;
+        if (in.bad()) {
+            errorMessage = "Read error.";
+            return false;
+        }
+        // Whole lines only; a line longer than a chunk grows the buffer until it ends
+        std::size_t complete = filled;
+        if (!last) {
+            const char* data = buffer.data();
+            std::size_t newline = filled;
+            while (newline > carried && data[newline - 1] != '\n') --newline;
+            if (newline == carried) {
+                carried = filled;
+                continue;
+            }
+            complete = newline;
+        }
+        const char* p = buffer.data();
+        const char* end = buffer.data() + complete;
+        if (header && p < end) {
+            if (!import.readHeader(p, end, fieldsOf(kind), errorMessage)) return false;
+            header = false;
+        }
+        if (p < end && !import.processChunk(p, end, errorMessage)) return false;
+        if (last) break;
+        buffer.erase(0, complete);
+        carried = filled - complete;
+    }
+    if (header) {
+        errorMessage = "The CSV file has no header.";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+BulkImporter::BulkImporter(ReservationSystem& system) : BulkImporter(system, Options()) {}
+
+BulkImporter::BulkImporter(ReservationSystem& system, const Options& options, WorkStealingExecutor& executor)
+    : system(system), options(options), executor(executor) {}
+
+bool BulkImporter::importFile(const std::string& path, Kind kind, Format format, Report& report, std::string& errorMessage) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        report = Report();
+        errorMessage = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    if (!importStream(in, kind, format, report, errorMessage)) {
+        errorMessage = path + ": " + errorMessage;
+        return false;
+    }
+    return true;
+}
+
+bool BulkImporter::importStream(std::istream& in, Kind kind, Format format, Report& report, std::string& errorMessage) {
+    report = Report();
+    auto start = std::chrono::steady_clock::now();
+    bool imported = false;
+    switch (kind) {
+        case Kind::AIRPLANES:
+            imported = run<ReservationSystem::ImportedAirplane>(system, options, executor, in, kind, format, report, errorMessage);
+            break;
+        case Kind::CUSTOMERS:
+            imported = run<ReservationSystem::ImportedCustomer>(system, options, executor, in, kind, format, report, errorMessage);
+            break;
+        case Kind::BOOKINGS:
+            imported = run<ReservationSystem::ImportedBooking>(system, options, executor, in, kind, format, report, errorMessage);
+            break;
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (imported) {
+        errorMessage = "Imported " + std::to_string(report.imported) + " of " + std::to_string(report.rows) + " row(s).";
+    }
+    return imported;
+}
+
+bool BulkImporter::parseKind(const std::string& name, Kind& kind) {
+    if (name == "airplanes") kind = Kind::AIRPLANES;
+    else if (name == "customers") kind = Kind::CUSTOMERS;
+    else if (name == "bookings") kind = Kind::BOOKINGS;
+    else return false;
+    return true;
+}
+
+bool BulkImporter::parseFormat(const std::string& name, Format& format) {
+    if (name == "csv") format = Format::CSV;
+    else if (name == "jsonl") format = Format::JSONL;
+    else return false;
+    return true;
+}
+
+bool BulkImporter::formatOfPath(const std::string& path, Format& format) {
+    auto endsWith = [&path](const char* suffix) {
+        std::size_t length = std::strlen(suffix);
+        return path.size() >= length && path.compare(path.size() - length, length, suffix) == 0;
+    };
+    if (endsWith(".csv")) format = Format::CSV;
+    else if (endsWith(".jsonl") || endsWith(".ndjson")) format = Format::JSONL;
+    else return false;
+    return true;
+}
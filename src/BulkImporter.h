@@ -0,0 +1,70 @@
+#ifndef BULKIMPORTER_H
+#define BULKIMPORTER_H
+
+#include "ReservationSystem.h"
+#include "WorkStealingExecutor.h"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Loads airplanes, customers or bookings from a CSV or JSON Lines file into a ReservationSystem.
+// The input is read chunkBytes at a time (cut at the last complete line), each chunk is split into
+// slices parsed on the executor at once, and the parsed rows are applied in file order, batchRows
+// per ReservationSystem::import* call (bookings on the executor too, in file order per flight). Memory stays at about one chunk and its rows whatever the
+// file size. A row that does not parse or that the system refuses (unknown customer, taken seat,
+// duplicate ID, ...) is reported with its line number and skipped; the rest still load.
+//
+// Fields by kind (names as CSV header columns or JSONL keys; * optional):
+//   airplanes: flightNumber, rows, seatsPerRow
+//   customers: customerId*, name, age, money (customerId empty or absent: one is generated)
+//   bookings:  customerId, flightNumber, seatId (charged the seat's fare)
+// A CSV file starts with a header line naming its columns in any order; fields may be quoted with
+// "" for a literal quote. Each JSONL line is one flat object of strings and numbers. Blank lines are
+// skipped.
+class BulkImporter {
+public:
+    enum class Kind { AIRPLANES, CUSTOMERS, BOOKINGS };
+    enum class Format { CSV, JSONL };
+
+    struct Options {
+        std::size_t chunkBytes = 4u << 20; // Read and parsed at a time
+        std::size_t sliceBytes = 64u << 10; // Parsed per task
+        std::size_t batchRows = 4096;      // Applied under one registry lock
+        std::size_t maxErrors = 100;       // Row errors kept in the report (all are counted)
+    };
+
+    struct RowError {
+        std::uint64_t line; // 1-based, counting the CSV header
+        std::string message;
+    };
+
+    struct Report {
+        std::uint64_t rows = 0;     // Data rows read
+        std::uint64_t imported = 0; // Applied
+        std::uint64_t failed = 0;   // rows - imported
+        std::vector<RowError> errors; // The first maxErrors, in line order
+        double seconds = 0;
+        double rowsPerSecond() const { return seconds > 0 ? rows / seconds : 0; }
+    };
+
+    explicit BulkImporter(ReservationSystem& system); // Default options, on WorkStealingExecutor::global()
+    BulkImporter(ReservationSystem& system, const Options& options, WorkStealingExecutor& executor = WorkStealingExecutor::global());
+
+    // false with errorMessage if the file cannot be read, its CSV header lacks a required column or
+    // the write-ahead log failed; report then covers what was imported up to there.
+    bool importFile(const std::string& path, Kind kind, Format format, Report& report, std::string& errorMessage);
+    bool importStream(std::istream& in, Kind kind, Format format, Report& report, std::string& errorMessage);
+
+    static bool parseKind(const std::string& name, Kind& kind);           // "airplanes", "customers" or "bookings"
+    static bool parseFormat(const std::string& name, Format& format);     // "csv" or "jsonl"
+    static bool formatOfPath(const std::string& path, Format& format);    // By extension: .csv, .jsonl or .ndjson
+
+private:
+    ReservationSystem& system;
+    const Options options;
+    WorkStealingExecutor& executor;
+};
+
+#endif // BULKIMPORTER_H
@@ -0,0 +1,149 @@
+#include "CommandPipeline.h"
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace {
+
+constexpr int SPINS_BEFORE_SLEEP = 64; // Yields before the writer parks on the condition variable
+
+} // namespace
+
+CommandPipeline::CommandPipeline(ReservationSystem& system, std::size_t capacity)
+    : system(system), ring(capacity) {
+    writer = std::thread(&CommandPipeline::run, this);
+}
+
+CommandPipeline::~CommandPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping.store(true, std::memory_order_seq_cst);
+        writerSleeping.store(false, std::memory_order_seq_cst);
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+std::future<CommandResult> CommandPipeline::submit(Command command) {
+    Envelope envelope{std::move(command), std::promise<CommandResult>()};
+    std::future<CommandResult> result = envelope.done.get_future();
+    while (!ring.tryPush(std::move(envelope))) {
+        wakeWriter(); // Full: the writer is surely awake, but never wait on a sleeping one
+        std::this_thread::yield();
+    }
+    // Pairs with the writer's sleeping-flag store and ring check: either it sees this command,
+    // or wakeWriter below sees it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    wakeWriter();
+    return result;
+}
+
+void CommandPipeline::wakeWriter() {
+    if (writerSleeping.load(std::memory_order_seq_cst) && writerSleeping.exchange(false, std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+}
+
+CommandResult CommandPipeline::apply(ReservationSystem& system, const Command& command) {
+    CommandResult result;
+    switch (command.type) {
+        case Command::Type::ADD_CUSTOMER:
+            result.customer = system.addCustomerInternal(command.name, command.age, command.money, command.autoGenerate);
+            result.success = result.customer != nullptr;
+            if (!result.success) {
+                result.message = "Failed to add customer internally";
+            }
+            break;
+        case Command::Type::BOOK:
+            result.booking = system.createBookingInternal(command.customerId, command.flightNumber, command.seatId, result.message);
+            result.success = result.booking != nullptr;
+            break;
+        case Command::Type::CANCEL:
+            result.success = system.cancelBookingInternal(command.bookingId, result.message);
+            break;
+        case Command::Type::SWAP:
+            result.success = system.swapSeatsInternal(command.bookingId, command.bookingId2, result.message);
+            break;
+    }
+    return result;
+}
+
+int CommandPipeline::drain() {
+    batch.clear();
+    ReservationSystem::setDurabilityDeferred(true);
+    while (static_cast<int>(batch.size()) < MAX_BATCH && ring.tryPop([this](Envelope& envelope) {
+        Applied entry;
+        entry.done = std::move(envelope.done);
+        try {
+            entry.result = apply(system, envelope.command);
+        } catch (...) {
+            entry.error = std::current_exception(); // Surfaces in the requester's future.get()
+        }
+        entry.lsn = ReservationSystem::takeDeferredLsn();
+        batch.push_back(std::move(entry));
+    })) {
+    }
+    ReservationSystem::setDurabilityDeferred(false);
+    if (batch.empty()) {
+        return 0;
+    }
+
+    WriteAheadLog::Lsn highest = 0;
+    for (const Applied& entry : batch) {
+        highest = std::max(highest, entry.lsn);
+    }
+    std::string logError;
+    bool durable = system.awaitDurable(highest, logError); // One wait covers every record of the batch
+    batches.fetch_add(1, std::memory_order_relaxed);       // Before any future completes, like applied
+    for (Applied& entry : batch) {
+        applied.fetch_add(1, std::memory_order_relaxed); // Before the future completes, so requesters see it counted
+        if (entry.error) {
+            entry.done.set_exception(entry.error);
+            continue;
+        }
+        if (!durable && entry.lsn != 0) { // As the *Internal call would have failed on its own wait
+            entry.result.success = false;
+            entry.result.message = logError;
+            entry.result.customer = nullptr;
+            entry.result.booking = nullptr;
+        }
+        entry.done.set_value(std::move(entry.result));
+    }
+    return static_cast<int>(batch.size());
+}
+
+void CommandPipeline::run() {
+    for (;;) {
+        if (drain() > 0) {
+            continue;
+        }
+        if (stopping.load(std::memory_order_seq_cst)) {
+            if (!ring.hasPending()) {
+                return; // Everything submitted before shutdown has been applied
+            }
+            std::this_thread::yield(); // A producer is still writing its claimed cell
+            continue;
+        }
+
+        // Under load the next command is usually moments away: spin before sleeping
+        bool pending = false;
+        for (int spin = 0; spin < SPINS_BEFORE_SLEEP && !pending; ++spin) {
+            std::this_thread::yield();
+            pending = ring.hasPending();
+        }
+        if (pending) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerSleeping.store(true, std::memory_order_seq_cst);
+        if (ring.hasPending() || stopping.load(std::memory_order_seq_cst)) {
+            writerSleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        wake.wait(lock, [this] {
+            return !writerSleeping.load(std::memory_order_seq_cst) || stopping.load(std::memory_order_seq_cst);
+        });
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef COMMANDPIPELINE_H
+#define COMMANDPIPELINE_H
+
+#include "MpscRingBuffer.h"
+#include "ReservationSystem.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A mutation for ReservationSystem, as published by a request thread
+struct Command {
+    enum class Type { ADD_CUSTOMER, BOOK, CANCEL, SWAP };
+
+    Type type = Type::BOOK;
+    std::string customerId;   // BOOK
+    std::string flightNumber; // BOOK
+    std::string seatId;       // BOOK
+    std::string bookingId;    // CANCEL, SWAP (first booking)
+    std::string bookingId2;   // SWAP
+    std::string name;         // ADD_CUSTOMER
+    int age = 0;              // ADD_CUSTOMER
+    double money = 0.0;       // ADD_CUSTOMER
+    bool autoGenerate = false; // ADD_CUSTOMER
+};
+
+// Outcome of a Command. Entity pointers stay valid (slot-map storage) and the entities' mutable
+// fields are atomics, so the requesting thread may read them after the result arrives.
+struct CommandResult {
+    bool success = false;
+    std::string message;        // The *Internal method's errorMessage
+    Customer* customer = nullptr; // ADD_CUSTOMER
+    Booking* booking = nullptr;   // BOOK
+};
+
+// Single-writer mode (the LMAX pattern): request threads publish commands into a lock-free
+// MPSC ring and one writer thread applies them to the ReservationSystem in batches. With a
+// write-ahead log open, a batch is applied with durability deferred and waits once for its
+// highest record (one group commit per batch); each request's future completes after that.
+// The writer sleeps on a condition variable when the ring stays empty.
+// Deliberately not lock-free on the domain side: the writer is not the only mutator (seat holds,
+// imports, reprices and checkpoint cuts run on other threads, and readers take the same locks),
+// so it applies commands through the *Internal methods and their locks. It takes those locks
+// uncontended; bench_command_pipeline measures them at about 6% of a command's cost on the
+// writer, while the pipeline's gain is the tail: mutations never contend, so p99.9 stays flat as
+// clients are added.
+class CommandPipeline {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+    static constexpr int MAX_BATCH = 256; // Commands applied per drain before checking for shutdown
+
+private:
+    struct Envelope {
+        Command command;
+        std::promise<CommandResult> done;
+    };
+    struct Applied { // A drained command waiting for its batch's log records
+        std::promise<CommandResult> done;
+        CommandResult result;
+        WriteAheadLog::Lsn lsn = 0;     // Its highest record; 0 if it logged nothing
+        std::exception_ptr error;
+    };
+
+    ReservationSystem& system;
+    MpscRingBuffer<Envelope> ring;
+    std::thread writer;
+    std::atomic<bool> writerSleeping{false};
+    std::atomic<bool> stopping{false};
+    std::mutex wakeMutex; // Only for the writer's sleep/wake handshake
+    std::condition_variable wake;
+    std::atomic<std::uint64_t> batches{0};
+    std::atomic<std::uint64_t> applied{0};
+    std::vector<Applied> batch; // Writer thread only; reused across drains
+
+    void run();           // Writer thread body
+    int drain();          // Applies up to MAX_BATCH published commands; returns how many
+    void wakeWriter();
+
+public:
+    explicit CommandPipeline(ReservationSystem& system, std::size_t capacity = DEFAULT_CAPACITY);
+    ~CommandPipeline(); // Applies every command already submitted, then stops the writer
+
+    CommandPipeline(const CommandPipeline&) = delete;
+    CommandPipeline& operator=(const CommandPipeline&) = delete;
+
+    // Any thread. Waits (yielding) while the ring is full
+    std::future<CommandResult> submit(Command command);
+
+    // Runs one command against the system directly; the writer thread uses this, and so does
+    // the API server's locked mode
+    static CommandResult apply(ReservationSystem& system, const Command& command);
+
+    std::uint64_t getBatchCount() const { return batches.load(std::memory_order_relaxed); }
+    std::uint64_t getAppliedCount() const { return applied.load(std::memory_order_relaxed); }
+};
+
+#endif // COMMANDPIPELINE_H
@@ -0,0 +1,84 @@
+#ifndef COPYONWRITECAPTURE_H
+#define COPYONWRITECAPTURE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// Point-in-time copy of a slot-indexed table that writers keep mutating while it is read.
+// begin() fixes the point and the slots [0, slotCount) it covers; the caller keeps writers out for
+// that call only. From then on a writer calls preserve() before it first mutates a slot: if the
+// scan has not passed the slot yet, its current state (still the one at begin()) is copied aside.
+// scan() walks the slots in order and hands each one's copy, or else its current state, to the
+// caller, so every slot is seen as it was at begin(). Image is what read() returns for one slot.
+//
+// The scan reads a slot without a copy under the same mutex a writer's preserve() takes, and a
+// writer passes preserve() before it mutates, so the scan never reads a slot mid-mutation. Writers
+// behind the scan, and every writer while no capture runs, pay one atomic load.
+template<typename Image>
+class CopyOnWriteCapture {
+private:
+    std::mutex mutex;
+    std::atomic<bool> running{false};
+    std::atomic<std::uint32_t> limit{0};  // Slots covered
+    std::atomic<std::uint32_t> cursor{0}; // Slots below have been scanned
+    std::unordered_map<std::uint32_t, Image> preserved;
+
+public:
+    void begin(std::uint32_t slotCount) {
+        std::lock_guard<std::mutex> lock(mutex);
+        preserved.clear();
+        cursor.store(0, std::memory_order_relaxed);
+        limit.store(slotCount, std::memory_order_relaxed);
+        running.store(true, std::memory_order_release);
+    }
+
+    void end() { // Drops any copies left over
+        std::lock_guard<std::mutex> lock(mutex);
+        running.store(false, std::memory_order_release);
+        preserved.clear();
+    }
+
+    bool active() const { return running.load(std::memory_order_acquire); }
+    std::uint32_t slotCount() const { return limit.load(std::memory_order_relaxed); }
+
+    // Writers: read() returns the slot's current state; it runs at most once per slot and capture
+    template<typename Read>
+    void preserve(std::uint32_t slot, Read&& read) {
+        if (!running.load(std::memory_order_acquire) || slot >= limit.load(std::memory_order_relaxed) ||
+            slot < cursor.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running.load(std::memory_order_relaxed) || slot < cursor.load(std::memory_order_relaxed)) return;
+        if (preserved.find(slot) == preserved.end()) {
+            preserved.emplace(slot, read());
+        }
+    }
+
+    // The scan: visit(slot, image) for the next count slots, reading those without a copy with
+    // read(slot). false once every slot has been visited.
+    template<typename Read, typename Visit>
+    bool scan(std::uint32_t count, Read&& read, Visit&& visit) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const std::uint32_t from = cursor.load(std::memory_order_relaxed);
+        const std::uint32_t last = limit.load(std::memory_order_relaxed);
+        const std::uint32_t to = from + std::min(count, last - from);
+        for (std::uint32_t slot = from; slot < to; ++slot) {
+            auto it = preserved.find(slot);
+            if (it != preserved.end()) {
+                visit(slot, static_cast<const Image&>(it->second));
+                preserved.erase(it);
+            } else {
+                visit(slot, static_cast<const Image&>(read(slot)));
+            }
+        }
+        cursor.store(to, std::memory_order_release); // Writers of these slots no longer need to copy
+        return to < last;
+    }
+};
+
+#endif // COPYONWRITECAPTURE_H
@@ -4,10 +4,19 @@
 
 // Constructors
 Customer::Customer(const std::string& name, int age, const std::string& personId, double money)
-    : Person(name, age, personId), money(money) {
+    : Person(name, age, personId), balanceCents(toCents(money)) {
     // std::cout << "Customer constructor called for " << this->name << std::endl; // Optional: for debugging
 }
 
+Customer::Customer(const Customer& other)
+    : Person(other), balanceCents(other.balanceCents.load(std::memory_order_relaxed)) {}
+
+Customer& Customer::operator=(const Customer& other) {
+    Person::operator=(other);
+    balanceCents.store(other.balanceCents.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
 // Destructor
 Customer::~Customer() {
     // std::cout << "Customer destructor called for " << this->name << std::endl; // Optional: for debugging
@@ -15,38 +24,57 @@ Customer::~Customer() {
 
 // Getter for money
 double Customer::getMoney() const {
-    return money;
+    return toDollars(getBalanceCents());
 }
 
 // Setter for money
 void Customer::setMoney(double money) {
     if (money >= 0.0) {
-        this->money = money;
+        balanceCents.store(toCents(money), std::memory_order_relaxed);
     } else {
         // std::cerr << "Error: Money cannot be negative." << std::endl;
-        this->money = 0.0; // Or handle error appropriately
+        balanceCents.store(0, std::memory_order_relaxed); // Or handle error appropriately
     }
 }
 
 bool Customer::chargeMoney(double amount) {
-    if (amount > 0 && this->money >= amount) {
-        this->money -= amount;
-        return true;
-    }
-    return false; // Insufficient funds or invalid amount
+    return amount > 0 && tryDebitCents(toCents(amount)); // false on insufficient funds or invalid amount
 }
 
 void Customer::addMoney(double amount) {
     if (amount > 0) {
-        this->money += amount;
+        creditCents(toCents(amount));
+    }
+}
+
+Cents Customer::getBalanceCents() const {
+    return balanceCents.load(std::memory_order_acquire);
+}
+
+bool Customer::tryDebitCents(Cents amount) {
+    if (amount <= 0) return false;
+    Cents balance = balanceCents.load(std::memory_order_relaxed);
+    do {
+        if (balance < amount) return false;
+    } while (!balanceCents.compare_exchange_weak(balance, balance - amount, std::memory_order_acq_rel, std::memory_order_relaxed));
+    return true;
+}
+
+void Customer::creditCents(Cents amount) {
+    if (amount > 0) {
+        balanceCents.fetch_add(amount, std::memory_order_acq_rel);
     }
 }
 
+void Customer::adjustCents(Cents delta) {
+    balanceCents.fetch_add(delta, std::memory_order_acq_rel);
+}
+
 // Override displayDetails
 void Customer::displayDetails() const {
     std::cout << "Customer Details:" << std::endl;
     std::cout << "  ID: " << getPersonId() << std::endl;
     std::cout << "  Name: " << getName() << std::endl;
     std::cout << "  Age: " << getAge() << std::endl;
-    std::cout << "  Money: $" << std::fixed << std::setprecision(2) << money << std::endl;
+    std::cout << "  Money: $" << std::fixed << std::setprecision(2) << getMoney() << std::endl;
 }
@@ -2,16 +2,22 @@
 #define CUSTOMER_H
 
 #include "Person.h" // Include the base class header
+#include "Money.h"
+#include <atomic>
 #include <string>
 
 class Customer : public Person {
 private:
-    double money;
+    std::atomic<Cents> balanceCents; // Updated with CAS, so concurrent charges never overdraw
+
 
 public:
     // Constructors
     Customer(const std::string& name = "Unknown Customer", int age = 0, const std::string& personId = "C0000", double money = 0.0);
 
+    Customer(const Customer& other);
+    Customer& operator=(const Customer& other);
+
     // Destructor
     ~Customer() override;
 
@@ -23,6 +29,12 @@ public:
     bool chargeMoney(double amount); // Returns true if successful
     void addMoney(double amount);
 
+    // Exact balance operations; each is one atomic update
+    Cents getBalanceCents() const;
+    bool tryDebitCents(Cents amount); // false (balance unchanged) if amount <= 0 or funds are short
+    void creditCents(Cents amount);   // Ignores amount <= 0
+    void adjustCents(Cents delta);    // Unchecked, may go negative: for replaying charges that were already approved
+
     // Override displayDetails
     void displayDetails() const override;
 };
@@ -0,0 +1,141 @@
+#include "EpochDomain.h"
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// A thread's slot and Guard nesting depth in one domain. Threads normally only touch the
+// global domain; the small list covers tests that create their own.
+struct ThreadRecord {
+    EpochDomain* domain;
+    int slot;
+    int depth;
+};
+
+struct ThreadRecords {
+    std::vector<ThreadRecord> records;
+    void (*release)(EpochDomain*, int) = nullptr;
+
+    ThreadRecord& find(EpochDomain* domain) {
+        for (ThreadRecord& record : records) {
+            if (record.domain == domain) return record;
+        }
+        records.push_back({domain, -1, 0});
+        return records.back();
+    }
+
+    void forget(EpochDomain* domain) {
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            if (records[i].domain == domain) {
+                records.erase(records.begin() + static_cast<std::ptrdiff_t>(i));
+                return;
+            }
+        }
+    }
+
+    ~ThreadRecords() {
+        for (const ThreadRecord& record : records) {
+            if (record.slot >= 0 && release) release(record.domain, record.slot); // Hand the slot back at thread exit
+        }
+        destroyed = true;
+    }
+
+    static thread_local bool destroyed; // Trivial, so still readable after ~ThreadRecords at thread exit
+};
+
+thread_local bool ThreadRecords::destroyed = false;
+thread_local ThreadRecords threadRecords;
+
+} // namespace
+
+EpochDomain::~EpochDomain() {
+    if (!ThreadRecords::destroyed) {
+        threadRecords.forget(this); // The main thread's records die before static domains do
+    }
+    for (const Retired& entry : retired) {
+        entry.deleter(entry.object);
+    }
+}
+
+int EpochDomain::acquireSlot() {
+    for (;;) {
+        for (int i = 0; i < MAX_THREADS; ++i) {
+            bool expected = false;
+            if (!slots[i].owned.load(std::memory_order_relaxed) &&
+                slots[i].owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return i;
+            }
+        }
+        std::this_thread::yield(); // More than MAX_THREADS threads are inside the domain; wait for one to exit
+    }
+}
+
+void EpochDomain::releaseSlot(int index) {
+    slots[index].epoch.store(0, std::memory_order_seq_cst);
+    slots[index].owned.store(false, std::memory_order_release);
+}
+
+void EpochDomain::pin() {
+    ThreadRecord& record = threadRecords.find(this);
+    if (record.depth++ > 0) return;
+    if (record.slot < 0) {
+        record.slot = acquireSlot();
+        threadRecords.release = [](EpochDomain* domain, int slot) { domain->releaseSlot(slot); };
+    }
+    // seq_cst store then loads: a writer that has already bumped the epoch past an object's retire
+    // epoch is guaranteed to have unlinked it before this thread's next pointer load
+    slots[record.slot].epoch.store(globalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+}
+
+void EpochDomain::unpin() {
+    ThreadRecord& record = threadRecords.find(this);
+    if (--record.depth > 0) return;
+    slots[record.slot].epoch.store(0, std::memory_order_release);
+}
+
+std::uint64_t EpochDomain::oldestPinnedEpoch() const {
+    std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+    for (const ThreadSlot& slot : slots) {
+        std::uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch < oldest) oldest = epoch;
+    }
+    return oldest;
+}
+
+void EpochDomain::retire(void* object, void (*deleter)(void*)) {
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    // Readers pinned from now on see epoch + 1 and can only have loaded the replacement
+    retired.push_back({object, deleter, globalEpoch.fetch_add(1, std::memory_order_seq_cst)});
+    if (retired.size() >= RECLAIM_BATCH) {
+        reclaimLocked();
+    }
+}
+
+void EpochDomain::reclaimLocked() {
+    const std::uint64_t oldest = oldestPinnedEpoch();
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < retired.size(); ++i) {
+        if (retired[i].epoch < oldest) {
+            retired[i].deleter(retired[i].object);
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired.resize(kept);
+}
+
+void EpochDomain::reclaim() {
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    reclaimLocked();
+}
+
+std::size_t EpochDomain::pendingCount() {
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    return retired.size();
+}
+
+EpochDomain& EpochDomain::global() {
+    static EpochDomain domain;
+    return domain;
+}
@@ -0,0 +1,76 @@
+#ifndef EPOCHDOMAIN_H
+#define EPOCHDOMAIN_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Epoch-based reclamation for read-mostly structures published through an atomic pointer.
+// Readers pin the current epoch with a Guard (two atomic stores, no lock, no shared cache line
+// with other readers) and may use anything they load until the Guard ends. Writers swap in a
+// new version and retire() the old one; it is deleted only once every reader that could still
+// see it has unpinned. Writers pay for reclamation; readers never wait for anything.
+class EpochDomain {
+public:
+    static constexpr int MAX_THREADS = 256;   // Threads pinned at the same time
+    static constexpr std::size_t RECLAIM_BATCH = 64; // Retired objects collected before a reclaim pass
+
+private:
+    struct alignas(64) ThreadSlot {
+        std::atomic<std::uint64_t> epoch{0}; // 0 = not pinned
+        std::atomic<bool> owned{false};
+    };
+
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+        std::uint64_t epoch; // Epoch at which it was unlinked
+    };
+
+    std::atomic<std::uint64_t> globalEpoch{1};
+    ThreadSlot slots[MAX_THREADS];
+    std::mutex retiredMutex; // Writers only
+    std::vector<Retired> retired;
+
+    int acquireSlot();
+    void releaseSlot(int index);
+    void pin();
+    void unpin();
+    std::uint64_t oldestPinnedEpoch() const; // UINT64_MAX if no thread is pinned
+    void reclaimLocked();
+
+public:
+    EpochDomain() = default;
+    ~EpochDomain(); // Deletes whatever is still retired; no reader may be pinned
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // Pins the calling thread for its lifetime. Guards nest; only the outermost one pins.
+    class Guard {
+    private:
+        EpochDomain& domain;
+
+    public:
+        explicit Guard(EpochDomain& d = EpochDomain::global()) : domain(d) { domain.pin(); }
+        ~Guard() { domain.unpin(); }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    // Call after object is no longer reachable through any published pointer
+    template<typename T>
+    void retire(const T* object) {
+        retire(const_cast<T*>(object), [](void* p) { delete static_cast<T*>(p); });
+    }
+    void retire(void* object, void (*deleter)(void*));
+
+    void reclaim();                 // Deletes every retired object no pinned reader can hold
+    std::size_t pendingCount();     // Retired but not yet deleted
+    std::uint64_t currentEpoch() const { return globalEpoch.load(std::memory_order_seq_cst); }
+
+    static EpochDomain& global(); // Shared by every ReservationSystem
+};
+
+#endif // EPOCHDOMAIN_H
@@ -0,0 +1,606 @@
+#include "EpollHttpServer.h"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cstdio> // For snprintf
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h> // For strcasecmp
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <mutex>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+constexpr int MAX_EVENTS = 256;
+constexpr int MAX_ACCEPTS_PER_WAKEUP = 64;          // Leaves the rest of a connect burst to the other loops
+constexpr std::size_t READ_CHUNK = 16 * 1024;
+constexpr std::size_t KEPT_OUTPUT_CAPACITY = 16 * 1024; // Larger output buffers are freed once sent
+constexpr std::size_t STREAM_AHEAD_BYTES = 64 * 1024;   // A streamed body is produced up to this far ahead of the socket
+
+// epoll_event::data.ptr values for the two non-connection descriptors
+char acceptTag;
+char wakeTag;
+
+int openReserveFd() {
+    return ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+}
+
+// Request line and headers of in[begin, headerEnd). false if malformed.
+bool parseHead(const std::string& in, std::size_t begin, std::size_t headerEnd, httplib::Request& request) {
+    std::size_t lineEnd = in.find("\r\n", begin);
+    std::size_t methodEnd = in.find(' ', begin);
+    if (methodEnd == std::string::npos || methodEnd >= lineEnd) return false;
+    std::size_t targetEnd = in.find(' ', methodEnd + 1);
+    if (targetEnd == std::string::npos || targetEnd >= lineEnd) return false;
+    request.method.assign(in, begin, methodEnd - begin);
+    request.target.assign(in, methodEnd + 1, targetEnd - methodEnd - 1);
+    request.version.assign(in, targetEnd + 1, lineEnd - targetEnd - 1);
+    if (request.method.empty() || request.target.empty() || request.version.compare(0, 7, "HTTP/1.") != 0) {
+        return false;
+    }
+
+    for (std::size_t line = lineEnd + 2; line < headerEnd;) {
+        std::size_t end = std::min(in.find("\r\n", line), headerEnd);
+        std::size_t colon = in.find(':', line);
+        if (colon == std::string::npos || colon >= end || colon == line) return false;
+        std::size_t valueBegin = colon + 1;
+        while (valueBegin < end && (in[valueBegin] == ' ' || in[valueBegin] == '\t')) ++valueBegin;
+        std::size_t valueEnd = end;
+        while (valueEnd > valueBegin && (in[valueEnd - 1] == ' ' || in[valueEnd - 1] == '\t')) --valueEnd;
+        request.headers.emplace(in.substr(line, colon - line), in.substr(valueBegin, valueEnd - valueBegin));
+        line = end + 2;
+    }
+
+    std::size_t query = request.target.find('?');
+    request.path = httplib::detail::decode_url(request.target.substr(0, query), false);
+    if (query != std::string::npos) {
+        httplib::detail::parse_query_text(request.target.data() + query + 1, request.target.size() - query - 1, request.params);
+    }
+    return true;
+}
+
+} // namespace
+
+struct EpollHttpServer::Connection {
+    int fd;
+    std::uint32_t events = 0;      // Currently registered epoll interest
+    std::string in;                // Received bytes; the first `parsed` are consumed
+    std::size_t parsed = 0;
+    std::string out;               // Queued response bytes; the first `sent` are written
+    std::size_t sent = 0;
+    bool peerClosed = false;       // Read side reached end of stream
+    bool closeAfterOutput = false; // Connection: close, or a protocol error
+    std::shared_ptr<Exchange> stream; // Exchange whose content provider is still producing the body
+    std::uint64_t serial;          // Tells a reused fd's new connection from the one a worker answers
+    bool awaiting = false;         // A worker has its request or stream; the requests behind it wait
+
+    Connection(int fd, std::uint64_t serial) : fd(fd), serial(serial) {}
+};
+
+// A request on its way through a worker and back to the loop that owns its connection
+struct EpollHttpServer::Exchange {
+    int fd;
+    std::uint64_t serial;
+    bool keepAlive;
+    httplib::Request request;
+    httplib::Response response;
+    // Set while the response's content provider streams the body, a page per worker job
+    std::string page;          // Framed body bytes produced by the last job
+    std::size_t streamed = 0;  // Body bytes produced so far
+    bool streamChunked = false; // Chunked framing; otherwise the body ends at its length or at close
+    bool streamDone = false;
+    bool streamFailed = false;
+};
+
+struct EpollHttpServer::Loop {
+    int epollFd = -1;
+    int completionFd = -1; // eventfd: a worker makes it readable after posting to `completed`
+    std::thread thread;
+    std::unordered_map<int, std::unique_ptr<Connection>> connections; // Only touched by this loop's thread
+    std::uint64_t nextSerial = 0;
+    std::mutex completedMutex;
+    std::vector<std::shared_ptr<Exchange>> completed; // Answered by workers, not yet queued on their connections
+};
+
+EpollHttpServer::EpollHttpServer(int loopCount)
+    : loopCount(loopCount > 0 ? loopCount : std::max(1u, std::thread::hardware_concurrency())) {
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+EpollHttpServer::~EpollHttpServer() {
+    stop();
+    if (listenFd >= 0) ::close(listenFd);
+    if (wakeFd >= 0) ::close(wakeFd);
+}
+
+EpollHttpServer& EpollHttpServer::addRoute(const char* method, const std::string& pattern, Handler handler) {
+    routes.push_back({method, std::regex(pattern), std::move(handler)});
+    return *this;
+}
+
+EpollHttpServer& EpollHttpServer::Get(const std::string& pattern, Handler handler) { return addRoute("GET", pattern, std::move(handler)); }
+EpollHttpServer& EpollHttpServer::Post(const std::string& pattern, Handler handler) { return addRoute("POST", pattern, std::move(handler)); }
+EpollHttpServer& EpollHttpServer::Put(const std::string& pattern, Handler handler) { return addRoute("PUT", pattern, std::move(handler)); }
+EpollHttpServer& EpollHttpServer::Delete(const std::string& pattern, Handler handler) { return addRoute("DELETE", pattern, std::move(handler)); }
+EpollHttpServer& EpollHttpServer::Options(const std::string& pattern, Handler handler) { return addRoute("OPTIONS", pattern, std::move(handler)); }
+
+void EpollHttpServer::setLogger(Logger newLogger) {
+    logger = std::move(newLogger);
+}
+
+void EpollHttpServer::set_pre_routing_handler(PreRoutingHandler handler) {
+    preRoutingHandler = std::move(handler);
+}
+
+int EpollHttpServer::bindToPort(const std::string& host, int port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addresses = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (addrinfo* address = addresses; address && fd < 0; address = address->ai_next) {
+        fd = ::socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0) continue;
+        int yes = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        if (::bind(fd, address->ai_addr, address->ai_addrlen) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ::freeaddrinfo(addresses);
+    if (fd < 0) return -1;
+
+    sockaddr_storage bound{};
+    socklen_t length = sizeof(bound);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &length);
+    if (listenFd >= 0) ::close(listenFd);
+    listenFd = fd;
+    return bound.ss_family == AF_INET6 ? ntohs(reinterpret_cast<sockaddr_in6&>(bound).sin6_port)
+                                       : ntohs(reinterpret_cast<sockaddr_in&>(bound).sin_port);
+}
+
+bool EpollHttpServer::listen(const std::string& host, int port) {
+    return bindToPort(host, port) >= 0 && listenAfterBind();
+}
+
+bool EpollHttpServer::listenAfterBind() {
+    if (listenFd < 0 || wakeFd < 0) return false;
+    reserveFd.store(openReserveFd());
+    for (int i = 0; i < loopCount; ++i) {
+        std::unique_ptr<Loop> loop(new Loop());
+        loop->epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        loop->completionFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event accept{};
+        accept.events = EPOLLIN | EPOLLEXCLUSIVE; // One loop woken per incoming connection
+        accept.data.ptr = &acceptTag;
+        epoll_event wake{};
+        wake.events = EPOLLIN; // Never drained: once stop() signals, every loop sees it
+        wake.data.ptr = &wakeTag;
+        epoll_event completion{};
+        completion.events = EPOLLIN;
+        completion.data.ptr = loop.get();
+        loops.push_back(std::move(loop));
+        Loop& created = *loops.back();
+        if (created.epollFd < 0 || created.completionFd < 0 || ::epoll_ctl(created.epollFd, EPOLL_CTL_ADD, listenFd, &accept) != 0 ||
+            ::epoll_ctl(created.epollFd, EPOLL_CTL_ADD, wakeFd, &wake) != 0 ||
+            ::epoll_ctl(created.epollFd, EPOLL_CTL_ADD, created.completionFd, &completion) != 0) {
+            for (auto& failed : loops) {
+                if (failed->epollFd >= 0) ::close(failed->epollFd);
+                if (failed->completionFd >= 0) ::close(failed->completionFd);
+            }
+            loops.clear();
+            return false;
+        }
+    }
+
+    taskQueue.reset(new_task_queue ? new_task_queue() : new httplib::ThreadPool(CPPHTTPLIB_THREAD_POOL_COUNT, DEFAULT_MAX_QUEUED));
+    running.store(true, std::memory_order_release);
+    for (std::size_t i = 1; i < loops.size(); ++i) {
+        loops[i]->thread = std::thread(&EpollHttpServer::runLoop, this, std::ref(*loops[i]));
+    }
+    runLoop(*loops[0]);
+    for (auto& loop : loops) {
+        if (loop->thread.joinable()) loop->thread.join();
+    }
+    taskQueue->shutdown(); // Runs what is queued; its responses go nowhere, as their connections are closed
+    taskQueue.reset();
+    for (auto& loop : loops) {
+        ::close(loop->epollFd);
+        ::close(loop->completionFd);
+    }
+    loops.clear();
+    int spare = reserveFd.exchange(-1);
+    if (spare >= 0) ::close(spare);
+    running.store(false, std::memory_order_release);
+    return true;
+}
+
+void EpollHttpServer::stop() {
+    stopping.store(true, std::memory_order_release);
+    if (wakeFd >= 0) {
+        std::uint64_t one = 1;
+        ssize_t written = ::write(wakeFd, &one, sizeof(one));
+        (void)written; // Only fails if the counter is already non-zero, which wakes the loops just the same
+    }
+}
+
+void EpollHttpServer::runLoop(Loop& loop) {
+    epoll_event events[MAX_EVENTS];
+    while (!stopping.load(std::memory_order_acquire)) {
+        int count = ::epoll_wait(loop.epollFd, events, MAX_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            void* tag = events[i].data.ptr;
+            if (tag == &wakeTag) continue;
+            if (tag == &acceptTag) {
+                acceptConnections(loop);
+                continue;
+            }
+            if (tag == &loop) {
+                completeResponses(loop);
+                continue;
+            }
+            Connection& connection = *static_cast<Connection*>(tag);
+            if (!serviceConnection(loop, connection, events[i].events)) {
+                closeConnection(loop, connection);
+            }
+        }
+    }
+    for (auto& entry : loop.connections) {
+        ::close(entry.first);
+    }
+    openConnections.fetch_sub(loop.connections.size(), std::memory_order_relaxed);
+    loop.connections.clear();
+}
+
+void EpollHttpServer::acceptConnections(Loop& loop) {
+    for (int accepted = 0; accepted < MAX_ACCEPTS_PER_WAKEUP; ++accepted) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno == EMFILE || errno == ENFILE) {
+                // Out of descriptors: accept with the spare one and close at once, so the client gets a
+                // reset instead of waiting in the backlog while the listener keeps every loop awake
+                int spare = reserveFd.exchange(-1);
+                if (spare >= 0) {
+                    ::close(spare);
+                    int shed = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+                    if (shed >= 0) ::close(shed);
+                    reserveFd.store(openReserveFd());
+                }
+            }
+            return; // EAGAIN: the backlog is empty or another loop took the connection
+        }
+        int yes = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)); // Responses go out in one write
+        std::unique_ptr<Connection> connection(new Connection(fd, loop.nextSerial++));
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.ptr = connection.get();
+        if (::epoll_ctl(loop.epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+        connection->events = event.events;
+        loop.connections.emplace(fd, std::move(connection));
+        openConnections.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EpollHttpServer::completeResponses(Loop& loop) {
+    std::uint64_t signals;
+    ssize_t drained = ::read(loop.completionFd, &signals, sizeof(signals));
+    (void)drained; // EAGAIN only if an earlier wakeup already took this signal with its exchanges
+    std::vector<std::shared_ptr<Exchange>> completed;
+    {
+        std::lock_guard<std::mutex> lock(loop.completedMutex);
+        completed.swap(loop.completed);
+    }
+    for (auto& exchange : completed) {
+        auto found = loop.connections.find(exchange->fd);
+        if (found == loop.connections.end() || found->second->serial != exchange->serial) continue; // Closed meanwhile
+        Connection& connection = *found->second;
+        connection.awaiting = false;
+        if (connection.stream == exchange) { // A page of the body
+            connection.out.append(exchange->page);
+            exchange->page.clear();
+            if (exchange->streamFailed) {
+                connection.stream.reset(); // The body is cut short: the client sees the connection close
+                connection.closeAfterOutput = true;
+            } else if (exchange->streamDone) {
+                connection.stream.reset();
+            }
+        } else {
+            if (writeResponse(connection, *exchange)) connection.stream = exchange;
+            if (logger) logger(exchange->request, exchange->response);
+        }
+        if (!serviceConnection(loop, connection, 0)) { // Streams, flushes and passes on the next pipelined request
+            closeConnection(loop, connection);
+        }
+    }
+}
+
+void EpollHttpServer::closeConnection(Loop& loop, Connection& connection) {
+    int fd = connection.fd;
+    ::close(fd); // Also removes it from the epoll set
+    openConnections.fetch_sub(1, std::memory_order_relaxed);
+    loop.connections.erase(fd); // Destroys connection
+}
+
+bool EpollHttpServer::serviceConnection(Loop& loop, Connection& connection, std::uint32_t events) {
+    if (events & EPOLLERR) return false;
+    if ((events & EPOLLHUP) && connection.awaiting) return false; // Nobody left to answer, and HUP cannot be masked
+    if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) && !connection.peerClosed && !readInput(connection)) {
+        connection.peerClosed = true; // Answer what already arrived, then close
+    }
+    for (;;) {
+        bool throttled = processInput(loop, connection);
+        if (!flushOutput(connection)) return false;
+        if (connection.sent < connection.out.size()) break; // Socket full: wait for EPOLLOUT
+        if (throttled) continue;                            // Output drained: serve the held-back requests
+        if (connection.awaiting) break;                     // Resumed by completeResponses
+        if (connection.closeAfterOutput || connection.peerClosed) return false;
+        break;
+    }
+    updateInterest(loop, connection);
+    return true;
+}
+
+bool EpollHttpServer::readInput(Connection& connection) {
+    char buffer[READ_CHUNK];
+    for (;;) {
+        ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.in.append(buffer, static_cast<std::size_t>(received));
+            if (static_cast<std::size_t>(received) < sizeof(buffer)) return true; // Drained for now
+            continue;
+        }
+        if (received == 0) return false;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+bool EpollHttpServer::processInput(Loop& loop, Connection& connection) {
+    if (connection.stream) { // Requests behind it wait until the body is out
+        if (connection.awaiting) return false; // Resumed when the page comes back
+        if (connection.out.size() - connection.sent >= STREAM_AHEAD_BYTES) return true; // Serviced again as the output drains
+        if (!handOff(loop, connection.stream, true)) {
+            connection.stream.reset(); // No worker for the rest of the body
+            connection.closeAfterOutput = true;
+            return false;
+        }
+        connection.awaiting = true;
+        return false;
+    }
+    bool throttled = false;
+    std::string& in = connection.in;
+    while (!connection.closeAfterOutput && !connection.awaiting) {
+        if (connection.out.size() - connection.sent >= MAX_PENDING_OUTPUT) {
+            throttled = true; // A pipelining client is not reading its responses
+            break;
+        }
+        std::size_t headerEnd = in.find("\r\n\r\n", connection.parsed);
+        if (headerEnd == std::string::npos) {
+            if (in.size() - connection.parsed > MAX_HEADER_BYTES) writeError(connection, 431);
+            break;
+        }
+        if (headerEnd - connection.parsed > MAX_HEADER_BYTES) {
+            writeError(connection, 431);
+            break;
+        }
+        auto exchange = std::make_shared<Exchange>();
+        httplib::Request& request = exchange->request;
+        if (!parseHead(in, connection.parsed, headerEnd, request)) {
+            writeError(connection, 400);
+            break;
+        }
+        if (request.has_header("Transfer-Encoding")) {
+            writeError(connection, 501); // Chunked request bodies are not supported
+            break;
+        }
+        std::uint64_t bodyLength = request.get_header_value_u64("Content-Length");
+        if (bodyLength > MAX_BODY_BYTES) {
+            writeError(connection, 413);
+            break;
+        }
+        std::size_t bodyBegin = headerEnd + 4;
+        if (in.size() - bodyBegin < bodyLength) break; // Rest of the body still in flight
+        request.body.assign(in, bodyBegin, bodyLength);
+        connection.parsed = bodyBegin + bodyLength;
+
+        const std::string& connectionHeader = request.get_header_value("Connection");
+        exchange->keepAlive = request.version == "HTTP/1.1" ? ::strcasecmp(connectionHeader.c_str(), "close") != 0
+                                                            : ::strcasecmp(connectionHeader.c_str(), "keep-alive") == 0;
+        exchange->fd = connection.fd;
+        exchange->serial = connection.serial;
+        if (!handOff(loop, exchange, false)) {
+            writeError(connection, 503); // Every worker busy and the queue full
+            break;
+        }
+        connection.awaiting = true; // One request at a time keeps pipelined responses in order
+    }
+
+    if (connection.parsed == in.size()) {
+        in.clear();
+        connection.parsed = 0;
+    } else if (connection.parsed > 0 && connection.parsed >= in.size() / 2) {
+        in.erase(0, connection.parsed); // Keep a pipelined tail without moving it on every request
+        connection.parsed = 0;
+    }
+    return throttled;
+}
+
+bool EpollHttpServer::flushOutput(Connection& connection) {
+    std::string& out = connection.out;
+    while (connection.sent < out.size()) {
+        ssize_t written = ::send(connection.fd, out.data() + connection.sent, out.size() - connection.sent, MSG_NOSIGNAL);
+        if (written > 0) {
+            connection.sent += static_cast<std::size_t>(written);
+            continue;
+        }
+        if (written < 0 && errno == EINTR) continue;
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        return false;
+    }
+    if (out.capacity() > KEPT_OUTPUT_CAPACITY) {
+        std::string().swap(out); // Idle keep-alive connections should not each pin a large buffer
+    } else {
+        out.clear();
+    }
+    connection.sent = 0;
+    return true;
+}
+
+void EpollHttpServer::updateInterest(Loop& loop, Connection& connection) {
+    std::uint32_t wanted = 0;
+    if (!connection.peerClosed) {
+        wanted |= EPOLLRDHUP;
+        if (!connection.closeAfterOutput && !connection.stream && !connection.awaiting &&
+            connection.out.size() - connection.sent < MAX_PENDING_OUTPUT) {
+            wanted |= EPOLLIN;
+        }
+    }
+    if (connection.sent < connection.out.size()) {
+        wanted |= EPOLLOUT;
+    }
+    if (wanted != connection.events) {
+        epoll_event event{};
+        event.events = wanted;
+        event.data.ptr = &connection;
+        ::epoll_ctl(loop.epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = wanted;
+    }
+}
+
+void EpollHttpServer::dispatch(httplib::Request& request, httplib::Response& response) const {
+    const std::string& method = request.method == "HEAD" ? std::string("GET") : request.method;
+    for (const Route& route : routes) {
+        if (route.method != method || !std::regex_match(request.path, request.matches, route.pattern)) {
+            continue;
+        }
+        try {
+            route.handler(request, response);
+        } catch (...) {
+            response = httplib::Response(); // As httplib does without an exception handler: a bare 500
+            response.status = 500;
+        }
+        if (response.status == -1) response.status = 200;
+        return;
+    }
+    response.status = 404;
+}
+
+bool EpollHttpServer::writeResponse(Connection& connection, Exchange& exchange) {
+    const httplib::Request& request = exchange.request;
+    httplib::Response& response = exchange.response;
+    bool keepAlive = exchange.keepAlive;
+    std::string& out = connection.out;
+    bool hasBody = response.status >= 200 && response.status != 204 && response.status != 304;
+    bool provided = hasBody && response.content_provider_;
+    bool chunked = provided && response.content_length_ == 0 && request.version == "HTTP/1.1";
+    if (provided && response.content_length_ == 0 && !chunked) keepAlive = false; // HTTP/1.0: the body ends at close
+    if (::strcasecmp(response.get_header_value("Connection").c_str(), "close") == 0) keepAlive = false; // As httplib honours it
+    out.append("HTTP/1.1 ").append(std::to_string(response.status)).append(" ")
+       .append(httplib::status_message(response.status)).append("\r\n");
+    for (const auto& header : response.headers) {
+        if (::strcasecmp(header.first.c_str(), "Content-Length") == 0 || ::strcasecmp(header.first.c_str(), "Connection") == 0) {
+            continue; // Written below
+        }
+        out.append(header.first).append(": ").append(header.second).append("\r\n");
+    }
+    if (chunked) {
+        out.append("Transfer-Encoding: chunked\r\n");
+    } else if (hasBody && (!provided || response.content_length_ > 0)) {
+        std::size_t length = provided ? response.content_length_ : response.body.size();
+        out.append("Content-Length: ").append(std::to_string(length)).append("\r\n");
+    }
+    out.append(keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
+    if (!keepAlive) connection.closeAfterOutput = true;
+    if (!hasBody || request.method == "HEAD") return false;
+    if (!provided) {
+        out.append(response.body);
+        return false;
+    }
+    exchange.streamChunked = chunked;
+    return true;
+}
+
+bool EpollHttpServer::handOff(Loop& loop, const std::shared_ptr<Exchange>& exchange, bool page) {
+    Loop* owner = &loop;
+    return taskQueue->enqueue([this, owner, exchange, page]() {
+        if (page) {
+            producePage(*exchange);
+        } else if (!preRoutingHandler || preRoutingHandler(exchange->request, exchange->response) != httplib::Server::HandlerResponse::Handled) {
+            dispatch(exchange->request, exchange->response);
+        } else if (exchange->response.status == -1) {
+            exchange->response.status = 200;
+        }
+        {
+            std::lock_guard<std::mutex> lock(owner->completedMutex);
+            owner->completed.push_back(exchange);
+        }
+        std::uint64_t one = 1;
+        ssize_t written = ::write(owner->completionFd, &one, sizeof(one));
+        (void)written; // Cannot overflow: the loop drains the counter on every wakeup
+    });
+}
+
+void EpollHttpServer::producePage(Exchange& exchange) {
+    httplib::Response& response = exchange.response;
+    bool done = false;
+    httplib::DataSink sink;
+    sink.write = [&exchange](const char* data, std::size_t length) {
+        if (length == 0) return true; // An empty chunk would end the body
+        if (exchange.streamChunked) {
+            char size[24];
+            int sizeLength = std::snprintf(size, sizeof(size), "%zx\r\n", length);
+            exchange.page.append(size, static_cast<std::size_t>(sizeLength)).append(data, length).append("\r\n");
+        } else {
+            exchange.page.append(data, length);
+        }
+        exchange.streamed += length;
+        return true;
+    };
+    sink.is_writable = []() { return true; };
+    sink.done = [&done]() { done = true; };
+    sink.done_with_trailer = [&done](const httplib::Headers&) { done = true; };
+    while (!done && exchange.page.size() < STREAM_AHEAD_BYTES) {
+        std::size_t remaining = response.content_length_ > exchange.streamed ? response.content_length_ - exchange.streamed : 0;
+        if (!response.content_provider_(exchange.streamed, remaining, sink)) {
+            exchange.streamFailed = true;
+            return;
+        }
+        if (response.content_length_ > 0 && exchange.streamed >= response.content_length_) done = true;
+    }
+    if (done) {
+        if (exchange.streamChunked) exchange.page.append("0\r\n\r\n");
+        response.content_provider_success_ = true;
+        exchange.streamDone = true;
+    }
+}
+
+void EpollHttpServer::writeError(Connection& connection, int status) {
+    connection.out.append("HTTP/1.1 ").append(std::to_string(status)).append(" ")
+                  .append(httplib::status_message(status))
+                  .append("\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    connection.closeAfterOutput = true;
+}
+
+#endif // __linux__
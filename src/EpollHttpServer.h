@@ -0,0 +1,110 @@
+#ifndef EPOLLHTTPSERVER_H
+#define EPOLLHTTPSERVER_H
+
+#include "../third_party/httplib.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// HTTP/1.1 server on a Linux epoll event loop (Linux only). Sockets are non-blocking and a few loop
+// threads each own the connections they accepted, so an idle keep-alive connection costs a buffer
+// and an epoll registration instead of a pooled thread. Parsed requests are handed to a bounded
+// worker pool (new_task_queue, as on httplib::Server) and each finished response is posted back to
+// its loop through that loop's eventfd, so a handler that blocks (e.g. on a log flush or the
+// command pipeline) holds up only its own connection; a request the pool refuses gets a 503.
+// Handlers take cpp-httplib's Request/Response and routes are registered and matched the way
+// httplib::Server does it (regex, first match in registration order), so registerApiRoutes serves
+// the same API on either backend. Request bodies need a Content-Length (no chunked uploads);
+// keep-alive and pipelined requests are supported. A response with a content provider (e.g.
+// set_chunked_content_provider) is streamed: the provider is pulled only as the socket drains,
+// a window at a time on a worker (so it may take locks), chunk-encoded for HTTP/1.1 clients, and
+// later pipelined requests wait for its end.
+class EpollHttpServer {
+public:
+    using Handler = std::function<void(const httplib::Request&, httplib::Response&)>;
+    using Logger = std::function<void(const httplib::Request&, const httplib::Response&)>;
+    using PreRoutingHandler = std::function<httplib::Server::HandlerResponse(const httplib::Request&, httplib::Response&)>;
+
+    static constexpr std::size_t MAX_HEADER_BYTES = 16 * 1024;  // Request line plus headers; larger gets 431
+    static constexpr std::size_t MAX_BODY_BYTES = 8 * 1024 * 1024; // Larger gets 413
+    static constexpr std::size_t MAX_PENDING_OUTPUT = 1024 * 1024; // Unsent bytes before a connection stops reading
+    static constexpr std::size_t DEFAULT_MAX_QUEUED = 1024;        // Requests waiting for a worker before 503s
+
+private:
+    struct Route {
+        std::string method;
+        std::regex pattern;
+        Handler handler;
+    };
+    struct Connection;
+    struct Loop;
+    struct Exchange;
+
+    std::vector<Route> routes; // Registered before listening; read-only afterwards
+    Logger logger;
+    PreRoutingHandler preRoutingHandler;
+    int loopCount;
+    int listenFd = -1;
+    int wakeFd = -1;    // eventfd: stop() makes it readable to wake every loop
+    std::atomic<int> reserveFd{-1}; // Spare descriptor, given up to accept-and-shed a connection when out of descriptors
+    std::vector<std::unique_ptr<Loop>> loops;
+    std::unique_ptr<httplib::TaskQueue> taskQueue; // Runs the handlers while listening
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+    std::atomic<std::size_t> openConnections{0};
+
+    EpollHttpServer& addRoute(const char* method, const std::string& pattern, Handler handler);
+    void runLoop(Loop& loop);
+    void acceptConnections(Loop& loop);
+    void completeResponses(Loop& loop); // Queues the responses the workers posted to this loop
+    void closeConnection(Loop& loop, Connection& connection);
+    bool serviceConnection(Loop& loop, Connection& connection, std::uint32_t events); // false: close it
+    bool readInput(Connection& connection);    // false once the peer has closed or failed
+    bool processInput(Loop& loop, Connection& connection); // Hands the next complete request to a worker; true if stopped by MAX_PENDING_OUTPUT
+    bool flushOutput(Connection& connection);  // false on a write error
+    void updateInterest(Loop& loop, Connection& connection);
+    void dispatch(httplib::Request& request, httplib::Response& response) const; // On a worker
+    // Runs the exchange's handler (or, for page, the next page of its streamed body) on a worker, then
+    // posts it back to loop; false if the pool refused it
+    bool handOff(Loop& loop, const std::shared_ptr<Exchange>& exchange, bool page);
+    static void producePage(Exchange& exchange); // On a worker: runs the content provider up to a window ahead
+    // Queues the head and a plain body; true if the body comes from the response's content provider
+    static bool writeResponse(Connection& connection, Exchange& exchange);
+    static void writeError(Connection& connection, int status); // Queues a bare error response and closes after it
+
+public:
+    explicit EpollHttpServer(int loopCount = 0); // 0: one loop per hardware thread
+    ~EpollHttpServer();
+
+    EpollHttpServer(const EpollHttpServer&) = delete;
+    EpollHttpServer& operator=(const EpollHttpServer&) = delete;
+
+    // Route registration, as on httplib::Server. HEAD requests are served by the Get routes.
+    EpollHttpServer& Get(const std::string& pattern, Handler handler);
+    EpollHttpServer& Post(const std::string& pattern, Handler handler);
+    EpollHttpServer& Put(const std::string& pattern, Handler handler);
+    EpollHttpServer& Delete(const std::string& pattern, Handler handler);
+    EpollHttpServer& Options(const std::string& pattern, Handler handler);
+    void setLogger(Logger newLogger); // Called on the loop thread after each response is queued
+    // Runs on the worker before routing; Handled skips the routes (httplib::Server's pre-routing handler)
+    void set_pre_routing_handler(PreRoutingHandler handler);
+    // Creates the handler pool when listening starts, as on httplib::Server (default: an
+    // httplib::ThreadPool of CPPHTTPLIB_THREAD_POOL_COUNT workers and DEFAULT_MAX_QUEUED waiting requests)
+    std::function<httplib::TaskQueue*()> new_task_queue;
+
+    int bindToPort(const std::string& host, int port); // port 0 picks a free one; returns the port, or -1
+    bool listenAfterBind();                            // Runs the loops; blocks until stop()
+    bool listen(const std::string& host, int port);    // bindToPort, then listenAfterBind
+    void stop();                                       // Any thread; open connections are closed
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+    std::size_t getConnectionCount() const { return openConnections.load(std::memory_order_relaxed); }
+};
+
+#endif // EPOLLHTTPSERVER_H
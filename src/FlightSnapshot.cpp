@@ -0,0 +1,137 @@
+#include "FlightSnapshot.h"
+#include <mutex>
+
+namespace {
+
+// Process-wide free lists. Deliberately never destroyed: EpochDomain::global() may still hand
+// back snapshots while static objects are being torn down at exit.
+struct SnapshotPool {
+    std::mutex mutex; // Writers and reclaimers only; readers never come here
+    std::vector<FlightSnapshot*> snapshots;
+    std::vector<FlightSnapshot::Chunk*> chunks;
+};
+
+SnapshotPool& pool() {
+    static SnapshotPool* instance = new SnapshotPool();
+    return *instance;
+}
+
+} // namespace
+
+FlightSnapshot* FlightSnapshot::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(pool().mutex);
+        if (!pool().snapshots.empty()) {
+            FlightSnapshot* snapshot = pool().snapshots.back();
+            pool().snapshots.pop_back();
+            return snapshot;
+        }
+    }
+    return new FlightSnapshot();
+}
+
+FlightSnapshot::Chunk* FlightSnapshot::acquireChunk() {
+    {
+        std::lock_guard<std::mutex> lock(pool().mutex);
+        if (!pool().chunks.empty()) {
+            Chunk* chunk = pool().chunks.back();
+            pool().chunks.pop_back();
+            return chunk;
+        }
+    }
+    return new Chunk();
+}
+
+void FlightSnapshot::releaseChunk(Chunk* chunk) {
+    if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(pool().mutex);
+        pool().chunks.push_back(chunk);
+    }
+}
+
+void FlightSnapshot::release(const FlightSnapshot* snapshot) {
+    if (!snapshot) return;
+    FlightSnapshot* recycled = const_cast<FlightSnapshot*>(snapshot);
+    for (Chunk* chunk : recycled->chunks) {
+        releaseChunk(chunk);
+    }
+    recycled->chunks.clear(); // Keeps its capacity for the next version
+    recycled->layout.reset();
+    std::lock_guard<std::mutex> lock(pool().mutex);
+    pool().snapshots.push_back(recycled);
+}
+
+void FlightSnapshot::addChunk(Chunk* chunk) {
+    chunk->refs.fetch_add(1, std::memory_order_relaxed);
+    chunks.push_back(chunk);
+}
+
+FlightSnapshot::Ptr FlightSnapshot::buildLayout(const Airplane& airplane, std::uint64_t version) {
+    Ptr snapshot(acquire());
+    snapshot->snapshotVersion = version;
+    snapshot->bookedSeats = 0;
+    auto layout = std::make_shared<Layout>();
+    const int capacity = airplane.getCapacity();
+    layout->flightNumber = airplane.getFlightNumber();
+    layout->seatsPerRow = airplane.getSeatsPerRow();
+    layout->rows = capacity / layout->seatsPerRow;
+    layout->prices.reserve(capacity);
+    layout->businessSeats.resize(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        layout->prices.push_back(airplane.getSeatPrice(i));
+        if (airplane.getSeatClass(i) == SeatClass::BUSINESS) layout->businessSeats.set(i);
+    }
+    snapshot->layout = std::move(layout);
+    return snapshot;
+}
+
+FlightSnapshot::Ptr FlightSnapshot::copyForUpdate() const {
+    Ptr next(acquire());
+    next->snapshotVersion = snapshotVersion + 1;
+    next->bookedSeats = bookedSeats;
+    next->layout = layout;
+    for (Chunk* chunk : chunks) {
+        next->addChunk(chunk);
+    }
+    return next;
+}
+
+FlightSnapshot::Ptr FlightSnapshot::withSeats(const SeatUpdate* updates, int count) const {
+    Ptr next = copyForUpdate(); // Shares layout and every chunk
+    for (int u = 0; u < count; ++u) {
+        const SeatUpdate& update = updates[u];
+        Chunk*& slot = next->chunks[update.seatIndex / CHUNK_SEATS];
+        // Copy the chunk unless an earlier update in this call already did
+        if (slot == chunks[update.seatIndex / CHUNK_SEATS]) {
+            Chunk* copy = acquireChunk();
+            copy->occupied = slot->occupied;
+            for (int i = 0; i < CHUNK_SEATS; ++i) {
+                copy->owners[i] = slot->owners[i];
+            }
+            copy->refs.store(1, std::memory_order_relaxed);
+            releaseChunk(slot);
+            slot = copy;
+        }
+        const std::uint64_t bit = 1ULL << (update.seatIndex % CHUNK_SEATS);
+        const bool wasBooked = (slot->occupied & bit) != 0;
+        if (update.booked) {
+            slot->occupied |= bit;
+            slot->owners[update.seatIndex % CHUNK_SEATS] = update.owner;
+        } else {
+            slot->occupied &= ~bit;
+            slot->owners[update.seatIndex % CHUNK_SEATS] = SeatOwner();
+        }
+        next->bookedSeats += static_cast<int>(update.booked) - static_cast<int>(wasBooked);
+    }
+    return next;
+}
+
+FlightSnapshot::Ptr FlightSnapshot::withPrices(const Airplane& airplane) const {
+    Ptr next = copyForUpdate();
+    auto updated = std::make_shared<Layout>(*layout);
+    for (int i = 0; i < getCapacity(); ++i) {
+        updated->prices[i] = airplane.getSeatPrice(i);
+    }
+    next->layout = std::move(updated);
+    return next;
+}
@@ -0,0 +1,128 @@
+#ifndef FLIGHTSNAPSHOT_H
+#define FLIGHTSNAPSHOT_H
+
+#include "Airplane.h"
+#include "SeatBitset.h"
+#include "SeatCodec.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Immutable, versioned view of one flight for lock-free readers (see EpochDomain).
+// Seats are stored in copy-on-write chunks of 64: publishing a change copies only the chunks it
+// touches plus the chunk pointer table, and every other chunk is shared with the previous
+// version. Readers only follow raw pointers, so they never touch a reference count.
+// Snapshots and chunks come from a process-wide free list and go back to it when released, so
+// publishing a version allocates nothing once the list has warmed up.
+class FlightSnapshot {
+public:
+    static constexpr int CHUNK_SEATS = 64;
+
+    // Who holds a seat. customerId points into customerIdInterner() and lives forever.
+    struct SeatOwner {
+        std::uint64_t bookingNumber = 0; // 0 = no booking recorded for the seat
+        const std::string* customerId = nullptr;
+    };
+
+    struct SeatUpdate {
+        int seatIndex;
+        bool booked;
+        SeatOwner owner;
+    };
+
+    struct Releaser {
+        void operator()(const FlightSnapshot* snapshot) const { release(snapshot); }
+    };
+    using Ptr = std::unique_ptr<FlightSnapshot, Releaser>;
+
+    // Fixed per flight until a fare changes
+    struct Layout {
+        std::string flightNumber;
+        int rows;
+        int seatsPerRow;
+        std::vector<double> prices;
+        SeatBitset businessSeats;
+    };
+
+    // Shared between versions; refs counts the snapshots pointing at it
+    struct Chunk {
+        std::atomic<int> refs{0};
+        std::uint64_t occupied = 0;
+        SeatOwner owners[CHUNK_SEATS];
+    };
+
+private:
+    std::uint64_t snapshotVersion;
+    int bookedSeats;
+    std::shared_ptr<const Layout> layout;
+    std::vector<Chunk*> chunks;
+
+    FlightSnapshot() : snapshotVersion(0), bookedSeats(0) {}
+    ~FlightSnapshot() = default;
+    const Chunk& chunkOf(int seatIndex) const { return *chunks[seatIndex / CHUNK_SEATS]; }
+
+    static FlightSnapshot* acquire();   // From the free list, or new
+    static Chunk* acquireChunk();
+    static void releaseChunk(Chunk* chunk); // Back to the free list when the last reference goes
+    Ptr copyForUpdate() const;          // Same layout and chunks (references taken), version + 1
+    static Ptr buildLayout(const Airplane& airplane, std::uint64_t version);
+    void addChunk(Chunk* chunk);
+
+public:
+    // Version `version` of a flight read from the live airplane; owners are filled in by ownerOf(seatIndex)
+    template<typename OwnerFn>
+    static Ptr build(const Airplane& airplane, OwnerFn ownerOf, std::uint64_t version = 1);
+
+    // Copy of this snapshot with the given seats replaced and the version bumped
+    Ptr withSeats(const SeatUpdate* updates, int count) const;
+    // Copy of this snapshot with fares re-read from the airplane and the version bumped
+    Ptr withPrices(const Airplane& airplane) const;
+
+    // Returns a snapshot and its chunk references to the free list; the snapshot must be unreachable
+    static void release(const FlightSnapshot* snapshot);
+    static void recycle(void* snapshot) { release(static_cast<const FlightSnapshot*>(snapshot)); } // EpochDomain deleter
+
+    std::uint64_t version() const { return snapshotVersion; }
+    const std::string& getFlightNumber() const { return layout->flightNumber; }
+    int getCapacity() const { return static_cast<int>(layout->prices.size()); }
+    int getBookedSeatsCount() const { return bookedSeats; }
+    bool isFull() const { return bookedSeats >= getCapacity(); }
+
+    // seatIndex must be in [0, getCapacity())
+    bool isSeatBooked(int seatIndex) const { return (chunkOf(seatIndex).occupied >> (seatIndex % CHUNK_SEATS)) & 1ULL; }
+    const SeatOwner& getSeatOwner(int seatIndex) const { return chunkOf(seatIndex).owners[seatIndex % CHUNK_SEATS]; }
+    double getSeatPrice(int seatIndex) const { return layout->prices[seatIndex]; }
+    SeatClass getSeatClass(int seatIndex) const {
+        return layout->businessSeats.test(seatIndex) ? SeatClass::BUSINESS : SeatClass::ECONOMY;
+    }
+    SeatKey getSeatKey(int seatIndex) const {
+        return SeatCodec::toKey(seatIndex / layout->seatsPerRow + 1, seatIndex % layout->seatsPerRow);
+    }
+};
+
+template<typename OwnerFn>
+FlightSnapshot::Ptr FlightSnapshot::build(const Airplane& airplane, OwnerFn ownerOf, std::uint64_t version) {
+    Ptr snapshot = buildLayout(airplane, version);
+    const int capacity = airplane.getCapacity();
+    for (int base = 0; base < capacity; base += CHUNK_SEATS) {
+        Chunk* chunk = acquireChunk();
+        chunk->occupied = 0;
+        for (int i = 0; i < CHUNK_SEATS; ++i) {
+            chunk->owners[i] = SeatOwner();
+        }
+        for (int i = base; i < capacity && i < base + CHUNK_SEATS; ++i) {
+            if (airplane.isSeatBooked(i)) {
+                chunk->occupied |= 1ULL << (i - base);
+                chunk->owners[i - base] = ownerOf(i);
+                ++snapshot->bookedSeats;
+            }
+        }
+        snapshot->addChunk(chunk);
+    }
+    return snapshot;
+}
+
+#endif // FLIGHTSNAPSHOT_H
@@ -0,0 +1,106 @@
+#include "JsonWriter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+JsonWriter::JsonWriter(std::string& buffer) : out(buffer), hasMembers(0), depth(0), afterKey(false) {}
+
+void JsonWriter::separate() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    std::uint64_t bit = 1ULL << (depth & 63);
+    if (hasMembers & bit) {
+        out.push_back(',');
+    }
+    hasMembers |= bit;
+}
+
+void JsonWriter::open(char bracket) {
+    separate();
+    out.push_back(bracket);
+    ++depth;
+    hasMembers &= ~(1ULL << (depth & 63));
+}
+
+void JsonWriter::close(char bracket) {
+    --depth;
+    out.push_back(bracket);
+}
+
+JsonWriter& JsonWriter::beginObject() { open('{'); return *this; }
+JsonWriter& JsonWriter::endObject() { close('}'); return *this; }
+JsonWriter& JsonWriter::beginArray() { open('['); return *this; }
+JsonWriter& JsonWriter::endArray() { close(']'); return *this; }
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    appendEscaped(name);
+    out.push_back(':');
+    afterKey = true;
+    return *this;
+}
+
+void JsonWriter::appendEscaped(std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+    out.push_back('"');
+    for (char c : text) {
+        switch (c) {
+            case '"':  out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out.append("\\u00");
+                    out.push_back(HEX[(c >> 4) & 0xF]);
+                    out.push_back(HEX[c & 0xF]);
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+    separate();
+    appendEscaped(text);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(long long number) {
+    separate();
+    char buffer[24];
+    int length = std::snprintf(buffer, sizeof(buffer), "%lld", number);
+    out.append(buffer, length);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    if (!std::isfinite(number)) {
+        return nullValue();
+    }
+    separate();
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.15g", number);
+    if (std::strtod(buffer, nullptr) != number) {
+        length = std::snprintf(buffer, sizeof(buffer), "%.17g", number); // Needs full precision
+    }
+    out.append(buffer, length);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out.append(flag ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::nullValue() {
+    separate();
+    out.append("null");
+    return *this;
+}
@@ -0,0 +1,43 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Minimal JSON writer that appends compact output to a caller-owned buffer.
+// Unlike building a DOM, nothing is allocated per value: once the buffer has grown to
+// the size of a typical response, writing the next response into it is allocation-free.
+// Commas between members and elements are inserted automatically (up to 64 nesting levels).
+class JsonWriter {
+private:
+    std::string& out;
+    std::uint64_t hasMembers; // Bit n: the container at depth n already has an entry
+    int depth;
+    bool afterKey;            // The next value completes a "key": pair
+
+    void separate();  // Emits ',' when the current container already has an entry
+    void open(char bracket);
+    void close(char bracket);
+    void appendEscaped(std::string_view text);
+
+public:
+    explicit JsonWriter(std::string& buffer);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(long long number);
+    JsonWriter& value(int number) { return value(static_cast<long long>(number)); }
+    JsonWriter& value(double number); // Shortest form that reads back exactly; non-finite becomes null
+    JsonWriter& value(bool flag);
+    JsonWriter& nullValue();
+};
+
+#endif // JSONWRITER_H
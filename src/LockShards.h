@@ -0,0 +1,80 @@
+#ifndef LOCKSHARDS_H
+#define LOCKSHARDS_H
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <utility>
+
+// Fixed pool of mutexes striped over entity slot indexes: the entity in slot i is guarded by
+// shard i % SHARD_COUNT. Each mutex sits on its own cache line so neighbouring shards do not
+// contend through false sharing.
+class LockShards {
+public:
+    static constexpr std::uint32_t SHARD_COUNT = 64;
+
+private:
+    struct alignas(64) Shard {
+        std::mutex mutex;
+    };
+    std::array<Shard, SHARD_COUNT> shards;
+
+public:
+    static std::uint32_t shardOf(std::uint32_t slotIndex) { return slotIndex % SHARD_COUNT; }
+    std::mutex& forSlot(std::uint32_t slotIndex) { return shards[shardOf(slotIndex)].mutex; }
+};
+
+// Locks the shards of up to two flights and two customers in the one global order used
+// everywhere: all flight shards before any customer shard, each group by ascending shard number,
+// duplicates taken once. Two guards can therefore never wait on each other in a cycle.
+class ShardLockGuard {
+private:
+    static constexpr int MAX_LOCKS = 4;
+    std::mutex* held[MAX_LOCKS];
+    int heldCount;
+
+    void lockGroup(LockShards& pool, std::initializer_list<std::uint32_t> slots) {
+        std::uint32_t shards[2];
+        int count = 0;
+        for (std::uint32_t slot : slots) {
+            if (count < 2) shards[count++] = LockShards::shardOf(slot);
+        }
+        if (count == 2 && shards[1] < shards[0]) std::swap(shards[0], shards[1]);
+        if (count == 2 && shards[1] == shards[0]) count = 1; // Same shard: take it once
+        for (int i = 0; i < count; ++i) {
+            std::mutex& mutex = pool.forSlot(shards[i]); // shardOf(shard) == shard
+            mutex.lock();
+            held[heldCount++] = &mutex;
+        }
+    }
+
+public:
+    ShardLockGuard() : heldCount(0) {} // Holds nothing until lock()
+
+    ShardLockGuard(LockShards& flightShards, std::initializer_list<std::uint32_t> flightSlots,
+                   LockShards& customerShards, std::initializer_list<std::uint32_t> customerSlots)
+        : heldCount(0) {
+        lock(flightShards, flightSlots, customerShards, customerSlots);
+    }
+
+    ~ShardLockGuard() { unlock(); }
+
+    // For callers that must re-check what they locked and retry; lock() requires nothing held
+    void lock(LockShards& flightShards, std::initializer_list<std::uint32_t> flightSlots,
+              LockShards& customerShards, std::initializer_list<std::uint32_t> customerSlots) {
+        lockGroup(flightShards, flightSlots);
+        lockGroup(customerShards, customerSlots);
+    }
+
+    void unlock() {
+        while (heldCount > 0) {
+            held[--heldCount]->unlock();
+        }
+    }
+
+    ShardLockGuard(const ShardLockGuard&) = delete;
+    ShardLockGuard& operator=(const ShardLockGuard&) = delete;
+};
+
+#endif // LOCKSHARDS_H
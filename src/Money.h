@@ -0,0 +1,20 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cmath>
+#include <cstdint>
+
+// Money is kept as whole cents so balances can be updated with a single atomic integer
+// operation and repeated charges/refunds never drift. Dollars (double) only appear at the
+// console/API boundary.
+using Cents = std::int64_t;
+
+inline Cents toCents(double dollars) {
+    return static_cast<Cents>(std::llround(dollars * 100.0));
+}
+
+inline double toDollars(Cents cents) {
+    return static_cast<double>(cents) / 100.0;
+}
+
+#endif // MONEY_H
@@ -0,0 +1,97 @@
+#ifndef MPSCRINGBUFFER_H
+#define MPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Bounded lock-free queue for many producers and one consumer.
+// Each cell carries a sequence number (Vyukov's scheme): a producer claims the next cell by
+// CAS on `tail`, writes the value, then publishes it by advancing the cell's sequence; the
+// consumer takes cells in order once they are published. Neither side ever blocks the other:
+// tryPush fails when the ring is full and tryPop fails when the next cell is not yet published.
+// Capacity must be a power of two.
+template<typename T>
+class MpscRingBuffer {
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::uint64_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    const std::uint64_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<std::uint64_t> tail; // Next cell to claim (producers)
+    alignas(64) std::uint64_t head;              // Next cell to consume (consumer only)
+
+public:
+    explicit MpscRingBuffer(std::size_t capacity)
+        : mask(capacity - 1), cells(new Cell[capacity]), tail(0), head(0) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("MpscRingBuffer capacity must be a power of two >= 2");
+        }
+        for (std::size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscRingBuffer() {
+        while (tryPop([](T&) {})) {
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // Any thread. false (value untouched) if the ring is full
+    bool tryPush(T&& value) {
+        std::uint64_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & mask];
+            std::uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::int64_t lag = static_cast<std::int64_t>(sequence) - static_cast<std::int64_t>(position);
+            if (lag == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    new (cell.storage) T(std::move(value));
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false; // The consumer has not freed this cell from the previous lap
+            } else {
+                position = tail.load(std::memory_order_relaxed); // Another producer took it
+            }
+        }
+    }
+
+    // Consumer thread only. Moves the next value into fn(T&); false if nothing is published yet
+    template<typename Fn>
+    bool tryPop(Fn fn) {
+        Cell& cell = cells[head & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        T* value = cell.value();
+        fn(*value);
+        value->~T();
+        cell.sequence.store(head + mask + 1, std::memory_order_release); // Free for the next lap
+        ++head;
+        return true;
+    }
+
+    // Consumer thread only. True if a producer has claimed a cell the consumer has not taken
+    // (it may still be mid-write)
+    bool hasPending() const {
+        return tail.load(std::memory_order_seq_cst) != head;
+    }
+
+    std::size_t capacity() const { return static_cast<std::size_t>(mask + 1); }
+};
+
+#endif // MPSCRINGBUFFER_H
@@ -12,7 +12,7 @@ Person::~Person() {
 }
 
 // Getters
-std::string Person::getName() const {
+const std::string& Person::getName() const {
     return name;
 }
 
@@ -20,7 +20,7 @@ int Person::getAge() const {
     return age;
 }
 
-std::string Person::getPersonId() const {
+const std::string& Person::getPersonId() const {
     return personId;
 }
 
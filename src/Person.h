@@ -18,9 +18,9 @@ public:
     virtual ~Person();
 
     // Getters
-    std::string getName() const;
+    const std::string& getName() const;
     int getAge() const;
-    std::string getPersonId() const;
+    const std::string& getPersonId() const;
 
     // Setters
     void setName(const std::string& name);
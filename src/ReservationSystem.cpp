@@ -1,15 +1,53 @@
 #include "ReservationSystem.h"
+#include "BookingTransaction.h"
+#include "BookingIdGenerator.h"
 #include <iostream>
-#include <algorithm> // For std::find_if
+#include <atomic>
+#include <algorithm> // For std::swap
 #include <random>    // For ID generation
 #include <sstream>   // For ID generation
 #include <iomanip>   // For std::setfill, std::setw, std::fixed, std::setprecision
+#include <fstream>   // For finding rotated log segments
+#include <iterator>  // For std::back_inserter
+#include <climits>   // For INT_MAX
+
+static std::atomic<int> g_customerIdCounter{1}; // Global static for resettable ID generation
+
+// New customers must not reuse the ID of one recovered or imported with a generated-looking ID
+static void advanceCustomerIdCounterPast(const std::string& customerId) {
+    if (customerId.compare(0, 4, "CUST") == 0 && customerId.size() > 4 &&
+        customerId.find_first_not_of("0123456789", 4) == std::string::npos && customerId.size() < 14) {
+        int next = std::stoi(customerId.substr(4)) + 1;
+        int current = g_customerIdCounter.load();
+        while (current < next && !g_customerIdCounter.compare_exchange_weak(current, next)) {
+        }
+    }
+}
 
-static int g_customerIdCounter = 1; // Global static for resettable ID generation
+static std::string bookingIdOf(std::uint64_t bookingNumber) {
+    char id[Booking::BOOKING_ID_LENGTH];
+    Booking::formatBookingId(bookingNumber, id);
+    return std::string(id, sizeof(id));
+}
+
+// Every seat must have a seat ID SeatCodec can encode and an int index
+static bool checkAirplaneSize(int rows, int seatsPerRow, std::string& errorMessage) {
+    if (rows <= 0 || seatsPerRow <= 0) {
+        errorMessage = "Rows and seats per row must be positive.";
+        return false;
+    }
+    if (rows > SeatCodec::MAX_ROW || seatsPerRow > SeatCodec::MAX_COLUMN + 1 ||
+        static_cast<long long>(rows) * seatsPerRow > INT_MAX) { // The product bound holds today; kept should the codec widen
+        errorMessage = "At most " + std::to_string(SeatCodec::MAX_ROW) + " rows, " + std::to_string(SeatCodec::MAX_COLUMN + 1) +
+                       " seats per row and " + std::to_string(INT_MAX) + " seats in all.";
+        return false;
+    }
+    return true;
+}
 
 // Constructor
 ReservationSystem::ReservationSystem(std::istream& cin_ref, std::ostream& cout_ref)
-    : m_cin_ptr(&cin_ref), m_cout_ptr(&cout_ref) {
+    : holdEpoch(std::chrono::steady_clock::now()), m_cin_ptr(&cin_ref), m_cout_ptr(&cout_ref) {
     // (*m_cout_ptr) << "ReservationSystem constructor called." << std::endl; // Optional
     initializeSystem(); // Populate with some initial data
 }
@@ -17,6 +55,9 @@ ReservationSystem::ReservationSystem(std::istream& cin_ref, std::ostream& cout_r
 // Destructor
 ReservationSystem::~ReservationSystem() {
     // (*m_cout_ptr) << "ReservationSystem destructor called." << std::endl; // Optional
+    stopCheckpointThread(); // Before any state they touch goes away
+    stopHoldExpiryThread();
+    discardSnapshots();
 }
 
 void ReservationSystem::setInputStreamForTest(std::istream& inputStream) {
@@ -28,10 +69,34 @@ void ReservationSystem::setOutputStreamForTest(std::ostream& outputStream) {
 }
 
 void ReservationSystem::resetSystemForTest() {
+    stopCheckpointThread(); // Would otherwise save the emptied state
+    std::lock_guard<std::mutex> checkpoint(checkpointMutex);
+    wal.reset(); // Flushed and closed: its records describe the state being thrown away
+    std::unique_lock<std::shared_mutex> registry(registryMutex);
+    std::unique_lock<std::shared_mutex> bookingLock(bookingMutex);
+    clearEntities();
+    resetCustomerIdCounterForTest(); 
+}
+
+void ReservationSystem::clearEntities() {
     airplanes.clear();
     customers.clear();
     bookings.clear();
-    resetCustomerIdCounterForTest(); 
+    customerIndex.clear();
+    airplaneIndex.clear();
+    bookingIndex.clear();
+    seatBookings.clear();
+    customerBookings.clear();
+    restoredCustomers.clear();
+    restoredBookings.clear();
+    restoredLogPosition = WriteAheadLog::Position();
+    restoredSnapshot.reset(); // Nothing refers into the mapping any more
+    discardSnapshots();
+    revenueCents = 0;
+    {
+        std::lock_guard<std::mutex> holds(holdMutex);
+        holdTimers.clear(); // Timers of the old bookings; their handles are stale anyway
+    }
 }
 
 void ReservationSystem::resetCustomerIdCounterForTest() {
@@ -39,11 +104,11 @@ void ReservationSystem::resetCustomerIdCounterForTest() {
 }
 
 void ReservationSystem::initializeSystem() {
-    airplanes.emplace_back("FL101", 15, 6); 
-    airplanes.emplace_back("FL202", 20, 6); 
+    addAirplaneRecord("FL101", 15, 6);
+    addAirplaneRecord("FL202", 20, 6);
 
-    customers.emplace_back("Alice Wonderland", 30, generateUniqueCustomerId(), 1500.0);
-    customers.emplace_back("Bob The Builder", 45, generateUniqueCustomerId(), 800.0);
+    addCustomerRecord("Alice Wonderland", 30, generateUniqueCustomerId(), 1500.0);
+    addCustomerRecord("Bob The Builder", 45, generateUniqueCustomerId(), 800.0);
     
     (*m_cout_ptr) << "System initialized with default airplanes and customers." << std::endl;
 }
@@ -54,31 +119,623 @@ std::string ReservationSystem::generateUniqueCustomerId() {
     return oss.str();
 }
 
-Customer* ReservationSystem::findCustomerById(const std::string& customerId) {
-    for (auto& customer : customers) {
-        if (customer.getPersonId() == customerId) {
-            return &customer;
+CustomerHandle ReservationSystem::addCustomerRecord(const std::string& name, int age, const std::string& customerId, double money,
+                                                    WriteAheadLog::Lsn* logged) {
+    std::unique_lock<std::shared_mutex> registry(registryMutex);
+    return addCustomerLocked(name, age, customerId, money, logged);
+}
+
+CustomerHandle ReservationSystem::addCustomerLocked(const std::string& name, int age, const std::string& customerId, double money,
+                                                    WriteAheadLog::Lsn* logged) {
+    CustomerHandle handle = customers.emplace(name, age, customerId, money);
+    customerIndex[customerId] = handle;
+    if (customerBookings.size() <= handle.index()) {
+        customerBookings.resize(handle.index() + 1);
+    }
+    customerBookings[handle.index()].clear(); // The slot may be reused
+    if (logged) { // Before the exclusive lock goes: no booking for this customer can be logged ahead of it
+        *logged = logMutation(WalRecord::addCustomer(customerId, name, age, customers.get(handle)->getBalanceCents()));
+    }
+    return handle;
+}
+
+AirplaneHandle ReservationSystem::addAirplaneRecord(const std::string& flightNumber, int rows, int seatsPerRow) {
+    std::unique_lock<std::shared_mutex> registry(registryMutex);
+    AirplaneHandle handle = airplanes.emplace(flightNumber, rows, seatsPerRow);
+    airplaneIndex[flightNumber] = handle;
+    createSeatBookingRow(handle, airplanes.get(handle)->getCapacity());
+    publishNewFlight(handle);
+    return handle;
+}
+
+void ReservationSystem::createSeatBookingRow(AirplaneHandle airplaneHandle, int capacity) {
+    if (seatBookings.size() <= airplaneHandle.index()) {
+        seatBookings.resize(airplaneHandle.index() + 1);
+    }
+    std::unique_ptr<std::atomic<std::uint32_t>[]> row(new std::atomic<std::uint32_t>[capacity]);
+    for (int i = 0; i < capacity; ++i) {
+        row[i].store(0, std::memory_order_relaxed);
+    }
+    seatBookings[airplaneHandle.index()] = std::move(row);
+}
+
+BookingHandle ReservationSystem::seatBookingAt(AirplaneHandle airplaneHandle, int seatIndex) const {
+    return BookingHandle::fromRaw(seatBookings[airplaneHandle.index()][seatIndex].load(std::memory_order_acquire));
+}
+
+FlightSnapshot::SeatOwner ReservationSystem::seatOwnerAt(AirplaneHandle airplaneHandle, int seatIndex) const {
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    return seatOwnerLocked(seatBookingAt(airplaneHandle, seatIndex));
+}
+
+FlightSnapshot::SeatOwner ReservationSystem::seatOwnerLocked(BookingHandle holder) const {
+    FlightSnapshot::SeatOwner owner;
+    if (const Booking* booking = bookings.get(holder)) {
+        owner.bookingNumber = booking->getBookingNumber();
+        owner.customerId = &customerIdInterner().lookup(booking->getCustomerRef());
+    }
+    return owner;
+}
+
+const FlightSnapshot* ReservationSystem::currentSnapshot(const FlightCell& cell) const {
+    const FlightSnapshot* snapshot = cell.current.load(std::memory_order_seq_cst);
+    if (snapshot) {
+        return snapshot;
+    }
+    // Built from the live seats. If another reader or a writer installs a version first, that one
+    // is used; a writer re-reads its seats onto whichever version it finds, so none is lost.
+    FlightSnapshot::Ptr built;
+    {
+        std::shared_lock<std::shared_mutex> lock(bookingMutex);
+        built = FlightSnapshot::build(*cell.airplane, [&](int seatIndex) {
+            return seatOwnerLocked(BookingHandle::fromRaw(cell.seatBookings[seatIndex].load(std::memory_order_acquire)));
+        });
+    }
+    if (cell.current.compare_exchange_strong(snapshot, built.get(), std::memory_order_seq_cst)) {
+        return built.release();
+    }
+    return snapshot;
+}
+
+void ReservationSystem::publishNewFlight(AirplaneHandle airplaneHandle) {
+    publishNewFlights(&airplaneHandle, 1);
+}
+
+void ReservationSystem::publishNewFlights(const AirplaneHandle* airplaneHandles, std::size_t count) {
+    std::unique_ptr<FleetDirectory> directory(new FleetDirectory());
+    const FleetDirectory* previous = fleet.load(std::memory_order_seq_cst);
+    if (previous) {
+        *directory = *previous;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        AirplaneHandle airplaneHandle = airplaneHandles[i];
+        if (flightCells.size() <= airplaneHandle.index()) {
+            flightCells.resize(airplaneHandle.index() + 1);
+        }
+        std::unique_ptr<FlightCell>& cell = flightCells[airplaneHandle.index()];
+        if (!cell) {
+            cell.reset(new FlightCell());
         }
+        const Airplane& airplane = *airplanes.get(airplaneHandle);
+        cell->airplane = &airplane;
+        cell->seatBookings = seatBookings[airplaneHandle.index()].get();
+        FlightSnapshot::release(cell->current.exchange(FlightSnapshot::build(airplane, [&](int seatIndex) {
+            return seatOwnerAt(airplaneHandle, seatIndex);
+        }).release(), std::memory_order_seq_cst));
+        directory->flights.push_back(cell.get());
+        directory->byNumber[airplane.getFlightNumber()] = cell.get();
+    }
+
+    // New directory version; the old one is reclaimed once no reader can still be walking it
+    fleet.store(directory.release(), std::memory_order_seq_cst);
+    if (previous) {
+        EpochDomain::global().retire(previous);
     }
-    return nullptr;
 }
 
-Airplane* ReservationSystem::findAirplaneByFlightNumber(const std::string& flightNumber) {
-    for (auto& airplane : airplanes) {
-        if (airplane.getFlightNumber() == flightNumber) {
-            return &airplane;
+void ReservationSystem::publishSeats(AirplaneHandle airplaneHandle, std::initializer_list<int> seatIndexes) {
+    FlightCell& cell = *flightCells[airplaneHandle.index()];
+    const Airplane& airplane = *airplanes.get(airplaneHandle);
+    EpochDomain::Guard guard; // Keeps the base version (and so its address) alive across the CAS
+    const FlightSnapshot* base = currentSnapshot(cell);
+    FlightSnapshot::SeatUpdate updates[2];
+    for (;;) {
+        // The live seats are re-read after every (re)load of base, so whichever version wins the
+        // CAS last reflects the latest state even when bookings publish out of order
+        int count = 0;
+        for (int seatIndex : seatIndexes) {
+            if (count == 2) break;
+            updates[count++] = {seatIndex, airplane.isSeatBooked(seatIndex), seatOwnerAt(airplaneHandle, seatIndex)};
+        }
+        FlightSnapshot::Ptr next = base->withSeats(updates, count);
+        if (cell.current.compare_exchange_weak(base, next.get(), std::memory_order_seq_cst)) {
+            next.release();
+            EpochDomain::global().retire(const_cast<FlightSnapshot*>(base), &FlightSnapshot::recycle);
+            return;
+        }
+    }
+}
+
+Cents ReservationSystem::getRevenueCents() const {
+    return revenueCents.load(std::memory_order_acquire);
+}
+
+void ReservationSystem::publishPrices(AirplaneHandle airplaneHandle) {
+    FlightCell& cell = *flightCells[airplaneHandle.index()];
+    const Airplane& airplane = *airplanes.get(airplaneHandle);
+    EpochDomain::Guard guard;
+    const FlightSnapshot* base = currentSnapshot(cell);
+    for (;;) {
+        FlightSnapshot::Ptr next = base->withPrices(airplane);
+        if (cell.current.compare_exchange_weak(base, next.get(), std::memory_order_seq_cst)) {
+            next.release();
+            EpochDomain::global().retire(const_cast<FlightSnapshot*>(base), &FlightSnapshot::recycle);
+            return;
+        }
+    }
+}
+
+void ReservationSystem::publishFlight(AirplaneHandle airplaneHandle) {
+    FlightCell& cell = *flightCells[airplaneHandle.index()];
+    const Airplane& airplane = *airplanes.get(airplaneHandle);
+    EpochDomain::Guard guard;
+    const FlightSnapshot* base = currentSnapshot(cell);
+    for (;;) {
+        // Rebuilt after every failed CAS for the same reason publishSeats re-reads its seats
+        FlightSnapshot::Ptr next = FlightSnapshot::build(airplane, [&](int seatIndex) {
+            return seatOwnerAt(airplaneHandle, seatIndex);
+        }, base->version() + 1);
+        if (cell.current.compare_exchange_weak(base, next.get(), std::memory_order_seq_cst)) {
+            next.release();
+            EpochDomain::global().retire(const_cast<FlightSnapshot*>(base), &FlightSnapshot::recycle);
+            return;
         }
     }
-    return nullptr;
+}
+
+bool ReservationSystem::setSeatPrice(const std::string& flightNumber, int seatIndex, double price, std::string& errorMessage) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    AirplaneHandle airplaneHandle = airplaneHandleOf(flightNumber);
+    Airplane* airplane = airplanes.get(airplaneHandle);
+    if (!airplane) {
+        errorMessage = "Flight " + flightNumber + " not found.";
+        return false;
+    }
+    WriteAheadLog::Lsn lsn = 0;
+    {
+        std::lock_guard<std::mutex> flight(flightLocks.forSlot(airplaneHandle.index()));
+        preserveFares(airplaneHandle, *airplane); // Before the change, like every other fare write
+        if (!airplane->setSeatPrice(seatIndex, price)) {
+            errorMessage = "Invalid seat or negative price.";
+            return false;
+        }
+        lsn = logFares(*airplane, seatIndex, seatIndex + 1);
+    }
+    publishPrices(airplaneHandle);
+    registry.unlock();
+    return awaitLogged(lsn, errorMessage);
+}
+
+bool ReservationSystem::repriceFlightInternal(const std::string& flightNumber, const std::function<double(const Airplane&, int)>& priceOf,
+                                              std::size_t& changedCount, std::string& errorMessage) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    AirplaneHandle airplaneHandle = airplaneHandleOf(flightNumber);
+    if (!airplanes.get(airplaneHandle)) {
+        errorMessage = "Flight " + flightNumber + " not found.";
+        return false;
+    }
+    WriteAheadLog::Lsn lsn = 0;
+    changedCount = repriceFlight(airplaneHandle, priceOf, lsn);
+    registry.unlock();
+    return awaitLogged(lsn, errorMessage);
+}
+
+WriteAheadLog::Lsn ReservationSystem::logFares(const Airplane& airplane, int firstSeatIndex, int endSeatIndex) {
+    if (!wal) return 0;
+    WriteAheadLog::Lsn lsn = 0;
+    for (int first = firstSeatIndex; first < endSeatIndex; first += static_cast<int>(WalRecord::MAX_FARES)) {
+        int end = std::min(endSeatIndex, first + static_cast<int>(WalRecord::MAX_FARES));
+        std::vector<double> fares;
+        fares.reserve(static_cast<std::size_t>(end - first));
+        for (int seatIndex = first; seatIndex < end; ++seatIndex) {
+            fares.push_back(airplane.getSeatPrice(seatIndex));
+        }
+        lsn = logMutation(WalRecord::setFares(airplane.getFlightNumber(), first, std::move(fares)));
+    }
+    return lsn;
+}
+
+void ReservationSystem::discardSnapshots() {
+    for (std::unique_ptr<FlightCell>& cell : flightCells) {
+        if (cell) {
+            FlightSnapshot::release(cell->current.exchange(nullptr));
+        }
+    }
+    flightCells.clear();
+    delete fleet.exchange(nullptr);
+}
+
+std::vector<AirplaneHandle> ReservationSystem::listAirplaneHandles() const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    std::vector<AirplaneHandle> handles;
+    handles.reserve(airplanes.size());
+    for (auto it = airplanes.begin(); it != airplanes.end(); ++it) {
+        handles.push_back(it.handle());
+    }
+    return handles;
+}
+
+CustomerHandle ReservationSystem::customerHandleOf(const std::string& customerId) const {
+    auto it = customerIndex.find(customerId);
+    CustomerHandle handle;
+    if (it != customerIndex.end()) {
+        handle = it->second;
+    } else if (restoredSnapshot) {
+        long row = restoredSnapshot->findCustomer(customerId);
+        handle = row < 0 ? CustomerHandle() : restoredCustomers[row];
+    }
+    // Stale handles (e.g. after the map was cleared) fail the generation check in the slot map
+    return customers.contains(handle) ? handle : CustomerHandle();
+}
+
+AirplaneHandle ReservationSystem::airplaneHandleOf(const std::string& flightNumber) const {
+    auto it = airplaneIndex.find(flightNumber);
+    if (it == airplaneIndex.end() || !airplanes.contains(it->second)) {
+        return AirplaneHandle();
+    }
+    return it->second;
+}
+
+BookingHandle ReservationSystem::bookingHandleOf(const std::string& bookingId) const {
+    std::uint64_t bookingNumber;
+    if (!Booking::parseBookingId(bookingId, bookingNumber)) {
+        return BookingHandle();
+    }
+    return bookingHandleOf(bookingNumber);
+}
+
+BookingHandle ReservationSystem::bookingHandleOf(std::uint64_t bookingNumber) const {
+    auto it = bookingIndex.find(bookingNumber);
+    BookingHandle handle;
+    if (it != bookingIndex.end()) {
+        handle = it->second;
+    } else if (restoredSnapshot) {
+        long row = restoredSnapshot->findBooking(bookingNumber);
+        handle = row < 0 ? BookingHandle() : restoredBookings[row];
+    }
+    return bookings.contains(handle) ? handle : BookingHandle();
+}
+
+CustomerHandle ReservationSystem::findCustomerHandle(const std::string& customerId) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    return customerHandleOf(customerId);
+}
+
+AirplaneHandle ReservationSystem::findAirplaneHandle(const std::string& flightNumber) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    return airplaneHandleOf(flightNumber);
+}
+
+BookingHandle ReservationSystem::findBookingHandle(const std::string& bookingId) const {
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    return bookingHandleOf(bookingId);
+}
+
+Customer* ReservationSystem::getCustomer(CustomerHandle handle) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    return customers.get(handle);
+}
+
+Airplane* ReservationSystem::getAirplane(AirplaneHandle handle) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    return airplanes.get(handle);
+}
+
+Booking* ReservationSystem::getBooking(BookingHandle handle) {
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    return bookings.get(handle);
+}
+
+const Customer* ReservationSystem::getCustomer(CustomerHandle handle) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    return customers.get(handle);
+}
+
+const Airplane* ReservationSystem::getAirplane(AirplaneHandle handle) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    return airplanes.get(handle);
+}
+
+const Booking* ReservationSystem::getBooking(BookingHandle handle) const {
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    return bookings.get(handle);
+}
+
+BookingHandle ReservationSystem::addBookingRecord(CustomerHandle customerHandle, AirplaneHandle airplaneHandle, int seatIndex, Cents paidCents,
+                                                  BookingStatus status, std::uint64_t bookingNumber) {
+    const Customer& customer = *customers.get(customerHandle);
+    const Airplane& airplane = *airplanes.get(airplaneHandle);
+    InternedId customerRef = customerIdInterner().intern(customer.getPersonId());
+    InternedId flightRef = flightNumberInterner().intern(airplane.getFlightNumber());
+    // Everything that can throw happens before the booking becomes visible, so a failed append
+    // leaves no trace and the caller's BookingTransaction can roll back cleanly
+    std::vector<BookingHandle>& customerList = customerBookings[customerHandle.index()];
+    if (customerList.size() == customerList.capacity()) {
+        customerList.reserve(std::max<std::size_t>(4, customerList.capacity() * 2)); // Same growth push_back would use
+    }
+    BookingHandle handle;
+    {
+        std::unique_lock<std::shared_mutex> lock(bookingMutex);
+        handle = bookingNumber ? bookings.emplace(bookingNumber, customerRef, flightRef, airplane.getSeatKey(seatIndex))
+                               : bookings.emplace(customerRef, flightRef, airplane.getSeatKey(seatIndex));
+        bookingCapture.preserve(handle.index(), []() { return BookingImage(); }); // A reused slot was empty at the cut
+        Booking& booking = *bookings.get(handle);
+        try {
+            bookingIndex[booking.getBookingNumber()] = handle;
+        } catch (...) {
+            bookings.erase(handle);
+            throw;
+        }
+        booking.setPaidCents(paidCents);
+        booking.setStatus(status);
+    }
+    seatBookings[airplaneHandle.index()][seatIndex].store(handle.raw(), std::memory_order_release);
+    customerList.push_back(handle); // Capacity reserved above: cannot throw
+    return handle;
+}
+
+Cents ReservationSystem::refundBooking(Booking& booking, Customer& customer) {
+    Cents refund = booking.getPaidCents();
+    customer.creditCents(refund);
+    revenueCents.fetch_sub(refund, std::memory_order_acq_rel);
+    return refund;
+}
+
+bool ReservationSystem::finishHold(BookingHandle bookingHandle, HoldOutcome outcome, std::string& errorMessage, WriteAheadLog::Lsn* logged) {
+    Booking* booking = getBooking(bookingHandle);
+    if (!booking) {
+        errorMessage = "Hold not found.";
+        return false;
+    }
+    CustomerHandle customerHandle = customerHandleOf(booking->getCustomerId());
+    AirplaneHandle airplaneHandle = airplaneHandleOf(booking->getFlightNumber());
+    Customer* customer = customers.get(customerHandle);
+    Airplane* airplane = airplanes.get(airplaneHandle);
+    if (!customer || !airplane) {
+        errorMessage = "Error: Could not find customer or airplane associated with this hold.";
+        return false;
+    }
+
+    // Confirm, release, cancel and expiry all re-check the status under these shards, so exactly one wins.
+    // Swaps only move CONFIRMED bookings, so a flight shard taken for a PENDING one is never stale.
+    ShardLockGuard shards(flightLocks, {airplaneHandle.index()}, customerLocks, {customerHandle.index()});
+    if (booking->getStatus() != BookingStatus::PENDING) {
+        errorMessage.assign("Booking ").append(booking->getBookingId()).append(" is not an active hold.");
+        return false;
+    }
+    int seatIndex = airplane->seatIndexOf(booking->getSeatKey());
+    preserveBooking(bookingHandle, *booking);
+    if (outcome == HoldOutcome::CONFIRM) {
+        preserveBalance(customerHandle, *customer);
+        Cents fare = toCents(airplane->getSeatPrice(seatIndex));
+        if (fare > 0 && !customer->tryDebitCents(fare)) {
+            errorMessage = "Insufficient funds."; // The hold stays until it is released or runs out
+            return false;
+        }
+        // Logged as a plain booking: the hold itself was never logged
+        WriteAheadLog::Lsn lsn = logMutation(WalRecord::book(booking->getBookingNumber(), customer->getPersonId(),
+                                                             airplane->getFlightNumber(), seatIndex, fare));
+        if (logged) *logged = lsn;
+        booking->setPaidCents(fare);
+        revenueCents.fetch_add(fare, std::memory_order_acq_rel);
+        booking->setStatus(BookingStatus::CONFIRMED);
+        errorMessage.assign("Hold ").append(booking->getBookingId()).append(" confirmed.");
+        return true;
+    }
+    booking->setStatus(BookingStatus::CANCELLED);
+    releaseSeatBooking(bookingHandle);
+    airplane->unbookSeatAt(seatIndex);
+    publishSeats(airplaneHandle, {seatIndex});
+    errorMessage.assign("Hold ").append(booking->getBookingId()).append(" released.");
+    return true;
+}
+
+std::uint64_t ReservationSystem::holdTickOf(std::chrono::steady_clock::time_point time) const {
+    if (time <= holdEpoch) return 0;
+    return static_cast<std::uint64_t>((time - holdEpoch) / HOLD_TICK);
+}
+
+void ReservationSystem::scheduleHoldExpiry(BookingHandle booking, std::chrono::steady_clock::time_point deadline) {
+    std::lock_guard<std::mutex> lock(holdMutex);
+    if (!holdExpiryThread.joinable()) {
+        holdExpiryThread = std::thread(&ReservationSystem::runHoldExpiry, this);
+    }
+    holdTimers.schedule(holdTickOf(deadline) + 1, booking.raw()); // At most one tick late, never early
+    if (holdTimers.size() == 1) {
+        holdWakeup.notify_one(); // The thread sleeps without a timeout while the wheel is empty
+    }
+}
+
+void ReservationSystem::runHoldExpiry() {
+    std::unique_lock<std::mutex> lock(holdMutex);
+    while (!stopHoldExpiry) {
+        if (holdTimers.size() == 0) {
+            holdWakeup.wait(lock);
+            continue;
+        }
+        holdWakeup.wait_for(lock, HOLD_TICK);
+        if (stopHoldExpiry) break;
+        lock.unlock(); // expireHolds takes holdMutex itself, then the registry and shard locks
+        expireHolds(std::chrono::steady_clock::now());
+        lock.lock();
+    }
+}
+
+void ReservationSystem::stopHoldExpiryThread() {
+    {
+        std::lock_guard<std::mutex> lock(holdMutex);
+        stopHoldExpiry = true;
+    }
+    holdWakeup.notify_all();
+    if (holdExpiryThread.joinable()) {
+        holdExpiryThread.join();
+    }
+}
+
+std::size_t ReservationSystem::expireHolds(std::chrono::steady_clock::time_point now) {
+    std::vector<std::uint64_t> due;
+    {
+        std::lock_guard<std::mutex> lock(holdMutex);
+        holdTimers.advanceTo(holdTickOf(now), due);
+    }
+    if (due.empty()) return 0;
+
+    std::size_t released = 0;
+    std::string message;
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    for (std::uint64_t raw : due) {
+        // Holds already confirmed, released or cancelled are simply skipped
+        released += finishHold(BookingHandle::fromRaw(static_cast<std::uint32_t>(raw)), HoldOutcome::RELEASE, message);
+    }
+    return released;
+}
+
+void ReservationSystem::releaseSeatBooking(BookingHandle bookingHandle) {
+    const Booking* booking = getBooking(bookingHandle);
+    if (!booking) return;
+    AirplaneHandle airplaneHandle = airplaneHandleOf(booking->getFlightNumber());
+    if (!airplaneHandle) return;
+    int seatIndex = airplanes.get(airplaneHandle)->seatIndexOf(booking->getSeatKey());
+    if (seatIndex < 0) return;
+    // Only clears the entry if it still names this booking; must run before the seat is released
+    std::uint32_t expected = bookingHandle.raw();
+    seatBookings[airplaneHandle.index()][seatIndex].compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+}
+
+void ReservationSystem::swapSeatBookings(BookingHandle handle1, AirplaneHandle airplaneHandle1, int seatIndex1,
+                                         BookingHandle handle2, AirplaneHandle airplaneHandle2, int seatIndex2) {
+    Booking* booking1 = getBooking(handle1);
+    Booking* booking2 = getBooking(handle2);
+    if (!booking1 || !booking2) return;
+    InternedId flightRef1 = booking1->getFlightRef();
+    SeatKey seatKey1 = booking1->getSeatKey();
+    booking1->setFlightRef(booking2->getFlightRef());
+    booking1->setSeatKey(booking2->getSeatKey());
+    booking2->setFlightRef(flightRef1);
+    booking2->setSeatKey(seatKey1);
+
+    // Both seats stay claimed throughout, so no booking thread writes these entries meanwhile
+    std::atomic<std::uint32_t>& entry1 = seatBookings[airplaneHandle1.index()][seatIndex1];
+    std::atomic<std::uint32_t>& entry2 = seatBookings[airplaneHandle2.index()][seatIndex2];
+    std::uint32_t raw1 = entry1.load(std::memory_order_relaxed);
+    entry1.store(entry2.load(std::memory_order_relaxed), std::memory_order_release);
+    entry2.store(raw1, std::memory_order_release);
+}
+
+void ReservationSystem::lockBookingShards(ShardLockGuard& shards, const Booking& first, const Booking* second,
+                                          std::initializer_list<std::uint32_t> customerSlots) {
+    for (;;) {
+        InternedId flightRef1 = first.getFlightRef();
+        InternedId flightRef2 = second ? second->getFlightRef() : flightRef1;
+        // Moving a booking takes both flights' shards, so a flight re-read under its shard is final
+        shards.lock(flightLocks, {airplaneHandleOf(flightNumberInterner().lookup(flightRef1)).index(),
+                                  airplaneHandleOf(flightNumberInterner().lookup(flightRef2)).index()},
+                    customerLocks, customerSlots);
+        if (first.getFlightRef() == flightRef1 && (!second || second->getFlightRef() == flightRef2)) {
+            return;
+        }
+        shards.unlock();
+    }
+}
+
+Customer* ReservationSystem::findCustomerById(const std::string& customerId) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    return customers.get(customerHandleOf(customerId));
+}
+
+Airplane* ReservationSystem::findAirplaneByFlightNumber(const std::string& flightNumber) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    return airplanes.get(airplaneHandleOf(flightNumber));
 }
 
 Booking* ReservationSystem::findBookingById(const std::string& bookingId) {
-    for (auto& booking : bookings) {
-        if (booking.getBookingId() == bookingId) {
-            return &booking;
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    return bookings.get(bookingHandleOf(bookingId));
+}
+
+Booking* ReservationSystem::findBookingForSeat(const std::string& flightNumber, const std::string& seatId) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    AirplaneHandle airplaneHandle = airplaneHandleOf(flightNumber);
+    if (!airplaneHandle) return nullptr;
+    int seatIndex = airplanes.get(airplaneHandle)->seatIndexOf(seatId);
+    if (seatIndex < 0) return nullptr;
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    return bookings.get(seatBookingAt(airplaneHandle, seatIndex));
+}
+
+void ReservationSystem::collectSeatBookings(AirplaneHandle airplaneHandle, std::vector<const Booking*>& out) const {
+    const int capacity = airplanes.get(airplaneHandle)->getCapacity();
+    out.clear();
+    out.reserve(capacity);
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    for (int seatIndex = 0; seatIndex < capacity; ++seatIndex) {
+        out.push_back(bookings.get(seatBookingAt(airplaneHandle, seatIndex))); // nullptr for free seats
+    }
+}
+
+template<typename Fn>
+void ReservationSystem::forEachCustomerBookingHandle(CustomerHandle customerHandle, Fn fn) const {
+    const std::uint32_t slot = customerHandle.index();
+    if (slot < restoredCustomers.size() && restoredCustomers[slot] == customerHandle) {
+        const SnapshotFile::CustomerRow& row = restoredSnapshot->customers()[slot];
+        const std::uint32_t* rows = restoredSnapshot->customerBookings() + row.firstBooking;
+        for (std::uint32_t i = 0; i < row.bookingCount; ++i) {
+            fn(restoredBookings[rows[i]]);
         }
     }
-    return nullptr;
+    for (BookingHandle bookingHandle : customerBookings[slot]) {
+        fn(bookingHandle);
+    }
+}
+
+void ReservationSystem::collectCustomerBookings(CustomerHandle customerHandle, std::vector<const Booking*>& out) const {
+    out.clear();
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    forEachCustomerBookingHandle(customerHandle, [&](BookingHandle bookingHandle) {
+        if (const Booking* booking = bookings.get(bookingHandle)) {
+            out.push_back(booking);
+        }
+    });
+}
+
+std::vector<const Booking*> ReservationSystem::getSeatBookings(const std::string& flightNumber) const {
+    std::vector<const Booking*> result;
+    getSeatBookings(flightNumber, result);
+    return result;
+}
+
+void ReservationSystem::getSeatBookings(const std::string& flightNumber, std::vector<const Booking*>& out) const {
+    visitFlight(flightNumber, out, [](const Airplane&, const std::vector<const Booking*>&) {});
+}
+
+std::vector<const Booking*> ReservationSystem::getBookingsForCustomer(const std::string& customerId) const {
+    std::vector<const Booking*> result;
+    visitCustomer(customerId, [&result](const Customer&, const std::vector<const Booking*>& customerBookingList) {
+        result = customerBookingList;
+    });
+    return result;
+}
+
+std::vector<const Booking*> ReservationSystem::getBookingsForCustomer(const std::string& customerId, BookingStatus status) const {
+    std::vector<const Booking*> result;
+    visitCustomer(customerId, [&result, status](const Customer&, const std::vector<const Booking*>& customerBookingList) {
+        for (const Booking* booking : customerBookingList) {
+            if (booking->getStatus() == status) {
+                result.push_back(booking);
+            }
+        }
+    });
+    return result;
 }
 
 void ReservationSystem::displayMainMenu() const {
@@ -181,7 +838,7 @@ void ReservationSystem::handleAddCustomer() {
         return;
     }
     
-    customers.emplace_back(name, age, newId, money);
+    addCustomerRecord(name, age, newId, money);
     (*m_cout_ptr) << "Customer " << name << " with ID " << newId << " added successfully." << std::endl;
 }
 
@@ -197,7 +854,8 @@ void ReservationSystem::handleBookSeat() {
     }
 
     std::string custId = getValidatedInput<std::string>("Enter Customer ID: ");
-    Customer* customer = findCustomerById(custId);
+    CustomerHandle customerHandle = findCustomerHandle(custId);
+    Customer* customer = customers.get(customerHandle);
     if (!customer) {
         (*m_cout_ptr) << "Customer with ID " << custId << " not found." << std::endl;
         return;
@@ -205,11 +863,12 @@ void ReservationSystem::handleBookSeat() {
     // customer->displayDetails(); // Uses std::cout, need to pass m_cout_ptr or refactor
 
     (*m_cout_ptr) << "\nAvailable Flights:" << std::endl;
-    for (size_t i = 0; i < airplanes.size(); ++i) {
-        (*m_cout_ptr) << i + 1 << ". Flight " << airplanes[i].getFlightNumber() << std::endl;
+    std::vector<AirplaneHandle> flights = listAirplaneHandles();
+    for (size_t i = 0; i < flights.size(); ++i) {
+        (*m_cout_ptr) << i + 1 << ". Flight " << airplanes.get(flights[i])->getFlightNumber() << std::endl;
     }
-    int flightChoice = getMenuChoice(1, airplanes.size()) -1; 
-    Airplane* airplane = &airplanes[flightChoice];
+    int flightChoice = getMenuChoice(1, flights.size()) -1; 
+    Airplane* airplane = airplanes.get(flights[flightChoice]);
     
     (*m_cout_ptr) << "Selected Flight: " << airplane->getFlightNumber() << std::endl;
     // airplane->displaySeatingMap(); // Uses std::cout
@@ -231,16 +890,18 @@ void ReservationSystem::handleBookSeat() {
     if (customer->getMoney() >= seat->getPrice()) {
         char confirm = getValidatedInput<char>("Confirm booking? (y/n): ");
         if (confirm == 'y' || confirm == 'Y') {
-            if (customer->chargeMoney(seat->getPrice())) {
-                if (airplane->bookSpecificSeat(seatIdToBook)) {
-                    bookings.emplace_back(customer->getPersonId(), airplane->getFlightNumber(), seat->getSeatId());
-                    bookings.back().setStatus(BookingStatus::CONFIRMED); 
-                    (*m_cout_ptr) << "Booking successful! Booking ID: " << bookings.back().getBookingId() << std::endl;
-                    // customer->displayDetails(); 
-                } else {
-                    (*m_cout_ptr) << "Booking failed internally (airplane could not book seat)." << std::endl;
-                    customer->addMoney(seat->getPrice()); 
-                }
+            int seatIndex = airplane->seatIndexOf(seatIdToBook);
+            preserveBalance(customerHandle, *customer);
+            BookingTransaction transaction(*airplane, seatIndex, *customer, revenueCents);
+            BookingTransaction::Status status = transaction.prepare();
+            if (status == BookingTransaction::Status::READY) {
+                BookingHandle booking = addBookingRecord(customerHandle, flights[flightChoice], seatIndex, transaction.getPriceCents());
+                transaction.commit();
+                publishSeats(flights[flightChoice], {seatIndex});
+                (*m_cout_ptr) << "Booking successful! Booking ID: " << bookings.get(booking)->getBookingId() << std::endl;
+                // customer->displayDetails(); 
+            } else if (status == BookingTransaction::Status::SEAT_TAKEN) {
+                (*m_cout_ptr) << "Booking failed internally (airplane could not book seat)." << std::endl;
             } else {
                  (*m_cout_ptr) << "Booking failed (could not charge customer - unexpected)." << std::endl;
             }
@@ -267,11 +928,12 @@ void ReservationSystem::handleViewFlightDetails() {
         return;
     }
     (*m_cout_ptr) << "Available Flights:" << std::endl;
-    for (size_t i = 0; i < airplanes.size(); ++i) {
-        (*m_cout_ptr) << i + 1 << ". Flight " << airplanes[i].getFlightNumber() << std::endl;
+    std::vector<AirplaneHandle> flights = listAirplaneHandles();
+    for (size_t i = 0; i < flights.size(); ++i) {
+        (*m_cout_ptr) << i + 1 << ". Flight " << airplanes.get(flights[i])->getFlightNumber() << std::endl;
     }
-    int flightChoice = getMenuChoice(1, airplanes.size()) - 1; 
-    Airplane* airplane = &airplanes[flightChoice];
+    int flightChoice = getMenuChoice(1, flights.size()) - 1; 
+    Airplane* airplane = airplanes.get(flights[flightChoice]);
     (void)airplane; // Mark as used
 
     // airplane->displaySeatingMap(); 
@@ -289,14 +951,12 @@ void ReservationSystem::handleSearchCustomer() {
     if (customer) {
         // customer->displayDetails(); 
         (*m_cout_ptr) << "Bookings for " << customer->getName() << ":" << std::endl;
-        bool foundBookings = false;
-        for(const auto& booking : bookings) {
-            if (booking.getCustomerId() == customer->getPersonId() && booking.getStatus() == BookingStatus::CONFIRMED) {
-                // booking.displayBookingDetails(); 
-                foundBookings = true;
-            }
+        std::vector<const Booking*> activeBookings = getBookingsForCustomer(id, BookingStatus::CONFIRMED);
+        for (const Booking* booking : activeBookings) {
+            (void)booking; // Mark as used
+            // booking->displayBookingDetails(); 
         }
-        if (!foundBookings) {
+        if (activeBookings.empty()) {
             (*m_cout_ptr) << "No active bookings found for this customer." << std::endl;
         }
     } else {
@@ -311,7 +971,8 @@ void ReservationSystem::handleCancelBooking() {
         return;
     }
     std::string bookingIdToCancel = getValidatedInput<std::string>("Enter Booking ID to cancel: ");
-    Booking* booking = findBookingById(bookingIdToCancel);
+    BookingHandle bookingHandle = findBookingHandle(bookingIdToCancel);
+    Booking* booking = bookings.get(bookingHandle);
 
     if (!booking) {
         (*m_cout_ptr) << "Booking with ID " << bookingIdToCancel << " not found." << std::endl;
@@ -327,12 +988,15 @@ void ReservationSystem::handleCancelBooking() {
     if (confirm == 'y' || confirm == 'Y') {
         Customer* customer = findCustomerById(booking->getCustomerId());
         Airplane* airplane = findAirplaneByFlightNumber(booking->getFlightNumber());
-        Seat* seat = airplane ? airplane->findSeat(booking->getSeatId()) : nullptr;
+        Seat* seat = airplane ? airplane->findSeat(booking->getSeatKey()) : nullptr;
 
         if (customer && airplane && seat) {
-            double refundAmount = seat->getPrice(); 
-            customer->addMoney(refundAmount);
+            preserveBooking(bookingHandle, *booking);
+            preserveBalance(customerHandleOf(booking->getCustomerId()), *customer);
+            double refundAmount = toDollars(refundBooking(*booking, *customer));
+            releaseSeatBooking(bookingHandle);
             airplane->unbookSpecificSeat(seat->getSeatId());
+            publishSeats(findAirplaneHandle(booking->getFlightNumber()), {airplane->seatIndexOf(booking->getSeatKey())});
             booking->setStatus(BookingStatus::CANCELLED);
             (*m_cout_ptr) << "Booking " << bookingIdToCancel << " cancelled successfully. $" << refundAmount << " refunded to customer " << customer->getName() << "." << std::endl;
         } else {
@@ -350,26 +1014,27 @@ void ReservationSystem::handleSwapSeats() {
         return;
     }
     std::string bookingId1_str = getValidatedInput<std::string>("Enter Booking ID of the first customer: ");
-    Booking* booking1 = findBookingById(bookingId1_str);
+    BookingHandle bookingHandle1 = findBookingHandle(bookingId1_str);
+    Booking* booking1 = bookings.get(bookingHandle1);
     if (!booking1 || booking1->getStatus() != BookingStatus::CONFIRMED) {
         (*m_cout_ptr) << "First booking ID not found or not confirmed." << std::endl;
         return;
     }
     std::string bookingId2_str = getValidatedInput<std::string>("Enter Booking ID of the second customer: ");
-    Booking* booking2 = findBookingById(bookingId2_str);
+    BookingHandle bookingHandle2 = findBookingHandle(bookingId2_str);
+    Booking* booking2 = bookings.get(bookingHandle2);
     if (!booking2 || booking2->getStatus() != BookingStatus::CONFIRMED) {
         (*m_cout_ptr) << "Second booking ID not found or not confirmed." << std::endl;
         return;
     }
-    if (booking1->getBookingId() == booking2->getBookingId()) {
+    if (booking1->getBookingNumber() == booking2->getBookingNumber()) {
         (*m_cout_ptr) << "Cannot swap a booking with itself." << std::endl;
         return;
     }
-    if (booking1->getFlightNumber() != booking2->getFlightNumber()) {
-        (*m_cout_ptr) << "Seat swaps are currently only supported for bookings on the same flight." << std::endl;
+    if (booking1->getFlightRef() != booking2->getFlightRef()) {
         (*m_cout_ptr) << "Booking 1 is for flight " << booking1->getFlightNumber() 
-                  << ", Booking 2 is for flight " << booking2->getFlightNumber() << std::endl;
-        return;
+                  << ", Booking 2 is for flight " << booking2->getFlightNumber()
+                  << ": the bookings will exchange flights, and each pays its new seat's fare." << std::endl;
     }
     (*m_cout_ptr) << "\nBooking 1 Details:" << std::endl;
     // booking1->displayBookingDetails(); 
@@ -385,13 +1050,14 @@ void ReservationSystem::handleSwapSeats() {
 
     char confirm = getValidatedInput<char>("\nConfirm swap of these two seats? (y/n): ");
     if (confirm == 'y' || confirm == 'Y') {
-        std::string seatId_cust1 = booking1->getSeatId();
-        std::string seatId_cust2 = booking2->getSeatId();
-        
-        booking1->setSeatId(seatId_cust2);
-        booking2->setSeatId(seatId_cust1);
+        std::string swapMessage;
+        if (!swapSeatsInternal(bookingId1_str, bookingId2_str, swapMessage)) {
+            (*m_cout_ptr) << "Seat swap failed: " << swapMessage << std::endl;
+            return;
+        }
 
         (*m_cout_ptr) << "\nSeat swap completed successfully!" << std::endl;
+        (*m_cout_ptr) << swapMessage << std::endl;
         (*m_cout_ptr) << "New Booking Details:" << std::endl;
         (*m_cout_ptr) << "--- For Booking ID " << booking1->getBookingId() << " (Customer " << booking1->getCustomerId() << "):" << std::endl;
         // booking1->displayBookingDetails(); 
@@ -435,8 +1101,13 @@ void ReservationSystem::handleAddAirplane() {
     }
     int rows = getValidatedInput<int>("Enter number of rows: ");
     int seatsPerRow = getValidatedInput<int>("Enter seats per row: ");
+    std::string sizeError;
+    if (!checkAirplaneSize(rows, seatsPerRow, sizeError)) {
+        (*m_cout_ptr) << sizeError << std::endl;
+        return;
+    }
 
-    airplanes.emplace_back(flightNum, rows, seatsPerRow);
+    addAirplaneRecord(flightNum, rows, seatsPerRow);
     (*m_cout_ptr) << "Airplane " << flightNum << " added successfully." << std::endl;
 }
 
@@ -468,81 +1139,159 @@ Customer* ReservationSystem::addCustomerInternal(const std::string& name_param,
         }
     }
     
-    customers.emplace_back(name, age, newId, money);
-    return &customers.back(); // Return pointer to the newly added customer
+    WriteAheadLog::Lsn lsn = 0;
+    CustomerHandle handle = addCustomerRecord(name, age, newId, money, &lsn);
+    std::string logError;
+    if (!awaitLogged(lsn, logError)) {
+        return nullptr;
+    }
+    return getCustomer(handle); // Stays valid as more customers are added
+}
+
+Airplane* ReservationSystem::addAirplaneInternal(const std::string& flightNumber, int rows, int seatsPerRow, std::string& errorMessage) {
+    if (!checkAirplaneSize(rows, seatsPerRow, errorMessage)) {
+        return nullptr;
+    }
+    AirplaneHandle handle;
+    WriteAheadLog::Lsn lsn;
+    {
+        // Check and insert under one exclusive lock so two callers cannot add the same flight
+        std::unique_lock<std::shared_mutex> registry(registryMutex);
+        if (airplaneHandleOf(flightNumber)) {
+            errorMessage = "Airplane with flight number " + flightNumber + " already exists.";
+            return nullptr;
+        }
+        handle = airplanes.emplace(flightNumber, rows, seatsPerRow);
+        airplaneIndex[flightNumber] = handle;
+        createSeatBookingRow(handle, airplanes.get(handle)->getCapacity());
+        publishNewFlight(handle);
+        lsn = logMutation(WalRecord::addAirplane(flightNumber, rows, seatsPerRow));
+    }
+    errorMessage = "Airplane added successfully.";
+    if (!awaitLogged(lsn, errorMessage)) {
+        return nullptr;
+    }
+    return getAirplane(handle);
 }
 
 Booking* ReservationSystem::createBookingInternal(const std::string& customerId, const std::string& flightNumber, const std::string& seatId, std::string& errorMessage) {
-    Customer* customer = findCustomerById(customerId);
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    WriteAheadLog::Lsn lsn = 0;
+    BookingHandle booking = bookSeatLocked(customerId, flightNumber, seatId, lsn, errorMessage);
+    if (!booking) {
+        return nullptr;
+    }
+    registry.unlock();
+    errorMessage = "Booking successful.";
+    if (!awaitLogged(lsn, errorMessage)) {
+        return nullptr;
+    }
+    return getBooking(booking); // Stays valid as more bookings are added
+}
+
+BookingHandle ReservationSystem::bookSeatLocked(const std::string& customerId, const std::string& flightNumber, const std::string& seatId,
+                                                WriteAheadLog::Lsn& lsn, std::string& errorMessage) {
+    CustomerHandle customerHandle = customerHandleOf(customerId);
+    Customer* customer = customers.get(customerHandle);
     if (!customer) {
         errorMessage = "Customer not found.";
-        return nullptr;
+        return BookingHandle();
     }
 
-    Airplane* airplane = findAirplaneByFlightNumber(flightNumber);
+    AirplaneHandle airplaneHandle = airplaneHandleOf(flightNumber);
+    Airplane* airplane = airplanes.get(airplaneHandle);
     if (!airplane) {
         errorMessage = "Airplane not found.";
-        return nullptr;
+        return BookingHandle();
     }
 
-    Seat* seat = airplane->findSeat(seatId);
-    if (!seat) {
+    int seatIndex = airplane->seatIndexOf(seatId);
+    if (seatIndex < 0) {
         errorMessage = "Seat not found on this flight.";
-        return nullptr;
+        return BookingHandle();
     }
 
-    if (seat->getIsBooked()) {
+    if (airplane->isSeatBooked(seatIndex)) {
         errorMessage = "Seat is already booked.";
-        return nullptr;
+        return BookingHandle();
     }
 
-    if (customer->getMoney() < seat->getPrice()) {
-        errorMessage = "Insufficient funds.";
-        return nullptr;
+    // Seat claim and charge are atomic operations with no lock; if the booking append below
+    // fails, the transaction's destructor refunds the customer and frees the seat
+    preserveBalance(customerHandle, *customer);
+    BookingTransaction transaction(*airplane, seatIndex, *customer, revenueCents);
+    switch (transaction.prepare()) {
+        case BookingTransaction::Status::READY:
+            break;
+        case BookingTransaction::Status::SEAT_TAKEN:
+            errorMessage = "Seat is already booked."; // Another customer claimed it since the check above
+            return BookingHandle();
+        case BookingTransaction::Status::INSUFFICIENT_FUNDS:
+            errorMessage = "Insufficient funds.";
+            return BookingHandle();
     }
 
-    if (customer->chargeMoney(seat->getPrice())) {
-        if (airplane->bookSpecificSeat(seat->getSeatId())) {
-            bookings.emplace_back(customer->getPersonId(), airplane->getFlightNumber(), seat->getSeatId());
-            bookings.back().setStatus(BookingStatus::CONFIRMED);
-            errorMessage = "Booking successful.";
-            return &bookings.back(); // Return pointer to the new booking
-        } else {
-            customer->addMoney(seat->getPrice()); // Refund customer
-            errorMessage = "Booking failed internally (airplane could not book seat).";
-            return nullptr;
-        }
-    } else {
-        errorMessage = "Booking failed (could not charge customer - unexpected).";
-        return nullptr;
+    BookingHandle booking;
+    {
+        std::lock_guard<std::mutex> customerLock(customerLocks.forSlot(customerHandle.index())); // Guards the customer's booking list
+        booking = addBookingRecord(customerHandle, airplaneHandle, seatIndex, transaction.getPriceCents());
+        // A cancel of this booking takes the same customer shard, so it is always logged after this
+        lsn = logMutation(WalRecord::book(getBooking(booking)->getBookingNumber(), customerId, flightNumber, seatIndex,
+                                          transaction.getPriceCents()));
     }
+    transaction.commit();
+    publishSeats(airplaneHandle, {seatIndex});
+    return booking;
 }
 
 bool ReservationSystem::cancelBookingInternal(const std::string& bookingId, std::string& errorMessage) {
-    Booking* booking = findBookingById(bookingId);
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    BookingHandle bookingHandle = findBookingHandle(bookingId);
+    Booking* booking = getBooking(bookingHandle);
 
     if (!booking) {
         errorMessage = "Booking with ID " + bookingId + " not found.";
         return false;
     }
 
+    // The customer of a booking never changes, so it can be resolved before locking
+    CustomerHandle customerHandle = customerHandleOf(booking->getCustomerId());
+    ShardLockGuard shards;
+    lockBookingShards(shards, *booking, nullptr, {customerHandle.index()});
+    AirplaneHandle airplaneHandle = airplaneHandleOf(booking->getFlightNumber());
+    Customer* customer = customers.get(customerHandle);
+    Airplane* airplane = airplanes.get(airplaneHandle);
+    if (!customer || !airplane) {
+        errorMessage = "Error: Could not find customer, airplane, or seat associated with this booking. Cancellation failed.";
+        return false;
+    }
+
     if (booking->getStatus() == BookingStatus::CANCELLED) {
         errorMessage = "Booking " + bookingId + " is already cancelled.";
         return false; // Or true, as it's already in the desired state for cancellation
     }
-    
-    // Logic from handleCancelBooking
-    Customer* customer = findCustomerById(booking->getCustomerId());
-    Airplane* airplane = findAirplaneByFlightNumber(booking->getFlightNumber());
-    Seat* seat = airplane ? airplane->findSeat(booking->getSeatId()) : nullptr;
 
-    if (customer && airplane && seat) {
-        double refundAmount = seat->getPrice(); 
-        customer->addMoney(refundAmount);
-        airplane->unbookSpecificSeat(seat->getSeatId()); // This updates bookedSeatsCount in Airplane
+    // Logic from handleCancelBooking
+    Seat* seat = airplane->findSeat(booking->getSeatKey()); // Read under the flight lock: swaps move it
+
+    if (seat) {
+        preserveBooking(bookingHandle, *booking);
+        preserveBalance(customerHandle, *customer);
+        // Logged before the refund and the freed seat become visible, so whatever builds on them logs later.
+        // Cancelling a hold is not logged: holds never are.
+        WriteAheadLog::Lsn lsn = booking->getStatus() == BookingStatus::CONFIRMED
+                                     ? logMutation(WalRecord::cancel(booking->getBookingNumber())) : 0;
+        double refundAmount = toDollars(refundBooking(*booking, *customer));
         booking->setStatus(BookingStatus::CANCELLED);
-        errorMessage = "Booking " + bookingId + " cancelled successfully. $" + std::to_string(refundAmount) + " refunded.";
-        return true;
+        releaseSeatBooking(bookingHandle); // Before the seat is freed, so a new claimant's entry is never cleared
+        airplane->unbookSpecificSeat(seat->getSeatId()); // This updates bookedSeatsCount in Airplane
+        publishSeats(airplaneHandle, {airplane->seatIndexOf(booking->getSeatKey())});
+        shards.unlock();
+        registry.unlock();
+        // Built in place so a caller that reuses errorMessage pays no allocation
+        errorMessage.assign("Booking ").append(bookingId).append(" cancelled successfully. $")
+                    .append(std::to_string(refundAmount)).append(" refunded.");
+        return awaitLogged(lsn, errorMessage);
     } else {
         errorMessage = "Error: Could not find customer, airplane, or seat associated with this booking. Cancellation failed.";
         // This state should ideally not happen if data integrity is maintained.
@@ -553,46 +1302,912 @@ bool ReservationSystem::cancelBookingInternal(const std::string& bookingId, std:
 bool ReservationSystem::swapSeatsInternal(const std::string& bookingId1_str, const std::string& bookingId2_str, std::string& errorMessage) {
     errorMessage.clear(); // Ensure errorMessage is in a good state
 
-    if (bookings.size() < 2) {
-        // This check is only for the general case; specific booking IDs might still be invalid.
-        // We proceed to find them individually.
-        // It's possible to have <2 bookings but still attempt a swap with invalid IDs.
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    BookingHandle bookingHandle1 = findBookingHandle(bookingId1_str);
+    Booking* booking1 = getBooking(bookingHandle1);
+    BookingHandle bookingHandle2 = findBookingHandle(bookingId2_str);
+    Booking* booking2 = getBooking(bookingHandle2);
+    if (!booking1) {
+        errorMessage = "First booking ID (" + bookingId1_str + ") not found or not confirmed.";
+        return false;
+    }
+    if (!booking2) {
+        errorMessage = "Second booking ID (" + bookingId2_str + ") not found or not confirmed.";
+        return false;
+    }
+    if (booking1->getBookingNumber() == booking2->getBookingNumber()) {
+        errorMessage = "Cannot swap a booking with itself.";
+        return false;
     }
 
-    Booking* booking1 = findBookingById(bookingId1_str);
-    if (!booking1 || booking1->getStatus() != BookingStatus::CONFIRMED) {
+    // Statuses, seats and fares are only stable under the flight locks. Both flights (and both
+    // customers, whose booking lists readers walk) are taken in the global shard order, so swaps
+    // in opposite directions between the same flights cannot deadlock.
+    CustomerHandle customerHandle1 = customerHandleOf(booking1->getCustomerId());
+    CustomerHandle customerHandle2 = customerHandleOf(booking2->getCustomerId());
+    ShardLockGuard shards;
+    lockBookingShards(shards, *booking1, booking2, {customerHandle1.index(), customerHandle2.index()});
+    if (booking1->getStatus() != BookingStatus::CONFIRMED) {
         errorMessage = "First booking ID (" + bookingId1_str + ") not found or not confirmed.";
         return false;
     }
-
-    Booking* booking2 = findBookingById(bookingId2_str);
-    if (!booking2 || booking2->getStatus() != BookingStatus::CONFIRMED) {
+    if (booking2->getStatus() != BookingStatus::CONFIRMED) {
         errorMessage = "Second booking ID (" + bookingId2_str + ") not found or not confirmed.";
         return false;
     }
 
-    if (booking1->getBookingId() == booking2->getBookingId()) {
-        errorMessage = "Cannot swap a booking with itself.";
+    AirplaneHandle airplaneHandle1 = airplaneHandleOf(booking1->getFlightNumber());
+    AirplaneHandle airplaneHandle2 = airplaneHandleOf(booking2->getFlightNumber());
+    Airplane* airplane1 = airplanes.get(airplaneHandle1);
+    Airplane* airplane2 = airplanes.get(airplaneHandle2);
+    Customer* customer1 = customers.get(customerHandle1);
+    Customer* customer2 = customers.get(customerHandle2);
+    int seatIndex1 = airplane1 ? airplane1->seatIndexOf(booking1->getSeatKey()) : -1;
+    int seatIndex2 = airplane2 ? airplane2->seatIndexOf(booking2->getSeatKey()) : -1;
+    if (!customer1 || !customer2 || seatIndex1 < 0 || seatIndex2 < 0) {
+        errorMessage = "Error: Could not find customer, airplane, or seat associated with these bookings. Swap failed.";
         return false;
     }
 
-    if (booking1->getFlightNumber() != booking2->getFlightNumber()) {
-        // Simplified error message to reduce string operations, in case of issues.
-        errorMessage = "Seat swaps only supported for bookings on the same flight."; 
+    // Each booking now pays the fare of the seat it moves to. Upgrades are charged before any
+    // downgrade is refunded, so a customer who cannot pay leaves at most one charge to undo.
+    Cents newFare1 = toCents(airplane2->getSeatPrice(seatIndex2));
+    Cents newFare2 = toCents(airplane1->getSeatPrice(seatIndex1));
+    Cents fareChange1 = newFare1 - booking1->getPaidCents();
+    Cents fareChange2 = newFare2 - booking2->getPaidCents();
+    preserveBooking(bookingHandle1, *booking1);
+    preserveBooking(bookingHandle2, *booking2);
+    preserveBalance(customerHandle1, *customer1);
+    preserveBalance(customerHandle2, *customer2);
+    if (fareChange1 > 0 && !customer1->tryDebitCents(fareChange1)) {
+        errorMessage.assign("Insufficient funds for the fare difference on booking ").append(bookingId1_str).append(".");
         return false;
     }
-    
-    // Price difference handling is not implemented.
-    // This assumes a direct swap of seat assignments.
+    if (fareChange2 > 0 && !customer2->tryDebitCents(fareChange2)) {
+        customer1->creditCents(fareChange1); // Ignores a non-positive amount
+        errorMessage.assign("Insufficient funds for the fare difference on booking ").append(bookingId2_str).append(".");
+        return false;
+    }
+    WriteAheadLog::Lsn lsn = logMutation(WalRecord::swap(booking1->getBookingNumber(), booking2->getBookingNumber(), newFare1, newFare2));
+    customer1->creditCents(-fareChange1); // Downgrade refunds; creditCents ignores the upgrades' negatives
+    customer2->creditCents(-fareChange2);
+    booking1->setPaidCents(newFare1);
+    booking2->setPaidCents(newFare2);
+    revenueCents.fetch_add(fareChange1 + fareChange2, std::memory_order_acq_rel);
 
     std::string tempSeatId1 = booking1->getSeatId(); // Store original seat of booking1
-    
     std::string b2_original_seat = booking2->getSeatId();
-    booking1->setSeatId(b2_original_seat); // Set booking1's seat to booking2's current/original seat
-    booking2->setSeatId(tempSeatId1);      // Set booking2's seat to booking1's original seat
+    swapSeatBookings(bookingHandle1, airplaneHandle1, seatIndex1, bookingHandle2, airplaneHandle2, seatIndex2);
+    if (airplaneHandle1 == airplaneHandle2) {
+        publishSeats(airplaneHandle1, {seatIndex1, seatIndex2});
+    } else {
+        publishSeats(airplaneHandle1, {seatIndex1});
+        publishSeats(airplaneHandle2, {seatIndex2});
+    }
+
+    errorMessage.assign("Seat swap successful. Booking ").append(bookingId1_str)
+                .append(" now has seat ").append(booking1->getSeatId())
+                .append(" (was ").append(tempSeatId1).append("). Booking ").append(bookingId2_str)
+                .append(" now has seat ").append(booking2->getSeatId())
+                .append(" (was ").append(b2_original_seat).append(").");
+    if (airplaneHandle1 != airplaneHandle2) {
+        errorMessage.append(" Flights exchanged: ").append(booking1->getFlightNumber())
+                    .append(" and ").append(booking2->getFlightNumber()).append(".");
+    }
+    if (fareChange1 != 0 || fareChange2 != 0) {
+        errorMessage.append(" Fare differences settled: $").append(std::to_string(toDollars(fareChange1)))
+                    .append(" and $").append(std::to_string(toDollars(fareChange2))).append(".");
+    }
+    shards.unlock();
+    registry.unlock();
+    return awaitLogged(lsn, errorMessage);
+}
+
+Booking* ReservationSystem::holdSeatInternal(const std::string& customerId, const std::string& flightNumber, const std::string& seatId,
+                                             std::chrono::milliseconds holdFor, std::string& errorMessage) {
+    if (holdFor.count() <= 0) {
+        errorMessage = "Hold duration must be positive.";
+        return nullptr;
+    }
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    CustomerHandle customerHandle = customerHandleOf(customerId);
+    Customer* customer = customers.get(customerHandle);
+    if (!customer) {
+        errorMessage = "Customer not found.";
+        return nullptr;
+    }
+
+    AirplaneHandle airplaneHandle = airplaneHandleOf(flightNumber);
+    Airplane* airplane = airplanes.get(airplaneHandle);
+    if (!airplane) {
+        errorMessage = "Airplane not found.";
+        return nullptr;
+    }
+
+    int seatIndex = airplane->seatIndexOf(seatId);
+    if (seatIndex < 0) {
+        errorMessage = "Seat not found on this flight.";
+        return nullptr;
+    }
+
+    if (airplane->isSeatBooked(seatIndex)) {
+        errorMessage = "Seat is already booked.";
+        return nullptr;
+    }
+    if (customer->getBalanceCents() < toCents(airplane->getSeatPrice(seatIndex))) {
+        errorMessage = "Insufficient funds."; // Checked, not reserved: the charge happens on confirm
+        return nullptr;
+    }
+    if (!airplane->bookSeatAt(seatIndex)) {
+        errorMessage = "Seat is already booked."; // Another customer claimed it since the check above
+        return nullptr;
+    }
+
+    BookingHandle booking;
+    try {
+        std::lock_guard<std::mutex> customerLock(customerLocks.forSlot(customerHandle.index())); // Guards the customer's booking list
+        booking = addBookingRecord(customerHandle, airplaneHandle, seatIndex, 0, BookingStatus::PENDING);
+    } catch (...) {
+        airplane->unbookSeatAt(seatIndex);
+        throw;
+    }
+    publishSeats(airplaneHandle, {seatIndex});
+    scheduleHoldExpiry(booking, std::chrono::steady_clock::now() + holdFor);
+    errorMessage = "Seat held.";
+    return getBooking(booking);
+}
+
+bool ReservationSystem::confirmHoldInternal(const std::string& bookingId, std::string& errorMessage) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    BookingHandle bookingHandle = findBookingHandle(bookingId);
+    if (!getBooking(bookingHandle)) {
+        errorMessage = "Booking with ID " + bookingId + " not found.";
+        return false;
+    }
+    WriteAheadLog::Lsn lsn = 0;
+    if (!finishHold(bookingHandle, HoldOutcome::CONFIRM, errorMessage, &lsn)) {
+        return false;
+    }
+    registry.unlock();
+    return awaitLogged(lsn, errorMessage);
+}
+
+bool ReservationSystem::releaseHoldInternal(const std::string& bookingId, std::string& errorMessage) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    BookingHandle bookingHandle = findBookingHandle(bookingId);
+    if (!getBooking(bookingHandle)) {
+        errorMessage = "Booking with ID " + bookingId + " not found.";
+        return false;
+    }
+    return finishHold(bookingHandle, HoldOutcome::RELEASE, errorMessage);
+}
+
+std::size_t ReservationSystem::repriceFlight(AirplaneHandle airplaneHandle, const std::function<double(const Airplane&, int)>& priceOf,
+                                             WriteAheadLog::Lsn& lastLogged) {
+    Airplane& airplane = *airplanes.get(airplaneHandle);
+    std::size_t changed = 0;
+    {
+        // For the Seat mirror's readers, and so the logged fares are the ones left by the last change
+        std::lock_guard<std::mutex> flight(flightLocks.forSlot(airplaneHandle.index()));
+        preserveFares(airplaneHandle, airplane);
+        const int capacity = airplane.getCapacity();
+        int firstChanged = capacity;
+        int lastChanged = -1;
+        for (int seatIndex = 0; seatIndex < capacity; ++seatIndex) {
+            double price = priceOf(airplane, seatIndex);
+            if (price != airplane.getSeatPrice(seatIndex) && airplane.setSeatPrice(seatIndex, price)) {
+                ++changed;
+                firstChanged = std::min(firstChanged, seatIndex);
+                lastChanged = seatIndex;
+            }
+        }
+        if (changed > 0) {
+            lastLogged = std::max(lastLogged, logFares(airplane, firstChanged, lastChanged + 1)); // One run of seats
+        }
+    }
+    if (changed > 0) {
+        publishPrices(airplaneHandle);
+    }
+    return changed;
+}
+
+std::size_t ReservationSystem::cancelFlightBookings(AirplaneHandle airplaneHandle, WriteAheadLog::Lsn& lastLogged) {
+    Airplane& airplane = *airplanes.get(airplaneHandle);
+    std::size_t cancelled = 0;
+    {
+        // Swaps move bookings only while holding this shard, so the seat entries below stay put
+        std::lock_guard<std::mutex> flight(flightLocks.forSlot(airplaneHandle.index()));
+        const int capacity = airplane.getCapacity();
+        for (int seatIndex = 0; seatIndex < capacity; ++seatIndex) {
+            BookingHandle bookingHandle = seatBookingAt(airplaneHandle, seatIndex);
+            Booking* booking;
+            {
+                std::shared_lock<std::shared_mutex> lock(bookingMutex);
+                booking = bookings.get(bookingHandle);
+            }
+            if (!booking) continue; // Free, or claimed by a booking not recorded yet
+            CustomerHandle customerHandle = customerHandleOf(booking->getCustomerId());
+            Customer* customer = customers.get(customerHandle);
+            if (!customer) continue;
+            std::lock_guard<std::mutex> lock(customerLocks.forSlot(customerHandle.index()));
+            if (booking->getStatus() == BookingStatus::CANCELLED) continue;
+            preserveBooking(bookingHandle, *booking);
+            preserveBalance(customerHandle, *customer);
+            if (booking->getStatus() == BookingStatus::CONFIRMED) {
+                lastLogged = std::max(lastLogged, logMutation(WalRecord::cancel(booking->getBookingNumber())));
+            }
+            refundBooking(*booking, *customer); // A hold has paid nothing, so it refunds nothing
+            booking->setStatus(BookingStatus::CANCELLED);
+            std::uint32_t expected = bookingHandle.raw();
+            seatBookings[airplaneHandle.index()][seatIndex].compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+            airplane.unbookSeatAt(seatIndex);
+            ++cancelled;
+        }
+    }
+    if (cancelled > 0) {
+        publishFlight(airplaneHandle);
+    }
+    return cancelled;
+}
+
+bool ReservationSystem::repriceAllFlightsInternal(const std::function<double(const Airplane&, int)>& priceOf, std::size_t& changedCount,
+                                                  std::string& errorMessage, WorkStealingExecutor& executor) {
+    std::shared_lock<std::shared_mutex> registry(registryMutex); // Held for the tasks too: they run inside this call
+    std::vector<AirplaneHandle> handles;
+    handles.reserve(airplanes.size());
+    for (auto it = airplanes.begin(); it != airplanes.end(); ++it) {
+        handles.push_back(it.handle());
+    }
+    std::atomic<std::size_t> changed{0};
+    std::atomic<WriteAheadLog::Lsn> lastLogged{0};
+    executor.parallelFor(0, handles.size(), 1, [&](std::size_t i) {
+        WriteAheadLog::Lsn flightLast = 0;
+        changed.fetch_add(repriceFlight(handles[i], priceOf, flightLast), std::memory_order_relaxed);
+        WriteAheadLog::Lsn seen = lastLogged.load(std::memory_order_relaxed);
+        while (seen < flightLast && !lastLogged.compare_exchange_weak(seen, flightLast, std::memory_order_relaxed)) {
+        }
+    });
+    registry.unlock();
+    changedCount = changed.load(std::memory_order_relaxed);
+    return awaitLogged(lastLogged.load(std::memory_order_relaxed), errorMessage); // Durable up to the last covers them all
+}
+
+bool ReservationSystem::cancelFlightBookingsInternal(const std::vector<std::string>& flightNumbers, std::size_t& cancelledCount,
+                                                     std::string& errorMessage, WorkStealingExecutor& executor) {
+    cancelledCount = 0;
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    std::vector<AirplaneHandle> handles;
+    handles.reserve(flightNumbers.size());
+    for (const std::string& flightNumber : flightNumbers) {
+        AirplaneHandle handle = airplaneHandleOf(flightNumber);
+        if (!handle) {
+            errorMessage = "Flight " + flightNumber + " not found.";
+            return false;
+        }
+        if (std::find(handles.begin(), handles.end(), handle) == handles.end()) {
+            handles.push_back(handle);
+        }
+    }
+    std::atomic<std::size_t> cancelled{0};
+    std::atomic<WriteAheadLog::Lsn> lastLogged{0};
+    executor.parallelFor(0, handles.size(), 1, [&](std::size_t i) {
+        WriteAheadLog::Lsn flightLast = 0;
+        cancelled.fetch_add(cancelFlightBookings(handles[i], flightLast), std::memory_order_relaxed);
+        WriteAheadLog::Lsn seen = lastLogged.load(std::memory_order_relaxed);
+        while (seen < flightLast && !lastLogged.compare_exchange_weak(seen, flightLast, std::memory_order_relaxed)) {
+        }
+    });
+    registry.unlock();
+    cancelledCount = cancelled.load(std::memory_order_relaxed);
+    errorMessage.assign("Cancelled ").append(std::to_string(cancelledCount)).append(" booking(s) on ")
+                .append(std::to_string(handles.size())).append(" flight(s).");
+    return awaitLogged(lastLogged.load(std::memory_order_relaxed), errorMessage); // Durable up to the last covers them all
+}
+
+// --- Bulk import ---
+
+bool ReservationSystem::importAirplanes(const std::vector<ImportedAirplane>& rows, std::vector<RejectedRow>& rejected,
+                                        std::string& errorMessage) {
+    std::vector<AirplaneHandle> added;
+    added.reserve(rows.size());
+    WriteAheadLog::Lsn lsn = 0;
+    {
+        std::unique_lock<std::shared_mutex> registry(registryMutex);
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const ImportedAirplane& row = rows[i];
+            std::string sizeError;
+            if (!checkAirplaneSize(row.rows, row.seatsPerRow, sizeError)) {
+                rejected.push_back({i, sizeError});
+                continue;
+            }
+            if (airplaneHandleOf(row.flightNumber)) {
+                rejected.push_back({i, "Airplane with flight number " + row.flightNumber + " already exists."});
+                continue;
+            }
+            AirplaneHandle handle = airplanes.emplace(row.flightNumber, row.rows, row.seatsPerRow);
+            airplaneIndex[row.flightNumber] = handle;
+            createSeatBookingRow(handle, airplanes.get(handle)->getCapacity());
+            added.push_back(handle);
+            lsn = logMutation(WalRecord::addAirplane(row.flightNumber, row.rows, row.seatsPerRow));
+        }
+        publishNewFlights(added.data(), added.size()); // One new fleet directory for the whole batch
+    }
+    return awaitLogged(lsn, errorMessage);
+}
+
+bool ReservationSystem::importCustomers(const std::vector<ImportedCustomer>& rows, std::vector<RejectedRow>& rejected,
+                                        std::string& errorMessage) {
+    WriteAheadLog::Lsn lsn = 0;
+    {
+        std::unique_lock<std::shared_mutex> registry(registryMutex);
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const ImportedCustomer& row = rows[i];
+            std::string customerId = row.customerId.empty() ? generateUniqueCustomerId() : row.customerId;
+            if (customerHandleOf(customerId)) {
+                rejected.push_back({i, "Customer " + customerId + " already exists."});
+                continue;
+            }
+            addCustomerLocked(row.name, row.age, customerId, row.money, &lsn);
+            advanceCustomerIdCounterPast(customerId);
+        }
+    }
+    return awaitLogged(lsn, errorMessage);
+}
+
+bool ReservationSystem::importBookings(const std::vector<ImportedBooking>& rows, std::vector<RejectedRow>& rejected,
+                                       std::string& errorMessage, WorkStealingExecutor& executor) {
+    // Rows go to buckets by flight number, one task each, so a flight's rows keep their order
+    const std::size_t bucketCount = static_cast<std::size_t>(executor.getWorkerCount()) * 4;
+    std::vector<std::vector<std::uint32_t>> buckets(bucketCount);
+    if (bucketCount == 1) {
+        buckets[0].resize(rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) buckets[0][i] = static_cast<std::uint32_t>(i);
+    } else {
+        std::hash<std::string> hash;
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            buckets[hash(rows[i].flightNumber) % bucketCount].push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    std::vector<std::vector<RejectedRow>> bucketRejected(bucketCount);
+    std::atomic<WriteAheadLog::Lsn> lastLogged{0};
+    {
+        std::shared_lock<std::shared_mutex> registry(registryMutex);
+        executor.parallelFor(0, bucketCount, 1, [&](std::size_t bucket) {
+            std::string reason;
+            WriteAheadLog::Lsn bucketLast = 0;
+            for (std::uint32_t i : buckets[bucket]) {
+                const ImportedBooking& row = rows[i];
+                WriteAheadLog::Lsn logged = 0;
+                if (bookSeatLocked(row.customerId, row.flightNumber, row.seatId, logged, reason)) {
+                    bucketLast = std::max(bucketLast, logged);
+                } else {
+                    bucketRejected[bucket].push_back({i, reason});
+                }
+            }
+            WriteAheadLog::Lsn seen = lastLogged.load(std::memory_order_relaxed);
+            while (seen < bucketLast && !lastLogged.compare_exchange_weak(seen, bucketLast, std::memory_order_relaxed)) {
+            }
+        });
+    }
+    std::size_t first = rejected.size();
+    for (std::vector<RejectedRow>& bucket : bucketRejected) {
+        std::move(bucket.begin(), bucket.end(), std::back_inserter(rejected));
+    }
+    std::sort(rejected.begin() + static_cast<std::ptrdiff_t>(first), rejected.end(),
+              [](const RejectedRow& a, const RejectedRow& b) { return a.index < b.index; });
+    return awaitLogged(lastLogged.load(std::memory_order_relaxed), errorMessage); // Durable up to the last covers the batch
+}
+
+// --- Write-ahead log ---
+
+WriteAheadLog::Lsn ReservationSystem::logMutation(const WalRecord& record) {
+    return wal ? wal->append(record) : 0;
+}
+
+namespace {
+
+thread_local bool t_durabilityDeferred = false;     // See setDurabilityDeferred
+thread_local WriteAheadLog::Lsn t_deferredLsn = 0;  // Highest LSN left unawaited since takeDeferredLsn
+
+} // namespace
+
+void ReservationSystem::setDurabilityDeferred(bool deferred) {
+    t_durabilityDeferred = deferred;
+}
+
+WriteAheadLog::Lsn ReservationSystem::takeDeferredLsn() {
+    WriteAheadLog::Lsn lsn = t_deferredLsn;
+    t_deferredLsn = 0;
+    return lsn;
+}
+
+bool ReservationSystem::awaitLogged(WriteAheadLog::Lsn lsn, std::string& errorMessage) {
+    if (t_durabilityDeferred) {
+        t_deferredLsn = std::max(t_deferredLsn, lsn); // The caller awaits the run at once
+        return true;
+    }
+    if (!wal || lsn == 0 || wal->awaitDurable(lsn)) {
+        return true;
+    }
+    errorMessage = "Applied, but the write-ahead log failed (" + wal->getError() + "); the change may not survive a restart.";
+    return false;
+}
+
+bool ReservationSystem::applyLogRecord(const WalRecord& record, std::string& errorMessage) {
+    switch (record.type) {
+        case WalRecord::Type::ADD_CUSTOMER: {
+            if (findCustomerHandle(record.customerId)) {
+                errorMessage = "Customer " + record.customerId + " already exists.";
+                return false;
+            }
+            addCustomerRecord(record.name, record.age, record.customerId, toDollars(record.cents));
+            advanceCustomerIdCounterPast(record.customerId);
+            return true;
+        }
+        case WalRecord::Type::ADD_AIRPLANE:
+            if (findAirplaneHandle(record.flightNumber) || !checkAirplaneSize(record.rows, record.seatsPerRow, errorMessage)) {
+                errorMessage = "Cannot add airplane " + record.flightNumber + ".";
+                return false;
+            }
+            addAirplaneRecord(record.flightNumber, record.rows, record.seatsPerRow);
+            return true;
+        case WalRecord::Type::SET_FARES: {
+            Airplane* airplane = airplanes.get(findAirplaneHandle(record.flightNumber));
+            if (!airplane || record.seatIndex < 0 || record.seatIndex + static_cast<std::int64_t>(record.fares.size()) > airplane->getCapacity()) {
+                errorMessage = "Fares reference an unknown flight or seat.";
+                return false;
+            }
+            for (std::size_t i = 0; i < record.fares.size(); ++i) {
+                if (!airplane->setSeatPrice(record.seatIndex + static_cast<int>(i), record.fares[i])) {
+                    errorMessage = "Fares of " + record.flightNumber + " include a negative one.";
+                    return false;
+                }
+            }
+            return true; // Published with the rest of the flight once replay ends
+        }
+        default:
+            break;
+    }
+
+    // Bookings, cancels and swaps redo the logged outcome: no fares are looked up and no balance is
+    // checked, as the original operation already did both
+    std::unique_lock<std::shared_mutex> registry(registryMutex);
+    if (record.type == WalRecord::Type::BOOK) {
+        CustomerHandle customerHandle = customerHandleOf(record.customerId);
+        AirplaneHandle airplaneHandle = airplaneHandleOf(record.flightNumber);
+        Customer* customer = customers.get(customerHandle);
+        Airplane* airplane = airplanes.get(airplaneHandle);
+        if (!customer || !airplane || record.seatIndex < 0 || record.seatIndex >= airplane->getCapacity()) {
+            errorMessage = "Booking references an unknown customer, flight or seat.";
+            return false;
+        }
+        if (bookingHandleOf(record.bookingNumber) || !airplane->bookSeatAt(record.seatIndex)) {
+            errorMessage = "Booking " + bookingIdOf(record.bookingNumber) + " conflicts with an existing booking.";
+            return false;
+        }
+        customer->adjustCents(-record.cents);
+        revenueCents.fetch_add(record.cents, std::memory_order_acq_rel);
+        addBookingRecord(customerHandle, airplaneHandle, record.seatIndex, record.cents, BookingStatus::CONFIRMED, record.bookingNumber);
+        BookingIdGenerator::global().advancePast(record.bookingNumber);
+        return true;
+    }
+
+    BookingHandle handle1 = bookingHandleOf(record.bookingNumber);
+    Booking* booking1 = bookings.get(handle1);
+    if (!booking1 || booking1->getStatus() != BookingStatus::CONFIRMED) {
+        errorMessage = "Booking " + bookingIdOf(record.bookingNumber) + " is not an active booking.";
+        return false;
+    }
+    AirplaneHandle airplaneHandle1 = airplaneHandleOf(booking1->getFlightNumber());
+    int seatIndex1 = airplanes.get(airplaneHandle1)->seatIndexOf(booking1->getSeatKey());
+    Customer* customer1 = customers.get(customerHandleOf(booking1->getCustomerId()));
+    if (record.type == WalRecord::Type::CANCEL) {
+        refundBooking(*booking1, *customer1);
+        booking1->setStatus(BookingStatus::CANCELLED);
+        releaseSeatBooking(handle1);
+        airplanes.get(airplaneHandle1)->unbookSeatAt(seatIndex1);
+        return true;
+    }
+
+    BookingHandle handle2 = bookingHandleOf(record.otherBookingNumber);
+    Booking* booking2 = bookings.get(handle2);
+    if (!booking2 || booking2->getStatus() != BookingStatus::CONFIRMED || handle1 == handle2) {
+        errorMessage = "Booking " + bookingIdOf(record.otherBookingNumber) + " is not an active booking.";
+        return false;
+    }
+    AirplaneHandle airplaneHandle2 = airplaneHandleOf(booking2->getFlightNumber());
+    int seatIndex2 = airplanes.get(airplaneHandle2)->seatIndexOf(booking2->getSeatKey());
+    Customer* customer2 = customers.get(customerHandleOf(booking2->getCustomerId()));
+    Cents fareChange1 = record.cents - booking1->getPaidCents();
+    Cents fareChange2 = record.otherCents - booking2->getPaidCents();
+    customer1->adjustCents(-fareChange1);
+    customer2->adjustCents(-fareChange2);
+    booking1->setPaidCents(record.cents);
+    booking2->setPaidCents(record.otherCents);
+    revenueCents.fetch_add(fareChange1 + fareChange2, std::memory_order_acq_rel);
+    swapSeatBookings(handle1, airplaneHandle1, seatIndex1, handle2, airplaneHandle2, seatIndex2);
+    return true;
+}
+
+bool ReservationSystem::openWriteAheadLog(const std::string& path, const WriteAheadLog::Options& options, std::string& errorMessage) {
+    std::lock_guard<std::mutex> checkpoint(checkpointMutex);
+    if (wal) {
+        errorMessage = "A write-ahead log is already open.";
+        return false;
+    }
+    const WriteAheadLog::Position from = restoredLogPosition;
+    auto apply = [this](const WalRecord& record, std::string& applyError) { return applyLogRecord(record, applyError); };
+    std::uint64_t replayedCount = 0;
+    std::uint64_t recordCount = 0;
+    std::uint64_t validLength = 0;
+    // Segments rotated out by checkpoints that did not complete, oldest first, then the current file
+    std::uint64_t segment = from.generation;
+    bool replayed = true;
+    while (replayed && std::ifstream(WriteAheadLog::segmentPath(path, segment))) {
+        replayed = WriteAheadLog::replay(WriteAheadLog::segmentPath(path, segment), apply, recordCount, validLength, errorMessage, from);
+        replayedCount += recordCount;
+        ++segment;
+    }
+    std::uint64_t generation = 0;
+    if (replayed) {
+        replayed = WriteAheadLog::replay(path, apply, recordCount, validLength, errorMessage, from, &generation);
+        replayedCount += recordCount;
+    }
+    if (replayed && validLength > 0 &&
+        (generation != segment || (generation == from.generation && validLength < from.offset))) { // A gap, or short of the cut
+        errorMessage = path + " does not continue from the snapshot and the log segments before it.";
+        replayed = false;
+    }
+    {
+        // Replay skips per-seat publishing; rebuild every flight's snapshot once instead
+        std::shared_lock<std::shared_mutex> registry(registryMutex);
+        for (auto it = airplanes.begin(); it != airplanes.end(); ++it) {
+            publishFlight(it.handle());
+        }
+    }
+    if (!replayed) {
+        return false;
+    }
+    if (validLength == 0) { // A new file must not reuse a generation whose records a snapshot skips
+        generation = std::max(segment, from.offset > 0 ? from.generation + 1 : from.generation);
+    }
+    wal = WriteAheadLog::open(path, validLength, options, errorMessage, generation);
+    if (!wal) {
+        return false;
+    }
+    errorMessage = "Recovered " + std::to_string(replayedCount) + " record(s) from " + path + ".";
+    return true;
+}
+
+// --- Snapshots ---
+
+ReservationSystem::BookingImage ReservationSystem::imageOf(const Booking& booking) {
+    BookingImage image;
+    image.exists = true;
+    image.number = booking.getBookingNumber();
+    image.status = booking.getStatus();
+    image.paidCents = booking.getPaidCents();
+    image.flightRef = booking.getFlightRef();
+    image.seatKey = booking.getSeatKey();
+    return image;
+}
+
+void ReservationSystem::preserveFares(AirplaneHandle handle, const Airplane& airplane) {
+    fareCapture.preserve(handle.index(), [&airplane]() {
+        std::vector<double> fares(static_cast<std::size_t>(airplane.getCapacity()));
+        for (int seatIndex = 0; seatIndex < airplane.getCapacity(); ++seatIndex) {
+            fares[seatIndex] = airplane.getSeatPrice(seatIndex);
+        }
+        return fares;
+    });
+}
+
+void ReservationSystem::preserveBooking(BookingHandle handle, const Booking& booking) {
+    bookingCapture.preserve(handle.index(), [&booking]() { return imageOf(booking); });
+}
+
+void ReservationSystem::preserveBalance(CustomerHandle handle, const Customer& customer) {
+    balanceCapture.preserve(handle.index(), [&customer]() { return customer.getBalanceCents(); });
+}
+
+bool ReservationSystem::saveSnapshot(const std::string& path, std::string& errorMessage) {
+    constexpr std::uint32_t NO_ROW = 0xFFFFFFFFu;
+    constexpr std::uint32_t SCAN_BATCH = 1024; // Slots copied per turn of the captures' mutexes
+    std::lock_guard<std::mutex> checkpoint(checkpointMutex);
+    // A new log file first, so that once this snapshot is durable every file before it can go
+    if (wal && !wal->rotate(errorMessage)) {
+        return false;
+    }
+
+    SnapshotFile::Image image;
+    WriteAheadLog::Position cut{};
+    {
+        // The cut. Every mutation holds registryMutex while it applies and logs, so none is half
+        // done here and the log position splits the records into those the image includes and
+        // those after it. Only counters are read under the exclusive lock.
+        std::unique_lock<std::shared_mutex> registry(registryMutex);
+        image.revenueCents = revenueCents.load(std::memory_order_acquire);
+        image.nextCustomerNumber = static_cast<std::uint64_t>(g_customerIdCounter.load());
+        if (wal) {
+            cut = wal->getPosition();
+        }
+        fareCapture.begin(airplanes.slotCount());
+        bookingCapture.begin(bookings.slotCount());
+        balanceCapture.begin(customers.slotCount());
+    }
+    image.logGeneration = cut.generation;
+    image.logOffset = cut.offset;
+
+    // Airplanes. Only their fares change; the captures leave entities added since the cut out.
+    std::vector<std::uint32_t> airplaneRowOfFlight; // By flightNumberInterner() id
+    std::vector<const Airplane*> airplaneOfRow;
+    auto readFares = [this](std::uint32_t slot) {
+        std::vector<double> fares;
+        if (const Airplane* airplane = airplanes.get(airplanes.handleAt(slot))) {
+            for (int seatIndex = 0; seatIndex < airplane->getCapacity(); ++seatIndex) {
+                fares.push_back(airplane->getSeatPrice(seatIndex));
+            }
+        }
+        return fares;
+    };
+    for (bool more = true; more;) {
+        std::shared_lock<std::shared_mutex> registry(registryMutex);
+        more = fareCapture.scan(SCAN_BATCH, readFares, [&](std::uint32_t slot, const std::vector<double>& fares) {
+            const Airplane* airplane = airplanes.get(airplanes.handleAt(slot));
+            if (!airplane) return;
+            InternedId flightRef = flightNumberInterner().intern(airplane->getFlightNumber());
+            if (airplaneRowOfFlight.size() <= flightRef) {
+                airplaneRowOfFlight.resize(flightRef + 1, NO_ROW);
+            }
+            airplaneRowOfFlight[flightRef] = static_cast<std::uint32_t>(image.airplanes.size());
+            airplaneOfRow.push_back(airplane);
+            image.airplanes.push_back({image.addString(airplane->getFlightNumber()), airplane->getCapacity() / airplane->getSeatsPerRow(),
+                                       airplane->getSeatsPerRow(), image.seatPrices.size()});
+            image.seatPrices.insert(image.seatPrices.end(), fares.begin(), fares.end());
+        });
+    }
+    fareCapture.end();
+
+    // Bookings before customers, whose rows list them; the customer pass fills in BookingRow::customer.
+    // A booking's seat is only stable under its flight's shard, but its image is a consistent copy.
+    std::vector<std::uint32_t> bookingRowOfSlot(bookingCapture.slotCount(), NO_ROW);
+    auto readBooking = [this](std::uint32_t slot) { // Under bookingMutex, which a reused slot is filled under
+        const Booking* booking = bookings.get(bookings.handleAt(slot));
+        return booking ? imageOf(*booking) : BookingImage();
+    };
+    for (bool more = true; more;) {
+        std::shared_lock<std::shared_mutex> bookingLock(bookingMutex);
+        more = bookingCapture.scan(SCAN_BATCH, readBooking, [&](std::uint32_t slot, const BookingImage& booking) {
+            if (!booking.exists || booking.status == BookingStatus::PENDING || booking.flightRef >= airplaneRowOfFlight.size() ||
+                airplaneRowOfFlight[booking.flightRef] == NO_ROW) {
+                return;
+            }
+            std::uint32_t airplaneRow = airplaneRowOfFlight[booking.flightRef];
+            int seatIndex = airplaneOfRow[airplaneRow]->seatIndexOf(booking.seatKey);
+            if (seatIndex < 0) {
+                return; // Only a booking whose seat was renamed through Booking::setSeatId
+            }
+            bookingRowOfSlot[slot] = static_cast<std::uint32_t>(image.bookings.size());
+            SnapshotFile::BookingRow row{booking.number, booking.paidCents, 0, airplaneRow, seatIndex,
+                                         static_cast<std::uint8_t>(booking.status), {}};
+            image.bookings.push_back(row);
+        });
+    }
+    bookingCapture.end();
+    image.seatBookings.assign(image.seatPrices.size(), 0); // A hold's seat counts as free
+    for (std::size_t bookingRow = 0; bookingRow < image.bookings.size(); ++bookingRow) {
+        const SnapshotFile::BookingRow& booking = image.bookings[bookingRow];
+        if (booking.status == static_cast<std::uint8_t>(BookingStatus::CONFIRMED)) {
+            image.seatBookings[image.airplanes[booking.airplane].firstSeat + booking.seatIndex] = static_cast<std::uint32_t>(bookingRow + 1);
+        }
+    }
+
+    // Customers: IDs, names and ages never change, balances come from the capture
+    std::vector<CustomerHandle> customerOfRow;
+    auto readBalance = [this](std::uint32_t slot) {
+        const Customer* customer = customers.get(customers.handleAt(slot));
+        return customer ? customer->getBalanceCents() : Cents(0);
+    };
+    for (bool more = true; more;) {
+        std::shared_lock<std::shared_mutex> registry(registryMutex);
+        more = balanceCapture.scan(SCAN_BATCH, readBalance, [&](std::uint32_t slot, Cents balance) {
+            CustomerHandle handle = customers.handleAt(slot);
+            const Customer* customer = customers.get(handle);
+            if (!customer) return;
+            image.customers.push_back({image.addString(customer->getPersonId()), image.addString(customer->getName()),
+                                       balance, 0, 0, customer->getAge()});
+            customerOfRow.push_back(handle);
+        });
+    }
+    balanceCapture.end();
+    // Booking lists only grow, and a booking added since the cut has no row
+    image.customerBookings.reserve(image.bookings.size());
+    for (std::size_t first = 0; first < customerOfRow.size(); first += SCAN_BATCH) {
+        std::shared_lock<std::shared_mutex> registry(registryMutex);
+        for (std::size_t customerRow = first; customerRow < std::min<std::size_t>(first + SCAN_BATCH, customerOfRow.size()); ++customerRow) {
+            CustomerHandle handle = customerOfRow[customerRow];
+            SnapshotFile::CustomerRow& row = image.customers[customerRow];
+            row.firstBooking = image.customerBookings.size();
+            std::lock_guard<std::mutex> customerLock(customerLocks.forSlot(handle.index()));
+            forEachCustomerBookingHandle(handle, [&](BookingHandle bookingHandle) {
+                std::uint32_t bookingRow = bookingHandle.index() < bookingRowOfSlot.size() ? bookingRowOfSlot[bookingHandle.index()] : NO_ROW;
+                if (bookingRow != NO_ROW) {
+                    image.customerBookings.push_back(bookingRow);
+                    image.bookings[bookingRow].customer = static_cast<std::uint32_t>(customerRow);
+                    ++row.bookingCount;
+                }
+            });
+        }
+    }
+
+    // The log must hold everything before the cut before a snapshot names the cut: otherwise a
+    // crash could leave the log shorter, and records appended after restart would be skipped
+    if (wal && !wal->flush()) {
+        errorMessage = "Cannot checkpoint: the write-ahead log has failed: " + wal->getError();
+        return false;
+    }
+    if (!SnapshotFile::write(path, image, errorMessage)) {
+        return false;
+    }
+    if (wal) {
+        WriteAheadLog::removeSegments(wal->getPath(), cut.generation);
+    }
+    lastCheckpoint = cut;
+    errorMessage = "Saved " + std::to_string(image.airplanes.size()) + " airplane(s), " + std::to_string(image.customers.size()) +
+                   " customer(s) and " + std::to_string(image.bookings.size()) + " booking(s) to " + path + ".";
+    return true;
+}
+
+void ReservationSystem::startCheckpoints(const std::string& path, std::chrono::milliseconds interval,
+                                         std::function<void(bool, const std::string&)> report) {
+    std::lock_guard<std::mutex> lock(checkpointThreadMutex);
+    if (!checkpointThread.joinable()) {
+        checkpointThread = std::thread(&ReservationSystem::runCheckpoints, this, path, interval, std::move(report));
+    }
+}
+
+void ReservationSystem::runCheckpoints(std::string snapshotPath, std::chrono::milliseconds interval,
+                                       std::function<void(bool, const std::string&)> report) {
+    std::unique_lock<std::mutex> lock(checkpointThreadMutex);
+    while (!checkpointWakeup.wait_for(lock, interval, [this]() { return stopCheckpoints; })) {
+        lock.unlock();
+        bool due = true;
+        {
+            std::lock_guard<std::mutex> checkpoint(checkpointMutex);
+            if (wal) {
+                WriteAheadLog::Position at = wal->getPosition();
+                due = at.generation != lastCheckpoint.generation || at.offset != lastCheckpoint.offset;
+            }
+        }
+        if (due) {
+            std::string message;
+            bool saved = saveSnapshot(snapshotPath, message);
+            if (report) report(saved, message);
+        }
+        lock.lock();
+    }
+}
+
+void ReservationSystem::stopCheckpointThread() {
+    {
+        std::lock_guard<std::mutex> lock(checkpointThreadMutex);
+        stopCheckpoints = true;
+    }
+    checkpointWakeup.notify_all();
+    if (checkpointThread.joinable()) {
+        checkpointThread.join();
+    }
+    std::lock_guard<std::mutex> lock(checkpointThreadMutex);
+    stopCheckpoints = false; // startCheckpoints() may run it again
+}
+
+bool ReservationSystem::loadSnapshot(const std::string& path, std::string& errorMessage) {
+    std::lock_guard<std::mutex> checkpoint(checkpointMutex);
+    if (wal) {
+        errorMessage = "Load the snapshot before opening the write-ahead log.";
+        return false;
+    }
+    std::unique_ptr<SnapshotFile> file = SnapshotFile::open(path, errorMessage);
+    if (!file) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> registry(registryMutex);
+    std::unique_lock<std::shared_mutex> bookingLock(bookingMutex);
+    clearEntities();
+    auto fail = [&](const std::string& message) {
+        clearEntities();
+        errorMessage = path + ": " + message;
+        return false;
+    };
+
+    // Airplanes: fares differing from the defaults are re-applied
+    const SnapshotFile::AirplaneRow* airplaneRows = file->airplanes();
+    std::vector<AirplaneHandle> airplaneHandles(file->airplaneCount());
+    std::vector<InternedId> flightRefs(file->airplaneCount());
+    for (std::size_t i = 0; i < file->airplaneCount(); ++i) {
+        std::string flightNumber(file->text(airplaneRows[i].flightNumber));
+        AirplaneHandle handle = airplanes.emplace(flightNumber, airplaneRows[i].rows, airplaneRows[i].seatsPerRow);
+        if (!airplaneIndex.emplace(flightNumber, handle).second) {
+            return fail("flight " + flightNumber + " appears twice.");
+        }
+        Airplane& airplane = *airplanes.get(handle);
+        const double* prices = file->seatPrices() + airplaneRows[i].firstSeat;
+        for (int seatIndex = 0; seatIndex < airplane.getCapacity(); ++seatIndex) {
+            if (prices[seatIndex] != airplane.getSeatPrice(seatIndex) && !airplane.setSeatPrice(seatIndex, prices[seatIndex])) {
+                return fail("flight " + flightNumber + " has a negative fare.");
+            }
+        }
+        createSeatBookingRow(handle, airplane.getCapacity());
+        airplaneHandles[i] = handle;
+        flightRefs[i] = flightNumberInterner().intern(flightNumber);
+    }
+
+    // Customers, in row order so that slot i holds row i; no hash index entries (see customerHandleOf)
+    const SnapshotFile::CustomerRow* customerRows = file->customers();
+    std::vector<InternedId> customerRefs(file->customerCount());
+    restoredCustomers.resize(file->customerCount());
+    customerBookings.resize(file->customerCount());
+    customerIdInterner().reserve(file->customerCount());
+    for (std::size_t i = 0; i < file->customerCount(); ++i) {
+        std::string_view customerId = file->text(customerRows[i].id);
+        CustomerHandle handle = customers.emplace(std::string(file->text(customerRows[i].name)), customerRows[i].age,
+                                                  std::string(customerId), 0.0);
+        customers.get(handle)->adjustCents(customerRows[i].balanceCents);
+        restoredCustomers[i] = handle;
+        customerRefs[i] = customerIdInterner().intern(customerId);
+    }
+
+    // Bookings, likewise by row
+    const SnapshotFile::BookingRow* bookingRows = file->bookings();
+    restoredBookings.resize(file->bookingCount());
+    for (std::size_t i = 0; i < file->bookingCount(); ++i) {
+        const SnapshotFile::BookingRow& row = bookingRows[i];
+        BookingHandle handle = bookings.emplace(row.number, customerRefs[row.customer], flightRefs[row.airplane],
+                                                SeatCodec::toKey(row.seatIndex / airplaneRows[row.airplane].seatsPerRow + 1,
+                                                                 row.seatIndex % airplaneRows[row.airplane].seatsPerRow));
+        Booking& booking = *bookings.get(handle);
+        booking.setPaidCents(row.paidCents);
+        booking.setStatus(static_cast<BookingStatus>(row.status));
+        restoredBookings[i] = handle;
+    }
+
+    // Seats, flight by flight: the file already checked that the seat column and the confirmed
+    // bookings name each other
+    const std::uint32_t* seatHolders = file->seatBookings();
+    for (std::size_t i = 0; i < file->airplaneCount(); ++i) {
+        Airplane& airplane = *airplanes.get(airplaneHandles[i]);
+        const std::uint32_t* holders = seatHolders + airplaneRows[i].firstSeat;
+        std::atomic<std::uint32_t>* row = seatBookings[airplaneHandles[i].index()].get();
+        for (int seatIndex = 0; seatIndex < airplane.getCapacity(); ++seatIndex) {
+            if (holders[seatIndex] != 0) {
+                airplane.bookSeatAt(seatIndex);
+                row[seatIndex].store(restoredBookings[holders[seatIndex] - 1].raw(), std::memory_order_relaxed);
+            }
+        }
+    }
+
+    revenueCents.store(file->getRevenueCents(), std::memory_order_release);
+    g_customerIdCounter = static_cast<int>(file->getNextCustomerNumber());
+    BookingIdGenerator::global().advancePast(file->getMaxBookingNumber());
+    restoredLogPosition = WriteAheadLog::Position{file->getLogGeneration(), file->getLogOffset()};
+
+    // A single directory rather than a version per airplane. Each flight's first snapshot is built
+    // on first use (currentSnapshot), so serving starts without building every seat map.
+    std::unique_ptr<FleetDirectory> directory(new FleetDirectory());
+    flightCells.resize(airplaneHandles.size());
+    for (AirplaneHandle handle : airplaneHandles) {
+        std::unique_ptr<FlightCell>& cell = flightCells[handle.index()];
+        cell.reset(new FlightCell());
+        cell->airplane = airplanes.get(handle);
+        cell->seatBookings = seatBookings[handle.index()].get();
+        directory->flights.push_back(cell.get());
+        directory->byNumber[cell->airplane->getFlightNumber()] = cell.get();
+    }
+    fleet.store(directory.release(), std::memory_order_seq_cst); // clearEntities dropped the previous one
 
-    errorMessage = "Seat swap successful. Booking " + bookingId1_str + " now has seat " + booking1->getSeatId() + 
-                   " (was " + tempSeatId1 + "). Booking " + bookingId2_str + " now has seat " + booking2->getSeatId() +
-                   " (was " + b2_original_seat + ").";
+    errorMessage = "Loaded " + std::to_string(file->airplaneCount()) + " airplane(s), " + std::to_string(file->customerCount()) +
+                   " customer(s) and " + std::to_string(file->bookingCount()) + " booking(s) from " + path + ".";
+    restoredSnapshot = std::move(file);
     return true;
 }
@@ -4,16 +4,137 @@
 #include "Airplane.h"
 #include "Customer.h"
 #include "Booking.h"
+#include "SlotMap.h"
+#include "LockShards.h"
+#include "Money.h"
+#include "EpochDomain.h"
+#include "FlightSnapshot.h"
+#include "TimerWheel.h"
+#include "WorkStealingExecutor.h"
+#include "WriteAheadLog.h"
+#include "SnapshotFile.h"
+#include "CopyOnWriteCapture.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <initializer_list>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <limits> // Required for std::numeric_limits
 #include <iostream> // For std::istream, std::ostream
 
+// Stable handles to entities owned by a ReservationSystem
+using CustomerHandle = SlotHandle<Customer>;
+using AirplaneHandle = SlotHandle<Airplane>;
+using BookingHandle = SlotHandle<Booking>;
+
 class ReservationSystem {
 private:
-    std::vector<Airplane> airplanes;
-    std::vector<Customer> customers;
-    std::vector<Booking> bookings;
+    // Slot-map storage: growth never moves existing entities, so handles and pointers stay valid
+    SlotMap<Airplane> airplanes;
+    SlotMap<Customer> customers;
+    SlotMap<Booking> bookings;
+
+    // Hash indexes from ID to handle, kept in sync by the add* helpers
+    std::unordered_map<std::string, CustomerHandle> customerIndex;
+    std::unordered_map<std::string, AirplaneHandle> airplaneIndex;
+    std::unordered_map<std::uint64_t, BookingHandle> bookingIndex; // Keyed by Booking::getBookingNumber()
+
+    // Indexed by airplane handle slot: seat index -> raw handle of the active booking (0 if free).
+    // Entries are atomics: a booking thread publishes its entry right after winning the seat claim.
+    std::vector<std::unique_ptr<std::atomic<std::uint32_t>[]>> seatBookings;
+
+    // Indexed by customer handle slot: that customer's bookings, oldest first
+    std::vector<std::vector<BookingHandle>> customerBookings;
+
+    // Concurrency for the *Internal API and the thread-safe readers below.
+    // Lock order: registryMutex, then flight shards, then customer shards (see ShardLockGuard),
+    // then bookingMutex. Operations on different flights and customers only share registryMutex
+    // in shared mode and bookingMutex for the brief insert of the booking record. Bookings do not
+    // take the flight shard at all: a BookingTransaction claims the seat with Airplane's atomic
+    // bookSeatAt and debits the customer's atomic balance.
+    mutable std::shared_mutex registryMutex; // airplanes/customers maps, their indexes, outer index vectors
+    mutable LockShards flightLocks;          // Per airplane slot: cancels, swaps and seat-map reads (claims are lock-free)
+    mutable LockShards customerLocks;        // Per customer slot: customerBookings row
+    mutable std::shared_mutex bookingMutex;  // bookings map and bookingIndex
+
+    // Lock-free read side. Each flight has a cell holding its current FlightSnapshot; writers publish
+    // a new version with a CAS and retire the old one to EpochDomain::global(). The directory of
+    // cells is itself an immutable snapshot, replaced when an airplane is added. Cells live until
+    // resetSystemForTest or destruction, which must not race with readers. A flight restored by
+    // loadSnapshot starts without a version; the first reader or writer builds it (currentSnapshot).
+    struct FlightCell {
+        mutable std::atomic<const FlightSnapshot*> current{nullptr};
+        const Airplane* airplane = nullptr;                        // What a first version is built from; readers
+        const std::atomic<std::uint32_t>* seatBookings = nullptr;  // hold no registry lock to look these up
+    };
+    struct FleetDirectory {
+        std::vector<const FlightCell*> flights; // In insertion order
+        std::unordered_map<std::string, const FlightCell*> byNumber;
+    };
+    std::vector<std::unique_ptr<FlightCell>> flightCells; // Indexed by airplane handle slot
+    std::atomic<const FleetDirectory*> fleet{nullptr};
+
+    // Sum of what confirmed bookings paid. Customer balances plus this stay constant across
+    // bookings and cancellations.
+    std::atomic<Cents> revenueCents{0};
+
+    // Timed seat holds. Each hold is a PENDING booking with a timer in holdTimers (payload: the raw
+    // booking handle). The expiry thread, started by the first hold, advances the wheel every
+    // HOLD_TICK and releases the holds that fell due; a hold confirmed or released before then is
+    // skipped when its timer fires. holdMutex is a leaf lock: nothing else is taken under it.
+    static constexpr std::chrono::milliseconds HOLD_TICK{100};
+    std::mutex holdMutex;                 // holdTimers and the expiry thread's state
+    std::condition_variable holdWakeup;
+    TimerWheel holdTimers;
+    std::chrono::steady_clock::time_point holdEpoch; // Tick 0 of holdTimers
+    std::thread holdExpiryThread;
+    bool stopHoldExpiry = false;
+
+    // Durability (see openWriteAheadLog). Each logged mutation appends its record while holding the
+    // locks that order it against conflicting mutations, applying nothing another thread could build
+    // on before the append; it waits for the record to be durable only after releasing them, so
+    // concurrent mutations share fsyncs. Null: nothing is logged.
+    std::unique_ptr<WriteAheadLog> wal;
+
+    // State restored by loadSnapshot. Its customers and bookings are left out of customerIndex,
+    // bookingIndex and customerBookings: lookups that miss those fall back to binary searches in
+    // the mapped file, and a restored customer's bookings from before the snapshot are read from
+    // its row there. Slot i of each map holds row i. Null: nothing restored.
+    std::unique_ptr<SnapshotFile> restoredSnapshot;
+    std::vector<CustomerHandle> restoredCustomers; // By customer row
+    std::vector<BookingHandle> restoredBookings;   // By booking row
+    WriteAheadLog::Position restoredLogPosition{}; // What of the log the restored snapshot already includes
+
+    // Checkpoints (see saveSnapshot). At its cut a checkpoint starts a capture of the airplanes'
+    // fares, the bookings and the customers' balances that existed then; from there on a writer
+    // calls preserve* before changing one of those (all else about them never changes), so the
+    // checkpoint copies each as it was at the cut while the writers carry on. checkpointMutex lets
+    // one checkpoint run at a time and keeps loadSnapshot and resetSystemForTest out meanwhile;
+    // it is taken before registryMutex, and the captures' own mutexes after every other lock.
+    struct BookingImage {
+        bool exists = false; // false: the slot was empty at the cut
+        std::uint64_t number = 0;
+        BookingStatus status = BookingStatus::CANCELLED;
+        Cents paidCents = 0;
+        InternedId flightRef = 0;
+        SeatKey seatKey = 0;
+    };
+    std::mutex checkpointMutex;
+    CopyOnWriteCapture<std::vector<double>> fareCapture; // By airplane slot
+    CopyOnWriteCapture<BookingImage> bookingCapture;     // By booking slot
+    CopyOnWriteCapture<Cents> balanceCapture;            // By customer slot
+    WriteAheadLog::Position lastCheckpoint{};            // Log position of the last checkpoint's cut; under checkpointMutex
+    std::mutex checkpointThreadMutex;                    // The periodic checkpoint thread's state
+    std::condition_variable checkpointWakeup;
+    std::thread checkpointThread;
+    bool stopCheckpoints = false;
 
     // I/O Stream Pointers - for testing
     std::istream* m_cin_ptr;
@@ -24,12 +145,161 @@ public: // Made public for testing - consider refactoring for better testability
     Customer* findCustomerById(const std::string& customerId);
     Airplane* findAirplaneByFlightNumber(const std::string& flightNumber);
     Booking* findBookingById(const std::string& bookingId);
+    Booking* findBookingForSeat(const std::string& flightNumber, const std::string& seatId); // Active booking holding the seat, or nullptr
+    // Active booking for every seat of a flight, aligned with Airplane::getAllSeats() (nullptr = none).
+    // Empty if the flight does not exist.
+    std::vector<const Booking*> getSeatBookings(const std::string& flightNumber) const;
+    void getSeatBookings(const std::string& flightNumber, std::vector<const Booking*>& out) const; // Reuses out's capacity
+    // A customer's bookings, oldest first; cost is proportional to that customer's booking count
+    std::vector<const Booking*> getBookingsForCustomer(const std::string& customerId) const;
+    std::vector<const Booking*> getBookingsForCustomer(const std::string& customerId, BookingStatus status) const;
+
+    // Handle-based access. Handles stay valid across growth; a handle to an entity that no
+    // longer exists (e.g. after resetSystemForTest) resolves to nullptr.
+    CustomerHandle findCustomerHandle(const std::string& customerId) const;
+    AirplaneHandle findAirplaneHandle(const std::string& flightNumber) const;
+    BookingHandle findBookingHandle(const std::string& bookingId) const;
+    Customer* getCustomer(CustomerHandle handle);
+    Airplane* getAirplane(AirplaneHandle handle);
+    Booking* getBooking(BookingHandle handle);
+    const Customer* getCustomer(CustomerHandle handle) const;
+    const Airplane* getAirplane(AirplaneHandle handle) const;
+    const Booking* getBooking(BookingHandle handle) const;
+
+    // Thread-safe reads for concurrent callers such as the API server. Each callback runs while
+    // the entity's locks are held, so it sees a consistent customer and no cancel or swap in
+    // flight; seats may still be claimed meanwhile (each seat reads as booked or free, and a
+    // just-claimed seat may not have its booking yet). It must not call back into this system.
+    template<typename Fn> void forEachAirplane(Fn fn) const;  // fn(const Airplane&)
+    template<typename Fn> void forEachCustomer(Fn fn) const;  // fn(const Customer&)
+    template<typename Fn> void forEachBooking(Fn fn) const;   // fn(const Booking&)
+    // Paged forms for streaming a listing: visit entities from slot position `from` on until limit
+    // have been visited, under the same locks (taken for the one page only), and return the
+    // position to continue from, or LIST_END once the last slot was passed. Entities added or
+    // removed between pages may or may not be listed.
+    static constexpr std::uint32_t LIST_END = 0xFFFFFFFFu;
+    template<typename Fn> std::uint32_t forEachCustomerFrom(std::uint32_t from, std::size_t limit, Fn fn) const;
+    template<typename Fn> std::uint32_t forEachBookingFrom(std::uint32_t from, std::size_t limit, Fn fn) const;
+    // fn(const Airplane&, const std::vector<const Booking*>& seatBookings); false if no such flight
+    template<typename Fn> bool visitFlight(const std::string& flightNumber, std::vector<const Booking*>& seatBookings, Fn fn) const;
+    // fn(const Customer&, const std::vector<const Booking*>& bookings); false if no such customer
+    template<typename Fn> bool visitCustomer(const std::string& customerId, Fn fn) const;
+    // Parallel counterparts of forEachAirplane/forEachCustomer for bulk work: each entity is its own
+    // task on executor, run under the same locks, and the call returns once all have run (the first
+    // exception fn throws is rethrown). fn runs on several threads at once. Airplanes and customers
+    // added meanwhile wait until the call returns.
+    template<typename Fn> void parallelForEachAirplane(Fn fn, WorkStealingExecutor& executor = WorkStealingExecutor::global()) const;
+    template<typename Fn> void parallelForEachCustomer(Fn fn, WorkStealingExecutor& executor = WorkStealingExecutor::global()) const;
+
+    // Lock-free snapshot reads: fn(const FlightSnapshot&) sees one immutable published version of
+    // the flight and never blocks or is blocked by bookings. The snapshot is only valid inside fn.
+    template<typename Fn> bool readFlightSnapshot(const std::string& flightNumber, Fn fn) const; // false if no such flight
+    template<typename Fn> void forEachFlightSnapshot(Fn fn) const; // In the order airplanes were added
+    // Fare changes go through these rather than Airplane::setSeatPrice, so they are written to the
+    // write-ahead log (a SET_FARES record), a running checkpoint keeps the fares of its cut and the
+    // flight's snapshot is republished. setSeatPrice fails if there is no such flight or seat or the
+    // price is negative; repriceFlightInternal sets one flight's seats as repriceAllFlightsInternal
+    // does. Both also fail, with the change applied, if the log does.
+    bool setSeatPrice(const std::string& flightNumber, int seatIndex, double price, std::string& errorMessage);
+    bool repriceFlightInternal(const std::string& flightNumber, const std::function<double(const Airplane&, int)>& priceOf,
+                               std::size_t& changedCount, std::string& errorMessage);
+
+    Cents getRevenueCents() const;
+
     std::string generateUniqueCustomerId(); // Made public for testing
     static void resetCustomerIdCounterForTest(); // For predictable IDs in tests
 
 private: // Back to private for other members
     // std::string generateUniqueFlightNumber(); // If airplanes are dynamically added
 
+    // Append an entity and register it in the matching index
+    CustomerHandle addCustomerRecord(const std::string& name, int age, const std::string& customerId, double money,
+                                     WriteAheadLog::Lsn* logged = nullptr); // With logged: also logs it, under the same lock
+    CustomerHandle addCustomerLocked(const std::string& name, int age, const std::string& customerId, double money,
+                                     WriteAheadLog::Lsn* logged); // Caller holds registryMutex exclusively
+    AirplaneHandle addAirplaneRecord(const std::string& flightNumber, int rows, int seatsPerRow);
+    std::vector<AirplaneHandle> listAirplaneHandles() const; // In insertion order, for the console menus
+
+    // Index lookups without locking; the caller holds registryMutex (or bookingMutex for bookings)
+    CustomerHandle customerHandleOf(const std::string& customerId) const;
+    AirplaneHandle airplaneHandleOf(const std::string& flightNumber) const;
+    BookingHandle bookingHandleOf(const std::string& bookingId) const;
+    BookingHandle bookingHandleOf(std::uint64_t bookingNumber) const;
+    BookingHandle seatBookingAt(AirplaneHandle airplane, int seatIndex) const; // Caller holds registryMutex
+    void createSeatBookingRow(AirplaneHandle airplane, int capacity);          // Caller holds registryMutex exclusively
+    // Caller holds registryMutex and the flight's shard (or the customer's shard)
+    void collectSeatBookings(AirplaneHandle airplane, std::vector<const Booking*>& out) const;
+    void collectCustomerBookings(CustomerHandle customer, std::vector<const Booking*>& out) const;
+    // fn(BookingHandle) for each of the customer's bookings, oldest first; same locking as above
+    template<typename Fn> void forEachCustomerBookingHandle(CustomerHandle customer, Fn fn) const;
+
+    // Snapshot publishing. publishNewFlight: caller holds registryMutex exclusively.
+    // publishSeats re-reads the given seats (at most two) from the live state and swaps in a new version.
+    void publishNewFlight(AirplaneHandle airplane);
+    void publishNewFlights(const AirplaneHandle* airplanes, std::size_t count); // One directory version for all of them
+    void publishSeats(AirplaneHandle airplane, std::initializer_list<int> seatIndexes);
+    void publishPrices(AirplaneHandle airplane); // Fares re-read from the airplane; caller holds registryMutex
+    void publishFlight(AirplaneHandle airplane); // Every seat re-read; caller holds registryMutex
+    FlightSnapshot::SeatOwner seatOwnerAt(AirplaneHandle airplane, int seatIndex) const;
+    FlightSnapshot::SeatOwner seatOwnerLocked(BookingHandle holder) const; // Caller holds bookingMutex
+    // The cell's version, built first if it has none yet; takes bookingMutex shared only then
+    const FlightSnapshot* currentSnapshot(const FlightCell& cell) const;
+    void discardSnapshots(); // Deletes every cell's snapshot and the directory; no reader may be active
+    void clearEntities();    // Empties every map and index; caller holds registryMutex and bookingMutex exclusively
+
+    // Booking bookkeeping shared by the console handlers and the *Internal API methods.
+    // These keep bookingIndex, seatBookings and customerBookings in step with the bookings map.
+    // The *Internal callers hold registryMutex and the customer's shard; cancels and swaps also
+    // hold the flight's shard. A seat's entry is written only by whoever holds the seat's claim.
+    BookingHandle addBookingRecord(CustomerHandle customer, AirplaneHandle airplane, int seatIndex, Cents paidCents,
+                                   BookingStatus status = BookingStatus::CONFIRMED, std::uint64_t bookingNumber = 0); // 0: a new number
+    // createBookingInternal up to the wait for the log: the caller holds registryMutex shared.
+    // Null with errorMessage if the booking was refused; lsn is its log record otherwise.
+    BookingHandle bookSeatLocked(const std::string& customerId, const std::string& flightNumber, const std::string& seatId,
+                                 WriteAheadLog::Lsn& lsn, std::string& errorMessage);
+    Cents refundBooking(Booking& booking, Customer& customer); // Credits what the booking paid; returns it
+    void releaseSeatBooking(BookingHandle booking);
+    // Exchanges two bookings' flights and seats and their seat -> booking index entries; the seats
+    // are the bookings' current ones. Caller holds both flights' shards.
+    void swapSeatBookings(BookingHandle booking1, AirplaneHandle airplane1, int seatIndex1,
+                          BookingHandle booking2, AirplaneHandle airplane2, int seatIndex2);
+    // Locks the shards of the flights the bookings are on (second may be null) plus the given customer
+    // shards. A cross-flight swap can move a booking until its flight's shard is held, so the flights
+    // are re-read under the locks and the locking retried if one moved. Caller holds registryMutex.
+    void lockBookingShards(ShardLockGuard& shards, const Booking& first, const Booking* second,
+                           std::initializer_list<std::uint32_t> customerSlots);
+    // One flight's share of the bulk operations below; caller holds registryMutex
+    std::size_t repriceFlight(AirplaneHandle airplane, const std::function<double(const Airplane&, int)>& priceOf,
+                              WriteAheadLog::Lsn& lastLogged);
+    WriteAheadLog::Lsn logFares(const Airplane& airplane, int firstSeatIndex, int endSeatIndex); // Under the flight lock
+    std::size_t cancelFlightBookings(AirplaneHandle airplane, WriteAheadLog::Lsn& lastLogged);
+
+    // Write-ahead logging. logMutation returns 0 when no log is open. awaitLogged waits until that
+    // record is durable; on a log failure it replaces errorMessage and returns false (the change
+    // stays applied in memory but may be lost on restart). applyLogRecord redoes one recovered record.
+    WriteAheadLog::Lsn logMutation(const WalRecord& record);
+    bool awaitLogged(WriteAheadLog::Lsn lsn, std::string& errorMessage);
+    bool applyLogRecord(const WalRecord& record, std::string& errorMessage);
+
+    // Hold bookkeeping. finishHold confirms or releases a PENDING booking under its flight and
+    // customer shards; the caller holds registryMutex. false (with errorMessage) if it is no longer held.
+    enum class HoldOutcome { CONFIRM, RELEASE };
+    bool finishHold(BookingHandle booking, HoldOutcome outcome, std::string& errorMessage, WriteAheadLog::Lsn* logged = nullptr);
+    void scheduleHoldExpiry(BookingHandle booking, std::chrono::steady_clock::time_point deadline);
+    std::uint64_t holdTickOf(std::chrono::steady_clock::time_point time) const; // Whole ticks since holdEpoch
+    void runHoldExpiry(); // Body of holdExpiryThread
+    void stopHoldExpiryThread();
+
+    // Checkpoint bookkeeping: each runs before the first change a writer makes to the entity and
+    // costs an atomic load unless a checkpoint is copying. The caller holds registryMutex.
+    void preserveFares(AirplaneHandle handle, const Airplane& airplane);
+    void preserveBooking(BookingHandle handle, const Booking& booking);
+    void preserveBalance(CustomerHandle handle, const Customer& customer);
+    static BookingImage imageOf(const Booking& booking);
+    void runCheckpoints(std::string snapshotPath, std::chrono::milliseconds interval,
+                        std::function<void(bool, const std::string&)> report); // Body of checkpointThread
+    void stopCheckpointThread();
+
     // Menu interaction methods
     void displayMainMenu() const;
     void handleAddCustomer();
@@ -58,17 +328,250 @@ public:
     void setInputStreamForTest(std::istream& inputStream);
     void setOutputStreamForTest(std::ostream& outputStream);
     void resetSystemForTest(); // Clears vectors
-    const std::vector<Customer>& getCustomersForTest() const { return customers; }
-    const std::vector<Airplane>& getAirplanesForTest() const { return airplanes; }
-    const std::vector<Booking>& getBookingsForTest() const { return bookings; }
+    const SlotMap<Customer>& getCustomersForTest() const { return customers; }
+    const SlotMap<Airplane>& getAirplanesForTest() const { return airplanes; }
+    const SlotMap<Booking>& getBookingsForTest() const { return bookings; }
 
-    // Methods for API interaction (programmatic, no console I/O)
+    // Methods for API interaction (programmatic, no console I/O). These are safe to call from
+    // several threads at once; the interactive console (run()) is single-threaded.
     Customer* addCustomerInternal(const std::string& name, int age, double money, bool autoGenerate);
+    Airplane* addAirplaneInternal(const std::string& flightNumber, int rows, int seatsPerRow, std::string& errorMessage);
     Booking* createBookingInternal(const std::string& customerId, const std::string& flightNumber, const std::string& seatId, std::string& errorMessage);
     bool cancelBookingInternal(const std::string& bookingId, std::string& errorMessage);
     bool swapSeatsInternal(const std::string& bookingId1, const std::string& bookingId2, std::string& errorMessage);
+
+    // Checkout holds: holdSeatInternal claims the seat for holdFor as a PENDING booking without
+    // charging the customer (whose balance must cover the fare at that moment). Confirming charges
+    // the fare and makes the booking CONFIRMED; releasing, or the hold running out, frees the seat.
+    Booking* holdSeatInternal(const std::string& customerId, const std::string& flightNumber, const std::string& seatId,
+                              std::chrono::milliseconds holdFor, std::string& errorMessage);
+    bool confirmHoldInternal(const std::string& bookingId, std::string& errorMessage);
+    bool releaseHoldInternal(const std::string& bookingId, std::string& errorMessage);
+    // Releases every hold due by now and returns how many were released. The expiry thread calls
+    // this with the current time; tests call it with a later one instead of waiting.
+    std::size_t expireHolds(std::chrono::steady_clock::time_point now);
+
+    // Bulk operations, fanned out over executor one flight per task; safe alongside everything above.
+    // repriceAllFlightsInternal sets every seat's fare to priceOf(airplane, seatIndex) (called on
+    // several threads at once; negative results leave the fare alone), logs and republishes each
+    // flight's fares and counts the fares that changed; false only if the log failed. Existing
+    // bookings keep what they paid; a booking racing the re-price pays the old or the new fare of its seat.
+    bool repriceAllFlightsInternal(const std::function<double(const Airplane&, int)>& priceOf, std::size_t& changedCount,
+                                   std::string& errorMessage, WorkStealingExecutor& executor = WorkStealingExecutor::global());
+    // Cancels every confirmed booking (with a refund) and releases every hold on the given flights.
+    // Nothing is cancelled if a flight does not exist. A seat claimed while its flight is being
+    // cleared may still end up booked.
+    bool cancelFlightBookingsInternal(const std::vector<std::string>& flightNumbers, std::size_t& cancelledCount,
+                                      std::string& errorMessage, WorkStealingExecutor& executor = WorkStealingExecutor::global());
+
+    // Bulk import (see BulkImporter). Each call applies a batch of rows in order under one registry
+    // lock, with the checks and logging of the matching *Internal call, and waits once for the whole
+    // batch to be durable. A row that fails its checks is skipped, its index and reason appended to
+    // rejected (in index order). false with errorMessage only if the log failed (the batch stays
+    // applied in memory). importBookings spreads the flights over executor: each flight's rows still
+    // apply in order, but which of a customer's bookings on different flights runs out of funds first
+    // is not fixed.
+    struct ImportedAirplane {
+        std::string flightNumber;
+        int rows = 0;
+        int seatsPerRow = 0;
+    };
+    struct ImportedCustomer {
+        std::string customerId; // Empty: a new ID is generated
+        std::string name;
+        int age = 0;
+        double money = 0.0;
+    };
+    struct ImportedBooking { // Charged the seat's fare, like createBookingInternal
+        std::string customerId;
+        std::string flightNumber;
+        std::string seatId;
+    };
+    struct RejectedRow {
+        std::size_t index;
+        std::string reason;
+    };
+    bool importAirplanes(const std::vector<ImportedAirplane>& rows, std::vector<RejectedRow>& rejected, std::string& errorMessage);
+    bool importCustomers(const std::vector<ImportedCustomer>& rows, std::vector<RejectedRow>& rejected, std::string& errorMessage);
+    bool importBookings(const std::vector<ImportedBooking>& rows, std::vector<RejectedRow>& rejected, std::string& errorMessage,
+                        WorkStealingExecutor& executor = WorkStealingExecutor::global());
+
+    // Durability. Replays the write-ahead log at path onto the current state, then keeps appending
+    // to it: from then on addCustomerInternal, addAirplaneInternal, createBookingInternal,
+    // cancelBookingInternal (of confirmed bookings), swapSeatsInternal, confirmHoldInternal,
+    // cancelFlightBookingsInternal, setSeatPrice and the reprices log what they did and return only
+    // once options.durability is met. Pending holds and anything done through the console menus are
+    // not logged. Call once,
+    // before serving requests, on the same starting state the log was written from (the seeded
+    // system, one reset with resetSystemForTest, or the snapshot just loaded). The segments saveSnapshot
+    // rotated out (path.<generation>) are replayed first, oldest first, skipping what the loaded
+    // snapshot already includes. false with errorMessage if the log cannot be read or does not fit
+    // the state; on success errorMessage reports how many records were replayed.
+    bool openWriteAheadLog(const std::string& path, const WriteAheadLog::Options& options, std::string& errorMessage);
+    const WriteAheadLog* getWriteAheadLog() const { return wal.get(); } // Null if none is open
+    // Group commit for one thread applying many mutations in a row (CommandPipeline's writer): while
+    // the calling thread has deferred durability, the methods above log as usual but return without
+    // waiting for their records. takeDeferredLsn returns the highest LSN the thread logged since its
+    // last call (0: none); awaitDurable then waits once for the whole run, replacing errorMessage and
+    // returning false on a log failure. Nothing applied meanwhile may be reported before that.
+    static void setDurabilityDeferred(bool deferred); // The calling thread only
+    static WriteAheadLog::Lsn takeDeferredLsn();
+    bool awaitDurable(WriteAheadLog::Lsn lsn, std::string& errorMessage) { return awaitLogged(lsn, errorMessage); }
+
+    // Binary snapshots (see SnapshotFile). saveSnapshot is a checkpoint: it briefly takes
+    // registryMutex exclusively to fix a point in time (the cut), then copies airplanes, customers
+    // and bookings as they were at the cut while mutations go on, preserving what they change
+    // before they change it (copy-on-write). With a write-ahead log open it first rotates the log,
+    // records in the snapshot where the cut fell in it, flushes the log up to there and, once the
+    // snapshot is durable, removes the log segments it covers. Pending holds are not saved. On
+    // success errorMessage reports what was written.
+    bool saveSnapshot(const std::string& path, std::string& errorMessage);
+    // Replaces the whole state with the snapshot at path, keeping the file mapped: restored
+    // customers and bookings are found through it rather than through freshly built hash indexes.
+    // Call before serving requests and before openWriteAheadLog, which then replays only the log
+    // records from after the snapshot's cut. Each flight's seat map is built on its first read.
+    // false with errorMessage if the file cannot be read or is damaged (the state is kept), or if it
+    // repeats a flight number or holds a negative fare (the system is left empty).
+    bool loadSnapshot(const std::string& path, std::string& errorMessage);
+    // Runs saveSnapshot(path) on a background thread every interval in which the write-ahead log
+    // grew (every interval if no log is open), passing each outcome and message to report. Stopped
+    // by the destructor. Call at most once.
+    void startCheckpoints(const std::string& path, std::chrono::milliseconds interval,
+                          std::function<void(bool, const std::string&)> report);
 };
 
+template<typename Fn>
+void ReservationSystem::forEachAirplane(Fn fn) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    for (auto it = airplanes.begin(); it != airplanes.end(); ++it) {
+        std::lock_guard<std::mutex> flight(flightLocks.forSlot(it.handle().index()));
+        fn(*it);
+    }
+}
+
+template<typename Fn>
+void ReservationSystem::forEachCustomer(Fn fn) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    for (auto it = customers.begin(); it != customers.end(); ++it) {
+        std::lock_guard<std::mutex> customer(customerLocks.forSlot(it.handle().index()));
+        fn(*it);
+    }
+}
+
+template<typename Fn>
+void ReservationSystem::forEachBooking(Fn fn) const {
+    std::shared_lock<std::shared_mutex> lock(bookingMutex); // Status and seat are atomics inside Booking
+    for (const Booking& booking : bookings) {
+        fn(booking);
+    }
+}
+
+template<typename Fn>
+std::uint32_t ReservationSystem::forEachCustomerFrom(std::uint32_t from, std::size_t limit, Fn fn) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    std::uint32_t slot = from;
+    for (std::size_t visited = 0; slot < customers.slotCount() && visited < limit; ++slot) {
+        CustomerHandle handle = customers.handleAt(slot);
+        if (!handle) continue;
+        std::lock_guard<std::mutex> customer(customerLocks.forSlot(slot));
+        fn(*customers.get(handle));
+        ++visited;
+    }
+    return slot < customers.slotCount() ? slot : LIST_END;
+}
+
+template<typename Fn>
+std::uint32_t ReservationSystem::forEachBookingFrom(std::uint32_t from, std::size_t limit, Fn fn) const {
+    std::shared_lock<std::shared_mutex> lock(bookingMutex);
+    std::uint32_t slot = from;
+    for (std::size_t visited = 0; slot < bookings.slotCount() && visited < limit; ++slot) {
+        BookingHandle handle = bookings.handleAt(slot);
+        if (!handle) continue;
+        fn(*bookings.get(handle));
+        ++visited;
+    }
+    return slot < bookings.slotCount() ? slot : LIST_END;
+}
+
+template<typename Fn>
+bool ReservationSystem::visitFlight(const std::string& flightNumber, std::vector<const Booking*>& seatBookings, Fn fn) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    AirplaneHandle handle = airplaneHandleOf(flightNumber);
+    const Airplane* airplane = airplanes.get(handle);
+    if (!airplane) {
+        seatBookings.clear();
+        return false;
+    }
+    std::lock_guard<std::mutex> flight(flightLocks.forSlot(handle.index()));
+    collectSeatBookings(handle, seatBookings);
+    fn(*airplane, seatBookings);
+    return true;
+}
+
+template<typename Fn>
+bool ReservationSystem::visitCustomer(const std::string& customerId, Fn fn) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    CustomerHandle handle = customerHandleOf(customerId);
+    const Customer* customer = customers.get(handle);
+    if (!customer) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(customerLocks.forSlot(handle.index()));
+    std::vector<const Booking*> customerBookingList;
+    collectCustomerBookings(handle, customerBookingList);
+    fn(*customer, customerBookingList);
+    return true;
+}
+
+template<typename Fn>
+void ReservationSystem::parallelForEachAirplane(Fn fn, WorkStealingExecutor& executor) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex); // Held for the tasks too: they run inside this call
+    std::vector<AirplaneHandle> handles;
+    handles.reserve(airplanes.size());
+    for (auto it = airplanes.begin(); it != airplanes.end(); ++it) {
+        handles.push_back(it.handle());
+    }
+    executor.parallelFor(0, handles.size(), 1, [&](std::size_t i) {
+        std::lock_guard<std::mutex> flight(flightLocks.forSlot(handles[i].index()));
+        fn(*airplanes.get(handles[i]));
+    });
+}
+
+template<typename Fn>
+void ReservationSystem::parallelForEachCustomer(Fn fn, WorkStealingExecutor& executor) const {
+    std::shared_lock<std::shared_mutex> registry(registryMutex);
+    std::vector<CustomerHandle> handles;
+    handles.reserve(customers.size());
+    for (auto it = customers.begin(); it != customers.end(); ++it) {
+        handles.push_back(it.handle());
+    }
+    executor.parallelFor(0, handles.size(), 1, [&](std::size_t i) {
+        std::lock_guard<std::mutex> customer(customerLocks.forSlot(handles[i].index()));
+        fn(*customers.get(handles[i]));
+    });
+}
+
+template<typename Fn>
+bool ReservationSystem::readFlightSnapshot(const std::string& flightNumber, Fn fn) const {
+    EpochDomain::Guard guard;
+    const FleetDirectory* directory = fleet.load(std::memory_order_seq_cst);
+    if (!directory) return false;
+    auto it = directory->byNumber.find(flightNumber);
+    if (it == directory->byNumber.end()) return false;
+    fn(*currentSnapshot(*it->second));
+    return true;
+}
+
+template<typename Fn>
+void ReservationSystem::forEachFlightSnapshot(Fn fn) const {
+    EpochDomain::Guard guard;
+    const FleetDirectory* directory = fleet.load(std::memory_order_seq_cst);
+    if (!directory) return;
+    for (const FlightCell* cell : directory->flights) {
+        fn(*currentSnapshot(*cell));
+    }
+}
+
 // Template function definition needs to be in the header or an included .tpp/.ipp file
 template<typename T>
 T ReservationSystem::getValidatedInput(const std::string& prompt) {
@@ -21,18 +21,32 @@ Seat::Seat(const std::string& id, SeatClass sc, double basePrice)
     // std::cout << "Seat constructor called for " << this->seatId << std::endl; // Optional
 }
 
+Seat::Seat(const Seat& other)
+    : seatId(other.seatId), isBooked(other.getIsBooked()),
+      price(other.price), seatClass(other.seatClass) {}
+
+Seat& Seat::operator=(const Seat& other) {
+    seatId = other.seatId;
+    isBooked.store(other.getIsBooked(), std::memory_order_relaxed);
+    occupancy = nullptr;
+    occupancyIndex = -1;
+    price = other.price;
+    seatClass = other.seatClass;
+    return *this;
+}
+
 // Destructor
 Seat::~Seat() {
     // std::cout << "Seat destructor called for " << this->seatId << std::endl; // Optional
 }
 
 // Getters
-std::string Seat::getSeatId() const {
+const std::string& Seat::getSeatId() const {
     return seatId;
 }
 
 bool Seat::getIsBooked() const {
-    return isBooked;
+    return occupancy ? occupancy->test(occupancyIndex) : isBooked.load(std::memory_order_relaxed);
 }
 
 double Seat::getPrice() const {
@@ -55,21 +69,19 @@ void Seat::setPrice(double newPrice) {
     // else { std::cerr << "Price cannot be negative." << std::endl; } // Optional error handling
 }
 
+void Seat::bindOccupancy(const AtomicSeatBitset* bits, int index) {
+    occupancy = bits;
+    occupancyIndex = index;
+}
+
 // Booking operations
 bool Seat::bookSeat() {
-    if (!isBooked) {
-        isBooked = true;
-        return true; // Successfully booked
-    }
-    return false; // Already booked
+    // true if this call did the booking, false if the seat was already booked
+    return !occupancy && !isBooked.exchange(true, std::memory_order_relaxed);
 }
 
 bool Seat::unbookSeat() {
-    if (isBooked) {
-        isBooked = false;
-        return true; // Successfully unbooked
-    }
-    return false; // Was not booked
+    return !occupancy && isBooked.exchange(false, std::memory_order_relaxed); // false if it was not booked
 }
 
 // Display
@@ -77,5 +89,5 @@ void Seat::displaySeatInfo() const {
     std::cout << "Seat ID: " << seatId
               << ", Class: " << getSeatClassString()
               << ", Price: $" << std::fixed << std::setprecision(2) << price
-              << ", Status: " << (isBooked ? "Booked" : "Available") << std::endl;
+              << ", Status: " << (getIsBooked() ? "Booked" : "Available") << std::endl;
 }
@@ -1,6 +1,8 @@
 #ifndef SEAT_H
 #define SEAT_H
 
+#include "AtomicSeatBitset.h"
+#include <atomic>
 #include <string>
 #include <iostream> // For display
 
@@ -11,12 +13,14 @@ enum class SeatClass {
 };
 
 // Forward declaration if needed, but not for simple enums like this
-// std::string seatClassToString(SeatClass sc); // Helper function prototype
+std::string seatClassToString(SeatClass sc); // "Economy" / "Business"
 
 class Seat {
 private:
     std::string seatId;     // e.g., "1A", "12F"
-    bool isBooked;
+    std::atomic<bool> isBooked; // Standalone seats only
+    const AtomicSeatBitset* occupancy = nullptr; // An Airplane's seat reads its occupancy bit instead
+    int occupancyIndex = -1;
     double price;
     SeatClass seatClass;
 
@@ -24,11 +28,14 @@ public:
     // Constructor
     Seat(const std::string& id = "N/A", SeatClass sc = SeatClass::ECONOMY, double basePrice = 50.0);
 
+    Seat(const Seat& other); // A copy is standalone, booked as the original was at the time
+    Seat& operator=(const Seat& other);
+
     // Destructor
     ~Seat();
 
     // Getters
-    std::string getSeatId() const;
+    const std::string& getSeatId() const;
     bool getIsBooked() const; // Renamed from isBooked to follow getter convention
     double getPrice() const;
     SeatClass getSeatClass() const;
@@ -38,7 +45,12 @@ public:
     void setPrice(double newPrice);
     // seatId and seatClass are typically set at creation and not changed.
 
-    // Booking operations
+    // Makes getIsBooked answer from bit `index` of occupancy (the Airplane's occupancy bitset, which
+    // must outlive the seat), so there is no second flag that a racing book and unbook could leave stale
+    void bindOccupancy(const AtomicSeatBitset* bits, int index);
+
+    // Booking operations, for standalone seats: an Airplane's seats are booked through the Airplane,
+    // and these return false for them
     bool bookSeat();   // Returns true if booking was successful
     bool unbookSeat(); // Returns true if unbooking was successful
 
@@ -0,0 +1,75 @@
+#include "SeatBitset.h"
+
+SeatBitset::SeatBitset(int size) : bitCount(0) {
+    resize(size);
+}
+
+void SeatBitset::resize(int size) {
+    bitCount = size > 0 ? size : 0;
+    words.assign((bitCount + 63) / 64, 0);
+}
+
+int SeatBitset::size() const {
+    return bitCount;
+}
+
+std::uint64_t SeatBitset::validMask(std::size_t wordIndex) const {
+    int remaining = bitCount - static_cast<int>(wordIndex * 64);
+    return remaining >= 64 ? ~0ULL : ((1ULL << remaining) - 1);
+}
+
+bool SeatBitset::test(int index) const {
+    return (words[index >> 6] >> (index & 63)) & 1ULL;
+}
+
+void SeatBitset::set(int index) {
+    words[index >> 6] |= 1ULL << (index & 63);
+}
+
+void SeatBitset::reset(int index) {
+    words[index >> 6] &= ~(1ULL << (index & 63));
+}
+
+int SeatBitset::count() const {
+    int total = 0;
+    for (std::uint64_t word : words) {
+        total += popcount(word);
+    }
+    return total;
+}
+
+int SeatBitset::countAnd(const SeatBitset& mask) const {
+    int total = 0;
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        total += popcount(words[w] & mask.words[w]);
+    }
+    return total;
+}
+
+int SeatBitset::countAndNot(const SeatBitset& mask) const {
+    int total = 0;
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        total += popcount(mask.words[w] & ~words[w] & validMask(w));
+    }
+    return total;
+}
+
+int SeatBitset::findFirstClear() const {
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        std::uint64_t free = ~words[w] & validMask(w);
+        if (free) {
+            return static_cast<int>(w * 64 + countTrailingZeros(free));
+        }
+    }
+    return -1;
+}
+
+int SeatBitset::findFirstClearIn(const SeatBitset& mask) const {
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        std::uint64_t free = mask.words[w] & ~words[w] & validMask(w);
+        if (free) {
+            return static_cast<int>(w * 64 + countTrailingZeros(free));
+        }
+    }
+    return -1;
+}
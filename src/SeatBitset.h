@@ -0,0 +1,92 @@
+#ifndef SEATBITSET_H
+#define SEATBITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Packed one-bit-per-seat set used by Airplane for occupancy and class masks.
+// Queries work a 64-bit word at a time so counting and searching cost
+// capacity / 64 popcounts instead of touching every Seat object.
+class SeatBitset {
+private:
+    std::vector<std::uint64_t> words;
+    int bitCount;
+
+    std::uint64_t validMask(std::size_t wordIndex) const; // Masks off bits past bitCount in the last word
+
+public:
+    explicit SeatBitset(int size = 0);
+
+    void resize(int size); // Clears all bits
+    int size() const;
+
+    bool test(int index) const;
+    void set(int index);
+    void reset(int index);
+
+    int count() const;                                 // Number of set bits
+    int countAnd(const SeatBitset& mask) const;        // |this & mask|
+    int countAndNot(const SeatBitset& mask) const;     // |mask & ~this|, e.g. free seats of a class
+    int findFirstClear() const;                        // -1 if every bit is set
+    int findFirstClearIn(const SeatBitset& mask) const; // First bit set in mask but clear here, or -1
+
+    // Raw 64-bit words, for callers that combine the set with their own per-word masks.
+    // Bits past size() in the last word are unspecified; AND with a mask that has them clear.
+    std::size_t wordCount() const { return words.size(); }
+    std::uint64_t word(std::size_t wordIndex) const { return words[wordIndex]; }
+
+    // Calls fn(index) for every clear bit, in ascending order
+    template<typename Fn>
+    void forEachClear(Fn fn) const {
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            std::uint64_t free = ~words[w] & validMask(w);
+            while (free) {
+                fn(static_cast<int>(w * 64 + countTrailingZeros(free)));
+                free &= free - 1;
+            }
+        }
+    }
+
+    // Calls fn(index) for every bit set in mask but clear here, in ascending order
+    template<typename Fn>
+    void forEachClearIn(const SeatBitset& mask, Fn fn) const {
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            std::uint64_t free = mask.words[w] & ~words[w] & validMask(w);
+            while (free) {
+                fn(static_cast<int>(w * 64 + countTrailingZeros(free)));
+                free &= free - 1;
+            }
+        }
+    }
+
+    // Portable bit helpers; compile to POPCNT/TZCNT when the target supports them
+    static int popcount(std::uint64_t word);
+    static int countTrailingZeros(std::uint64_t word); // word must be non-zero
+};
+
+inline int SeatBitset::popcount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline int SeatBitset::countTrailingZeros(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int n = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+#endif // SEATBITSET_H
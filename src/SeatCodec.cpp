@@ -0,0 +1,64 @@
+#include "SeatCodec.h"
+
+bool SeatCodec::parse(const std::string& seatId, int& row, int& column) {
+    // Shortest valid ID is "1A"; the longest is seven row digits plus a letter
+    if (seatId.size() < 2 || seatId.size() > 8) {
+        return false;
+    }
+    const size_t letterPos = seatId.size() - 1;
+    if (seatId[0] == '0') {
+        return false; // Rows are printed without leading zeros
+    }
+
+    int parsedRow = 0;
+    for (size_t i = 0; i < letterPos; ++i) {
+        char c = seatId[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        parsedRow = parsedRow * 10 + (c - '0');
+    }
+
+    // Column letters are 'A' + j, exactly as Airplane::initializeSeats generates them
+    int parsedColumn = static_cast<unsigned char>(seatId[letterPos]) - 'A';
+    if (parsedColumn < 0 || parsedColumn > MAX_COLUMN) {
+        return false;
+    }
+
+    row = parsedRow;
+    column = parsedColumn;
+    return true;
+}
+
+SeatKey SeatCodec::toKey(int row, int column) {
+    if (row <= 0 || row > MAX_ROW || column < 0 || column > MAX_COLUMN) {
+        return INVALID_KEY;
+    }
+    return (static_cast<SeatKey>(row) << 8) | static_cast<SeatKey>(column);
+}
+
+SeatKey SeatCodec::parseKey(const std::string& seatId) {
+    int row = 0;
+    int column = 0;
+    if (!parse(seatId, row, column)) {
+        return INVALID_KEY;
+    }
+    return toKey(row, column);
+}
+
+int SeatCodec::rowOf(SeatKey key) {
+    return static_cast<int>(key >> 8);
+}
+
+int SeatCodec::columnOf(SeatKey key) {
+    return static_cast<int>(key & 0xFF);
+}
+
+std::string SeatCodec::toSeatId(SeatKey key) {
+    if (key == INVALID_KEY) {
+        return std::string();
+    }
+    std::string id = std::to_string(rowOf(key));
+    id += static_cast<char>('A' + columnOf(key));
+    return id;
+}
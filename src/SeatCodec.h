@@ -0,0 +1,31 @@
+#ifndef SEATCODEC_H
+#define SEATCODEC_H
+
+#include <cstdint>
+#include <string>
+
+// Compact integer form of a seat ID: row number in the high bits, column (0 = 'A') in the low byte
+using SeatKey = std::uint32_t;
+
+// Converts between textual seat IDs ("12F") and row/column coordinates or SeatKeys.
+// Seat IDs follow the layout built by Airplane::initializeSeats: a 1-based row number
+// without leading zeros followed by a single column letter starting at 'A'.
+class SeatCodec {
+public:
+    static constexpr SeatKey INVALID_KEY = 0; // Row 0 never exists, so 0 is free to mean "invalid"
+    static constexpr int MAX_ROW = 9999999;   // Seven digits keeps row << 8 inside 32 bits
+    static constexpr int MAX_COLUMN = 255 - 'A'; // Highest column whose letter still fits in a char
+
+    // Parses seatId into a 1-based row and 0-based column. Returns false if malformed.
+    static bool parse(const std::string& seatId, int& row, int& column);
+
+    // Packs coordinates into a SeatKey (INVALID_KEY if out of range)
+    static SeatKey toKey(int row, int column);
+    static SeatKey parseKey(const std::string& seatId); // INVALID_KEY if malformed
+
+    static int rowOf(SeatKey key);
+    static int columnOf(SeatKey key);
+    static std::string toSeatId(SeatKey key); // Empty string for INVALID_KEY
+};
+
+#endif // SEATCODEC_H
@@ -0,0 +1,170 @@
+#include "ServerConfig.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    std::size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    std::size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+// Whole-string non-negative integer no larger than limit
+bool parseCount(const std::string& value, long long limit, long long& out) {
+    if (value.empty() || value.size() > 12 || !std::all_of(value.begin(), value.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+        return false;
+    }
+    out = std::stoll(value);
+    return out <= limit;
+}
+
+} // namespace
+
+bool ServerConfig::set(const std::string& rawKey, const std::string& value, std::string& errorMessage) {
+    std::string key = rawKey;
+    std::replace(key.begin(), key.end(), '-', '_');
+    if (key == "host") {
+        if (value.empty()) {
+            errorMessage = "host must not be empty.";
+            return false;
+        }
+        host = value;
+        return true;
+    }
+    if (key == "wal_path") {
+        walPath = value;
+        return true;
+    }
+    if (key == "snapshot_path") {
+        snapshotPath = value;
+        return true;
+    }
+    if (key == "durability") {
+        if (!WriteAheadLog::parseDurability(value, wal.durability)) {
+            errorMessage = "durability must be per-op, group or async.";
+            return false;
+        }
+        return true;
+    }
+    if (key == "mode") {
+        if (value != "locked" && value != "pipeline") {
+            errorMessage = "mode must be locked or pipeline.";
+            return false;
+        }
+        pipelineMode = value == "pipeline";
+        return true;
+    }
+
+    struct NumericKey {
+        const char* name;
+        long long min, max;
+    };
+    static const NumericKey numericKeys[] = {
+        {"port", 1, 65535}, {"keep_alive_timeout_s", 0, 3600}, {"loop_threads", 0, 1024},
+        {"min_workers", 1, 4096}, {"max_workers", 1, 4096}, {"max_queued", 1, 1000000},
+        {"target_wait_ms", 1, 600000}, {"max_wait_ms", 1, 600000}, {"adjust_interval_ms", 1, 600000},
+        {"shed_workers", 1, 256}, {"max_shed_queued", 0, 1000000}, {"wal_flush_ms", 1, 60000},
+        {"checkpoint_interval_s", 0, 86400},
+    };
+    const NumericKey* spec = nullptr;
+    for (const NumericKey& candidate : numericKeys) {
+        if (key == candidate.name) spec = &candidate;
+    }
+    if (!spec) {
+        errorMessage = "Unknown setting " + rawKey + ".";
+        return false;
+    }
+    long long number = 0;
+    if (!parseCount(value, spec->max, number) || number < spec->min) {
+        errorMessage = rawKey + " must be a whole number from " + std::to_string(spec->min) + " to " + std::to_string(spec->max) + ".";
+        return false;
+    }
+    if (key == "port") port = static_cast<int>(number);
+    else if (key == "keep_alive_timeout_s") keepAliveTimeoutSec = static_cast<int>(number);
+    else if (key == "loop_threads") loopThreads = static_cast<int>(number);
+    else if (key == "min_workers") pool.minWorkers = static_cast<int>(number);
+    else if (key == "max_workers") pool.maxWorkers = static_cast<int>(number);
+    else if (key == "max_queued") pool.maxQueued = static_cast<std::size_t>(number);
+    else if (key == "target_wait_ms") pool.targetWait = std::chrono::milliseconds(number);
+    else if (key == "max_wait_ms") pool.maxWait = std::chrono::milliseconds(number);
+    else if (key == "adjust_interval_ms") pool.adjustInterval = std::chrono::milliseconds(number);
+    else if (key == "shed_workers") pool.shedWorkers = static_cast<int>(number);
+    else if (key == "wal_flush_ms") wal.asyncFlushInterval = std::chrono::milliseconds(number);
+    else if (key == "checkpoint_interval_s") checkpointIntervalSec = static_cast<int>(number);
+    else pool.maxShedQueued = static_cast<std::size_t>(number);
+    return true;
+}
+
+bool ServerConfig::load(std::istream& in, std::string& errorMessage) {
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+        std::size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            errorMessage = "Line " + std::to_string(lineNumber) + ": expected key = value.";
+            return false;
+        }
+        if (!set(trim(line.substr(0, equals)), trim(line.substr(equals + 1)), errorMessage)) {
+            errorMessage = "Line " + std::to_string(lineNumber) + ": " + errorMessage;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ServerConfig::loadFile(const std::string& path, std::string& errorMessage) {
+    std::ifstream file(path);
+    if (!file) {
+        errorMessage = "Cannot open config file " + path + ".";
+        return false;
+    }
+    if (!load(file, errorMessage)) {
+        errorMessage = path + ": " + errorMessage;
+        return false;
+    }
+    return true;
+}
+
+bool ServerConfig::parseArguments(int argc, char** argv, std::string& errorMessage) {
+    for (int i = 1; i < argc; ++i) { // The file first, so that flags override it wherever they appear
+        std::string argument = argv[i];
+        if (argument.compare(0, 9, "--config=") == 0 && !loadFile(argument.substr(9), errorMessage)) {
+            return false;
+        }
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        std::size_t equals = argument.find('=');
+        if (argument.compare(0, 2, "--") != 0 || equals == std::string::npos) {
+            errorMessage = "Unexpected argument " + argument + ".";
+            return false;
+        }
+        std::string key = argument.substr(2, equals - 2);
+        if (key != "config" && !set(key, argument.substr(equals + 1), errorMessage)) {
+            return false;
+        }
+    }
+    return validate(errorMessage);
+}
+
+bool ServerConfig::validate(std::string& errorMessage) const {
+    if (pool.minWorkers > pool.maxWorkers) {
+        errorMessage = "min_workers must not exceed max_workers.";
+        return false;
+    }
+    if (pool.targetWait > pool.maxWait) {
+        errorMessage = "target_wait_ms must not exceed max_wait_ms.";
+        return false;
+    }
+    if (checkpointIntervalSec > 0 && snapshotPath.empty()) {
+        errorMessage = "checkpoint_interval_s needs snapshot_path.";
+        return false;
+    }
+    return true;
+}
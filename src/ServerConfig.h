@@ -0,0 +1,41 @@
+#ifndef SERVERCONFIG_H
+#define SERVERCONFIG_H
+
+#include "AdaptiveTaskQueue.h"
+#include "WriteAheadLog.h"
+#include <istream>
+#include <string>
+
+// airline_api_server and airline_api_server_epoll settings. A config file holds `key = value` lines (# starts a comment); the
+// same keys are accepted on the command line as --key=value with dashes or underscores, and the
+// command line wins over the file (--config=path names the file). Keys:
+//   host, port, mode (locked|pipeline), keep_alive_timeout_s (httplib backend only),
+//   loop_threads (epoll backend only; 0: one event loop per hardware thread),
+//   min_workers, max_workers, max_queued, target_wait_ms, max_wait_ms, adjust_interval_ms,
+//   shed_workers, max_shed_queued (see AdaptiveTaskQueue::Settings),
+//   wal_path (empty: no log), durability (per-op|group|async), wal_flush_ms (see WriteAheadLog),
+//   snapshot_path (empty: none; loaded at startup if present, written by POST /api/admin/snapshot),
+//   checkpoint_interval_s (0: off; otherwise a snapshot every so often while the log grows, which
+//   also drops the log segments it covers; needs snapshot_path)
+struct ServerConfig {
+    std::string host = "0.0.0.0";
+    int port = 8080;
+    bool pipelineMode = false;
+    int keepAliveTimeoutSec = 5;
+    int loopThreads = 0;
+    AdaptiveTaskQueue::Settings pool;
+    std::string walPath;
+    WriteAheadLog::Options wal;
+    std::string snapshotPath;
+    int checkpointIntervalSec = 0;
+
+    // Each returns false with errorMessage set on an unknown key, a malformed value or a setting
+    // out of range; config is then partly updated.
+    bool set(const std::string& key, const std::string& value, std::string& errorMessage);
+    bool load(std::istream& in, std::string& errorMessage); // Messages name the offending line
+    bool loadFile(const std::string& path, std::string& errorMessage);
+    bool parseArguments(int argc, char** argv, std::string& errorMessage); // Loads --config first
+    bool validate(std::string& errorMessage) const; // Cross-field checks, e.g. min_workers <= max_workers
+};
+
+#endif // SERVERCONFIG_H
@@ -0,0 +1,216 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Stable 32-bit reference to an element of a SlotMap<T>.
+// Low 24 bits: slot index. High 8 bits: generation of the slot when the handle was issued.
+// A handle whose generation no longer matches its slot (element erased or map cleared)
+// simply resolves to nullptr instead of dangling.
+template<typename T>
+class SlotHandle {
+private:
+    std::uint32_t value;
+
+public:
+    static constexpr std::uint32_t INDEX_BITS = 24;
+    static constexpr std::uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+
+    constexpr SlotHandle() : value(0) {} // Null handle: generation 0 is never issued
+    constexpr SlotHandle(std::uint32_t index, std::uint32_t generation)
+        : value((generation << INDEX_BITS) | (index & INDEX_MASK)) {}
+
+    static constexpr SlotHandle fromRaw(std::uint32_t raw) {
+        SlotHandle handle;
+        handle.value = raw;
+        return handle;
+    }
+
+    constexpr std::uint32_t index() const { return value & INDEX_MASK; }
+    constexpr std::uint32_t generation() const { return value >> INDEX_BITS; }
+    constexpr std::uint32_t raw() const { return value; }
+    constexpr bool isNull() const { return value == 0; }
+    constexpr explicit operator bool() const { return value != 0; }
+
+    constexpr bool operator==(const SlotHandle& other) const { return value == other.value; }
+    constexpr bool operator!=(const SlotHandle& other) const { return value != other.value; }
+};
+
+// Slot-map container: O(1) insert, erase and handle lookup.
+// Elements live in fixed-size chunks that are never moved, so pointers and handles stay
+// valid while the map grows. Erased slots go on a free list and are reused with a bumped
+// generation. Iteration visits live elements in slot order, which is insertion order
+// until the first erase.
+template<typename T>
+class SlotMap {
+public:
+    using Handle = SlotHandle<T>;
+
+    static constexpr std::uint32_t CHUNK_SIZE = 4096;
+    static constexpr std::uint32_t MAX_SLOTS = Handle::INDEX_MASK + 1;
+
+private:
+    struct Slot {
+        std::optional<T> value;
+        std::uint32_t generation = 1;
+        std::uint32_t nextFree = 0;
+    };
+
+    static constexpr std::uint32_t NO_FREE_SLOT = MAX_SLOTS;
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    std::uint32_t usedSlots;  // Slots [0, usedSlots) have been handed out at least once since the last clear()
+    std::uint32_t liveCount;
+    std::uint32_t freeHead;   // Head of the free list threaded through Slot::nextFree
+
+    Slot& slotAt(std::uint32_t index) { return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+    const Slot& slotAt(std::uint32_t index) const { return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE]; }
+
+    static std::uint32_t nextGeneration(std::uint32_t generation) {
+        return generation == 0xFF ? 1 : generation + 1; // 8 bits, skipping 0 (reserved for null)
+    }
+
+    std::uint32_t acquireSlot() {
+        if (freeHead != NO_FREE_SLOT) {
+            std::uint32_t index = freeHead;
+            freeHead = slotAt(index).nextFree;
+            return index;
+        }
+        if (usedSlots == MAX_SLOTS) {
+            throw std::length_error("SlotMap capacity exhausted");
+        }
+        if (usedSlots == chunks.size() * CHUNK_SIZE) {
+            chunks.emplace_back(new Slot[CHUNK_SIZE]);
+        }
+        return usedSlots++;
+    }
+
+public:
+    template<bool IsConst>
+    class BasicIterator {
+    private:
+        using MapType = typename std::conditional<IsConst, const SlotMap, SlotMap>::type;
+        MapType* map;
+        std::uint32_t index;
+
+        void skipEmpty() {
+            while (index < map->usedSlots && !map->slotAt(index).value) {
+                ++index;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::conditional<IsConst, const T*, T*>::type;
+        using reference = typename std::conditional<IsConst, const T&, T&>::type;
+
+        BasicIterator(MapType* m, std::uint32_t i) : map(m), index(i) { skipEmpty(); }
+
+        reference operator*() const { return *map->slotAt(index).value; }
+        pointer operator->() const { return &*map->slotAt(index).value; }
+        Handle handle() const { return Handle(index, map->slotAt(index).generation); }
+
+        BasicIterator& operator++() {
+            ++index;
+            skipEmpty();
+            return *this;
+        }
+        BasicIterator operator++(int) {
+            BasicIterator copy = *this;
+            ++(*this);
+            return copy;
+        }
+        bool operator==(const BasicIterator& other) const { return index == other.index; }
+        bool operator!=(const BasicIterator& other) const { return index != other.index; }
+    };
+
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    SlotMap() : usedSlots(0), liveCount(0), freeHead(NO_FREE_SLOT) {
+        // Reserving the whole chunk directory up front means growing never moves it
+        chunks.reserve(MAX_SLOTS / CHUNK_SIZE);
+    }
+
+    SlotMap(const SlotMap&) = delete;
+    SlotMap& operator=(const SlotMap&) = delete;
+
+    template<typename... Args>
+    Handle emplace(Args&&... args) {
+        std::uint32_t index = acquireSlot();
+        Slot& slot = slotAt(index);
+        slot.value.emplace(std::forward<Args>(args)...);
+        ++liveCount;
+        return Handle(index, slot.generation);
+    }
+
+    // Returns nullptr for null, erased or otherwise stale handles
+    T* get(Handle handle) {
+        if (handle.isNull() || handle.index() >= usedSlots) return nullptr;
+        Slot& slot = slotAt(handle.index());
+        return (slot.value && slot.generation == handle.generation()) ? &*slot.value : nullptr;
+    }
+
+    const T* get(Handle handle) const {
+        if (handle.isNull() || handle.index() >= usedSlots) return nullptr;
+        const Slot& slot = slotAt(handle.index());
+        return (slot.value && slot.generation == handle.generation()) ? &*slot.value : nullptr;
+    }
+
+    bool contains(Handle handle) const { return get(handle) != nullptr; }
+
+    // Handle of the element in slot index; null if the slot is empty
+    Handle handleAt(std::uint32_t index) const {
+        if (index >= usedSlots || !slotAt(index).value) return Handle();
+        return Handle(index, slotAt(index).generation);
+    }
+
+    bool erase(Handle handle) {
+        if (!get(handle)) return false;
+        Slot& slot = slotAt(handle.index());
+        slot.value.reset();
+        slot.generation = nextGeneration(slot.generation);
+        slot.nextFree = freeHead;
+        freeHead = handle.index();
+        --liveCount;
+        return true;
+    }
+
+    // Destroys every element and invalidates all outstanding handles; chunks are kept for reuse
+    void clear() {
+        for (std::uint32_t i = 0; i < usedSlots; ++i) {
+            Slot& slot = slotAt(i);
+            if (slot.value) {
+                slot.value.reset();
+            }
+            slot.generation = nextGeneration(slot.generation);
+        }
+        usedSlots = 0;
+        liveCount = 0;
+        freeHead = NO_FREE_SLOT;
+    }
+
+    std::size_t size() const { return liveCount; }
+    bool empty() const { return liveCount == 0; }
+    std::uint32_t slotCount() const { return usedSlots; } // Upper bound on handle indexes in use
+
+    T& front() { return *begin(); }
+    const T& front() const { return *begin(); }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, usedSlots); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, usedSlots); }
+};
+
+#endif // SLOTMAP_H
@@ -0,0 +1,371 @@
+#include "SnapshotFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint> // For INT32_MAX
+#include <cstdio>  // For std::rename
+#include <cstring> // For std::strerror, std::memcmp, std::memcpy
+#include <numeric> // For std::iota
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct SnapshotFile::FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;  // BYTE_ORDER_MARK as the writing host stores it
+    std::uint64_t fileSize;
+    std::int64_t revenueCents;
+    std::uint64_t nextCustomerNumber;
+    std::uint64_t maxBookingNumber;
+    std::uint64_t logGeneration;
+    std::uint64_t logOffset;
+    struct {
+        std::uint64_t offset;
+        std::uint64_t size;   // Bytes
+    } sections[SECTION_COUNT];
+};
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'A', 'R', 'S', 'S', 'N', 'A', 'P', '1'};
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+std::uint64_t alignUp(std::uint64_t offset) { return (offset + 7) & ~std::uint64_t(7); }
+
+#ifdef _WIN32
+int createForWrite(const std::string& path) { return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644); }
+bool syncFile(int fd) { return ::_commit(fd) == 0; }
+long writeSome(int fd, const char* data, std::size_t size) {
+    return ::_write(fd, data, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+}
+void closeFile(int fd) { ::_close(fd); }
+bool replaceFile(const std::string& from, const std::string& to) {
+    return ::MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+void syncParentDirectory(const std::string&) {} // NTFS makes the directory entry durable with the file
+#else
+int createForWrite(const std::string& path) { return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644); }
+bool syncFile(int fd) { return ::fsync(fd) == 0; }
+long writeSome(int fd, const char* data, std::size_t size) { return static_cast<long>(::write(fd, data, size)); }
+void closeFile(int fd) { ::close(fd); }
+bool replaceFile(const std::string& from, const std::string& to) { return std::rename(from.c_str(), to.c_str()) == 0; }
+
+// The rename is only durable once the directory itself is synced
+void syncParentDirectory(const std::string& path) {
+    std::size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirFd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+#endif
+
+bool writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        long written = writeSome(fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+// Read-only view of a whole file
+struct SnapshotFile::Mapping {
+    const char* data = nullptr;
+    std::uint64_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE view = nullptr;
+
+    bool map(const std::string& path) {
+        file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER length;
+        if (file == INVALID_HANDLE_VALUE || !::GetFileSizeEx(file, &length)) return false;
+        size = static_cast<std::uint64_t>(length.QuadPart);
+        if (size == 0) return true;
+        view = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        data = view ? static_cast<const char*>(::MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        return data != nullptr;
+    }
+    ~Mapping() {
+        if (data) ::UnmapViewOfFile(data);
+        if (view) ::CloseHandle(view);
+        if (file != INVALID_HANDLE_VALUE) ::CloseHandle(file);
+    }
+#else
+    bool map(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat status;
+        bool mapped = ::fstat(fd, &status) == 0;
+        if (mapped) {
+            size = static_cast<std::uint64_t>(status.st_size);
+            if (size > 0) {
+                void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                mapped = address != MAP_FAILED;
+                data = mapped ? static_cast<const char*>(address) : nullptr;
+            }
+        }
+        ::close(fd); // The mapping keeps the file open
+        return mapped;
+    }
+    ~Mapping() {
+        if (data) ::munmap(const_cast<char*>(data), size);
+    }
+#endif
+};
+
+SnapshotFile::StringRef SnapshotFile::Image::addString(const std::string& value) {
+    StringRef ref{strings.size(), static_cast<std::uint32_t>(value.size()), 0};
+    strings += value;
+    return ref;
+}
+
+SnapshotFile::SnapshotFile() = default;
+SnapshotFile::~SnapshotFile() = default;
+
+bool SnapshotFile::write(const std::string& path, const Image& image, std::string& errorMessage) {
+    // Lookup sections: row numbers ordered by customer ID and by booking number. Bookings are
+    // usually in number order already, as numbers grow with time.
+    auto textOf = [&image](const StringRef& ref) { return std::string_view(image.strings.data() + ref.offset, ref.length); };
+    std::vector<std::uint32_t> customersById(image.customers.size());
+    std::iota(customersById.begin(), customersById.end(), 0u);
+    std::sort(customersById.begin(), customersById.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return textOf(image.customers[a].id) < textOf(image.customers[b].id);
+    });
+    std::vector<std::uint32_t> bookingsByNumber(image.bookings.size());
+    std::iota(bookingsByNumber.begin(), bookingsByNumber.end(), 0u);
+    auto byNumber = [&image](std::uint32_t a, std::uint32_t b) { return image.bookings[a].number < image.bookings[b].number; };
+    if (!std::is_sorted(bookingsByNumber.begin(), bookingsByNumber.end(), byNumber)) {
+        std::sort(bookingsByNumber.begin(), bookingsByNumber.end(), byNumber);
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.revenueCents = image.revenueCents;
+    header.nextCustomerNumber = image.nextCustomerNumber;
+    header.logGeneration = image.logGeneration;
+    header.logOffset = image.logOffset;
+    for (const BookingRow& booking : image.bookings) {
+        header.maxBookingNumber = std::max(header.maxBookingNumber, booking.number);
+    }
+    const char* data[SECTION_COUNT] = {
+        reinterpret_cast<const char*>(image.airplanes.data()), reinterpret_cast<const char*>(image.seatPrices.data()),
+        reinterpret_cast<const char*>(image.seatBookings.data()),
+        reinterpret_cast<const char*>(image.customers.data()), reinterpret_cast<const char*>(customersById.data()),
+        reinterpret_cast<const char*>(image.customerBookings.data()), reinterpret_cast<const char*>(image.bookings.data()),
+        reinterpret_cast<const char*>(bookingsByNumber.data()), image.strings.data()};
+    const std::uint64_t sizes[SECTION_COUNT] = {
+        image.airplanes.size() * sizeof(AirplaneRow), image.seatPrices.size() * sizeof(double),
+        image.seatBookings.size() * sizeof(std::uint32_t),
+        image.customers.size() * sizeof(CustomerRow), customersById.size() * sizeof(std::uint32_t),
+        image.customerBookings.size() * sizeof(std::uint32_t), image.bookings.size() * sizeof(BookingRow),
+        bookingsByNumber.size() * sizeof(std::uint32_t), image.strings.size()};
+    std::uint64_t offset = alignUp(sizeof(FileHeader));
+    for (int section = 0; section < SECTION_COUNT; ++section) {
+        header.sections[section].offset = offset;
+        header.sections[section].size = sizes[section];
+        offset = alignUp(offset + sizes[section]);
+    }
+    header.fileSize = offset;
+
+    std::string temporary = path + ".tmp";
+    int fd = createForWrite(temporary);
+    if (fd < 0) {
+        errorMessage = "Cannot create " + temporary + ": " + std::strerror(errno) + ".";
+        return false;
+    }
+    static const char padding[8] = {};
+    bool written = writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+                   writeAll(fd, padding, header.sections[0].offset - sizeof(header));
+    for (int section = 0; written && section < SECTION_COUNT; ++section) {
+        std::uint64_t end = header.sections[section].offset + sizes[section];
+        std::uint64_t next = section + 1 < SECTION_COUNT ? header.sections[section + 1].offset : header.fileSize;
+        written = writeAll(fd, data[section], sizes[section]) && writeAll(fd, padding, next - end);
+    }
+    written = written && syncFile(fd);
+    int writeError = errno;
+    closeFile(fd);
+    if (!written || !replaceFile(temporary, path)) {
+        errorMessage = "Cannot write " + path + ": " + std::strerror(written ? errno : writeError) + ".";
+        std::remove(temporary.c_str());
+        return false;
+    }
+    syncParentDirectory(path);
+    return true;
+}
+
+std::unique_ptr<SnapshotFile> SnapshotFile::open(const std::string& path, std::string& errorMessage) {
+    std::unique_ptr<SnapshotFile> file(new SnapshotFile());
+    file->mapping.reset(new Mapping());
+    if (!file->mapping->map(path)) {
+        errorMessage = "Cannot open " + path + ": " + std::strerror(errno) + ".";
+        return nullptr;
+    }
+    const Mapping& mapping = *file->mapping;
+    FileHeader header;
+    if (mapping.size < sizeof(header) || std::memcmp(mapping.data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        errorMessage = path + " is not a reservation snapshot.";
+        return nullptr;
+    }
+    std::memcpy(&header, mapping.data, sizeof(header));
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        errorMessage = path + " was written on a host with the other byte order.";
+        return nullptr;
+    }
+    if (header.version != FORMAT_VERSION) {
+        errorMessage = path + " has snapshot format version " + std::to_string(header.version) + "; this build reads version " +
+                       std::to_string(FORMAT_VERSION) + ".";
+        return nullptr;
+    }
+    if (header.fileSize != mapping.size) {
+        errorMessage = path + " is truncated.";
+        return nullptr;
+    }
+    const std::size_t rowSizes[SECTION_COUNT] = {sizeof(AirplaneRow), sizeof(double), sizeof(std::uint32_t), sizeof(CustomerRow),
+                                                 sizeof(std::uint32_t), sizeof(std::uint32_t), sizeof(BookingRow),
+                                                 sizeof(std::uint32_t), 1};
+    for (int section = 0; section < SECTION_COUNT; ++section) {
+        std::uint64_t offset = header.sections[section].offset;
+        std::uint64_t size = header.sections[section].size;
+        if (offset % 8 != 0 || offset < sizeof(header) || offset > mapping.size || size > mapping.size - offset ||
+            size % rowSizes[section] != 0) {
+            errorMessage = path + " is damaged (section " + std::to_string(section) + " is out of bounds).";
+            return nullptr;
+        }
+        file->sections[section] = mapping.data + offset;
+        file->counts[section] = static_cast<std::size_t>(size / rowSizes[section]);
+    }
+    file->revenueCents = header.revenueCents;
+    file->nextCustomerNumber = header.nextCustomerNumber;
+    file->maxBookingNumber = header.maxBookingNumber;
+    file->logGeneration = header.logGeneration;
+    file->logOffset = header.logOffset;
+    if (!file->validate(errorMessage)) {
+        errorMessage = path + " is damaged (" + errorMessage + ").";
+        return nullptr;
+    }
+    return file;
+}
+
+bool SnapshotFile::validate(std::string& errorMessage) const {
+    auto inStrings = [this](const StringRef& ref) {
+        return ref.offset <= counts[STRINGS] && ref.length <= counts[STRINGS] - ref.offset;
+    };
+    if (counts[SEAT_BOOKINGS] != seatCount() || counts[CUSTOMERS_BY_ID] != customerCount() || counts[BOOKINGS_BY_NUMBER] != bookingCount() ||
+        counts[CUSTOMER_BOOKINGS] != bookingCount()) {
+        errorMessage = "index sizes do not match the tables";
+        return false;
+    }
+    std::uint64_t nextSeat = 0;
+    for (std::size_t row = 0; row < airplaneCount(); ++row) {
+        const AirplaneRow& airplane = airplanes()[row];
+        if (!inStrings(airplane.flightNumber) || airplane.rows <= 0 || airplane.seatsPerRow <= 0 ||
+            static_cast<std::int64_t>(airplane.rows) * airplane.seatsPerRow > INT32_MAX || airplane.firstSeat != nextSeat) {
+            errorMessage = "airplane " + std::to_string(row);
+            return false;
+        }
+        nextSeat += static_cast<std::uint64_t>(airplane.rows) * static_cast<std::uint64_t>(airplane.seatsPerRow);
+    }
+    if (nextSeat != seatCount()) {
+        errorMessage = "seat count";
+        return false;
+    }
+    std::uint64_t nextBooking = 0;
+    for (std::size_t row = 0; row < customerCount(); ++row) {
+        const CustomerRow& customer = customers()[row];
+        if (!inStrings(customer.id) || !inStrings(customer.name) || customer.firstBooking != nextBooking) {
+            errorMessage = "customer " + std::to_string(row);
+            return false;
+        }
+        nextBooking += customer.bookingCount;
+    }
+    if (nextBooking != bookingCount()) {
+        errorMessage = "customer booking count";
+        return false;
+    }
+    const std::uint32_t* byId = reinterpret_cast<const std::uint32_t*>(sections[CUSTOMERS_BY_ID]);
+    const std::uint32_t* byNumber = reinterpret_cast<const std::uint32_t*>(sections[BOOKINGS_BY_NUMBER]);
+    // Strictly ascending keys: lookups by binary search are exact and IDs are unique
+    for (std::size_t i = 0; i < customerCount(); ++i) {
+        if (byId[i] >= customerCount() || (i > 0 && !(text(customers()[byId[i - 1]].id) < text(customers()[byId[i]].id)))) {
+            errorMessage = "customer index";
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < bookingCount(); ++i) {
+        if (byNumber[i] >= bookingCount() || customerBookings()[i] >= bookingCount() ||
+            (i > 0 && bookings()[byNumber[i - 1]].number >= bookings()[byNumber[i]].number)) {
+            errorMessage = "booking index";
+            return false;
+        }
+    }
+    std::size_t confirmed = 0;
+    for (std::size_t row = 0; row < bookingCount(); ++row) {
+        const BookingRow& booking = bookings()[row];
+        if (booking.customer >= customerCount() || booking.airplane >= airplaneCount() || booking.seatIndex < 0 ||
+            booking.seatIndex >= airplanes()[booking.airplane].rows * airplanes()[booking.airplane].seatsPerRow ||
+            booking.status > 1) { // CONFIRMED or CANCELLED
+            errorMessage = "booking " + std::to_string(row);
+            return false;
+        }
+        confirmed += booking.status == 0;
+    }
+    // Each held seat names a confirmed booking of that seat, and there are as many held seats as
+    // confirmed bookings, so no booking holds two seats and none is left without one
+    std::size_t held = 0;
+    for (std::size_t row = 0; row < airplaneCount(); ++row) {
+        const AirplaneRow& airplane = airplanes()[row];
+        const std::uint32_t* holders = seatBookings() + airplane.firstSeat;
+        for (std::int32_t seat = 0; seat < airplane.rows * airplane.seatsPerRow; ++seat) {
+            if (holders[seat] == 0) continue;
+            const BookingRow* booking = holders[seat] <= bookingCount() ? &bookings()[holders[seat] - 1] : nullptr;
+            if (!booking || booking->status != 0 || booking->airplane != row || booking->seatIndex != seat) {
+                errorMessage = "seat " + std::to_string(seat) + " of airplane " + std::to_string(row);
+                return false;
+            }
+            ++held;
+        }
+    }
+    if (held != confirmed) {
+        errorMessage = "confirmed bookings without a seat";
+        return false;
+    }
+    return true;
+}
+
+long SnapshotFile::findCustomer(std::string_view customerId) const {
+    const std::uint32_t* byId = reinterpret_cast<const std::uint32_t*>(sections[CUSTOMERS_BY_ID]);
+    const std::uint32_t* end = byId + customerCount();
+    const std::uint32_t* it = std::lower_bound(byId, end, customerId, [this](std::uint32_t row, std::string_view id) {
+        return text(customers()[row].id) < id;
+    });
+    return it != end && text(customers()[*it].id) == customerId ? static_cast<long>(*it) : -1;
+}
+
+long SnapshotFile::findBooking(std::uint64_t bookingNumber) const {
+    const std::uint32_t* byNumber = reinterpret_cast<const std::uint32_t*>(sections[BOOKINGS_BY_NUMBER]);
+    const std::uint32_t* end = byNumber + bookingCount();
+    const std::uint32_t* it = std::lower_bound(byNumber, end, bookingNumber, [this](std::uint32_t row, std::uint64_t number) {
+        return bookings()[row].number < number;
+    });
+    return it != end && bookings()[*it].number == bookingNumber ? static_cast<long>(*it) : -1;
+}
@@ -0,0 +1,125 @@
+#ifndef SNAPSHOTFILE_H
+#define SNAPSHOTFILE_H
+
+#include "Money.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Versioned binary image of a ReservationSystem: airplanes with their seat fares, customers, and
+// bookings (confirmed and cancelled; pending holds are left out). A seat column names the confirmed
+// booking holding each seat, so a reader restores occupancy flight by flight.
+// The file is a header followed by fixed-size row tables, each on an 8-byte boundary, so a reader
+// maps it and uses the rows in place. Two sorted index sections answer customer-ID and
+// booking-number lookups by binary search, so no hash table has to be built before serving.
+// Rows are in host byte order; the header records it and a file from a host of the other order is
+// rejected. A snapshot is written to path + ".tmp", fsynced and renamed over path, so readers see
+// either the previous snapshot or the complete new one.
+class SnapshotFile {
+public:
+    static constexpr std::uint32_t FORMAT_VERSION = 2;
+
+    struct StringRef { // A range of the string table
+        std::uint64_t offset;
+        std::uint32_t length;
+        std::uint32_t reserved;
+    };
+    struct AirplaneRow {
+        StringRef flightNumber;
+        std::int32_t rows;
+        std::int32_t seatsPerRow;
+        std::uint64_t firstSeat; // Index of its first seat in seatPrices()
+    };
+    struct CustomerRow {
+        StringRef id;
+        StringRef name;
+        Cents balanceCents;
+        std::uint64_t firstBooking; // Its bookings are customerBookings()[firstBooking, + bookingCount)
+        std::uint32_t bookingCount;
+        std::int32_t age;
+    };
+    struct BookingRow {
+        std::uint64_t number;   // Booking::getBookingNumber()
+        Cents paidCents;
+        std::uint32_t customer; // Customer row
+        std::uint32_t airplane; // Airplane row; for a cancelled booking, where it was
+        std::int32_t seatIndex;
+        std::uint8_t status;    // BookingStatus
+        std::uint8_t reserved[3];
+    };
+
+    // What a snapshot is written from; rows refer to each other by position
+    struct Image {
+        std::vector<AirplaneRow> airplanes;
+        std::vector<double> seatPrices;              // Every airplane's seats in turn
+        std::vector<std::uint32_t> seatBookings;     // Aligned with seatPrices: 1 + row of the confirmed booking holding the seat, 0 if free
+        std::vector<CustomerRow> customers;
+        std::vector<std::uint32_t> customerBookings; // Booking rows grouped by customer, oldest first
+        std::vector<BookingRow> bookings;
+        std::string strings;
+        Cents revenueCents = 0;
+        std::uint64_t nextCustomerNumber = 1;        // Next number behind generated "CUST" IDs
+        std::uint64_t logGeneration = 0;             // Write-ahead log position the image includes everything
+        std::uint64_t logOffset = 0;                 // before (see WriteAheadLog::Position); 0, 0 without a log
+
+        StringRef addString(const std::string& value);
+    };
+
+private:
+    enum Section { AIRPLANES, SEAT_PRICES, SEAT_BOOKINGS, CUSTOMERS, CUSTOMERS_BY_ID, CUSTOMER_BOOKINGS,
+                   BOOKINGS, BOOKINGS_BY_NUMBER, STRINGS, SECTION_COUNT };
+
+    struct FileHeader;
+    struct Mapping; // Platform file mapping
+    std::unique_ptr<Mapping> mapping;
+    const char* sections[SECTION_COUNT] = {};
+    std::size_t counts[SECTION_COUNT] = {}; // Rows (bytes for STRINGS)
+    Cents revenueCents = 0;
+    std::uint64_t nextCustomerNumber = 1;
+    std::uint64_t maxBookingNumber = 0;
+    std::uint64_t logGeneration = 0;
+    std::uint64_t logOffset = 0;
+
+    SnapshotFile();
+    // Every row reference and string range lies inside the file, and the seat column and the
+    // confirmed bookings name each other
+    bool validate(std::string& errorMessage) const;
+
+public:
+    ~SnapshotFile();
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    // Sorts the lookup sections and writes image to path. false with errorMessage on an I/O error.
+    static bool write(const std::string& path, const Image& image, std::string& errorMessage);
+    // Maps path read-only and checks its structure; nullptr with errorMessage if it is missing,
+    // of another format or version, or damaged. The rows stay valid while the SnapshotFile lives.
+    static std::unique_ptr<SnapshotFile> open(const std::string& path, std::string& errorMessage);
+
+    std::size_t airplaneCount() const { return counts[AIRPLANES]; }
+    std::size_t seatCount() const { return counts[SEAT_PRICES]; }
+    std::size_t customerCount() const { return counts[CUSTOMERS]; }
+    std::size_t bookingCount() const { return counts[BOOKINGS]; }
+    const AirplaneRow* airplanes() const { return reinterpret_cast<const AirplaneRow*>(sections[AIRPLANES]); }
+    const double* seatPrices() const { return reinterpret_cast<const double*>(sections[SEAT_PRICES]); }
+    const std::uint32_t* seatBookings() const { return reinterpret_cast<const std::uint32_t*>(sections[SEAT_BOOKINGS]); }
+    const CustomerRow* customers() const { return reinterpret_cast<const CustomerRow*>(sections[CUSTOMERS]); }
+    const std::uint32_t* customerBookings() const { return reinterpret_cast<const std::uint32_t*>(sections[CUSTOMER_BOOKINGS]); }
+    const BookingRow* bookings() const { return reinterpret_cast<const BookingRow*>(sections[BOOKINGS]); }
+    std::string_view text(StringRef ref) const { return std::string_view(sections[STRINGS] + ref.offset, ref.length); }
+
+    Cents getRevenueCents() const { return revenueCents; }
+    std::uint64_t getNextCustomerNumber() const { return nextCustomerNumber; }
+    std::uint64_t getMaxBookingNumber() const { return maxBookingNumber; }
+    std::uint64_t getLogGeneration() const { return logGeneration; }
+    std::uint64_t getLogOffset() const { return logOffset; }
+
+    // Row of the customer or booking, by binary search over the sorted index sections; -1 if absent
+    long findCustomer(std::string_view customerId) const;
+    long findBooking(std::uint64_t bookingNumber) const;
+};
+
+#endif // SNAPSHOTFILE_H
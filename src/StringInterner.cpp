@@ -0,0 +1,61 @@
+#include "StringInterner.h"
+#include <mutex>
+
+InternedId StringInterner::intern(std::string_view value) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(value);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(value); // Another thread may have added it in between
+    if (it != ids.end()) {
+        return it->second;
+    }
+    InternedId id = static_cast<InternedId>(strings.size());
+    strings.emplace_back(value);
+    ids.emplace(std::string_view(strings.back()), id);
+    return id;
+}
+
+bool StringInterner::find(std::string_view value, InternedId& id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(value);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+const std::string& StringInterner::lookup(InternedId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex); // deque indexing races with a concurrent push_back
+    return strings[id];
+}
+
+std::size_t StringInterner::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return strings.size();
+}
+
+void StringInterner::reserve(std::size_t additional) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    ids.reserve(ids.size() + additional);
+}
+
+StringInterner& customerIdInterner() {
+    static StringInterner interner;
+    return interner;
+}
+
+StringInterner& flightNumberInterner() {
+    static StringInterner interner;
+    return interner;
+}
+
+StringInterner& seatLabelInterner() {
+    static StringInterner interner;
+    return interner;
+}
@@ -0,0 +1,41 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using InternedId = std::uint32_t;
+
+// Maps each distinct string to a small integer and back.
+// Ids are dense and start at 0; the strings themselves are stored once and never move,
+// so references returned by lookup() stay valid for the lifetime of the interner.
+// Safe to use from several threads.
+class StringInterner {
+private:
+    mutable std::shared_mutex mutex;
+    std::deque<std::string> strings;                        // Id -> string (stable addresses)
+    std::unordered_map<std::string_view, InternedId> ids;   // Views into `strings`
+
+public:
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    InternedId intern(std::string_view value);                  // Returns the existing id or adds a new one
+    bool find(std::string_view value, InternedId& id) const;   // false if the string was never interned
+    const std::string& lookup(InternedId id) const;             // id must come from intern()
+    std::size_t size() const;
+    void reserve(std::size_t additional);                       // Room for that many more strings without rehashing
+};
+
+// Process-wide tables shared by every Booking
+StringInterner& customerIdInterner();
+StringInterner& flightNumberInterner();
+StringInterner& seatLabelInterner(); // Only for seat labels SeatCodec cannot encode
+
+#endif // STRINGINTERNER_H
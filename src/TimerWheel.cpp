@@ -0,0 +1,85 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(std::uint64_t startTick) : levelCount{}, now(startTick), count(0) {}
+
+void TimerWheel::place(const Timer& timer) {
+    // deadline == now only happens while cascading, just before the current level-0 slot fires
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = level * SLOT_BITS;
+        if ((timer.deadline >> shift) - (now >> shift) < static_cast<std::uint64_t>(SLOTS)) { // Fits this level's rotation
+            slots[level][(timer.deadline >> shift) & (SLOTS - 1)].push_back(timer);
+            ++levelCount[level];
+            return;
+        }
+    }
+    // Beyond the wheel's span: park in the farthest top-level slot and re-place it from there
+    int shift = (LEVELS - 1) * SLOT_BITS;
+    slots[LEVELS - 1][((now >> shift) + SLOTS - 1) & (SLOTS - 1)].push_back(timer);
+    ++levelCount[LEVELS - 1];
+}
+
+void TimerWheel::cascade(int level) {
+    std::vector<Timer>& slot = slots[level][(now >> (level * SLOT_BITS)) & (SLOTS - 1)];
+    cascading.swap(slot);
+    levelCount[level] -= cascading.size();
+    for (const Timer& timer : cascading) {
+        place(timer);
+    }
+    cascading.clear();
+}
+
+void TimerWheel::schedule(std::uint64_t deadlineTick, std::uint64_t payload) {
+    place(Timer{deadlineTick > now ? deadlineTick : now + 1, payload});
+    ++count;
+}
+
+void TimerWheel::advanceTo(std::uint64_t tick, std::vector<std::uint64_t>& expired) {
+    while (now < tick) {
+        if (count == 0) {
+            now = tick;
+            return;
+        }
+        // Nothing fires or cascades before the next boundary of the lowest non-empty level
+        int lowest = 0;
+        while (levelCount[lowest] == 0) {
+            ++lowest;
+        }
+        if (lowest > 0) {
+            std::uint64_t span = std::uint64_t(1) << (lowest * SLOT_BITS);
+            std::uint64_t quiet = (now | (span - 1)); // Last tick before that boundary
+            if (quiet >= tick) {
+                now = tick;
+                return;
+            }
+            now = quiet;
+        }
+        ++now;
+        // On a wheel boundary, pull the next slot of each higher level down, outermost first
+        int boundary = 0;
+        while (boundary + 1 < LEVELS && ((now >> (boundary * SLOT_BITS)) & (SLOTS - 1)) == 0) {
+            ++boundary;
+        }
+        for (int level = boundary; level >= 1; --level) {
+            cascade(level);
+        }
+        std::vector<Timer>& due = slots[0][now & (SLOTS - 1)];
+        for (const Timer& timer : due) {
+            expired.push_back(timer.payload);
+        }
+        count -= due.size();
+        levelCount[0] -= due.size();
+        due.clear();
+    }
+}
+
+void TimerWheel::clear() {
+    for (auto& level : slots) {
+        for (std::vector<Timer>& slot : level) {
+            slot.clear();
+        }
+    }
+    for (std::size_t& n : levelCount) {
+        n = 0;
+    }
+    count = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timing wheel over an abstract tick counter.
+// LEVELS wheels of SLOTS slots each: level L slot s holds timers whose deadline, shifted right by
+// L * SLOT_BITS, equals s within the current rotation. schedule() is O(1) (one push_back);
+// advancing a tick fires the current level-0 slot and, on a wheel boundary, cascades the next
+// higher slot down a level. Each timer moves at most LEVELS times before it fires.
+// With 4 levels of 64 slots the wheel spans 2^24 ticks; later deadlines wait in the farthest
+// top-level slot and are re-placed each time that slot comes round.
+// Not thread-safe: the owner serializes schedule/advance (ReservationSystem uses holdMutex).
+class TimerWheel {
+public:
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int LEVELS = 4;
+
+private:
+    struct Timer {
+        std::uint64_t deadline; // Tick
+        std::uint64_t payload;  // Opaque to the wheel (ReservationSystem stores a booking handle)
+    };
+
+    std::vector<Timer> slots[LEVELS][SLOTS]; // Cleared, not freed, so a warm wheel does not allocate
+    std::vector<Timer> cascading;            // Scratch for the slot being cascaded
+    std::size_t levelCount[LEVELS];          // Timers per level: empty lower levels let advanceTo skip ahead
+    std::uint64_t now;
+    std::size_t count;
+
+    void place(const Timer& timer);
+    void cascade(int level);
+
+public:
+    explicit TimerWheel(std::uint64_t startTick = 0);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // A deadline at or before the current tick fires on the next advance
+    void schedule(std::uint64_t deadlineTick, std::uint64_t payload);
+
+    // Moves the wheel to tick and appends the payload of every timer that fell due to expired,
+    // in deadline order. Stretches with nothing to fire or cascade are skipped, not stepped.
+    void advanceTo(std::uint64_t tick, std::vector<std::uint64_t>& expired);
+
+    void clear(); // Drops every timer; the current tick is kept
+    std::size_t size() const { return count; }
+    std::uint64_t currentTick() const { return now; }
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,157 @@
+#include "WorkStealingExecutor.h"
+#include <chrono>
+
+namespace {
+
+// The pool and deque index of the calling thread, when it is a worker
+thread_local const WorkStealingExecutor* currentExecutor = nullptr;
+thread_local std::size_t currentQueue = 0;
+
+} // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(int workerCount) {
+    if (workerCount <= 0) {
+        workerCount = static_cast<int>(std::thread::hardware_concurrency());
+        if (workerCount <= 0) workerCount = 1;
+    }
+    for (int i = 0; i < workerCount; ++i) {
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&WorkStealingExecutor::workerLoop, this, static_cast<std::size_t>(i));
+    }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping = true;
+    }
+    idle.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+WorkStealingExecutor& WorkStealingExecutor::global() {
+    static WorkStealingExecutor executor;
+    return executor;
+}
+
+void WorkStealingExecutor::enqueue(Task task) {
+    std::size_t target = currentExecutor == this ? currentQueue
+                                                 : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    queuedTasks.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(idleMutex); // A worker between its check and its wait sees the count
+    }
+    idle.notify_one();
+}
+
+bool WorkStealingExecutor::takeTask(Task& task) {
+    const std::size_t count = queues.size();
+    const bool isWorker = currentExecutor == this;
+    if (isWorker) {
+        WorkerQueue& own = *queues[currentQueue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    // Steal, starting next to our own deque so thieves spread over the victims
+    std::size_t start = isWorker ? currentQueue + 1 : nextQueue.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < count; ++i) {
+        WorkerQueue& victim = *queues[(start + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingExecutor::runOneTask() {
+    Task task;
+    if (!takeTask(task)) {
+        return false;
+    }
+    queuedTasks.fetch_sub(1, std::memory_order_seq_cst);
+    task();
+    return true;
+}
+
+void WorkStealingExecutor::workerLoop(std::size_t index) {
+    currentExecutor = this;
+    currentQueue = index;
+    for (;;) {
+        if (runOneTask()) continue;
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idle.wait(lock, [this]() { return stopping || queuedTasks.load(std::memory_order_seq_cst) > 0; });
+        if (stopping && queuedTasks.load(std::memory_order_seq_cst) <= 0) {
+            return;
+        }
+    }
+}
+
+WorkStealingExecutor::TaskGroup::TaskGroup(WorkStealingExecutor& executor) : executor(executor) {}
+
+WorkStealingExecutor::TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+        // Dropped: the caller did not ask for it
+    }
+}
+
+void WorkStealingExecutor::TaskGroup::run(Task task) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    executor.enqueue([this, task = std::move(task)]() {
+        if (!failed.load(std::memory_order_relaxed)) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+        finishOne();
+    });
+}
+
+void WorkStealingExecutor::TaskGroup::finishOne() {
+    // Under the mutex, so a waiter that sees zero cannot destroy the group before this returns
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        finished.notify_all();
+    }
+}
+
+void WorkStealingExecutor::TaskGroup::wait() {
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (executor.runOneTask()) continue;
+        // Whatever is left is running on other threads; sleep, waking now and then in case one of
+        // them queues more work this thread could help with
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait_for(lock, std::chrono::milliseconds(1), [this]() { return pending.load(std::memory_order_acquire) == 0; });
+    }
+    std::exception_ptr thrown;
+    {
+        std::lock_guard<std::mutex> lock(mutex); // Pairs with finishOne: the last finisher has let go
+        thrown = error;
+        error = nullptr;
+        failed.store(false, std::memory_order_relaxed);
+    }
+    if (thrown) {
+        std::rethrow_exception(thrown);
+    }
+}
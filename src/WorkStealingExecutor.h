@@ -0,0 +1,116 @@
+#ifndef WORKSTEALINGEXECUTOR_H
+#define WORKSTEALINGEXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads for bulk work, with one task deque per worker. A worker pushes the
+// tasks it spawns onto its own deque and pops them back newest first (the data it just touched is
+// still in cache); an idle worker steals the oldest task from another deque, which under
+// parallelFor's halving is the largest piece of the range left. Each deque has its own mutex, so
+// workers only meet when one steals. Tasks are started through a TaskGroup, whose wait() runs
+// queued tasks instead of blocking, so waiting from inside a task cannot starve the pool.
+class WorkStealingExecutor {
+public:
+    using Task = std::function<void()>;
+
+    class TaskGroup;
+
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks; // Owner works at the back, thieves take from the front
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues; // One per worker
+    std::vector<std::thread> workers;
+    std::atomic<std::int64_t> queuedTasks{0}; // Sleep hint: may briefly dip below zero
+    std::atomic<std::size_t> nextQueue{0};    // Round-robin target for tasks from outside the pool
+    std::mutex idleMutex;                     // Only for the sleep/wake handshake
+    std::condition_variable idle;
+    bool stopping = false;                    // Guarded by idleMutex
+
+    void enqueue(Task task);
+    bool runOneTask(); // Runs one queued task (own deque first, then stealing); false if none was found
+    bool takeTask(Task& task);
+    void workerLoop(std::size_t index);
+
+    template<typename Fn>
+    void runRange(TaskGroup& group, std::size_t begin, std::size_t end, std::size_t grain, const Fn& fn);
+
+public:
+    explicit WorkStealingExecutor(int workerCount = 0); // 0: one worker per hardware thread
+    ~WorkStealingExecutor(); // Runs what is still queued, then joins the workers
+
+    WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+    WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+    static WorkStealingExecutor& global(); // Process-wide pool, started on first use
+
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+
+    // Calls fn(i) for every i in [begin, end) and returns once all calls have finished. The range is
+    // halved into tasks until pieces hold at most `grain` indexes (grain 1: one task per index), so
+    // idle workers steal large pieces first. fn runs on several threads at once. If a call throws,
+    // indexes not yet started are skipped and the first exception is rethrown here.
+    template<typename Fn>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Fn fn);
+
+    // A set of tasks the caller waits on together
+    class TaskGroup {
+    private:
+        WorkStealingExecutor& executor;
+        std::atomic<std::size_t> pending{0}; // Decremented under mutex; polled without it
+        std::atomic<bool> failed{false};
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+
+        void finishOne();
+
+    public:
+        explicit TaskGroup(WorkStealingExecutor& executor);
+        ~TaskGroup(); // Waits for the group's tasks; an exception not collected by wait() is dropped
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        // Queues task on the executor. After a task of this group has thrown, later ones are skipped.
+        void run(Task task);
+        // Runs queued tasks (this group's or others') until every task of the group has finished,
+        // then rethrows the first exception one of them threw
+        void wait();
+    };
+};
+
+template<typename Fn>
+void WorkStealingExecutor::runRange(TaskGroup& group, std::size_t begin, std::size_t end, std::size_t grain, const Fn& fn) {
+    while (end - begin > grain) {
+        std::size_t middle = begin + (end - begin) / 2;
+        group.run([this, &group, middle, end, grain, &fn]() { runRange(group, middle, end, grain, fn); });
+        end = middle;
+    }
+    for (std::size_t i = begin; i < end; ++i) {
+        fn(i);
+    }
+}
+
+template<typename Fn>
+void WorkStealingExecutor::parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Fn fn) {
+    if (begin >= end) return;
+    if (grain == 0) grain = 1;
+    TaskGroup group(*this);
+    group.run([this, &group, begin, end, grain, &fn]() { runRange(group, begin, end, grain, fn); });
+    group.wait();
+}
+
+#endif // WORKSTEALINGEXECUTOR_H
@@ -0,0 +1,612 @@
+#include "WriteAheadLog.h"
+#include <array>
+#include <cerrno>
+#include <cstdio>  // For SEEK_END
+#include <cstring> // For std::strerror, std::memcmp, std::memcpy
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char LOG_MAGIC[8] = {'A', 'R', 'S', 'W', 'A', 'L', '0', '2'};
+constexpr char LEGACY_LOG_MAGIC[8] = {'A', 'R', 'S', 'W', 'A', 'L', '0', '1'}; // No generation: read as generation 0
+constexpr std::size_t LOG_HEADER_SIZE = 16;                // Magic, generation
+constexpr std::size_t RECORD_HEADER_SIZE = 8;              // Payload length, CRC-32
+constexpr std::uint32_t MAX_PAYLOAD_SIZE = 1u << 20;       // Larger lengths can only be corruption
+
+#ifdef _WIN32
+int openForAppend(const std::string& path) { return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY, 0644); }
+bool truncateTo(int fd, std::uint64_t length) { return ::_chsize_s(fd, static_cast<__int64>(length)) == 0; }
+bool seekToEnd(int fd) { return ::_lseeki64(fd, 0, SEEK_END) >= 0; }
+bool syncFile(int fd) { return ::_commit(fd) == 0; }
+long writeSome(int fd, const char* data, std::size_t size) { return ::_write(fd, data, static_cast<unsigned>(size)); }
+void closeFile(int fd) { ::_close(fd); }
+void syncParentDirectory(const std::string&) {} // NTFS makes the directory entry durable with the file
+#else
+int openForAppend(const std::string& path) { return ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644); }
+bool truncateTo(int fd, std::uint64_t length) { return ::ftruncate(fd, static_cast<off_t>(length)) == 0; }
+bool seekToEnd(int fd) { return ::lseek(fd, 0, SEEK_END) >= 0; }
+#ifdef __linux__
+bool syncFile(int fd) { return ::fdatasync(fd) == 0; } // The size change is data; mtime is not needed
+#else
+bool syncFile(int fd) { return ::fsync(fd) == 0; }
+#endif
+long writeSome(int fd, const char* data, std::size_t size) { return static_cast<long>(::write(fd, data, size)); }
+void closeFile(int fd) { ::close(fd); }
+
+// A new file's directory entry is only durable once the directory itself is synced
+void syncParentDirectory(const std::string& path) {
+    std::size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirFd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+#endif
+
+// CRC-32 (IEEE 802.3, as in zlib)
+std::uint32_t crc32(const char* data, std::size_t size) {
+    static const std::array<std::uint32_t, 256> table = []() {
+        std::array<std::uint32_t, 256> entries{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+        return entries;
+    }();
+    std::uint32_t c = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) {
+        c = table[(c ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+// Little-endian fixed-width fields, so the file reads the same on any host
+void putUint(std::string& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void putString(std::string& out, const std::string& value) {
+    std::size_t length = value.size() < 0xFFFF ? value.size() : 0xFFFF; // IDs and names are far shorter
+    putUint(out, length, 2);
+    out.append(value, 0, length);
+}
+
+std::string logHeader(std::uint64_t generation) {
+    std::string header(LOG_MAGIC, sizeof(LOG_MAGIC));
+    putUint(header, generation, 8);
+    return header;
+}
+
+class PayloadReader {
+    const std::string& payload;
+    std::size_t at = 0;
+    bool ok = true;
+
+public:
+    explicit PayloadReader(const std::string& payload) : payload(payload) {}
+
+    std::uint64_t getUint(int bytes) {
+        if (payload.size() - at < static_cast<std::size_t>(bytes)) {
+            ok = false;
+            return 0;
+        }
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(payload[at + i])) << (8 * i);
+        }
+        at += bytes;
+        return value;
+    }
+
+    std::string getString() {
+        std::size_t length = static_cast<std::size_t>(getUint(2));
+        if (!ok || payload.size() - at < length) {
+            ok = false;
+            return "";
+        }
+        std::string value = payload.substr(at, length);
+        at += length;
+        return value;
+    }
+
+    bool finished() const { return ok && at == payload.size(); }
+};
+
+void encodePayload(const WalRecord& record, std::string& out) {
+    putUint(out, static_cast<std::uint8_t>(record.type), 1);
+    switch (record.type) {
+        case WalRecord::Type::ADD_CUSTOMER:
+            putString(out, record.customerId);
+            putString(out, record.name);
+            putUint(out, static_cast<std::uint32_t>(record.age), 4);
+            putUint(out, static_cast<std::uint64_t>(record.cents), 8);
+            break;
+        case WalRecord::Type::ADD_AIRPLANE:
+            putString(out, record.flightNumber);
+            putUint(out, static_cast<std::uint32_t>(record.rows), 4);
+            putUint(out, static_cast<std::uint32_t>(record.seatsPerRow), 4);
+            break;
+        case WalRecord::Type::BOOK:
+            putUint(out, record.bookingNumber, 8);
+            putString(out, record.customerId);
+            putString(out, record.flightNumber);
+            putUint(out, static_cast<std::uint32_t>(record.seatIndex), 4);
+            putUint(out, static_cast<std::uint64_t>(record.cents), 8);
+            break;
+        case WalRecord::Type::CANCEL:
+            putUint(out, record.bookingNumber, 8);
+            break;
+        case WalRecord::Type::SWAP:
+            putUint(out, record.bookingNumber, 8);
+            putUint(out, record.otherBookingNumber, 8);
+            putUint(out, static_cast<std::uint64_t>(record.cents), 8);
+            putUint(out, static_cast<std::uint64_t>(record.otherCents), 8);
+            break;
+        case WalRecord::Type::SET_FARES:
+            putString(out, record.flightNumber);
+            putUint(out, static_cast<std::uint32_t>(record.seatIndex), 4);
+            putUint(out, record.fares.size(), 4);
+            for (double fare : record.fares) {
+                std::uint64_t bits;
+                std::memcpy(&bits, &fare, sizeof(bits));
+                putUint(out, bits, 8);
+            }
+            break;
+    }
+}
+
+bool decodePayload(const std::string& payload, WalRecord& record) {
+    PayloadReader in(payload);
+    record = WalRecord();
+    std::uint64_t type = in.getUint(1);
+    switch (type) {
+        case static_cast<std::uint8_t>(WalRecord::Type::ADD_CUSTOMER):
+            record.type = WalRecord::Type::ADD_CUSTOMER;
+            record.customerId = in.getString();
+            record.name = in.getString();
+            record.age = static_cast<std::int32_t>(in.getUint(4));
+            record.cents = static_cast<Cents>(in.getUint(8));
+            break;
+        case static_cast<std::uint8_t>(WalRecord::Type::ADD_AIRPLANE):
+            record.type = WalRecord::Type::ADD_AIRPLANE;
+            record.flightNumber = in.getString();
+            record.rows = static_cast<std::int32_t>(in.getUint(4));
+            record.seatsPerRow = static_cast<std::int32_t>(in.getUint(4));
+            break;
+        case static_cast<std::uint8_t>(WalRecord::Type::BOOK):
+            record.type = WalRecord::Type::BOOK;
+            record.bookingNumber = in.getUint(8);
+            record.customerId = in.getString();
+            record.flightNumber = in.getString();
+            record.seatIndex = static_cast<std::int32_t>(in.getUint(4));
+            record.cents = static_cast<Cents>(in.getUint(8));
+            break;
+        case static_cast<std::uint8_t>(WalRecord::Type::CANCEL):
+            record.type = WalRecord::Type::CANCEL;
+            record.bookingNumber = in.getUint(8);
+            break;
+        case static_cast<std::uint8_t>(WalRecord::Type::SWAP):
+            record.type = WalRecord::Type::SWAP;
+            record.bookingNumber = in.getUint(8);
+            record.otherBookingNumber = in.getUint(8);
+            record.cents = static_cast<Cents>(in.getUint(8));
+            record.otherCents = static_cast<Cents>(in.getUint(8));
+            break;
+        case static_cast<std::uint8_t>(WalRecord::Type::SET_FARES): {
+            record.type = WalRecord::Type::SET_FARES;
+            record.flightNumber = in.getString();
+            record.seatIndex = static_cast<std::int32_t>(in.getUint(4));
+            std::uint64_t count = in.getUint(4);
+            if (count > WalRecord::MAX_FARES) return false;
+            record.fares.resize(static_cast<std::size_t>(count));
+            for (double& fare : record.fares) {
+                std::uint64_t bits = in.getUint(8);
+                std::memcpy(&fare, &bits, sizeof(fare));
+            }
+            break;
+        }
+        default:
+            return false;
+    }
+    return in.finished();
+}
+
+} // namespace
+
+// --- WalRecord ---
+
+WalRecord WalRecord::addCustomer(const std::string& customerId, const std::string& name, int age, Cents balance) {
+    WalRecord record;
+    record.type = Type::ADD_CUSTOMER;
+    record.customerId = customerId;
+    record.name = name;
+    record.age = age;
+    record.cents = balance;
+    return record;
+}
+
+WalRecord WalRecord::addAirplane(const std::string& flightNumber, int rows, int seatsPerRow) {
+    WalRecord record;
+    record.type = Type::ADD_AIRPLANE;
+    record.flightNumber = flightNumber;
+    record.rows = rows;
+    record.seatsPerRow = seatsPerRow;
+    return record;
+}
+
+WalRecord WalRecord::book(std::uint64_t bookingNumber, const std::string& customerId, const std::string& flightNumber,
+                          int seatIndex, Cents paid) {
+    WalRecord record;
+    record.type = Type::BOOK;
+    record.bookingNumber = bookingNumber;
+    record.customerId = customerId;
+    record.flightNumber = flightNumber;
+    record.seatIndex = seatIndex;
+    record.cents = paid;
+    return record;
+}
+
+WalRecord WalRecord::cancel(std::uint64_t bookingNumber) {
+    WalRecord record;
+    record.type = Type::CANCEL;
+    record.bookingNumber = bookingNumber;
+    return record;
+}
+
+WalRecord WalRecord::swap(std::uint64_t bookingNumber1, std::uint64_t bookingNumber2, Cents newFare1, Cents newFare2) {
+    WalRecord record;
+    record.type = Type::SWAP;
+    record.bookingNumber = bookingNumber1;
+    record.otherBookingNumber = bookingNumber2;
+    record.cents = newFare1;
+    record.otherCents = newFare2;
+    return record;
+}
+
+WalRecord WalRecord::setFares(const std::string& flightNumber, int firstSeatIndex, std::vector<double> fares) {
+    WalRecord record;
+    record.type = Type::SET_FARES;
+    record.flightNumber = flightNumber;
+    record.seatIndex = firstSeatIndex;
+    record.fares = std::move(fares);
+    return record;
+}
+
+// --- WriteAheadLog ---
+
+bool WriteAheadLog::parseDurability(const std::string& name, Durability& durability) {
+    if (name == "per-op") durability = Durability::PER_OP;
+    else if (name == "group") durability = Durability::GROUP;
+    else if (name == "async") durability = Durability::ASYNC;
+    else return false;
+    return true;
+}
+
+bool WriteAheadLog::replay(const std::string& path, const std::function<bool(const WalRecord&, std::string&)>& apply,
+                           std::uint64_t& recordCount, std::uint64_t& validLength, std::string& errorMessage,
+                           const Position& from, std::uint64_t* generation) {
+    recordCount = 0;
+    validLength = 0;
+    if (generation) *generation = 0;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return true; // No log yet
+    }
+    char magic[sizeof(LOG_MAGIC)];
+    if (!in.read(magic, sizeof(magic))) {
+        return true; // Cut short while being created: start over
+    }
+    std::uint64_t fileGeneration = 0;
+    if (std::memcmp(magic, LOG_MAGIC, sizeof(magic)) == 0) {
+        std::string bytes(LOG_HEADER_SIZE - sizeof(LOG_MAGIC), '\0');
+        if (!in.read(&bytes[0], bytes.size())) {
+            return true;
+        }
+        fileGeneration = PayloadReader(bytes).getUint(8);
+        validLength = LOG_HEADER_SIZE;
+    } else if (std::memcmp(magic, LEGACY_LOG_MAGIC, sizeof(magic)) == 0) {
+        validLength = sizeof(LEGACY_LOG_MAGIC);
+    } else {
+        errorMessage = path + " is not a reservation write-ahead log.";
+        return false;
+    }
+    if (generation) *generation = fileGeneration;
+
+    std::string header(RECORD_HEADER_SIZE, '\0');
+    std::string payload;
+    WalRecord record;
+    std::string applyError;
+    std::uint64_t recordNumber = 0;
+    while (in.read(&header[0], RECORD_HEADER_SIZE)) {
+        std::uint32_t length = 0, checksum = 0;
+        for (int i = 0; i < 4; ++i) {
+            length |= static_cast<std::uint32_t>(static_cast<unsigned char>(header[i])) << (8 * i);
+            checksum |= static_cast<std::uint32_t>(static_cast<unsigned char>(header[4 + i])) << (8 * i);
+        }
+        if (length == 0 || length > MAX_PAYLOAD_SIZE) break;
+        payload.resize(length);
+        if (!in.read(&payload[0], length)) break;                  // Torn write
+        if (crc32(payload.data(), payload.size()) != checksum) break;
+        if (!decodePayload(payload, record)) break;
+        ++recordNumber;
+        std::uint64_t recordEnd = validLength + RECORD_HEADER_SIZE + length;
+        bool before = fileGeneration < from.generation || (fileGeneration == from.generation && recordEnd <= from.offset);
+        if (!before) {
+            if (!apply(record, applyError)) {
+                errorMessage = path + ": record " + std::to_string(recordNumber) + ": " + applyError;
+                return false;
+            }
+            ++recordCount;
+        }
+        validLength = recordEnd;
+    }
+    return true;
+}
+
+std::unique_ptr<WriteAheadLog> WriteAheadLog::open(const std::string& path, std::uint64_t validLength, const Options& options,
+                                                   std::string& errorMessage, std::uint64_t generation) {
+    int fd = openForAppend(path);
+    if (fd < 0) {
+        errorMessage = "Cannot open write-ahead log " + path + ": " + std::strerror(errno) + ".";
+        return nullptr;
+    }
+    std::unique_ptr<WriteAheadLog> log(new WriteAheadLog(path, fd, options));
+    std::string failure;
+    bool fresh = validLength < sizeof(LOG_MAGIC);
+    if (!truncateTo(fd, fresh ? 0 : validLength) || !seekToEnd(fd)) {
+        errorMessage = "Cannot truncate write-ahead log " + path + ": " + std::strerror(errno) + ".";
+        return nullptr;
+    }
+    if (fresh ? !writeAndSync(fd, logHeader(generation), failure) : !syncFile(fd)) {
+        errorMessage = "Cannot write write-ahead log " + path + ": " + (fresh ? failure : std::strerror(errno)) + ".";
+        return nullptr;
+    }
+    if (fresh) {
+        syncParentDirectory(path);
+    }
+    log->end.generation = generation;
+    log->end.offset = fresh ? LOG_HEADER_SIZE : validLength;
+    if (options.durability == Durability::ASYNC) {
+        log->asyncFlusher = std::thread(&WriteAheadLog::runAsyncFlusher, log.get());
+    }
+    return log;
+}
+
+std::string WriteAheadLog::segmentPath(const std::string& path, std::uint64_t generation) {
+    return path + "." + std::to_string(generation);
+}
+
+void WriteAheadLog::removeSegments(const std::string& path, std::uint64_t beforeGeneration) {
+    // Segments are numbered without gaps, so the first one missing ends the older ones too
+    for (std::uint64_t generation = beforeGeneration; generation-- > 0;) {
+        if (std::remove(segmentPath(path, generation).c_str()) != 0) break;
+    }
+}
+
+WriteAheadLog::WriteAheadLog(const std::string& path, int fd, const Options& options) : options(options), path(path), fd(fd) {}
+
+WriteAheadLog::~WriteAheadLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    flusherWake.notify_all();
+    if (asyncFlusher.joinable()) {
+        asyncFlusher.join();
+    }
+    flush();
+    if (fd >= 0) {
+        closeFile(fd);
+    }
+}
+
+bool WriteAheadLog::writeAndSync(int fd, const std::string& bytes, std::string& failure) {
+    std::size_t written = 0;
+    while (written < bytes.size()) {
+        long count = writeSome(fd, bytes.data() + written, bytes.size() - written);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            failure = std::strerror(errno);
+            return false;
+        }
+        written += static_cast<std::size_t>(count);
+    }
+    if (!syncFile(fd)) {
+        failure = std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+WriteAheadLog::Lsn WriteAheadLog::append(const WalRecord& record) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!error.empty()) {
+        return ++appendedLsn; // Never becomes durable, so awaitDurable reports the failure
+    }
+    // Header placeholder first, so the payload is encoded straight into the buffer
+    std::size_t start = buffer.size();
+    buffer.append(RECORD_HEADER_SIZE, '\0');
+    encodePayload(record, buffer);
+    std::size_t length = buffer.size() - start - RECORD_HEADER_SIZE;
+    std::uint32_t checksum = crc32(buffer.data() + start + RECORD_HEADER_SIZE, length);
+    for (int i = 0; i < 4; ++i) {
+        buffer[start + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+        buffer[start + 4 + i] = static_cast<char>((checksum >> (8 * i)) & 0xFF);
+    }
+    Lsn lsn = ++appendedLsn;
+    ++stats.records;
+    end.offset += RECORD_HEADER_SIZE + length;
+
+    if (options.durability == Durability::PER_OP && !syncing) {
+        // Written and synced under the mutex: every record pays for its own fsync
+        std::string failure;
+        if (writeAndSync(fd, buffer, failure)) {
+            stats.bytes += buffer.size();
+            ++stats.syncs;
+            durableLsn = lsn;
+        } else {
+            error = failure;
+        }
+        buffer.clear();
+    }
+    return lsn;
+}
+
+bool WriteAheadLog::syncLocked(std::unique_lock<std::mutex>& lock, Lsn target) {
+    for (;;) {
+        if (durableLsn >= target) return true;
+        if (!error.empty()) return false;
+        if (syncing) {
+            synced.wait(lock); // The current leader's batch may not reach target; re-check after it
+            continue;
+        }
+        // Lead: take everything buffered so far, including records of threads now waiting behind us
+        syncing = true;
+        writing.swap(buffer);
+        Lsn batchEnd = appendedLsn;
+        lock.unlock();
+        std::string failure;
+        bool ok = writeAndSync(fd, writing, failure);
+        lock.lock();
+        syncing = false;
+        if (ok) {
+            stats.bytes += writing.size();
+            ++stats.syncs;
+            durableLsn = batchEnd;
+        } else {
+            error = failure;
+        }
+        writing.clear();
+        synced.notify_all();
+    }
+}
+
+bool WriteAheadLog::awaitDurable(Lsn lsn) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (options.durability != Durability::GROUP) {
+        return error.empty(); // PER_OP synced in append; ASYNC leaves it to the flusher
+    }
+    return syncLocked(lock, lsn);
+}
+
+bool WriteAheadLog::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    return syncLocked(lock, appendedLsn);
+}
+
+bool WriteAheadLog::rotate(std::string& errorMessage) {
+    // The next file is complete, header and all, before the current one is touched
+    const std::string nextPath = path + ".next";
+    std::uint64_t nextGeneration = getPosition().generation + 1;
+    int nextFd = openForAppend(nextPath);
+    std::string failure;
+    bool prepared = nextFd >= 0 && truncateTo(nextFd, 0) && writeAndSync(nextFd, logHeader(nextGeneration), failure);
+    if (nextFd >= 0) {
+        closeFile(nextFd); // Reopened under its final name: an open file cannot be renamed everywhere
+    }
+    if (!prepared) {
+        errorMessage = "Cannot create write-ahead log " + nextPath + ": " + (failure.empty() ? std::strerror(errno) : failure) + ".";
+        std::remove(nextPath.c_str());
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    synced.wait(lock, [this]() { return !syncing; });
+    if (!error.empty()) {
+        errorMessage = "The write-ahead log has failed: " + error;
+        lock.unlock();
+        std::remove(nextPath.c_str());
+        return false;
+    }
+    // Lead like a sync: the current file gets everything buffered so far and anything appended
+    // from here on belongs to the next one, whose offsets start after its header
+    syncing = true;
+    writing.swap(buffer);
+    Lsn batchEnd = appendedLsn;
+    const Position previousEnd = end;
+    end = Position{nextGeneration, LOG_HEADER_SIZE};
+    lock.unlock();
+
+    const std::string retiredPath = segmentPath(path, previousEnd.generation);
+    bool written = writeAndSync(fd, writing, failure);
+    closeFile(fd);
+    bool retired = written && std::rename(path.c_str(), retiredPath.c_str()) == 0;
+    bool moved = retired && std::rename(nextPath.c_str(), path.c_str()) == 0;
+    if (!moved) {
+        errorMessage = written ? "Cannot rename write-ahead log " + path + ": " + std::strerror(errno) + "."
+                               : "Cannot write write-ahead log " + path + ": " + failure + ".";
+        if (retired) {
+            std::rename(retiredPath.c_str(), path.c_str()); // Put the current file back
+        }
+        std::remove(nextPath.c_str());
+    } else {
+        syncParentDirectory(path);
+    }
+    fd = openForAppend(path); // The new file, or the current one again
+    bool reopened = fd >= 0 && seekToEnd(fd);
+
+    lock.lock();
+    syncing = false;
+    if (written) {
+        stats.bytes += writing.size();
+        ++stats.syncs;
+        durableLsn = batchEnd;
+    } else {
+        error = failure;
+    }
+    if (!reopened && error.empty()) {
+        error = std::strerror(errno);
+        errorMessage = "Cannot reopen write-ahead log " + path + ": " + error + ".";
+        moved = false;
+    }
+    writing.clear();
+    if (!moved && written) {
+        end = Position{previousEnd.generation, previousEnd.offset + (end.offset - LOG_HEADER_SIZE)}; // Still the current file
+    }
+    if (options.durability == Durability::PER_OP && error.empty()) {
+        syncLocked(lock, appendedLsn); // Records appended meanwhile could not be written by append()
+    }
+    synced.notify_all();
+    return moved;
+}
+
+WriteAheadLog::Position WriteAheadLog::getPosition() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return end;
+}
+
+void WriteAheadLog::runAsyncFlusher() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        flusherWake.wait_for(lock, options.asyncFlushInterval, [this]() { return stopping; });
+        if (error.empty() && durableLsn < appendedLsn) {
+            syncLocked(lock, appendedLsn);
+        }
+    }
+}
+
+WriteAheadLog::Stats WriteAheadLog::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+std::string WriteAheadLog::getError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
@@ -0,0 +1,156 @@
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include "Money.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One logged mutation of ReservationSystem, carrying its outcome (IDs, seat, amounts) so that
+// replaying it needs no clock, ID generator or fare table. Only the fields of its type are used.
+struct WalRecord {
+    enum class Type : std::uint8_t {
+        ADD_CUSTOMER = 1, // customerId, name, age, cents = opening balance
+        ADD_AIRPLANE = 2, // flightNumber, rows, seatsPerRow
+        BOOK = 3,         // bookingNumber, customerId, flightNumber, seatIndex, cents = paid
+        CANCEL = 4,       // bookingNumber
+        SWAP = 5,         // bookingNumber, otherBookingNumber, cents/otherCents = their new fares
+        SET_FARES = 6     // flightNumber, seatIndex = first seat, fares = it and the seats after it
+    };
+    static constexpr std::size_t MAX_FARES = 65536; // Per SET_FARES record; longer runs take several
+
+    Type type = Type::CANCEL;
+    std::uint64_t bookingNumber = 0;
+    std::uint64_t otherBookingNumber = 0;
+    std::string customerId;
+    std::string name;
+    std::string flightNumber;
+    std::int32_t age = 0;
+    std::int32_t rows = 0;
+    std::int32_t seatsPerRow = 0;
+    std::int32_t seatIndex = 0;
+    Cents cents = 0;
+    Cents otherCents = 0;
+    std::vector<double> fares; // Exact, as the snapshot stores them
+
+    static WalRecord addCustomer(const std::string& customerId, const std::string& name, int age, Cents balance);
+    static WalRecord addAirplane(const std::string& flightNumber, int rows, int seatsPerRow);
+    static WalRecord book(std::uint64_t bookingNumber, const std::string& customerId, const std::string& flightNumber,
+                          int seatIndex, Cents paid);
+    static WalRecord cancel(std::uint64_t bookingNumber);
+    static WalRecord swap(std::uint64_t bookingNumber1, std::uint64_t bookingNumber2, Cents newFare1, Cents newFare2);
+    static WalRecord setFares(const std::string& flightNumber, int firstSeatIndex, std::vector<double> fares);
+};
+
+// Append-only binary log: a 16-byte header (magic and generation), then per record its payload
+// length, a CRC-32 of the payload and the payload. Records get increasing LSNs (log sequence
+// numbers) in append order. rotate() closes the current file as a numbered segment and carries on in
+// a fresh one of the next generation, so a checkpoint can drop every segment it already covers.
+// Durability modes:
+//   PER_OP  append() writes the record and syncs the file before returning: one fsync per record.
+//   GROUP   append() only buffers; awaitDurable() syncs. The first waiter writes and syncs everything
+//           buffered so far while later waiters queue behind it, so concurrent callers share fsyncs.
+//   ASYNC   append() only buffers; a background thread writes and syncs every asyncFlushInterval.
+//           awaitDurable() does not wait, so a crash can lose the last interval of acknowledged records.
+// A failed write or sync is sticky: nothing more is written and awaitDurable() returns false.
+class WriteAheadLog {
+public:
+    using Lsn = std::uint64_t;
+
+    enum class Durability { PER_OP, GROUP, ASYNC };
+
+    struct Options {
+        Durability durability = Durability::GROUP;
+        std::chrono::milliseconds asyncFlushInterval{10};
+    };
+
+    // A point in the log: the segment's generation and a byte offset within it. Everything appended
+    // before the point lies in older generations or below the offset. Position() is 0, 0.
+    struct Position {
+        std::uint64_t generation;
+        std::uint64_t offset;
+    };
+
+    struct Stats {
+        std::uint64_t records = 0; // Appended since open
+        std::uint64_t syncs = 0;   // fsyncs issued
+        std::uint64_t bytes = 0;   // Written since open
+    };
+
+    static bool parseDurability(const std::string& name, Durability& durability); // "per-op", "group" or "async"
+
+    // Reads the log at path and hands each intact record to apply, in order. Reading stops at the
+    // first torn or corrupt record (the tail of a write cut short by a crash); validLength is the
+    // size of the intact prefix, to pass to open(). A missing file is an empty log. Records before
+    // from are read but neither applied nor counted in recordCount. generation, if given, receives
+    // the file's generation. false with errorMessage if the file is not a log or apply fails
+    // (apply's message is prefixed with the record number).
+    static bool replay(const std::string& path, const std::function<bool(const WalRecord&, std::string&)>& apply,
+                       std::uint64_t& recordCount, std::uint64_t& validLength, std::string& errorMessage,
+                       const Position& from = Position(), std::uint64_t* generation = nullptr);
+
+    // Opens path for appending after its first validLength bytes, cutting off anything beyond
+    // (validLength 0 starts a new log of the given generation; otherwise pass the generation replay
+    // reported). nullptr with errorMessage on failure.
+    static std::unique_ptr<WriteAheadLog> open(const std::string& path, std::uint64_t validLength, const Options& options,
+                                               std::string& errorMessage, std::uint64_t generation = 0);
+
+    // Where rotate() leaves the segment of the given generation, and removing those older than
+    // beforeGeneration (once a checkpoint covers them)
+    static std::string segmentPath(const std::string& path, std::uint64_t generation);
+    static void removeSegments(const std::string& path, std::uint64_t beforeGeneration);
+
+    ~WriteAheadLog(); // Writes and syncs whatever is still buffered
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Logs the record. Outside PER_OP this is a copy into a buffer, cheap enough to call while
+    // holding the locks that order the mutation against others.
+    Lsn append(const WalRecord& record);
+    bool awaitDurable(Lsn lsn); // Call without holding entity locks; false if the log has failed
+    bool flush();               // Writes and syncs everything appended so far, in any mode
+    // Writes and syncs the current file, renames it to segmentPath(path, generation) and continues in
+    // a new file at path of the next generation. Appends keep going meanwhile and land in the new
+    // file. false with errorMessage if it could not (the log carries on in the current file, unless
+    // writing it failed).
+    bool rotate(std::string& errorMessage);
+    Position getPosition() const; // The end of what has been appended
+
+    Stats getStats() const;
+    const Options& getOptions() const { return options; }
+    const std::string& getPath() const { return path; }
+    std::string getError() const; // Empty unless the log has failed
+
+private:
+    const Options options;
+    const std::string path;
+    int fd;
+    mutable std::mutex mutex;
+    std::condition_variable synced;
+    std::string buffer;   // Encoded records not yet handed to a writer
+    std::string writing;  // The leader's batch; swapped with buffer so both keep their capacity
+    Lsn appendedLsn = 0;
+    Lsn durableLsn = 0;
+    Position end{};       // Of the appended records
+    bool syncing = false; // A leader is writing outside the mutex
+    std::string error;
+    Stats stats;
+
+    std::thread asyncFlusher;
+    std::condition_variable flusherWake;
+    bool stopping = false;
+
+    WriteAheadLog(const std::string& path, int fd, const Options& options);
+    bool syncLocked(std::unique_lock<std::mutex>& lock, Lsn target); // Until durableLsn >= target or failure
+    static bool writeAndSync(int fd, const std::string& bytes, std::string& failure); // Called without the mutex
+    void runAsyncFlusher();
+};
+
+#endif // WRITEAHEADLOG_H
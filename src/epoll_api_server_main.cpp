@@ -0,0 +1,83 @@
+#include "ApiRoutes.h" // The same routes as airline_api_server
+#include "ApiServerSetup.h"
+#include "EpollHttpServer.h"
+#include <iostream>
+#include <memory>
+#include <string>
+#include <csignal>
+#include <cstdlib> // For rand() in customer auto-generation
+#include <ctime>   // For time() in srand()
+#include <sys/resource.h>
+
+namespace {
+
+EpollHttpServer* runningServer = nullptr;
+
+void stopOnSignal(int) {
+    if (runningServer) runningServer->stop(); // Only an atomic store and an eventfd write
+}
+
+// Each keep-alive connection holds a descriptor, so allow as many as the hard limit does
+void raiseDescriptorLimit() {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+} // namespace
+
+// Usage: airline_api_server_epoll [--config=path] [--key=value ...]
+//   Same API, settings and admin routes as airline_api_server (see its usage and ServerConfig.h) on an
+//   epoll event loop: idle keep-alive connections cost no thread. Requests are handled on the same
+//   AdaptiveTaskQueue (min_workers, max_workers, ...), so blocking durability modes only hold up the
+//   connection waiting on them.
+//   --loop-threads=N  event-loop threads (default 0: one per hardware thread)
+int main(int argc, char** argv) {
+    ServerConfig config;
+    std::string configError;
+    if (!config.parseArguments(argc, argv, configError)) {
+        std::cerr << configError << " Usage: " << argv[0] << " [--config=path] [--key=value ...]" << std::endl;
+        return 1;
+    }
+    bool pipelineMode = config.pipelineMode;
+    raiseDescriptorLimit();
+    srand(time(nullptr));
+
+    ReservationSystem airlineSystem(std::cin, std::cout);
+    std::string startupError;
+    if (!restoreAndPersist(airlineSystem, config, startupError)) {
+        std::cerr << startupError << std::endl;
+        return 1;
+    }
+    std::unique_ptr<CommandPipeline> pipeline; // Declared after airlineSystem: stopped before it is destroyed
+    if (pipelineMode) {
+        pipeline = std::make_unique<CommandPipeline>(airlineSystem);
+    }
+    auto execute = [&](Command command) {
+        return pipeline ? pipeline->submit(std::move(command)).get() : CommandPipeline::apply(airlineSystem, command);
+    };
+
+    AdaptiveTaskQueue* taskQueue = nullptr; // Owned by svr, which creates it in listenAfterBind()
+    EpollHttpServer svr(config.loopThreads); // Declared last: its loops and workers stop before the system they call into
+    useAdaptiveTaskQueue(svr, config, taskQueue);
+    registerApiRoutes(svr, airlineSystem, execute);
+    registerAdminRoutes(svr, airlineSystem, config, taskQueue);
+    svr.setLogger([](const httplib::Request& req, const httplib::Response& res) {
+        std::cout << "HTTP " << req.method << " " << req.path << " -> " << res.status << '\n'; // No flush per request
+    });
+
+    if (svr.bindToPort(config.host, config.port) < 0) {
+        std::cerr << "Failed to start server!" << std::endl;
+        return 1;
+    }
+    runningServer = &svr;
+    std::signal(SIGINT, stopOnSignal);
+    std::signal(SIGTERM, stopOnSignal);
+    std::cout << "Starting epoll API server on http://" << config.host << ":" << config.port << " (" << (pipelineMode ? "pipeline" : "locked")
+              << " mode, " << config.pool.minWorkers << "-" << config.pool.maxWorkers << " workers)..." << std::endl;
+    svr.listenAfterBind();
+    runningServer = nullptr;
+    return 0;
+}
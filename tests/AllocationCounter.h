@@ -0,0 +1,51 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+// Counts heap allocations made by the current thread between start() and stop().
+// Including this header REPLACES the global operator new/delete for the whole binary,
+// so include it from exactly one translation unit per executable (a test or a benchmark).
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace allocation_counter {
+
+struct Stats {
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+};
+
+inline thread_local bool counting = false;
+inline thread_local Stats current;
+
+inline void start() {
+    current = Stats();
+    counting = true;
+}
+
+inline Stats stop() {
+    counting = false;
+    return current;
+}
+
+inline void* allocate(std::size_t size) {
+    if (counting) {
+        ++current.allocations;
+        current.bytes += size;
+    }
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+} // namespace allocation_counter
+
+void* operator new(std::size_t size) { return allocation_counter::allocate(size); }
+void* operator new[](std::size_t size) { return allocation_counter::allocate(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+#endif // ALLOCATIONCOUNTER_H
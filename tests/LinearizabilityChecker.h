@@ -0,0 +1,77 @@
+#ifndef LINEARIZABILITYCHECKER_H
+#define LINEARIZABILITYCHECKER_H
+
+// Brute-force linearizability check for small concurrent histories (Wing & Gong search with
+// memoization). Record each operation's invoke and response on a shared logical clock, then ask
+// whether some total order that respects real time explains every observed result.
+// Linearizability is local, so independent objects (e.g. separate seats) can be checked one
+// history at a time, which keeps each search small.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace linearizability {
+
+struct Operation {
+    std::uint64_t invoke = 0;   // Clock value taken before the call
+    std::uint64_t response = 0; // Clock value taken after the call returned
+    int kind = 0;               // Caller-defined operation code
+    int result = 0;             // Caller-defined observed result
+};
+
+// Shared logical clock: every tick() is strictly after all ticks that happened before it
+class Clock {
+private:
+    std::atomic<std::uint64_t> now{0};
+
+public:
+    std::uint64_t tick() { return now.fetch_add(1, std::memory_order_seq_cst); }
+};
+
+// apply(state, op, nextState) returns false if op's result is impossible from state.
+// Histories are limited to 64 operations.
+template<typename State, typename Apply>
+bool check(std::vector<Operation> history, State initial, Apply apply) {
+    if (history.size() > 64) return false;
+    std::sort(history.begin(), history.end(),
+              [](const Operation& a, const Operation& b) { return a.invoke < b.invoke; });
+    const std::size_t n = history.size();
+    const std::uint64_t all = n == 64 ? ~0ULL : ((1ULL << n) - 1);
+    std::set<std::pair<std::uint64_t, State>> visited;
+
+    // Depth-first over "which operations are already linearized"; memoized on (done, state)
+    struct Search {
+        const std::vector<Operation>& ops;
+        std::uint64_t all;
+        Apply& apply;
+        std::set<std::pair<std::uint64_t, State>>& visited;
+
+        bool run(std::uint64_t done, const State& state) {
+            if (done == all) return true;
+            if (!visited.insert({done, state}).second) return false;
+            // An operation may go next only if it was invoked before every pending one responded
+            std::uint64_t earliestResponse = ~0ULL;
+            for (std::size_t i = 0; i < ops.size(); ++i) {
+                if (!(done >> i & 1)) earliestResponse = std::min(earliestResponse, ops[i].response);
+            }
+            for (std::size_t i = 0; i < ops.size(); ++i) {
+                if (done >> i & 1) continue;
+                if (ops[i].invoke > earliestResponse) break; // Sorted by invoke: none of the rest qualify
+                State next = state;
+                if (apply(state, ops[i], next) && run(done | (1ULL << i), next)) return true;
+            }
+            return false;
+        }
+    };
+    Search search{history, all, apply, visited};
+    return search.run(0, initial);
+}
+
+} // namespace linearizability
+
+#endif // LINEARIZABILITYCHECKER_H
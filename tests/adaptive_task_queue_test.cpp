@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+#include "../src/AdaptiveTaskQueue.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Polls until condition holds or two seconds pass
+template<typename Condition>
+bool eventually(Condition condition) {
+    auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(2ms);
+    }
+    return true;
+}
+
+AdaptiveTaskQueue::Settings smallPool(int minWorkers, int maxWorkers, std::size_t maxQueued) {
+    AdaptiveTaskQueue::Settings settings;
+    settings.minWorkers = minWorkers;
+    settings.maxWorkers = maxWorkers;
+    settings.maxQueued = maxQueued;
+    settings.targetWait = 5ms;
+    settings.maxWait = 1000ms;
+    settings.adjustInterval = 20ms;
+    settings.shedWorkers = 1;
+    settings.maxShedQueued = 4;
+    return settings;
+}
+
+} // namespace
+
+TEST(AdaptiveTaskQueueTest, RunsTasksAndShutdownDrainsTheQueue) {
+    std::atomic<int> ran{0};
+    {
+        AdaptiveTaskQueue queue(smallPool(2, 2, 100));
+        for (int i = 0; i < 50; ++i) {
+            EXPECT_TRUE(queue.enqueue([&ran]() {
+                EXPECT_FALSE(AdaptiveTaskQueue::isShedding());
+                ran++;
+            }));
+        }
+        queue.shutdown();
+        EXPECT_EQ(ran.load(), 50);
+        EXPECT_FALSE(queue.enqueue([]() {})); // Closed after shutdown
+        AdaptiveTaskQueue::Stats stats = queue.getStats();
+        EXPECT_EQ(stats.accepted, 50u);
+        EXPECT_EQ(stats.shed, 0u);
+    } // A second shutdown from the destructor is a no-op
+}
+
+TEST(AdaptiveTaskQueueTest, GrowsWhileTasksWaitAndShrinksWhenIdle) {
+    AdaptiveTaskQueue queue(smallPool(1, 4, 100));
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(queue.enqueue([released]() { released.wait(); }));
+    }
+    EXPECT_TRUE(eventually([&]() { return queue.getStats().workers == 4; })); // Capped at maxWorkers
+    EXPECT_GT(queue.getStats().queueDepth, 0u);
+    EXPECT_GT(queue.getStats().oldestWaitMs, 0.0);
+
+    release.set_value();
+    EXPECT_TRUE(eventually([&]() { return queue.getStats().queueDepth == 0 && queue.getStats().busyWorkers == 0; }));
+    EXPECT_TRUE(eventually([&]() { return queue.getStats().workers == 1; })); // Back down to minWorkers
+}
+
+TEST(AdaptiveTaskQueueTest, ConnectionsBeyondMaxQueuedAreShedOrDropped) {
+    AdaptiveTaskQueue::Settings settings = smallPool(1, 1, 1);
+    settings.maxShedQueued = 1;
+    AdaptiveTaskQueue queue(settings);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::promise<void> started;
+    ASSERT_TRUE(queue.enqueue([&started, released]() {
+        started.set_value();
+        released.wait();
+    }));
+    started.get_future().wait(); // The only worker is busy
+    ASSERT_TRUE(queue.enqueue([]() { EXPECT_FALSE(AdaptiveTaskQueue::isShedding()); })); // Fills maxQueued
+
+    std::promise<bool> shedFlag;
+    std::promise<void> shedRelease;
+    std::shared_future<void> shedReleased = shedRelease.get_future().share();
+    ASSERT_TRUE(queue.enqueue([&shedFlag, shedReleased]() { // Served at once by the shed thread
+        shedFlag.set_value(AdaptiveTaskQueue::isShedding());
+        shedReleased.wait();
+    }));
+    EXPECT_TRUE(shedFlag.get_future().get());
+    ASSERT_TRUE(queue.enqueue([]() {})); // Waits in the shed lane
+    EXPECT_FALSE(queue.enqueue([]() { ADD_FAILURE() << "Dropped task ran"; })); // Over both limits
+
+    AdaptiveTaskQueue::Stats stats = queue.getStats();
+    EXPECT_EQ(stats.queueDepth, 1u);
+    EXPECT_EQ(stats.shedQueueDepth, 1u);
+    EXPECT_EQ(stats.accepted, 5u);
+    EXPECT_EQ(stats.shed, 2u);
+    EXPECT_EQ(stats.dropped, 1u);
+    release.set_value();
+    shedRelease.set_value();
+    queue.shutdown();
+}
+
+TEST(AdaptiveTaskQueueTest, TasksThatWaitedPastMaxWaitRunInSheddingMode) {
+    AdaptiveTaskQueue::Settings settings = smallPool(1, 1, 10);
+    settings.maxWait = 20ms;
+    AdaptiveTaskQueue queue(settings);
+    ASSERT_TRUE(queue.enqueue([]() { std::this_thread::sleep_for(60ms); }));
+    std::promise<bool> staleFlag;
+    ASSERT_TRUE(queue.enqueue([&staleFlag]() { staleFlag.set_value(AdaptiveTaskQueue::isShedding()); }));
+    EXPECT_TRUE(staleFlag.get_future().get());
+    EXPECT_FALSE(AdaptiveTaskQueue::isShedding()); // Thread-local: the test thread is unaffected
+    queue.shutdown();
+    EXPECT_EQ(queue.getStats().shed, 1u);
+    EXPECT_GE(queue.getStats().waitMaxMs, 0.0);
+}
+
+TEST(AdaptiveTaskQueueTest, SaturatedServerAnswers503WithRetryAfter) {
+    httplib::Server server;
+    server.new_task_queue = []() { return new AdaptiveTaskQueue(smallPool(1, 1, 1)); };
+    server.set_pre_routing_handler([](const httplib::Request&, httplib::Response& res) {
+        if (!AdaptiveTaskQueue::isShedding()) return httplib::Server::HandlerResponse::Unhandled;
+        AdaptiveTaskQueue::writeShedResponse(res);
+        return httplib::Server::HandlerResponse::Handled;
+    });
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> handled{0};
+    server.Get("/slow", [&](const httplib::Request&, httplib::Response& res) {
+        handled++;
+        released.wait();
+        res.set_content("ok", "text/plain");
+    });
+    int port = server.bind_to_any_port("127.0.0.1");
+    std::thread serverThread([&server]() { server.listen_after_bind(); });
+
+    auto get = [port]() {
+        httplib::Client client("127.0.0.1", port);
+        client.set_read_timeout(5, 0);
+        return client.Get("/slow");
+    };
+    auto first = std::async(std::launch::async, get); // Holds the only worker
+    ASSERT_TRUE(eventually([&]() { return handled.load() == 1; }));
+    auto second = std::async(std::launch::async, get); // Fills the queue
+    std::this_thread::sleep_for(50ms);                  // Let the listener hand it over
+
+    auto start = std::chrono::steady_clock::now();
+    httplib::Result third = get();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_TRUE(third);
+    EXPECT_EQ(third->status, 503);
+    EXPECT_EQ(third->get_header_value("Retry-After"), "1");
+    EXPECT_LT(elapsed, 1s); // Answered without waiting for the busy worker
+
+    release.set_value();
+    httplib::Result firstResult = first.get();
+    httplib::Result secondResult = second.get();
+    ASSERT_TRUE(firstResult);
+    ASSERT_TRUE(secondResult);
+    EXPECT_EQ(firstResult->status, 200);
+    EXPECT_EQ(secondResult->status, 200);
+    server.stop();
+    serverThread.join();
+}
@@ -1,6 +1,11 @@
 #include "gtest/gtest.h"
 #include "../src/Airplane.h" // Adjust path
 #include "../src/Customer.h" // For suggestLowerPriceSeats
+#include "LinearizabilityChecker.h"
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
 
 // Test fixture for Airplane tests
 class AirplaneTest : public ::testing::Test {
@@ -238,3 +243,225 @@ TEST_F(AirplaneTest, SuggestLowerPriceSeatsNullCustomer) {
     std::vector<const Seat*> suggestions = plane_mixed->suggestLowerPriceSeats(nullptr, 100.0);
     EXPECT_TRUE(suggestions.empty());
 }
+
+// Test seat addressing by decoded seat ID and SeatKey
+TEST_F(AirplaneTest, SeatIndexAndKeyAddressing) {
+    EXPECT_EQ(plane_mixed->seatIndexOf("1A"), 0);
+    EXPECT_EQ(plane_mixed->seatIndexOf("2C"), 8); // Row 2 starts at index 6
+    EXPECT_EQ(plane_mixed->seatIndexOf("5F"), 29);
+    EXPECT_EQ(plane_mixed->seatIndexOf("6A"), -1);  // Past the last row
+    EXPECT_EQ(plane_mixed->seatIndexOf("1G"), -1);  // Past the last column
+    EXPECT_EQ(plane_mixed->seatIndexOf("A1"), -1);  // Malformed
+
+    SeatKey key = plane_mixed->getSeatKey(8);
+    EXPECT_EQ(SeatCodec::toSeatId(key), "2C");
+    EXPECT_EQ(plane_mixed->seatIndexOf(key), 8);
+    ASSERT_NE(plane_mixed->findSeat(key), nullptr);
+    EXPECT_EQ(plane_mixed->findSeat(key)->getSeatId(), "2C");
+    EXPECT_EQ(plane_mixed->getSeatKey(30), SeatCodec::INVALID_KEY);
+
+    // Every generated seat decodes back to its own position
+    const auto& seats = plane_default->getAllSeats();
+    for (size_t i = 0; i < seats.size(); ++i) {
+        EXPECT_EQ(plane_default->seatIndexOf(seats[i].getSeatId()), static_cast<int>(i));
+    }
+}
+
+// Test seat lookup on a wide-body with many rows
+TEST_F(AirplaneTest, FindSeatLargeAirplane) {
+    Airplane wideBody("WB600", 600, 10);
+    Seat* lastSeat = wideBody.findSeat("600J");
+    ASSERT_NE(lastSeat, nullptr);
+    EXPECT_EQ(lastSeat->getSeatId(), "600J");
+    EXPECT_TRUE(wideBody.bookSeatAt(wideBody.seatIndexOf("600J")));
+    EXPECT_TRUE(lastSeat->getIsBooked());
+    EXPECT_TRUE(wideBody.unbookSeatAt(wideBody.seatIndexOf("600J")));
+    EXPECT_FALSE(wideBody.bookSeatAt(-1));
+    EXPECT_EQ(wideBody.findSeat("601A"), nullptr);
+}
+
+// Test bitset-backed availability queries
+TEST_F(AirplaneTest, AvailabilityQueries) {
+    // plane_mixed: row 1 Business (indices 0-5), rows 2-5 Economy
+    EXPECT_EQ(plane_mixed->getAvailableSeatCount(), 30);
+    EXPECT_EQ(plane_mixed->getAvailableSeatCount(SeatClass::BUSINESS), 6);
+    EXPECT_EQ(plane_mixed->getAvailableSeatCount(SeatClass::ECONOMY), 24);
+    EXPECT_EQ(plane_mixed->findFirstAvailableSeat(), 0);
+    EXPECT_EQ(plane_mixed->findFirstAvailableSeat(SeatClass::ECONOMY), 6);
+
+    plane_mixed->bookSpecificSeat("1A");
+    plane_mixed->bookSpecificSeat("2A");
+    EXPECT_TRUE(plane_mixed->isSeatBooked(0));
+    EXPECT_FALSE(plane_mixed->isSeatBooked(1));
+    EXPECT_FALSE(plane_mixed->isSeatBooked(-1));
+    EXPECT_EQ(plane_mixed->getAvailableSeatCount(), 28);
+    EXPECT_EQ(plane_mixed->getAvailableSeatCount(SeatClass::BUSINESS), 5);
+    EXPECT_EQ(plane_mixed->findFirstAvailableSeat(), 1);
+    EXPECT_EQ(plane_mixed->findFirstAvailableSeat(SeatClass::ECONOMY), 7);
+
+    plane_mixed->unbookSpecificSeat("1A");
+    EXPECT_EQ(plane_mixed->findFirstAvailableSeat(), 0);
+    EXPECT_EQ(plane_mixed->getAvailableSeatCount(SeatClass::BUSINESS), 6);
+
+    // Full plane
+    for (const char* id : {"1A", "1B", "2A", "2B"}) {
+        plane_small->bookSpecificSeat(id);
+    }
+    EXPECT_EQ(plane_small->getAvailableSeatCount(), 0);
+    EXPECT_EQ(plane_small->findFirstAvailableSeat(), -1);
+    EXPECT_EQ(plane_small->findFirstAvailableSeat(SeatClass::ECONOMY), -1);
+}
+
+// Test the columnar per-seat accessors and price updates
+TEST_F(AirplaneTest, SeatColumns) {
+    int index1A = plane_mixed->seatIndexOf("1A");
+    int index2C = plane_mixed->seatIndexOf("2C");
+    EXPECT_DOUBLE_EQ(plane_mixed->getSeatPrice(index1A), 200.0);
+    EXPECT_EQ(plane_mixed->getSeatClass(index1A), SeatClass::BUSINESS);
+    EXPECT_DOUBLE_EQ(plane_mixed->getSeatPrice(index2C), 50.0);
+    EXPECT_EQ(plane_mixed->getSeatClass(index2C), SeatClass::ECONOMY);
+    EXPECT_EQ(plane_mixed->getSeatId(index2C), "2C");
+
+    EXPECT_TRUE(plane_mixed->setSeatPrice(index2C, 42.5));
+    EXPECT_DOUBLE_EQ(plane_mixed->getSeatPrice(index2C), 42.5);
+    EXPECT_DOUBLE_EQ(plane_mixed->findSeat("2C")->getPrice(), 42.5); // Seat mirror follows
+    EXPECT_FALSE(plane_mixed->setSeatPrice(index2C, -1.0));
+    EXPECT_FALSE(plane_mixed->setSeatPrice(-1, 10.0));
+    EXPECT_DOUBLE_EQ(plane_mixed->getSeatPrice(index2C), 42.5);
+}
+
+// Test the batch cheapest-N query
+TEST_F(AirplaneTest, FindCheapestAvailableSeats) {
+    plane_mixed->setSeatPrice(plane_mixed->seatIndexOf("5F"), 10.0);
+    plane_mixed->setSeatPrice(plane_mixed->seatIndexOf("4B"), 20.0);
+    plane_mixed->setSeatPrice(plane_mixed->seatIndexOf("3D"), 20.0);
+    plane_mixed->bookSpecificSeat("2A");
+
+    std::vector<int> cheapest = plane_mixed->findCheapestAvailableSeats(4, 1000.0);
+    ASSERT_EQ(cheapest.size(), 4u);
+    EXPECT_EQ(plane_mixed->getSeatId(cheapest[0]), "5F");
+    EXPECT_EQ(plane_mixed->getSeatId(cheapest[1]), "3D"); // Equal prices: lower index first
+    EXPECT_EQ(plane_mixed->getSeatId(cheapest[2]), "4B");
+    EXPECT_EQ(plane_mixed->getSeatId(cheapest[3]), "2B"); // 2A is booked
+
+    // Budget filter, and asking for more than exist
+    EXPECT_EQ(plane_mixed->findCheapestAvailableSeats(10, 20.0).size(), 3u);
+    EXPECT_EQ(plane_mixed->findCheapestAvailableSeats(100, 1000.0).size(), 29u);
+    EXPECT_TRUE(plane_mixed->findCheapestAvailableSeats(0, 1000.0).empty());
+    EXPECT_TRUE(plane_mixed->findCheapestAvailableSeats(5, 5.0).empty());
+
+    // Class-restricted variant
+    std::vector<int> business = plane_mixed->findCheapestAvailableSeats(3, 1000.0, SeatClass::BUSINESS);
+    ASSERT_EQ(business.size(), 3u);
+    EXPECT_EQ(plane_mixed->getSeatId(business[0]), "1A");
+    EXPECT_TRUE(plane_mixed->findCheapestAvailableSeats(3, 100.0, SeatClass::BUSINESS).empty());
+}
+
+// Test the price scan across several 64-seat words
+TEST_F(AirplaneTest, FindCheapestAvailableSeatsLargeAirplane) {
+    Airplane big("BIG01", 50, 6); // 300 seats
+    for (int i = 0; i < big.getCapacity(); ++i) {
+        big.setSeatPrice(i, 1000.0 - i); // Later seats are cheaper
+    }
+    big.bookSeatAt(299);
+    std::vector<int> cheapest = big.findCheapestAvailableSeats(3, 1000.0);
+    EXPECT_EQ(cheapest, (std::vector<int>{298, 297, 296}));
+    EXPECT_EQ(big.findCheapestAvailableSeats(300, 750.0).size(), 49u); // Seats 250..298
+}
+
+// Many threads race for every seat of one flight: each seat goes to exactly one of them
+TEST_F(AirplaneTest, ConcurrentBookSeatAtHasOneWinnerPerSeat) {
+    const int threadCount = 8;
+    const int capacity = plane_default->getCapacity();
+    std::vector<std::atomic<int>> winners(capacity);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < capacity; ++i) {
+                int seatIndex = (i + t * 11) % capacity;
+                if (plane_default->bookSeatAt(seatIndex)) winners[seatIndex].fetch_add(1);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < capacity; ++i) {
+        EXPECT_EQ(winners[i].load(), 1) << i;
+        EXPECT_TRUE(plane_default->getAllSeats()[i].getIsBooked());
+    }
+    EXPECT_EQ(plane_default->getBookedSeatsCount(), capacity);
+    EXPECT_TRUE(plane_default->isFull());
+}
+
+namespace {
+
+enum SeatOp { BOOK = 0, UNBOOK = 1 };
+
+// Sequential spec of one seat: state is "booked"; book succeeds only on a free seat, unbook only on a booked one
+bool applySeatOp(const bool& booked, const linearizability::Operation& op, bool& next) {
+    bool expected = op.kind == BOOK ? !booked : booked;
+    if ((op.result != 0) != expected) return false;
+    next = expected ? (op.kind == BOOK) : booked;
+    return true;
+}
+
+} // namespace
+
+TEST(LinearizabilityCheckerTest, RejectsImpossibleSeatHistory) {
+    using linearizability::Operation;
+    // Two books that both succeed without an unbook between them cannot be ordered
+    std::vector<Operation> overlapping = {{0, 3, BOOK, 1}, {1, 2, BOOK, 0}};
+    EXPECT_TRUE(linearizability::check(overlapping, false, applySeatOp));
+    std::vector<Operation> doubleBooked = {{0, 3, BOOK, 1}, {1, 2, BOOK, 1}};
+    EXPECT_FALSE(linearizability::check(doubleBooked, false, applySeatOp));
+    // Real time matters: an unbook that finished before a book started cannot have freed it
+    std::vector<Operation> staleUnbook = {{0, 1, UNBOOK, 1}, {2, 3, BOOK, 1}};
+    EXPECT_FALSE(linearizability::check(staleUnbook, false, applySeatOp));
+}
+
+// Records concurrent bookSeatAt/unbookSeatAt calls and checks each seat's history against the
+// sequential spec. Seats are independent objects, so per-seat checks cover the whole history.
+TEST_F(AirplaneTest, BookAndUnbookAreLinearizable) {
+    const int threadCount = 4;
+    const int opsPerThread = 12;
+    const int seatCount = 2; // 4 x 12 ops over 2 seats keeps each seat's history near 24 ops
+    for (int round = 0; round < 50; ++round) {
+        Airplane plane("LZ001", 1, seatCount);
+        linearizability::Clock clock;
+        std::vector<std::vector<linearizability::Operation>> perSeat(seatCount);
+        std::vector<std::vector<std::pair<int, linearizability::Operation>>> recorded(threadCount);
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                std::mt19937 gen(round * 100 + t);
+                while (!go.load()) {}
+                for (int i = 0; i < opsPerThread; ++i) {
+                    int seatIndex = static_cast<int>(gen() % seatCount);
+                    linearizability::Operation op;
+                    op.kind = gen() % 2 == 0 ? BOOK : UNBOOK;
+                    op.invoke = clock.tick();
+                    op.result = op.kind == BOOK ? plane.bookSeatAt(seatIndex) : plane.unbookSeatAt(seatIndex);
+                    op.response = clock.tick();
+                    recorded[t].push_back({seatIndex, op});
+                }
+            });
+        }
+        go.store(true);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        for (const auto& ops : recorded) {
+            for (const auto& entry : ops) perSeat[entry.first].push_back(entry.second);
+        }
+        int occupied = 0;
+        for (int seat = 0; seat < seatCount; ++seat) {
+            ASSERT_TRUE(linearizability::check(perSeat[seat], false, applySeatOp))
+                << "round " << round << ", seat " << seat;
+            occupied += plane.isSeatBooked(seat);
+            EXPECT_EQ(plane.getAllSeats()[seat].getIsBooked(), plane.isSeatBooked(seat)); // One bit, no mirror to go stale
+        }
+        EXPECT_EQ(plane.getBookedSeatsCount(), occupied); // Counter settles once all calls returned
+    }
+}
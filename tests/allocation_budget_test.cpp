@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include "AllocationCounter.h" // Replaces operator new for the test binary; counts only inside start()/stop()
+#include "../src/ApiJson.h"
+#include "../src/ReservationSystem.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Steady-state heap allocation budgets for the booking hot path. Warm-up operations let the
+// indexes, slot maps and caller buffers reach their working size first.
+class AllocationBudgetTest : public ::testing::Test {
+protected:
+    static constexpr int kOps = 100;
+    static constexpr int kSlack = 4; // Occasional index rehash or vector growth during the window
+
+    std::stringstream test_in;
+    std::stringstream test_out;
+    ReservationSystem rs;
+    std::string error;
+    std::vector<std::string> seats;
+
+    AllocationBudgetTest() : rs(test_in, test_out) {}
+
+    void SetUp() override {
+        rs.resetSystemForTest();
+        rs.initializeSystem();
+        rs.findCustomerById("CUST0001")->setMoney(1e9);
+        error.reserve(256);
+        Airplane* plane = rs.findAirplaneByFlightNumber("FL202"); // 20 rows x 6
+        for (int i = 0; i < plane->getCapacity(); ++i) {
+            seats.push_back(plane->getSeatId(i));
+        }
+        // Warm up with book/cancel cycles over the first half of the plane. Several cycles, so the
+        // flight snapshot free list holds a full reclamation batch of recycled versions.
+        for (int cycle = 0; cycle < 3; ++cycle) {
+            std::vector<std::string> ids;
+            for (int i = 0; i < 60; ++i) {
+                ids.push_back(rs.createBookingInternal("CUST0001", "FL202", seats[i], error)->getBookingId());
+            }
+            for (const std::string& id : ids) {
+                rs.cancelBookingInternal(id, error);
+            }
+        }
+    }
+};
+
+TEST_F(AllocationBudgetTest, CreateBookingAtMostOneAllocation) {
+    allocation_counter::start();
+    for (int i = 0; i < 60; ++i) {
+        ASSERT_NE(rs.createBookingInternal("CUST0001", "FL202", seats[60 + i], error), nullptr);
+    }
+    allocation_counter::Stats stats = allocation_counter::stop();
+    EXPECT_LE(stats.allocations, 60u + kSlack); // One booking-index node per booking
+}
+
+TEST_F(AllocationBudgetTest, CancelAndSwapAllocationFree) {
+    std::vector<std::string> ids;
+    for (int i = 0; i < 40; ++i) {
+        ids.push_back(rs.createBookingInternal("CUST0001", "FL202", seats[60 + i], error)->getBookingId());
+    }
+
+    allocation_counter::start();
+    for (int i = 0; i + 1 < 40; i += 2) {
+        ASSERT_TRUE(rs.swapSeatsInternal(ids[i], ids[i + 1], error));
+    }
+    allocation_counter::Stats swapStats = allocation_counter::stop();
+    EXPECT_EQ(swapStats.allocations, 0u);
+
+    allocation_counter::start();
+    for (const std::string& id : ids) {
+        ASSERT_TRUE(rs.cancelBookingInternal(id, error));
+    }
+    allocation_counter::Stats cancelStats = allocation_counter::stop();
+    EXPECT_EQ(cancelStats.allocations, 0u);
+}
+
+TEST_F(AllocationBudgetTest, SeatMapSerializationAllocationFree) {
+    rs.createBookingInternal("CUST0001", "FL202", "10C", error);
+    const Airplane& plane = *rs.findAirplaneByFlightNumber("FL202");
+    std::vector<const Booking*> seatBookings;
+    std::string body;
+    rs.getSeatBookings("FL202", seatBookings);
+    writeSeatMapJson(body, plane, seatBookings);
+
+    allocation_counter::start();
+    for (int i = 0; i < kOps; ++i) {
+        rs.getSeatBookings("FL202", seatBookings);
+        body.clear();
+        writeSeatMapJson(body, plane, seatBookings);
+    }
+    allocation_counter::Stats stats = allocation_counter::stop();
+    EXPECT_EQ(stats.allocations, 0u);
+    EXPECT_NE(body.find("\"bookedByCustomerId\":\"CUST0001\""), std::string::npos);
+}
+
+TEST(AllocationCounterTest, CountsOnlyWhileStarted) {
+    allocation_counter::start();
+    std::string* heapString = new std::string(100, 'x'); // Object plus its character buffer
+    allocation_counter::Stats stats = allocation_counter::stop();
+    delete heapString;
+    EXPECT_EQ(stats.allocations, 2u);
+    EXPECT_GE(stats.bytes, sizeof(std::string) + 100);
+
+    std::vector<int> untracked(10);
+    allocation_counter::start();
+    allocation_counter::Stats empty = allocation_counter::stop();
+    EXPECT_EQ(empty.allocations, 0u);
+}
@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+#include "../src/AtomicSeatBitset.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Test claims, releases and scans across word boundaries
+TEST(AtomicSeatBitsetTest, TrySetTryResetAndScans) {
+    AtomicSeatBitset bits(130);
+    EXPECT_EQ(bits.size(), 130);
+    EXPECT_EQ(bits.count(), 0);
+
+    EXPECT_TRUE(bits.trySet(0));
+    EXPECT_FALSE(bits.trySet(0)); // Second claim of the same bit fails
+    EXPECT_TRUE(bits.trySet(64));
+    EXPECT_TRUE(bits.trySet(129));
+    EXPECT_TRUE(bits.test(64));
+    EXPECT_FALSE(bits.test(65));
+    EXPECT_EQ(bits.count(), 3);
+    EXPECT_EQ(bits.findFirstClear(), 1);
+
+    EXPECT_TRUE(bits.tryReset(64));
+    EXPECT_FALSE(bits.tryReset(64));
+    EXPECT_EQ(bits.count(), 2);
+
+    SeatBitset mask(130);
+    mask.set(0);
+    mask.set(100);
+    mask.set(129);
+    EXPECT_EQ(bits.countAndNot(mask), 1);
+    EXPECT_EQ(bits.findFirstClearIn(mask), 100);
+    std::vector<int> clear;
+    bits.forEachClearIn(mask, [&clear](int index) { clear.push_back(index); });
+    EXPECT_EQ(clear, std::vector<int>{100});
+}
+
+// Racing claims on the same bits: every bit is won exactly once
+TEST(AtomicSeatBitsetTest, ConcurrentClaimsHaveOneWinnerPerBit) {
+    const int bitCount = 1000;
+    const int threadCount = 8;
+    AtomicSeatBitset bits(bitCount);
+    std::vector<std::atomic<int>> winners(bitCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < bitCount; ++i) {
+                int index = (i + t * 131) % bitCount;
+                if (bits.trySet(index)) winners[index].fetch_add(1);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(bits.count(), bitCount);
+    for (int i = 0; i < bitCount; ++i) {
+        EXPECT_EQ(winners[i].load(), 1) << i;
+    }
+}
@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+#include "../src/BookingIdGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Test layout: timestamp in the high bits, sequence in the low bits
+TEST(BookingIdGeneratorTest, EncodesTimestampAndSequence) {
+    BookingIdGenerator generator;
+    const std::uint64_t t = BookingIdGenerator::EPOCH_MILLIS + 5000;
+    std::uint64_t first = generator.nextAt(t);
+    std::uint64_t second = generator.nextAt(t);
+    EXPECT_EQ(first, 5000ULL << BookingIdGenerator::SEQUENCE_BITS);
+    EXPECT_EQ(second, first + 1);
+    EXPECT_EQ(BookingIdGenerator::timestampMillis(first), t);
+    EXPECT_EQ(BookingIdGenerator::timestampMillis(second), t);
+
+    // A new millisecond starts a new sequence
+    std::uint64_t later = generator.nextAt(t + 1);
+    EXPECT_EQ(later, 5001ULL << BookingIdGenerator::SEQUENCE_BITS);
+}
+
+// Test that numbers stay unique and increasing when the clock steps back or the sequence runs out
+TEST(BookingIdGeneratorTest, MonotonicUnderClockSkewAndOverflow) {
+    BookingIdGenerator generator;
+    const std::uint64_t t = BookingIdGenerator::EPOCH_MILLIS + 100;
+    std::uint64_t before = generator.nextAt(t);
+    std::uint64_t skewed = generator.nextAt(t - 50); // Clock went backwards
+    EXPECT_GT(skewed, before);
+
+    std::uint64_t previous = skewed;
+    for (std::uint64_t i = 0; i < BookingIdGenerator::SEQUENCE_MASK + 10; ++i) {
+        std::uint64_t next = generator.nextAt(t);
+        ASSERT_GT(next, previous);
+        previous = next;
+    }
+    EXPECT_EQ(BookingIdGenerator::timestampMillis(previous), t + 1); // Borrowed into the next millisecond
+    EXPECT_GT(generator.nextAt(t + 1), previous);
+}
+
+// Test the real clock: IDs carry roughly the current time
+TEST(BookingIdGeneratorTest, UsesSystemClock) {
+    BookingIdGenerator generator;
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::uint64_t stamp = BookingIdGenerator::timestampMillis(generator.next());
+    EXPECT_GE(stamp + 1000, static_cast<std::uint64_t>(now));
+    EXPECT_LE(stamp, static_cast<std::uint64_t>(now) + 1000);
+}
+
+// Stress test: many threads drawing from one generator never see a duplicate,
+// and each thread sees strictly increasing numbers
+TEST(BookingIdGeneratorTest, UniqueAcrossThreads) {
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 100000;
+    BookingIdGenerator generator;
+    std::vector<std::vector<std::uint64_t>> drawn(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&generator, &drawn, t]() {
+            drawn[t].reserve(kPerThread);
+            for (int i = 0; i < kPerThread; ++i) {
+                drawn[t].push_back(generator.next());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<std::uint64_t> all;
+    all.reserve(static_cast<size_t>(kThreads) * kPerThread);
+    for (const auto& numbers : drawn) {
+        EXPECT_TRUE(std::is_sorted(numbers.begin(), numbers.end()));
+        EXPECT_EQ(std::adjacent_find(numbers.begin(), numbers.end()), numbers.end());
+        all.insert(all.end(), numbers.begin(), numbers.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+}
@@ -41,6 +41,8 @@ TEST_F(BookingTest, ConstructorAndGetters) {
 
     // Booking date string should be generated and not empty
     EXPECT_FALSE(b1->getBookingDateString().empty());
+    EXPECT_EQ(b1->getBookingDateString().size(), 19u); // YYYY-MM-DD HH:MM:SS, from the booking number's timestamp
+    EXPECT_EQ(b1->getPaidCents(), 0);
     // std::cout << "B1 Date: " << b1->getBookingDateString() << std::endl; // For manual inspection
     // std::cout << "B2 Date: " << b2->getBookingDateString() << std::endl;
     // Dates might be very close, but IDs should differ due to random component or time progression
@@ -99,3 +101,54 @@ TEST_F(BookingTest, GenerateBookingIdUniqueness) {
     EXPECT_NE(id1, tempBooking2.getBookingId());
     EXPECT_NE(id2, tempBooking2.getBookingId());
 }
+
+// Test the compact constructor and accessors
+TEST_F(BookingTest, CompactReferences) {
+    Booking compact(customerIdInterner().intern("C0001"), flightNumberInterner().intern("FL101"), SeatCodec::parseKey("12C"));
+    EXPECT_EQ(compact.getCustomerId(), "C0001");
+    EXPECT_EQ(compact.getFlightNumber(), "FL101");
+    EXPECT_EQ(compact.getSeatId(), "12C");
+    EXPECT_EQ(compact.getCustomerRef(), b1->getCustomerRef()); // Same customer, same interned id
+    EXPECT_EQ(compact.getFlightRef(), b1->getFlightRef());
+    EXPECT_NE(compact.getFlightRef(), b2->getFlightRef());
+    EXPECT_EQ(compact.getSeatKey(), SeatCodec::parseKey("12C"));
+
+    compact.setSeatKey(SeatCodec::parseKey("3F"));
+    EXPECT_EQ(compact.getSeatId(), "3F");
+
+    // Labels SeatCodec cannot encode are still kept, just without a seat key
+    compact.setSeatId("NEW10X");
+    EXPECT_EQ(compact.getSeatId(), "NEW10X");
+    EXPECT_EQ(compact.getSeatKey(), SeatCodec::INVALID_KEY);
+
+    EXPECT_LE(sizeof(Booking), 32u);
+}
+
+// Test booking ID formatting and parsing round trip
+TEST_F(BookingTest, BookingIdFormatAndParse) {
+    std::uint64_t number = 0;
+    ASSERT_TRUE(Booking::parseBookingId(b1->getBookingId(), number));
+    EXPECT_EQ(number, b1->getBookingNumber());
+    EXPECT_EQ(b1->getBookingId().size(), static_cast<size_t>(Booking::BOOKING_ID_LENGTH));
+
+    EXPECT_EQ(Booking::formatBookingId(0), "BK0000000000000");
+    EXPECT_EQ(Booking::formatBookingId(32 * 10 + 31), "BK00000000000AZ");
+    EXPECT_EQ(Booking::formatBookingId(~0ULL), "BKFZZZZZZZZZZZZ");
+    ASSERT_TRUE(Booking::parseBookingId("BKFZZZZZZZZZZZZ", number));
+    EXPECT_EQ(number, ~0ULL);
+    ASSERT_TRUE(Booking::parseBookingId("BK00000000000AZ", number));
+    EXPECT_EQ(number, 351u);
+
+    EXPECT_FALSE(Booking::parseBookingId("", number));
+    EXPECT_FALSE(Booking::parseBookingId("BK123", number));
+    EXPECT_FALSE(Booking::parseBookingId("XX00000000000AZ", number));
+    EXPECT_FALSE(Booking::parseBookingId("BK00000000000IZ", number)); // I is not a Crockford digit
+    EXPECT_FALSE(Booking::parseBookingId("BK00000000000az", number));
+    EXPECT_FALSE(Booking::parseBookingId("BKG000000000000", number)); // Would overflow 64 bits
+}
+
+// Test that later bookings get larger IDs that also sort later as strings
+TEST_F(BookingTest, BookingIdsAreTimeOrdered) {
+    EXPECT_LT(b1->getBookingNumber(), b2->getBookingNumber());
+    EXPECT_LT(b1->getBookingId(), b2->getBookingId());
+}
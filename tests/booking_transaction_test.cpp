@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include "../src/BookingTransaction.h"
+#include <atomic>
+#include <stdexcept>
+
+class BookingTransactionTest : public ::testing::Test {
+protected:
+    Airplane plane{"TX100", 2, 6}; // Row 1 is business ($200), row 2 economy ($50)
+    Customer customer{"Tx Customer", 30, "C0001", 250.0};
+    std::atomic<Cents> revenue{0};
+};
+
+TEST_F(BookingTransactionTest, CommitKeepsSeatChargeAndRevenue) {
+    int seatIndex = plane.seatIndexOf("2A");
+    {
+        BookingTransaction transaction(plane, seatIndex, customer, revenue);
+        ASSERT_EQ(transaction.prepare(), BookingTransaction::Status::READY);
+        EXPECT_EQ(transaction.getPriceCents(), 5000);
+        transaction.commit();
+    }
+    EXPECT_TRUE(plane.isSeatBooked(seatIndex));
+    EXPECT_EQ(customer.getBalanceCents(), 20000);
+    EXPECT_EQ(revenue.load(), 5000);
+}
+
+TEST_F(BookingTransactionTest, UncommittedTransactionRollsBack) {
+    int seatIndex = plane.seatIndexOf("1A");
+    {
+        BookingTransaction transaction(plane, seatIndex, customer, revenue);
+        ASSERT_EQ(transaction.prepare(), BookingTransaction::Status::READY);
+        EXPECT_TRUE(plane.isSeatBooked(seatIndex));
+        EXPECT_EQ(customer.getBalanceCents(), 5000);
+    } // Destroyed without commit, as when the booking append fails
+    EXPECT_FALSE(plane.isSeatBooked(seatIndex));
+    EXPECT_EQ(customer.getBalanceCents(), 25000);
+    EXPECT_EQ(revenue.load(), 0);
+
+    // Same when the append throws
+    try {
+        BookingTransaction transaction(plane, seatIndex, customer, revenue);
+        ASSERT_EQ(transaction.prepare(), BookingTransaction::Status::READY);
+        throw std::runtime_error("append failed");
+    } catch (const std::runtime_error&) {
+    }
+    EXPECT_FALSE(plane.isSeatBooked(seatIndex));
+    EXPECT_EQ(customer.getBalanceCents(), 25000);
+}
+
+TEST_F(BookingTransactionTest, FailedStepsLeaveNothingBehind) {
+    int taken = plane.seatIndexOf("2B");
+    ASSERT_TRUE(plane.bookSeatAt(taken));
+    {
+        BookingTransaction transaction(plane, taken, customer, revenue);
+        EXPECT_EQ(transaction.prepare(), BookingTransaction::Status::SEAT_TAKEN);
+    }
+    EXPECT_TRUE(plane.isSeatBooked(taken)); // Still the other holder's seat
+    EXPECT_EQ(customer.getBalanceCents(), 25000);
+
+    customer.setMoney(199.99);
+    int business = plane.seatIndexOf("1B");
+    {
+        BookingTransaction transaction(plane, business, customer, revenue);
+        EXPECT_EQ(transaction.prepare(), BookingTransaction::Status::INSUFFICIENT_FUNDS);
+    }
+    EXPECT_FALSE(plane.isSeatBooked(business));
+    EXPECT_EQ(customer.getBalanceCents(), 19999);
+    EXPECT_EQ(revenue.load(), 0);
+}
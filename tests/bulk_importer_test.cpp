@@ -0,0 +1,237 @@
+#include "gtest/gtest.h"
+#include "../src/BulkImporter.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+class BulkImporterTest : public ::testing::Test {
+protected:
+    std::stringstream console;
+    ReservationSystem system{console, console};
+
+    void SetUp() override { system.resetSystemForTest(); }
+
+    BulkImporter::Report import(const std::string& text, BulkImporter::Kind kind, BulkImporter::Format format,
+                                const BulkImporter::Options& options = BulkImporter::Options()) {
+        std::istringstream in(text);
+        BulkImporter importer(system, options);
+        BulkImporter::Report report;
+        std::string message;
+        EXPECT_TRUE(importer.importStream(in, kind, format, report, message)) << message;
+        return report;
+    }
+
+    static BulkImporter::Options tinyChunks() {
+        BulkImporter::Options options;
+        options.chunkBytes = 40; // Shorter than some lines
+        options.sliceBytes = 16;
+        options.batchRows = 3;
+        return options;
+    }
+};
+
+} // namespace
+
+// Test that airplanes whose seats SeatCodec cannot number are refused like on the API path
+TEST_F(BulkImporterTest, OversizedAirplanesAreRefused) {
+    BulkImporter::Report airplanes = import("flightNumber,rows,seatsPerRow\nFL1,10,192\nFL2,10000000,1\nFL3,2,191\n",
+                                            BulkImporter::Kind::AIRPLANES, BulkImporter::Format::CSV);
+    EXPECT_EQ(airplanes.imported, 1u);
+    ASSERT_EQ(airplanes.errors.size(), 2u);
+    for (std::size_t i = 0; i < 2; ++i) {
+        EXPECT_EQ(airplanes.errors[i].line, i + 2);
+        EXPECT_EQ(airplanes.errors[i].message, "At most 9999999 rows, 191 seats per row and 2147483647 seats in all.");
+    }
+    EXPECT_EQ(system.findAirplaneByFlightNumber("FL2"), nullptr);
+    ASSERT_NE(system.findAirplaneByFlightNumber("FL3"), nullptr);
+    EXPECT_EQ(system.findAirplaneByFlightNumber("FL3")->getCapacity(), 382);
+}
+
+// Test that CSV rows load in order, columns by header name, and refused rows are reported by line
+TEST_F(BulkImporterTest, CsvLoadsRowsAndReportsEachRefusedLine) {
+    BulkImporter::Report airplanes = import("flightNumber,seatsPerRow,rows\nFL1,4,10\r\nFL2,6,20\nFL1,4,10\n", BulkImporter::Kind::AIRPLANES,
+                                            BulkImporter::Format::CSV);
+    EXPECT_EQ(airplanes.rows, 3u);
+    EXPECT_EQ(airplanes.imported, 2u);
+    ASSERT_EQ(airplanes.errors.size(), 1u);
+    EXPECT_EQ(airplanes.errors[0].line, 4u);
+    EXPECT_EQ(airplanes.errors[0].message, "Airplane with flight number FL1 already exists.");
+    ASSERT_NE(system.findAirplaneByFlightNumber("FL1"), nullptr);
+    EXPECT_EQ(system.findAirplaneByFlightNumber("FL1")->getCapacity(), 40);
+
+    BulkImporter::Report customers = import(
+        "customerId,name,age,money,loyaltyTier\n"
+        "P-100,\"Doe, Jane \"\"JD\"\"\",34,500.25,gold\n"
+        ",Generated,40,100,\n"
+        "P-101,Old,-3,10,\n"
+        "P-102,Short,20\n"
+        "\n"
+        "P-100,Again,30,1,\n",
+        BulkImporter::Kind::CUSTOMERS, BulkImporter::Format::CSV);
+    EXPECT_EQ(customers.rows, 5u);
+    EXPECT_EQ(customers.imported, 2u);
+    EXPECT_EQ(customers.failed, 3u);
+    ASSERT_EQ(customers.errors.size(), 3u);
+    EXPECT_EQ(customers.errors[0].line, 4u);
+    EXPECT_EQ(customers.errors[0].message, "age must be a non-negative whole number.");
+    EXPECT_EQ(customers.errors[1].line, 5u);
+    EXPECT_EQ(customers.errors[1].message, "Expected 5 field(s), found 3.");
+    EXPECT_EQ(customers.errors[2].line, 7u); // After the blank line
+    EXPECT_EQ(customers.errors[2].message, "Customer P-100 already exists.");
+    ASSERT_NE(system.findCustomerById("P-100"), nullptr);
+    EXPECT_EQ(system.findCustomerById("P-100")->getName(), "Doe, Jane \"JD\"");
+    EXPECT_EQ(system.findCustomerById("P-100")->getBalanceCents(), 50025);
+    EXPECT_NE(system.findCustomerById("CUST0001"), nullptr); // The generated ID
+
+    BulkImporter::Report bookings = import(
+        "customerId,flightNumber,seatId\n"
+        "P-100,FL1,1A\n"
+        "P-100,FL1,1A\n"
+        "P-999,FL1,1B\n"
+        "P-100,FL9,1B\n"
+        "P-100,FL1,99Z\n"
+        "CUST0001,FL2,20F\n",
+        BulkImporter::Kind::BOOKINGS, BulkImporter::Format::CSV);
+    EXPECT_EQ(bookings.imported, 2u);
+    ASSERT_EQ(bookings.errors.size(), 4u);
+    EXPECT_EQ(bookings.errors[0].message, "Seat is already booked.");
+    EXPECT_EQ(bookings.errors[1].message, "Customer not found.");
+    EXPECT_EQ(bookings.errors[2].message, "Airplane not found.");
+    EXPECT_EQ(bookings.errors[3].line, 6u);
+    EXPECT_EQ(bookings.errors[3].message, "Seat not found on this flight.");
+    ASSERT_NE(system.findBookingForSeat("FL1", "1A"), nullptr);
+    EXPECT_EQ(system.findBookingForSeat("FL1", "1A")->getCustomerId(), "P-100");
+    EXPECT_LT(system.findCustomerById("P-100")->getBalanceCents(), 50025); // Charged the fare
+    EXPECT_EQ(system.getRevenueCents(), 50025 - system.findCustomerById("P-100")->getBalanceCents() +
+                                            10000 - system.findCustomerById("CUST0001")->getBalanceCents());
+}
+
+// Test that JSON Lines rows unescape strings and that chunk and slice boundaries keep line numbers
+TEST_F(BulkImporterTest, JsonLinesAcrossTinyChunksMatchOneChunk) {
+    std::string customers;
+    for (int i = 1; i <= 30; ++i) {
+        if (i % 7 == 0) {
+            customers += "{\"customerId\": \"J" + std::to_string(i) + "\", \"name\": [\"nested\"], \"age\": 1, \"money\": 1}\n";
+        } else {
+            customers += "{\"customerId\":\"J" + std::to_string(i) + "\",\"name\":\"Caf\\u00e9 \\\"" + std::to_string(i) +
+                         "\\\"\",\"age\":" + std::to_string(20 + i) + ",\"money\":1e3,\"note\":\"ignored\"}\n";
+        }
+    }
+    customers += "{\"customerId\":\"J31\",\"name\":\"No newline\",\"age\":5,\"money\":0.5}";
+
+    BulkImporter::Report whole = import(customers, BulkImporter::Kind::CUSTOMERS, BulkImporter::Format::JSONL);
+    system.resetSystemForTest();
+    BulkImporter::Report chunked = import(customers, BulkImporter::Kind::CUSTOMERS, BulkImporter::Format::JSONL, tinyChunks());
+    for (const BulkImporter::Report* report : {&whole, &chunked}) {
+        EXPECT_EQ(report->rows, 31u);
+        EXPECT_EQ(report->imported, 27u);
+        ASSERT_EQ(report->errors.size(), 4u);
+        for (std::size_t i = 0; i < 4; ++i) {
+            EXPECT_EQ(report->errors[i].line, 7u * (i + 1));
+            EXPECT_EQ(report->errors[i].message, "Not a JSON object of strings and numbers.");
+        }
+    }
+    ASSERT_NE(system.findCustomerById("J12"), nullptr);
+    EXPECT_EQ(system.findCustomerById("J12")->getName(), "Caf\xC3\xA9 \"12\"");
+    EXPECT_EQ(system.findCustomerById("J12")->getAge(), 32);
+    EXPECT_EQ(system.findCustomerById("J12")->getBalanceCents(), 100000);
+    EXPECT_EQ(system.findCustomerById("J31")->getName(), "No newline");
+    EXPECT_EQ(system.findCustomerById("J7"), nullptr);
+}
+
+// Test that a file the importer cannot use is refused as a whole
+TEST_F(BulkImporterTest, RefusesMissingFilesAndHeadersWithoutRequiredColumns) {
+    BulkImporter importer(system);
+    BulkImporter::Report report;
+    std::string message;
+    std::string path = ::testing::TempDir() + "bulk_importer_missing.csv";
+    std::remove(path.c_str());
+    EXPECT_FALSE(importer.importFile(path, BulkImporter::Kind::AIRPLANES, BulkImporter::Format::CSV, report, message));
+    EXPECT_EQ(message.compare(0, 13 + path.size(), "Cannot open " + path + ":"), 0);
+
+    std::istringstream noSeatColumn("customerId,flightNumber\nCUST0001,FL1\n");
+    EXPECT_FALSE(importer.importStream(noSeatColumn, BulkImporter::Kind::BOOKINGS, BulkImporter::Format::CSV, report, message));
+    EXPECT_EQ(message, "The CSV header has no seatId column.");
+    std::istringstream empty("");
+    EXPECT_FALSE(importer.importStream(empty, BulkImporter::Kind::BOOKINGS, BulkImporter::Format::CSV, report, message));
+    EXPECT_EQ(message, "The CSV file has no header.");
+
+    BulkImporter::Format format = BulkImporter::Format::CSV;
+    EXPECT_TRUE(BulkImporter::formatOfPath("partner/bookings.ndjson", format));
+    EXPECT_EQ(format, BulkImporter::Format::JSONL);
+    EXPECT_FALSE(BulkImporter::formatOfPath("bookings.xml", format));
+    BulkImporter::Kind kind = BulkImporter::Kind::AIRPLANES;
+    EXPECT_TRUE(BulkImporter::parseKind("bookings", kind));
+    EXPECT_EQ(kind, BulkImporter::Kind::BOOKINGS);
+    EXPECT_FALSE(BulkImporter::parseKind("seats", kind));
+}
+
+// Test that imported rows are logged and a restart recovers them
+TEST_F(BulkImporterTest, ImportedRowsAreLoggedAndRecovered) {
+    std::string walPath = ::testing::TempDir() + "bulk_importer_test.wal";
+    std::string csvPath = ::testing::TempDir() + "bulk_importer_test.csv";
+    std::remove(walPath.c_str());
+    std::string message;
+    ASSERT_TRUE(system.openWriteAheadLog(walPath, WriteAheadLog::Options(), message)) << message;
+    import("flightNumber,rows,seatsPerRow\nFL7,30,6\n", BulkImporter::Kind::AIRPLANES, BulkImporter::Format::CSV);
+    {
+        std::ofstream out(csvPath);
+        out << "name,age,money\n";
+        for (int i = 0; i < 50; ++i) out << "Passenger " << i << "," << 20 + i << ",1000\n";
+    }
+    BulkImporter importer(system, tinyChunks());
+    BulkImporter::Report report;
+    ASSERT_TRUE(importer.importFile(csvPath, BulkImporter::Kind::CUSTOMERS, BulkImporter::Format::CSV, report, message)) << message;
+    EXPECT_EQ(message, "Imported 50 of 50 row(s).");
+    std::string bookings = "customerId,flightNumber,seatId\n";
+    for (int i = 0; i < 50; ++i) bookings += "CUST" + std::string(i + 1 < 10 ? "000" : "00") + std::to_string(i + 1) + ",FL7," +
+                                             std::to_string(i / 6 + 1) + static_cast<char>('A' + i % 6) + "\n";
+    report = import(bookings, BulkImporter::Kind::BOOKINGS, BulkImporter::Format::CSV, tinyChunks());
+    EXPECT_EQ(report.imported, 50u);
+    EXPECT_GT(report.rowsPerSecond(), 0);
+    Cents revenue = system.getRevenueCents();
+
+    system.resetSystemForTest();
+    ReservationSystem recovered(console, console);
+    recovered.resetSystemForTest();
+    ASSERT_TRUE(recovered.openWriteAheadLog(walPath, WriteAheadLog::Options(), message)) << message;
+    EXPECT_EQ(message, "Recovered 101 record(s) from " + walPath + ".");
+    EXPECT_EQ(recovered.findAirplaneByFlightNumber("FL7")->getBookedSeatsCount(), 50);
+    EXPECT_EQ(recovered.getRevenueCents(), revenue);
+    EXPECT_EQ(recovered.findBookingForSeat("FL7", "9B")->getCustomerId(), "CUST0050");
+    EXPECT_EQ(recovered.addCustomerInternal("Next", 30, 10.0, false)->getPersonId(), "CUST0051");
+    recovered.resetSystemForTest();
+    std::remove(walPath.c_str());
+    std::remove(csvPath.c_str());
+}
+
+// Test that bookings spread over several workers keep each flight's rows in file order
+TEST_F(BulkImporterTest, BookingsOnManyWorkersKeepEachFlightInOrder) {
+    std::string airplanes = "flightNumber,rows,seatsPerRow\n";
+    for (int f = 0; f < 20; ++f) airplanes += "F" + std::to_string(f) + ",2,2\n";
+    import(airplanes, BulkImporter::Kind::AIRPLANES, BulkImporter::Format::CSV);
+    import("customerId,name,age,money\nA,First,30,100000\nB,Second,30,100000\n", BulkImporter::Kind::CUSTOMERS, BulkImporter::Format::CSV);
+    std::string bookings = "customerId,flightNumber,seatId\n";
+    for (int f = 0; f < 20; ++f) {
+        bookings += "A,F" + std::to_string(f) + ",1A\n";
+        bookings += "B,F" + std::to_string(f) + ",1A\n"; // Taken by A, whichever worker runs the flight
+    }
+
+    WorkStealingExecutor executor(4);
+    BulkImporter importer(system, BulkImporter::Options(), executor); // One batch for all the rows
+    std::istringstream in(bookings);
+    BulkImporter::Report report;
+    std::string message;
+    ASSERT_TRUE(importer.importStream(in, BulkImporter::Kind::BOOKINGS, BulkImporter::Format::CSV, report, message)) << message;
+    EXPECT_EQ(report.imported, 20u);
+    ASSERT_EQ(report.errors.size(), 20u);
+    for (std::size_t i = 0; i < 20; ++i) {
+        EXPECT_EQ(report.errors[i].line, 3 + 2 * i);
+        EXPECT_EQ(report.errors[i].message, "Seat is already booked.");
+        EXPECT_EQ(system.findBookingForSeat("F" + std::to_string(i), "1A")->getCustomerId(), "A");
+    }
+}
@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include "../src/CommandPipeline.h"
+#include <cstdio>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CommandPipelineTest : public ::testing::Test {
+protected:
+    std::stringstream test_in;
+    std::stringstream test_out;
+    ReservationSystem rs;
+
+    CommandPipelineTest() : rs(test_in, test_out) {}
+
+    void SetUp() override {
+        rs.resetSystemForTest();
+        rs.initializeSystem();
+    }
+
+    static Command book(const std::string& customerId, const std::string& flightNumber, const std::string& seatId) {
+        Command command;
+        command.type = Command::Type::BOOK;
+        command.customerId = customerId;
+        command.flightNumber = flightNumber;
+        command.seatId = seatId;
+        return command;
+    }
+};
+
+TEST_F(CommandPipelineTest, AppliesEachCommandType) {
+    CommandPipeline pipeline(rs);
+
+    Command addCustomer;
+    addCustomer.type = Command::Type::ADD_CUSTOMER;
+    addCustomer.name = "Piped Customer";
+    addCustomer.age = 40;
+    addCustomer.money = 900.0;
+    CommandResult added = pipeline.submit(addCustomer).get();
+    ASSERT_TRUE(added.success);
+    ASSERT_NE(added.customer, nullptr);
+    EXPECT_EQ(added.customer->getName(), "Piped Customer");
+
+    CommandResult first = pipeline.submit(book(added.customer->getPersonId(), "FL101", "3A")).get();
+    CommandResult second = pipeline.submit(book("CUST0001", "FL101", "3B")).get();
+    ASSERT_TRUE(first.success) << first.message;
+    ASSERT_TRUE(second.success) << second.message;
+    EXPECT_EQ(first.message, "Booking successful.");
+
+    CommandResult taken = pipeline.submit(book("CUST0002", "FL101", "3A")).get();
+    EXPECT_FALSE(taken.success);
+    EXPECT_EQ(taken.message, "Seat is already booked.");
+
+    Command swap;
+    swap.type = Command::Type::SWAP;
+    swap.bookingId = first.booking->getBookingId();
+    swap.bookingId2 = second.booking->getBookingId();
+    EXPECT_TRUE(pipeline.submit(swap).get().success);
+    EXPECT_EQ(first.booking->getSeatId(), "3B");
+
+    Command cancel;
+    cancel.type = Command::Type::CANCEL;
+    cancel.bookingId = first.booking->getBookingId();
+    EXPECT_TRUE(pipeline.submit(cancel).get().success);
+    EXPECT_FALSE(pipeline.submit(cancel).get().success); // Already cancelled
+    EXPECT_EQ(first.booking->getStatus(), BookingStatus::CANCELLED);
+}
+
+TEST_F(CommandPipelineTest, ConcurrentSubmittersGetOneWinnerPerSeat) {
+    const int threadCount = 4;
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL202");
+    std::vector<std::string> customerIds;
+    for (int t = 0; t < threadCount; ++t) {
+        customerIds.push_back(rs.addCustomerInternal("Racer", 30, 1e9, false)->getPersonId());
+    }
+
+    std::vector<int> wins(threadCount, 0);
+    {
+        CommandPipeline pipeline(rs, 16); // Small ring: submitters wait for space
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                std::vector<std::future<CommandResult>> pending;
+                for (int i = 0; i < plane->getCapacity(); ++i) {
+                    pending.push_back(pipeline.submit(book(customerIds[t], "FL202", plane->getSeatId(i))));
+                }
+                for (auto& result : pending) {
+                    wins[t] += result.get().success;
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(pipeline.getAppliedCount(), static_cast<std::uint64_t>(threadCount * plane->getCapacity()));
+        EXPECT_LE(pipeline.getBatchCount(), pipeline.getAppliedCount());
+    }
+
+    int total = 0;
+    for (int count : wins) total += count;
+    EXPECT_EQ(total, plane->getCapacity());
+    EXPECT_TRUE(plane->isFull());
+}
+
+TEST_F(CommandPipelineTest, ShutdownAppliesEverythingSubmitted) {
+    std::vector<std::future<CommandResult>> pending;
+    {
+        CommandPipeline pipeline(rs);
+        for (int row = 1; row <= 10; ++row) {
+            pending.push_back(pipeline.submit(book("CUST0001", "FL202", std::to_string(row) + "D")));
+        }
+    } // Destructor drains the ring before stopping the writer
+    for (auto& result : pending) {
+        EXPECT_TRUE(result.get().success);
+    }
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL202")->getBookedSeatsCount(), 10);
+}
+
+TEST_F(CommandPipelineTest, BatchesShareOneLogWaitInGroupMode) {
+    std::string path = ::testing::TempDir() + "command_pipeline_test.wal";
+    std::remove(path.c_str());
+    Customer* rich = rs.addCustomerInternal("Rich Traveller", 40, 1e7, false);
+    ASSERT_NE(rich, nullptr);
+    const std::string richId = rich->getPersonId();
+    std::string message;
+    ASSERT_NE(rs.addAirplaneInternal("FL900", 30, 6, message), nullptr) << message;
+    ASSERT_TRUE(rs.openWriteAheadLog(path, WriteAheadLog::Options(), message)) << message; // Group commit by default
+    std::vector<std::future<CommandResult>> pending;
+    {
+        CommandPipeline pipeline(rs);
+        for (int row = 1; row <= 30; ++row) {
+            for (char letter : {'A', 'B', 'C', 'D', 'E', 'F'}) {
+                pending.push_back(pipeline.submit(book(richId, "FL900", std::to_string(row) + letter)));
+            }
+        }
+        pending.push_back(pipeline.submit(book("CUST0002", "FL900", "1A"))); // Taken: logs nothing
+        for (std::size_t i = 0; i + 1 < pending.size(); ++i) {
+            CommandResult result = pending[i].get();
+            EXPECT_TRUE(result.success) << result.message;
+            EXPECT_NE(result.booking, nullptr);
+        }
+        EXPECT_FALSE(pending.back().get().success);
+        // A future completes only once its record is durable, and the writer waited once per batch
+        WriteAheadLog::Stats stats = rs.getWriteAheadLog()->getStats();
+        EXPECT_EQ(stats.records, 180u);
+        EXPECT_LE(stats.syncs, pipeline.getBatchCount());
+        EXPECT_LT(pipeline.getBatchCount(), 180u);
+    }
+    rs.resetSystemForTest(); // Closes the log
+    std::remove(path.c_str());
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "../src/CopyOnWriteCapture.h"
+#include <atomic>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+// Test that writes ahead of the scan are hidden by their copies and writes behind it are not copied
+TEST(CopyOnWriteCaptureTest, ScanSeesEverySlotAsItWasAtBegin) {
+    std::vector<int> table = {10, 20, 30, 40, 50};
+    CopyOnWriteCapture<int> capture;
+    auto read = [&table](std::uint32_t slot) { return table[slot]; };
+    std::vector<int> seen;
+    auto visit = [&seen](std::uint32_t, const int& value) { seen.push_back(value); };
+
+    capture.preserve(1, [&]() { return read(1); }); // No capture yet: nothing is copied
+    capture.begin(4);                               // Slot 4 is outside it
+    EXPECT_TRUE(capture.active());
+    EXPECT_EQ(capture.slotCount(), 4u);
+
+    int reads = 0;
+    capture.preserve(2, [&]() { ++reads; return read(2); });
+    table[2] = 31;
+    capture.preserve(2, [&]() { ++reads; return read(2); }); // Already copied
+    table[2] = 32;
+    EXPECT_EQ(reads, 1);
+
+    EXPECT_TRUE(capture.scan(2, read, visit));
+    capture.preserve(0, [&]() { ++reads; return read(0); }); // Behind the cursor
+    table[0] = 11;
+    capture.preserve(4, [&]() { ++reads; return read(4); }); // Beyond the slots covered
+    table[4] = 51;
+    capture.preserve(3, [&]() { return read(3); });
+    table[3] = 41;
+    EXPECT_EQ(reads, 1);
+    EXPECT_FALSE(capture.scan(10, read, visit));
+    capture.end();
+    EXPECT_FALSE(capture.active());
+
+    EXPECT_EQ(seen, (std::vector<int>{10, 20, 30, 40}));
+}
+
+// Test that a capture taken while writers move units between slots always adds up to the total
+TEST(CopyOnWriteCaptureTest, ConcurrentTransfersNeverShowInAScan) {
+    constexpr std::uint32_t kSlots = 512;
+    constexpr long kPerSlot = 100;
+    std::vector<std::atomic<long>> table(kSlots);
+    for (std::atomic<long>& value : table) {
+        value = kPerSlot;
+    }
+    CopyOnWriteCapture<long> capture;
+    std::shared_mutex cut; // Writers share it; begin() takes it alone
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 3; ++t) {
+        writers.emplace_back([&, t]() {
+            std::mt19937 random(static_cast<unsigned>(t));
+            std::uniform_int_distribution<std::uint32_t> pick(0, kSlots - 1);
+            while (!stop.load()) {
+                std::uint32_t from = pick(random), to = pick(random);
+                std::shared_lock<std::shared_mutex> lock(cut);
+                capture.preserve(from, [&]() { return table[from].load(); });
+                capture.preserve(to, [&]() { return table[to].load(); });
+                table[from] -= 1;
+                table[to] += 1;
+            }
+        });
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        {
+            std::unique_lock<std::shared_mutex> lock(cut);
+            capture.begin(kSlots);
+        }
+        long total = 0;
+        while (capture.scan(16, [&](std::uint32_t slot) { return table[slot].load(); },
+                            [&total](std::uint32_t, const long& value) { total += value; })) {
+            std::this_thread::yield();
+        }
+        capture.end();
+        EXPECT_EQ(total, kPerSlot * kSlots) << round;
+    }
+    stop = true;
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+}
@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 #include "../src/Customer.h" // Adjust path to Customer.h
 #include <limits> // For std::numeric_limits for double comparison
+#include <atomic>
+#include <thread>
+#include <vector>
 
 // Test fixture for Customer tests
 class CustomerTest : public ::testing::Test {
@@ -91,6 +94,45 @@ TEST_F(CustomerTest, AddMoneyNegativeAmount) {
     EXPECT_DOUBLE_EQ(c1->getMoney(), 800.0);
 }
 
+// Balances are whole cents: repeated charges and refunds do not drift
+TEST_F(CustomerTest, BalanceInCentsDoesNotDrift) {
+    EXPECT_EQ(c1->getBalanceCents(), 80000);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(c1->chargeMoney(0.10));
+    }
+    EXPECT_EQ(c1->getBalanceCents(), 70000);
+    for (int i = 0; i < 1000; ++i) {
+        c1->addMoney(0.10);
+    }
+    EXPECT_EQ(c1->getBalanceCents(), 80000);
+    EXPECT_DOUBLE_EQ(c1->getMoney(), 800.0);
+
+    EXPECT_FALSE(c1->tryDebitCents(80001));
+    EXPECT_FALSE(c1->tryDebitCents(0));
+    EXPECT_TRUE(c1->tryDebitCents(80000));
+    EXPECT_EQ(c1->getBalanceCents(), 0);
+    c1->creditCents(-5); // Ignored
+    EXPECT_EQ(c1->getBalanceCents(), 0);
+}
+
+// Concurrent debits never overdraw: exactly balance / amount of them succeed
+TEST_F(CustomerTest, ConcurrentDebitsNeverOverdraw) {
+    std::atomic<int> successes{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 10000; ++i) {
+                successes += c1->tryDebitCents(7);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(successes.load(), 80000 / 7);
+    EXPECT_EQ(c1->getBalanceCents(), 80000 % 7);
+}
+
 // Test displayDetails - This is harder to test directly with gtest for console output.
 // Typically, you'd refactor displayDetails to return a string or use output redirection.
 // For now, we'll assume it works if other parts work, or manually verify.
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "../src/EpochDomain.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<int> deletedCount{0};
+
+struct Tracked {
+    int value;
+    explicit Tracked(int v) : value(v) {}
+    ~Tracked() { deletedCount.fetch_add(1); }
+};
+
+} // namespace
+
+// Retired objects wait for pinned readers, then go on the next reclaim pass
+TEST(EpochDomainTest, RetiredObjectOutlivesPinnedReader) {
+    EpochDomain domain;
+    deletedCount = 0;
+    {
+        EpochDomain::Guard reader(domain);
+        domain.retire(new Tracked(1));
+        domain.reclaim();
+        EXPECT_EQ(deletedCount.load(), 0);
+        EXPECT_EQ(domain.pendingCount(), 1u);
+    }
+    domain.reclaim();
+    EXPECT_EQ(deletedCount.load(), 1);
+    EXPECT_EQ(domain.pendingCount(), 0u);
+}
+
+// Guards nest; a reader that pins after the retire cannot hold the old object
+TEST(EpochDomainTest, NestedGuardsAndLaterReaders) {
+    EpochDomain domain;
+    deletedCount = 0;
+    {
+        EpochDomain::Guard outer(domain);
+        {
+            EpochDomain::Guard inner(domain);
+        }
+        domain.retire(new Tracked(2));
+        domain.reclaim();
+        EXPECT_EQ(deletedCount.load(), 0); // Still pinned by outer
+    }
+
+    domain.retire(new Tracked(3));
+    std::thread laterReader([&domain]() {
+        EpochDomain::Guard guard(domain); // Pins an epoch newer than both retirements
+        domain.reclaim();
+    });
+    laterReader.join();
+    EXPECT_EQ(deletedCount.load(), 2);
+}
+
+// Readers keep loading and using the published object while writers replace it
+TEST(EpochDomainTest, ConcurrentPublishAndRead) {
+    EpochDomain domain;
+    deletedCount = 0;
+    std::atomic<Tracked*> published{new Tracked(0)};
+    std::atomic<bool> stop{false};
+    std::atomic<long> badReads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                EpochDomain::Guard guard(domain);
+                Tracked* current = published.load(std::memory_order_seq_cst);
+                if (current->value < 0) badReads.fetch_add(1);
+            }
+        });
+    }
+    const int versions = 5000;
+    for (int v = 1; v <= versions; ++v) {
+        Tracked* previous = published.exchange(new Tracked(v), std::memory_order_seq_cst);
+        domain.retire(previous);
+    }
+    stop.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    domain.reclaim();
+    EXPECT_EQ(badReads.load(), 0);
+    EXPECT_EQ(deletedCount.load(), versions); // Every retired version was eventually freed
+    delete published.load();
+}
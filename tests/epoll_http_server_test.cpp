@@ -0,0 +1,356 @@
+#ifdef __linux__
+
+#include "gtest/gtest.h"
+#include "../src/ApiRoutes.h"
+#include "../src/ApiServerSetup.h"
+#include "../src/EpollHttpServer.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Blocking client socket to 127.0.0.1:port; -1 on failure
+int connectTo(int port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Reads until the peer closes or `expected` occurrences of "HTTP/1.1 " have fully arrived
+std::string readResponses(int fd, int expected) {
+    std::string received;
+    char buffer[4096];
+    for (;;) {
+        int complete = 0;
+        for (std::size_t at = received.find("HTTP/1.1 "); at != std::string::npos; at = received.find("HTTP/1.1 ", at + 1)) {
+            std::size_t headerEnd = received.find("\r\n\r\n", at);
+            std::size_t lengthAt = received.find("Content-Length: ", at);
+            if (headerEnd == std::string::npos || lengthAt == std::string::npos || lengthAt > headerEnd) break;
+            if (received.size() >= headerEnd + 4 + std::stoul(received.substr(lengthAt + 16))) ++complete;
+        }
+        if (complete >= expected) return received;
+        ssize_t count = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (count <= 0) return received;
+        received.append(buffer, static_cast<std::size_t>(count));
+    }
+}
+
+} // namespace
+
+class EpollHttpServerTest : public ::testing::Test {
+protected:
+    EpollHttpServer server{2};
+    std::thread serverThread;
+    int port = -1;
+
+    void start() {
+        port = server.bindToPort("127.0.0.1", 0);
+        ASSERT_GT(port, 0);
+        serverThread = std::thread([this]() { server.listenAfterBind(); });
+        while (!server.isRunning()) {
+            std::this_thread::yield();
+        }
+    }
+
+    void TearDown() override {
+        server.stop();
+        if (serverThread.joinable()) serverThread.join();
+    }
+};
+
+TEST_F(EpollHttpServerTest, RoutesLikeHttplibOverOneKeepAliveConnection) {
+    server.Get(R"(/items/(\w+))", [](const httplib::Request& req, httplib::Response& res) {
+        res.set_content("item " + std::string(req.matches[1]) + " " + req.get_param_value("q"), "text/plain");
+    });
+    server.Post("/echo", [](const httplib::Request& req, httplib::Response& res) {
+        res.status = 201;
+        res.set_content(req.body, "application/json");
+    });
+    server.Get("/boom", [](const httplib::Request&, httplib::Response&) { throw std::runtime_error("handler failed"); });
+    start();
+
+    httplib::Client client("127.0.0.1", port);
+    client.set_keep_alive(true);
+    auto item = client.Get("/items/42?q=a%20b");
+    ASSERT_TRUE(item);
+    EXPECT_EQ(item->status, 200);
+    EXPECT_EQ(item->body, "item 42 a b");
+    EXPECT_EQ(item->get_header_value("Content-Type"), "text/plain");
+
+    auto echo = client.Post("/echo", R"({"x":1})", "application/json");
+    ASSERT_TRUE(echo);
+    EXPECT_EQ(echo->status, 201);
+    EXPECT_EQ(echo->body, R"({"x":1})");
+
+    auto missing = client.Get("/items/a/b");
+    ASSERT_TRUE(missing);
+    EXPECT_EQ(missing->status, 404);
+    auto failed = client.Get("/boom");
+    ASSERT_TRUE(failed);
+    EXPECT_EQ(failed->status, 500);
+    EXPECT_EQ(server.getConnectionCount(), 1u); // Every request reused the one connection
+}
+
+TEST_F(EpollHttpServerTest, PipelinedRequestsAndProtocolErrors) {
+    server.Get("/ping", [](const httplib::Request&, httplib::Response& res) { res.set_content("pong", "text/plain"); });
+    start();
+
+    int fd = connectTo(port);
+    ASSERT_GE(fd, 0);
+    std::string twoRequests = "GET /ping HTTP/1.1\r\nHost: x\r\n\r\nGET /ping HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n";
+    ASSERT_EQ(::send(fd, twoRequests.data(), twoRequests.size(), 0), static_cast<ssize_t>(twoRequests.size()));
+    std::string responses = readResponses(fd, 3); // Only two come: the server closes after the second
+    ::close(fd);
+    EXPECT_EQ(responses.find("HTTP/1.1 200 OK"), 0u);
+    std::size_t second = responses.find("HTTP/1.1 200 OK", 1);
+    ASSERT_NE(second, std::string::npos);
+    EXPECT_NE(responses.find("Connection: close", second), std::string::npos);
+    EXPECT_EQ(responses.substr(responses.size() - 4), "pong");
+
+    fd = connectTo(port);
+    std::string garbage = "NONSENSE\r\n\r\n";
+    ::send(fd, garbage.data(), garbage.size(), 0);
+    EXPECT_EQ(readResponses(fd, 2).find("HTTP/1.1 400 Bad Request"), 0u);
+    ::close(fd);
+
+    fd = connectTo(port);
+    std::string hugeHeader = "GET /ping HTTP/1.1\r\nX-Filler: " + std::string(EpollHttpServer::MAX_HEADER_BYTES, 'x') + "\r\n\r\n";
+    ::send(fd, hugeHeader.data(), hugeHeader.size(), 0);
+    EXPECT_EQ(readResponses(fd, 2).find("HTTP/1.1 431"), 0u);
+    ::close(fd);
+}
+
+TEST_F(EpollHttpServerTest, IdleKeepAliveConnectionsDoNotStarveRequests) {
+    std::stringstream in, out;
+    ReservationSystem rs(in, out);
+    rs.resetSystemForTest();
+    rs.initializeSystem();
+    auto execute = [&rs](Command command) { return CommandPipeline::apply(rs, command); };
+    registerApiRoutes(server, rs, execute);
+    start();
+
+    // Far more idle connections than httplib's thread pool has threads
+    const int idleCount = 2000;
+    std::vector<int> idle;
+    for (int i = 0; i < idleCount; ++i) {
+        int fd = connectTo(port);
+        ASSERT_GE(fd, 0);
+        idle.push_back(fd);
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (server.getConnectionCount() < static_cast<std::size_t>(idleCount) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(server.getConnectionCount(), static_cast<std::size_t>(idleCount));
+
+    httplib::Client client("127.0.0.1", port);
+    auto seatMap = client.Get("/api/airplanes/FL101");
+    ASSERT_TRUE(seatMap);
+    EXPECT_EQ(seatMap->status, 200);
+    EXPECT_NE(seatMap->body.find("\"flightNumber\":\"FL101\""), std::string::npos);
+    auto booked = client.Post("/api/bookings", R"({"customerId":"CUST0001","flightNumber":"FL101","seatId":"2B"})", "application/json");
+    ASSERT_TRUE(booked);
+    EXPECT_EQ(booked->status, 201);
+    auto again = client.Post("/api/bookings", R"({"customerId":"CUST0002","flightNumber":"FL101","seatId":"2B"})", "application/json");
+    ASSERT_TRUE(again);
+    EXPECT_EQ(again->status, 409);
+
+    // The idle connections are still served
+    std::string request = "GET /api/airplanes HTTP/1.1\r\nHost: x\r\n\r\n";
+    for (int i = 0; i < idleCount; i += 250) {
+        ::send(idle[i], request.data(), request.size(), 0);
+        EXPECT_EQ(readResponses(idle[i], 1).find("HTTP/1.1 200 OK"), 0u);
+    }
+    for (int fd : idle) {
+        ::close(fd);
+    }
+    server.stop();
+    serverThread.join(); // Before rs goes out of scope
+}
+
+// Test that the list endpoints stream in chunks and match the DOM-built lists on both backends
+TEST_F(EpollHttpServerTest, ListsStreamInChunksOnBothBackends) {
+    std::stringstream in, out;
+    ReservationSystem rs(in, out);
+    rs.resetSystemForTest();
+    std::string message;
+    ASSERT_TRUE(rs.addAirplaneInternal("FL9", 30, 6, message)) << message;
+    for (int i = 0; i < 1000; ++i) {
+        Customer* customer = rs.addCustomerInternal("Customer \"" + std::to_string(i) + "\"", 20 + i % 50, 1000.5, false);
+        ASSERT_NE(customer, nullptr);
+        if (i < 180) {
+            ASSERT_NE(rs.createBookingInternal(customer->getPersonId(), "FL9", std::to_string(i / 6 + 1) + static_cast<char>('A' + i % 6), message),
+                      nullptr) << message;
+        }
+    }
+    json customers = json::array();
+    rs.forEachCustomer([&customers](const Customer& customer) { customers.push_back(customer); });
+    json bookings = json::array();
+    rs.forEachBooking([&bookings](const Booking& booking) { bookings.push_back(booking); });
+
+    auto execute = [&rs](Command command) { return CommandPipeline::apply(rs, command); };
+    registerApiRoutes(server, rs, execute);
+    start();
+    httplib::Server httplibServer;
+    registerApiRoutes(httplibServer, rs, execute);
+    int httplibPort = httplibServer.bind_to_any_port("127.0.0.1");
+    std::thread httplibThread([&httplibServer]() { httplibServer.listen_after_bind(); });
+    httplibServer.wait_until_ready();
+
+    for (int backendPort : {port, httplibPort}) {
+        httplib::Client client("127.0.0.1", backendPort);
+        client.set_keep_alive(true);
+        for (int round = 0; round < 2; ++round) { // The connection is reused after each streamed body
+            auto customerList = client.Get("/api/customers");
+            ASSERT_TRUE(customerList);
+            EXPECT_EQ(customerList->get_header_value("Transfer-Encoding"), "chunked");
+            EXPECT_FALSE(customerList->has_header("Content-Length"));
+            EXPECT_EQ(json::parse(customerList->body), customers);
+            auto bookingList = client.Get("/api/bookings");
+            ASSERT_TRUE(bookingList);
+            EXPECT_EQ(json::parse(bookingList->body), bookings);
+        }
+    }
+    httplibServer.stop();
+    httplibThread.join();
+
+    // An HTTP/1.0 client, which cannot take chunks, reads the body up to the close
+    int fd = connectTo(port);
+    ASSERT_GE(fd, 0);
+    std::string request = "GET /api/bookings HTTP/1.0\r\n\r\n";
+    ::send(fd, request.data(), request.size(), 0);
+    std::string response = readResponses(fd, 1);
+    ::close(fd);
+    std::size_t bodyBegin = response.find("\r\n\r\n");
+    ASSERT_NE(bodyBegin, std::string::npos);
+    EXPECT_NE(response.find("Connection: close"), std::string::npos);
+    EXPECT_EQ(json::parse(response.substr(bodyBegin + 4)), bookings);
+    server.stop();
+    serverThread.join(); // Before rs goes out of scope
+}
+
+// Test that the admin and stats routes both mains share are served on the epoll backend's task queue
+TEST_F(EpollHttpServerTest, SharedAdminRoutesOnAnAdaptiveTaskQueue) {
+    std::stringstream in, out;
+    ReservationSystem rs(in, out);
+    rs.resetSystemForTest();
+    ServerConfig config;
+    config.pool.minWorkers = 2;
+    config.pool.maxWorkers = 4;
+    AdaptiveTaskQueue* taskQueue = nullptr;
+    useAdaptiveTaskQueue(server, config, taskQueue);
+    auto execute = [&rs](Command command) { return CommandPipeline::apply(rs, command); };
+    registerApiRoutes(server, rs, execute);
+    registerAdminRoutes(server, rs, config, taskQueue);
+    start();
+    ASSERT_NE(taskQueue, nullptr);
+
+    httplib::Client client("127.0.0.1", port);
+    auto imported = client.Post("/api/admin/import?kind=airplanes&format=csv", "flightNumber,rows,seatsPerRow\nFL7,10,4\nFL7,10,4\n", "text/csv");
+    ASSERT_TRUE(imported);
+    EXPECT_EQ(imported->status, 200);
+    json report = json::parse(imported->body);
+    EXPECT_EQ(report["imported"], 1);
+    EXPECT_EQ(report["failed"], 1);
+    EXPECT_EQ(report["errors"][0]["line"], 3);
+    auto seatMap = client.Get("/api/airplanes/FL7");
+    ASSERT_TRUE(seatMap);
+    EXPECT_EQ(seatMap->status, 200);
+
+    auto snapshot = client.Post("/api/admin/snapshot", "", "application/json");
+    ASSERT_TRUE(snapshot);
+    EXPECT_EQ(snapshot->status, 404); // No snapshot_path
+    auto stats = client.Get("/api/server/stats");
+    ASSERT_TRUE(stats);
+    json j = json::parse(stats->body);
+    EXPECT_EQ(j["maxWorkers"], 4);
+    EXPECT_GE(j["accepted"].get<std::uint64_t>(), 3u);
+    server.stop();
+    serverThread.join(); // Before rs goes out of scope
+}
+
+// Test that a blocked handler or content provider holds up only its own connection, not the others on its loop
+TEST(EpollHttpServerWorkersTest, BlockingHandlerDoesNotStallItsLoop) {
+    EpollHttpServer oneLoop(1);
+    oneLoop.new_task_queue = [] { return new httplib::ThreadPool(3); };
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<bool> blocked{false};
+    oneLoop.Get("/slow", [&](const httplib::Request&, httplib::Response& res) {
+        blocked = true;
+        released.wait();
+        res.set_content("done", "text/plain");
+    });
+    std::atomic<bool> providerBlocked{false};
+    oneLoop.Get("/list", [&](const httplib::Request&, httplib::Response& res) {
+        res.set_chunked_content_provider("application/json", [&](std::size_t offset, httplib::DataSink& sink) {
+            if (offset == 0) return sink.write("[1", 2);
+            providerBlocked = true;
+            released.wait(); // As a page waiting for a lock held by an import or a checkpoint cut
+            sink.write(",2]", 3);
+            sink.done();
+            return true;
+        });
+    });
+    oneLoop.Get("/ping", [](const httplib::Request&, httplib::Response& res) { res.set_content("pong", "text/plain"); });
+    oneLoop.set_pre_routing_handler([](const httplib::Request& req, httplib::Response& res) {
+        if (req.path != "/shed") return httplib::Server::HandlerResponse::Unhandled;
+        res.status = 503;
+        return httplib::Server::HandlerResponse::Handled;
+    });
+    int port = oneLoop.bindToPort("127.0.0.1", 0);
+    ASSERT_GT(port, 0);
+    std::thread loopThread([&oneLoop]() { oneLoop.listenAfterBind(); });
+    while (!oneLoop.isRunning()) {
+        std::this_thread::yield();
+    }
+
+    int slow = connectTo(port);
+    ASSERT_GE(slow, 0);
+    std::string request = "GET /slow HTTP/1.1\r\nHost: x\r\n\r\nGET /ping HTTP/1.1\r\nHost: x\r\n\r\n";
+    ::send(slow, request.data(), request.size(), 0);
+    int list = connectTo(port);
+    ASSERT_GE(list, 0);
+    std::string listRequest = "GET /list HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n";
+    ::send(list, listRequest.data(), listRequest.size(), 0);
+    while (!blocked || !providerBlocked) {
+        std::this_thread::yield();
+    }
+    httplib::Client client("127.0.0.1", port);
+    auto ping = client.Get("/ping");
+    ASSERT_TRUE(ping);
+    EXPECT_EQ(ping->body, "pong");
+    auto shed = client.Get("/shed");
+    ASSERT_TRUE(shed);
+    EXPECT_EQ(shed->status, 503);
+
+    release.set_value();
+    std::string responses = readResponses(slow, 2);
+    ::close(slow);
+    std::size_t done = responses.find("done");
+    ASSERT_NE(done, std::string::npos);
+    EXPECT_NE(responses.find("pong", done), std::string::npos); // The pipelined request is answered after it
+    std::string listResponse = readResponses(list, 2); // Read to the close
+    ::close(list);
+    EXPECT_NE(listResponse.find("2\r\n[1\r\n3\r\n,2]\r\n0\r\n\r\n"), std::string::npos);
+    oneLoop.stop();
+    loopThread.join();
+}
+
+#endif // __linux__
@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "../src/FlightSnapshot.h"
+#include <string>
+
+namespace {
+
+const std::string kCustomer = "CUST0001";
+
+FlightSnapshot::SeatOwner ownerFor(std::uint64_t bookingNumber) {
+    FlightSnapshot::SeatOwner owner;
+    owner.bookingNumber = bookingNumber;
+    owner.customerId = &kCustomer;
+    return owner;
+}
+
+} // namespace
+
+TEST(FlightSnapshotTest, BuildCopiesLiveFlight) {
+    Airplane plane("SN100", 20, 6); // 120 seats: two chunks
+    plane.bookSeatAt(0);
+    plane.bookSeatAt(70);
+    auto snapshot = FlightSnapshot::build(plane, [](int seatIndex) { return ownerFor(1000 + seatIndex); });
+
+    EXPECT_EQ(snapshot->version(), 1u);
+    EXPECT_EQ(snapshot->getFlightNumber(), "SN100");
+    EXPECT_EQ(snapshot->getCapacity(), 120);
+    EXPECT_EQ(snapshot->getBookedSeatsCount(), 2);
+    EXPECT_TRUE(snapshot->isSeatBooked(70));
+    EXPECT_FALSE(snapshot->isSeatBooked(71));
+    EXPECT_EQ(snapshot->getSeatOwner(70).bookingNumber, 1070u);
+    EXPECT_EQ(snapshot->getSeatOwner(1).bookingNumber, 0u);
+    EXPECT_EQ(snapshot->getSeatClass(0), SeatClass::BUSINESS);
+    EXPECT_DOUBLE_EQ(snapshot->getSeatPrice(0), plane.getSeatPrice(0));
+    EXPECT_EQ(SeatCodec::toSeatId(snapshot->getSeatKey(70)), "12E");
+}
+
+TEST(FlightSnapshotTest, WithSeatsCopiesOnlyTouchedChunks) {
+    Airplane plane("SN200", 20, 6);
+    auto first = FlightSnapshot::build(plane, [](int) { return FlightSnapshot::SeatOwner(); });
+    FlightSnapshot::SeatUpdate updates[] = {{3, true, ownerFor(7)}, {5, true, ownerFor(8)}};
+    auto second = first->withSeats(updates, 2);
+
+    EXPECT_EQ(second->version(), 2u);
+    EXPECT_EQ(second->getBookedSeatsCount(), 2);
+    EXPECT_EQ(second->getSeatOwner(5).bookingNumber, 8u);
+    EXPECT_FALSE(first->isSeatBooked(3)); // The old version is untouched
+    EXPECT_EQ(first->getBookedSeatsCount(), 0);
+    EXPECT_NE(&first->getSeatOwner(3), &second->getSeatOwner(3));
+    EXPECT_EQ(&first->getSeatOwner(100), &second->getSeatOwner(100)); // Second chunk is shared
+
+    FlightSnapshot::SeatUpdate release[] = {{3, false, FlightSnapshot::SeatOwner()}};
+    auto third = second->withSeats(release, 1);
+    EXPECT_EQ(third->getBookedSeatsCount(), 1);
+    EXPECT_FALSE(third->isSeatBooked(3));
+    EXPECT_EQ(third->getSeatOwner(3).customerId, nullptr);
+}
+
+TEST(FlightSnapshotTest, WithPricesRereadsFares) {
+    Airplane plane("SN300", 5, 4);
+    auto first = FlightSnapshot::build(plane, [](int) { return FlightSnapshot::SeatOwner(); });
+    plane.setSeatPrice(6, 42.5);
+    auto second = first->withPrices(plane);
+    EXPECT_DOUBLE_EQ(second->getSeatPrice(6), 42.5);
+    EXPECT_DOUBLE_EQ(first->getSeatPrice(6), 50.0);
+    EXPECT_EQ(second->version(), 2u);
+}
@@ -0,0 +1,72 @@
+#include "gtest/gtest.h"
+#include "../src/JsonWriter.h"
+#include "../src/ApiJson.h"
+#include "../third_party/nlohmann_json.hpp"
+#include <cmath>
+#include <string>
+
+// Test commas, nesting and scalar formatting
+TEST(JsonWriterTest, WritesNestedStructures) {
+    std::string out;
+    JsonWriter writer(out);
+    writer.beginObject()
+          .key("name").value("FL101")
+          .key("count").value(3)
+          .key("price").value(50.0)
+          .key("ratio").value(0.1)
+          .key("ok").value(true)
+          .key("none").nullValue()
+          .key("list").beginArray().value(1).value(2).beginObject().endObject().beginArray().endArray().endArray()
+          .key("empty").beginObject().endObject()
+          .endObject();
+    EXPECT_EQ(out, "{\"name\":\"FL101\",\"count\":3,\"price\":50,\"ratio\":0.1,\"ok\":true,\"none\":null,"
+                   "\"list\":[1,2,{},[]],\"empty\":{}}");
+    EXPECT_NO_THROW(nlohmann::json::parse(out));
+}
+
+// Test string escaping and doubles that need full precision
+TEST(JsonWriterTest, EscapesAndPrecision) {
+    std::string out;
+    JsonWriter writer(out);
+    writer.beginArray()
+          .value("quote\" backslash\\ newline\n tab\t ctrl\x01")
+          .value(1.0 / 3.0)
+          .value(std::nan(""))
+          .endArray();
+    nlohmann::json parsed = nlohmann::json::parse(out);
+    EXPECT_EQ(parsed[0].get<std::string>(), "quote\" backslash\\ newline\n tab\t ctrl\x01");
+    EXPECT_EQ(parsed[1].get<double>(), 1.0 / 3.0);
+    EXPECT_TRUE(parsed[2].is_null());
+}
+
+// Test that the writer appends to existing buffer contents
+TEST(JsonWriterTest, AppendsToBuffer) {
+    std::string out = "data: ";
+    JsonWriter(out).beginArray().value(7).endArray();
+    EXPECT_EQ(out, "data: [7]");
+}
+
+// Test the seat map body matches the fields the GUI reads
+TEST(ApiJsonTest, SeatMapJson) {
+    Airplane plane("FL777", 2, 2);
+    plane.bookSpecificSeat("1B");
+    Booking booking("CUST0042", "FL777", "1B");
+    std::vector<const Booking*> seatBookings(plane.getCapacity(), nullptr);
+    seatBookings[plane.seatIndexOf("1B")] = &booking;
+
+    std::string out;
+    writeSeatMapJson(out, plane, seatBookings);
+    nlohmann::json parsed = nlohmann::json::parse(out);
+    EXPECT_EQ(parsed["flightNumber"], "FL777");
+    EXPECT_EQ(parsed["capacity"], 4);
+    EXPECT_EQ(parsed["bookedSeatsCount"], 1);
+    EXPECT_EQ(parsed["isFull"], false);
+    ASSERT_EQ(parsed["seats"].size(), 4u);
+    EXPECT_EQ(parsed["seats"][0]["seatId"], "1A");
+    EXPECT_FALSE(parsed["seats"][0].contains("bookingId"));
+    EXPECT_EQ(parsed["seats"][1]["isBooked"], true);
+    EXPECT_EQ(parsed["seats"][1]["seatClass"], "Business");
+    EXPECT_EQ(parsed["seats"][1]["price"], 200.0);
+    EXPECT_EQ(parsed["seats"][1]["bookedByCustomerId"], "CUST0042");
+    EXPECT_EQ(parsed["seats"][1]["bookingId"], booking.getBookingId());
+}
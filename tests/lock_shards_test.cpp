@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+#include "../src/LockShards.h"
+#include <thread>
+#include <vector>
+
+TEST(LockShardsTest, SlotsMapToShardsModuloCount) {
+    LockShards shards;
+    EXPECT_EQ(LockShards::shardOf(3), 3u);
+    EXPECT_EQ(LockShards::shardOf(LockShards::SHARD_COUNT + 3), 3u);
+    EXPECT_EQ(&shards.forSlot(3), &shards.forSlot(LockShards::SHARD_COUNT + 3));
+    EXPECT_NE(&shards.forSlot(3), &shards.forSlot(4));
+}
+
+TEST(LockShardsTest, GuardHoldsEachShardOnceAndReleasesAll) {
+    LockShards flights;
+    LockShards customers;
+    {
+        // Slots 1 and 65 share a shard; taking it twice would deadlock
+        ShardLockGuard guard(flights, {65, 1}, customers, {7});
+        EXPECT_FALSE(flights.forSlot(1).try_lock());
+        EXPECT_FALSE(customers.forSlot(7).try_lock());
+        EXPECT_TRUE(flights.forSlot(2).try_lock());
+        flights.forSlot(2).unlock();
+    }
+    EXPECT_TRUE(flights.forSlot(1).try_lock());
+    flights.forSlot(1).unlock();
+    EXPECT_TRUE(customers.forSlot(7).try_lock());
+    customers.forSlot(7).unlock();
+}
+
+TEST(LockShardsTest, OpposingSlotOrdersDoNotDeadlock) {
+    // Two threads name the same pair of flights in opposite orders, the classic lock-order deadlock
+    LockShards flights;
+    LockShards customers;
+    long counter = 0;
+    auto worker = [&](std::uint32_t first, std::uint32_t second) {
+        for (int i = 0; i < 20000; ++i) {
+            ShardLockGuard guard(flights, {first, second}, customers, {second, first});
+            ++counter;
+        }
+    };
+    std::thread a(worker, 5, 9);
+    std::thread b(worker, 9, 5);
+    a.join();
+    b.join();
+    EXPECT_EQ(counter, 40000);
+}
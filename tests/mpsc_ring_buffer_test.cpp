@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "../src/MpscRingBuffer.h"
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(MpscRingBufferTest, FifoAndFull) {
+    MpscRingBuffer<int> ring(4);
+    EXPECT_EQ(ring.capacity(), 4u);
+    EXPECT_FALSE(ring.hasPending());
+    for (int i = 0; i < 4; ++i) {
+        int value = i;
+        EXPECT_TRUE(ring.tryPush(std::move(value)));
+    }
+    int extra = 99;
+    EXPECT_FALSE(ring.tryPush(std::move(extra)));
+    EXPECT_TRUE(ring.hasPending());
+
+    std::vector<int> popped;
+    while (ring.tryPop([&popped](int& value) { popped.push_back(value); })) {
+    }
+    EXPECT_EQ(popped, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_FALSE(ring.hasPending());
+
+    // Cells are reusable on the next lap
+    int again = 7;
+    EXPECT_TRUE(ring.tryPush(std::move(again)));
+    EXPECT_TRUE(ring.tryPop([](int& value) { EXPECT_EQ(value, 7); }));
+
+    EXPECT_THROW(MpscRingBuffer<int>(6), std::invalid_argument);
+}
+
+TEST(MpscRingBufferTest, MovesAndDestroysValues) {
+    auto tracked = std::make_shared<int>(5);
+    {
+        MpscRingBuffer<std::shared_ptr<int>> ring(2);
+        std::shared_ptr<int> copy = tracked;
+        ASSERT_TRUE(ring.tryPush(std::move(copy)));
+        EXPECT_EQ(copy, nullptr); // Moved in
+        EXPECT_EQ(tracked.use_count(), 2);
+        std::shared_ptr<int> rejected = tracked;
+        copy = tracked;
+        ASSERT_TRUE(ring.tryPush(std::move(copy)));
+        EXPECT_FALSE(ring.tryPush(std::move(rejected)));
+        EXPECT_NE(rejected, nullptr); // Untouched when the ring is full
+    } // Unconsumed values are destroyed with the ring
+    EXPECT_EQ(tracked.use_count(), 1);
+}
+
+TEST(MpscRingBufferTest, ManyProducersLoseNothingAndKeepPerProducerOrder) {
+    const int producers = 4;
+    const int perProducer = 50000;
+    MpscRingBuffer<std::uint64_t> ring(64); // Small ring so producers hit the full case often
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                std::uint64_t value = (static_cast<std::uint64_t>(p) << 32) | static_cast<std::uint64_t>(i);
+                while (!ring.tryPush(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    while (received < producers * perProducer) {
+        if (!ring.tryPop([&](std::uint64_t& value) {
+                int producer = static_cast<int>(value >> 32);
+                int sequence = static_cast<int>(value & 0xFFFFFFFFu);
+                EXPECT_EQ(sequence, next[producer]);
+                next[producer] = sequence + 1;
+            })) {
+            std::this_thread::yield();
+            continue;
+        }
+        ++received;
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int count : next) {
+        EXPECT_EQ(count, perProducer);
+    }
+    EXPECT_FALSE(ring.hasPending());
+}
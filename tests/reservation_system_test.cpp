@@ -5,6 +5,15 @@
 #include "../src/Booking.h"
 #include <sstream> // For std::stringstream
 #include <string>
+#include <algorithm>
+#include <atomic>
+#include <cstdio> // For std::remove
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
 
 class ReservationSystemTest : public ::testing::Test {
 protected:
@@ -118,7 +127,7 @@ TEST_F(ReservationSystemTest, HandleBookSeatNoCustomers) {
     // Let's re-initialize and then clear customers
     rs.resetSystemForTest();
     rs.initializeSystem(); // Adds planes and customers
-    const_cast<std::vector<Customer>*>(&rs.getCustomersForTest())->clear(); // Hacky way to clear private member for test
+    const_cast<SlotMap<Customer>*>(&rs.getCustomersForTest())->clear(); // Hacky way to clear private member for test
 
     test_in.str("2\n0\n"); 
     rs.run();
@@ -329,12 +338,1408 @@ TEST_F(ReservationSystemTest, SwapSeatsInternal_DifferentFlights) {
     Customer* cust2 = rs.addCustomerInternal("UserB", 35, 600.0, false);
     std::string bookingError;
 
-    Booking* booking1 = rs.createBookingInternal(cust1->getPersonId(), "FL101", "7A", bookingError);
+    Booking* booking1 = rs.createBookingInternal(cust1->getPersonId(), "FL101", "7A", bookingError); // Economy, $50
     ASSERT_NE(booking1, nullptr);
-    Booking* booking2 = rs.createBookingInternal(cust2->getPersonId(), "FL202", "1A", bookingError);
+    Booking* booking2 = rs.createBookingInternal(cust2->getPersonId(), "FL202", "1A", bookingError); // Business, $200
     ASSERT_NE(booking2, nullptr);
+    Cents revenueBefore = rs.getRevenueCents();
 
     std::string errorMsg;
-    EXPECT_FALSE(rs.swapSeatsInternal(booking1->getBookingId(), booking2->getBookingId(), errorMsg));
-    EXPECT_NE(errorMsg.find("only supported for bookings on the same flight"), std::string::npos);
+    ASSERT_TRUE(rs.swapSeatsInternal(booking1->getBookingId(), booking2->getBookingId(), errorMsg)) << errorMsg;
+    EXPECT_NE(errorMsg.find("Fare differences settled"), std::string::npos);
+    EXPECT_EQ(booking1->getFlightNumber(), "FL202");
+    EXPECT_EQ(booking1->getSeatId(), "1A");
+    EXPECT_EQ(booking2->getFlightNumber(), "FL101");
+    EXPECT_EQ(booking2->getSeatId(), "7A");
+
+    // Each booking now pays its new seat's fare: the upgrade is charged, the downgrade refunded
+    EXPECT_EQ(booking1->getPaidCents(), 20000);
+    EXPECT_EQ(booking2->getPaidCents(), 5000);
+    EXPECT_EQ(cust1->getBalanceCents(), 30000);
+    EXPECT_EQ(cust2->getBalanceCents(), 55000);
+    EXPECT_EQ(rs.getRevenueCents(), revenueBefore);
+
+    // Occupancy is unchanged; the seat indexes and snapshots follow the bookings
+    EXPECT_TRUE(rs.findAirplaneByFlightNumber("FL101")->isSeatBooked(rs.findAirplaneByFlightNumber("FL101")->seatIndexOf("7A")));
+    EXPECT_EQ(rs.findBookingForSeat("FL202", "1A"), booking1);
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "7A"), booking2);
+    int seat1A = rs.findAirplaneByFlightNumber("FL202")->seatIndexOf("1A");
+    rs.readFlightSnapshot("FL202", [&](const FlightSnapshot& snapshot) {
+        EXPECT_EQ(snapshot.getSeatOwner(seat1A).bookingNumber, booking1->getBookingNumber());
+    });
+
+    // Cancelling afterwards frees the seat on the new flight and refunds the new fare
+    ASSERT_TRUE(rs.cancelBookingInternal(booking1->getBookingId(), errorMsg)) << errorMsg;
+    EXPECT_EQ(rs.findBookingForSeat("FL202", "1A"), nullptr);
+    EXPECT_FALSE(rs.findAirplaneByFlightNumber("FL202")->isSeatBooked(seat1A));
+    EXPECT_EQ(cust1->getBalanceCents(), 50000);
+}
+
+TEST_F(ReservationSystemTest, SwapSeatsInternal_UnaffordableUpgradeChangesNothing) {
+    Customer* cust1 = rs.addCustomerInternal("Short", 30, 60.0, false);
+    Customer* cust2 = rs.addCustomerInternal("Rich", 35, 600.0, false);
+    std::string error;
+    Booking* economy = rs.createBookingInternal(cust1->getPersonId(), "FL101", "9C", error);
+    Booking* business = rs.createBookingInternal(cust2->getPersonId(), "FL202", "2C", error);
+    ASSERT_NE(economy, nullptr);
+    ASSERT_NE(business, nullptr);
+
+    // The downgrade's refund is only paid once the upgrade has been charged, so nothing moves
+    EXPECT_FALSE(rs.swapSeatsInternal(business->getBookingId(), economy->getBookingId(), error));
+    EXPECT_NE(error.find("Insufficient funds"), std::string::npos);
+    EXPECT_EQ(cust1->getBalanceCents(), 1000);
+    EXPECT_EQ(cust2->getBalanceCents(), 40000);
+    EXPECT_EQ(economy->getFlightNumber(), "FL101");
+    EXPECT_EQ(business->getSeatId(), "2C");
+    EXPECT_EQ(economy->getPaidCents(), 5000);
+    EXPECT_EQ(rs.findBookingForSeat("FL202", "2C"), business);
+}
+
+TEST_F(ReservationSystemTest, FindersUseIndexesForNewEntities) {
+    // Enough customers to force the underlying vector to reallocate several times
+    for (int i = 0; i < 100; ++i) {
+        rs.addCustomerInternal("Indexed User", 20 + i % 50, 100.0, false);
+    }
+    Customer* last = rs.findCustomerById("CUST0102");
+    ASSERT_NE(last, nullptr);
+    EXPECT_EQ(last->getPersonId(), "CUST0102");
+    EXPECT_EQ(rs.findCustomerById("CUST0103"), nullptr);
+
+    test_in.str("7\n1\nFL303\n4\n4\n0\n"); // Admin, add airplane FL303 (4x4), exit
+    rs.run();
+    Airplane* added = rs.findAirplaneByFlightNumber("FL303");
+    ASSERT_NE(added, nullptr);
+    EXPECT_EQ(added->getCapacity(), 16);
+
+    rs.resetSystemForTest();
+    EXPECT_EQ(rs.findCustomerById("CUST0001"), nullptr);
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL101"), nullptr);
+}
+
+TEST_F(ReservationSystemTest, SeatBookingIndexTracksBookCancelAndSwap) {
+    std::string error;
+    std::string id1 = rs.createBookingInternal("CUST0001", "FL101", "8A", error)->getBookingId();
+    std::string id2 = rs.createBookingInternal("CUST0002", "FL101", "8B", error)->getBookingId();
+
+    Booking* onSeat = rs.findBookingForSeat("FL101", "8A");
+    ASSERT_NE(onSeat, nullptr);
+    EXPECT_EQ(onSeat->getBookingId(), id1);
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "8C"), nullptr);
+    EXPECT_EQ(rs.findBookingForSeat("FL999", "8A"), nullptr);
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "bogus"), nullptr);
+
+    // Seat map view is aligned with the airplane's seats
+    std::vector<const Booking*> seatMap = rs.getSeatBookings("FL101");
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL101");
+    ASSERT_NE(plane, nullptr);
+    ASSERT_EQ(seatMap.size(), plane->getAllSeats().size());
+    int index8A = plane->seatIndexOf("8A");
+    ASSERT_NE(seatMap[index8A], nullptr);
+    EXPECT_EQ(seatMap[index8A]->getCustomerId(), "CUST0001");
+    EXPECT_TRUE(rs.getSeatBookings("FL999").empty());
+
+    ASSERT_TRUE(rs.swapSeatsInternal(id1, id2, error)) << error;
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "8A")->getBookingId(), id2);
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "8B")->getBookingId(), id1);
+
+    ASSERT_TRUE(rs.cancelBookingInternal(id2, error)) << error;
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "8A"), nullptr);
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "8B")->getBookingId(), id1);
+
+    // A new booking on the freed seat replaces the cancelled one
+    std::string id3 = rs.createBookingInternal("CUST0002", "FL101", "8A", error)->getBookingId();
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "8A")->getBookingId(), id3);
+}
+
+TEST_F(ReservationSystemTest, SeatBookingIndexTracksConsoleBooking) {
+    test_in.str("2\nCUST0001\n2\n9C\ny\n0\n"); // Cust1, Flight 2 (FL202), Seat 9C
+    rs.run();
+    Booking* booking = rs.findBookingForSeat("FL202", "9C");
+    ASSERT_NE(booking, nullptr);
+    EXPECT_EQ(booking->getCustomerId(), "CUST0001");
+}
+
+TEST_F(ReservationSystemTest, CustomerBookingIndex) {
+    std::string error;
+    std::string id1 = rs.createBookingInternal("CUST0001", "FL101", "10A", error)->getBookingId();
+    rs.createBookingInternal("CUST0002", "FL101", "10B", error);
+    std::string id3 = rs.createBookingInternal("CUST0001", "FL202", "10C", error)->getBookingId();
+    ASSERT_TRUE(rs.cancelBookingInternal(id1, error)) << error;
+
+    std::vector<const Booking*> all = rs.getBookingsForCustomer("CUST0001");
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all[0]->getBookingId(), id1); // Oldest first
+    EXPECT_EQ(all[1]->getBookingId(), id3);
+
+    std::vector<const Booking*> confirmed = rs.getBookingsForCustomer("CUST0001", BookingStatus::CONFIRMED);
+    ASSERT_EQ(confirmed.size(), 1u);
+    EXPECT_EQ(confirmed[0]->getBookingId(), id3);
+    std::vector<const Booking*> cancelled = rs.getBookingsForCustomer("CUST0001", BookingStatus::CANCELLED);
+    ASSERT_EQ(cancelled.size(), 1u);
+    EXPECT_EQ(cancelled[0]->getBookingId(), id1);
+
+    EXPECT_EQ(rs.getBookingsForCustomer("CUST0002").size(), 1u);
+    EXPECT_TRUE(rs.getBookingsForCustomer("CUST9999").empty());
+
+    // A brand-new customer starts with no bookings
+    Customer* fresh = rs.addCustomerInternal("Fresh", 40, 300.0, false);
+    EXPECT_TRUE(rs.getBookingsForCustomer(fresh->getPersonId()).empty());
+}
+
+TEST_F(ReservationSystemTest, HandleSearchCustomerListsActiveBookings) {
+    test_in.str("4\nCUST0002\n0\n");
+    rs.run();
+    EXPECT_NE(test_out.str().find("No active bookings found for this customer."), std::string::npos);
+
+    std::string error;
+    ASSERT_NE(rs.createBookingInternal("CUST0002", "FL101", "11A", error), nullptr) << error;
+    test_out.str("");
+    test_in.clear();
+    test_in.str("4\nCUST0002\n0\n");
+    rs.run();
+    EXPECT_NE(test_out.str().find("Bookings for Bob The Builder:"), std::string::npos);
+    EXPECT_EQ(test_out.str().find("No active bookings found"), std::string::npos);
+}
+
+TEST_F(ReservationSystemTest, EntityPointersAndHandlesStayValidAsStorageGrows) {
+    std::string error;
+    Booking* first = rs.createBookingInternal("CUST0001", "FL101", "12A", error);
+    ASSERT_NE(first, nullptr) << error;
+    BookingHandle firstHandle = rs.findBookingHandle(first->getBookingId());
+    ASSERT_FALSE(firstHandle.isNull());
+    Customer* alice = rs.findCustomerById("CUST0001");
+
+    // Plenty of customers and bookings; a vector would have reallocated many times
+    for (int i = 0; i < 200; ++i) {
+        rs.addCustomerInternal("Growth User", 30, 100.0, false);
+    }
+    for (int row = 13; row <= 20; ++row) {
+        ASSERT_NE(rs.createBookingInternal("CUST0002", "FL202", std::to_string(row) + "B", error), nullptr) << error;
+    }
+
+    EXPECT_EQ(rs.findCustomerById("CUST0001"), alice);
+    EXPECT_EQ(rs.getBooking(firstHandle), first);
+    EXPECT_EQ(first->getSeatId(), "12A");
+
+    ASSERT_TRUE(rs.cancelBookingInternal(first->getBookingId(), error)) << error;
+    EXPECT_EQ(rs.getBooking(firstHandle), first); // Cancelled bookings are kept, not erased
+
+    rs.resetSystemForTest();
+    EXPECT_EQ(rs.getBooking(firstHandle), nullptr); // Stale after reset instead of dangling
+}
+
+TEST_F(ReservationSystemTest, RapidBookingsGetDistinctIds) {
+    // Bookings made within the same second used to be able to share an ID
+    std::string error;
+    std::vector<std::string> ids;
+    for (int row = 5; row <= 14; ++row) {
+        for (char column : {'A', 'B'}) {
+            Booking* booking = rs.createBookingInternal("CUST0001", "FL202", std::to_string(row) + column, error);
+            ASSERT_NE(booking, nullptr) << error;
+            ids.push_back(booking->getBookingId());
+        }
+    }
+    for (size_t i = 0; i < ids.size(); ++i) {
+        Booking* found = rs.findBookingById(ids[i]);
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(found->getBookingId(), ids[i]);
+        if (i > 0) {
+            EXPECT_LT(ids[i - 1], ids[i]);
+        }
+    }
+}
+
+TEST_F(ReservationSystemTest, AddAirplaneInternal) {
+    std::string error;
+    Airplane* plane = rs.addAirplaneInternal("FL303", 10, 4, error);
+    ASSERT_NE(plane, nullptr) << error;
+    EXPECT_EQ(plane->getCapacity(), 40);
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL303"), plane);
+    EXPECT_NE(rs.createBookingInternal("CUST0001", "FL303", "1A", error), nullptr) << error;
+
+    EXPECT_EQ(rs.addAirplaneInternal("FL303", 5, 5, error), nullptr);
+    EXPECT_EQ(error, "Airplane with flight number FL303 already exists.");
+    EXPECT_EQ(rs.addAirplaneInternal("FL404", 0, 5, error), nullptr);
+    EXPECT_EQ(error, "Rows and seats per row must be positive.");
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL404"), nullptr);
+
+    // Seat IDs must stay encodable and seat indexes must fit an int
+    const std::string tooLarge = "At most 9999999 rows, 191 seats per row and 2147483647 seats in all.";
+    EXPECT_EQ(rs.addAirplaneInternal("FL404", 10, SeatCodec::MAX_COLUMN + 2, error), nullptr);
+    EXPECT_EQ(error, tooLarge);
+    EXPECT_EQ(rs.addAirplaneInternal("FL404", SeatCodec::MAX_ROW + 1, 1, error), nullptr);
+    EXPECT_EQ(error, tooLarge);
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL404"), nullptr);
+    Airplane* widest = rs.addAirplaneInternal("FL404", 1, SeatCodec::MAX_COLUMN + 1, error);
+    ASSERT_NE(widest, nullptr) << error;
+    EXPECT_EQ(widest->seatIndexOf(widest->getAllSeats().back().getSeatId()), SeatCodec::MAX_COLUMN);
+}
+
+TEST_F(ReservationSystemTest, PagedVisitorsResumeWhereThePreviousPageStopped) {
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_NE(rs.addCustomerInternal("Paged " + std::to_string(i), 30, 100.0, false), nullptr);
+    }
+    std::vector<std::string> all;
+    rs.forEachCustomer([&all](const Customer& customer) { all.push_back(customer.getPersonId()); });
+    std::vector<std::string> paged;
+    int pages = 0;
+    for (std::uint32_t from = 0; from != ReservationSystem::LIST_END; ++pages) {
+        from = rs.forEachCustomerFrom(from, 5, [&paged](const Customer& customer) { paged.push_back(customer.getPersonId()); });
+    }
+    EXPECT_EQ(paged, all);
+    EXPECT_EQ(pages, 3); // 12 customers in pages of 5
+    int bookings = 0;
+    EXPECT_EQ(rs.forEachBookingFrom(0, 5, [&bookings](const Booking&) { ++bookings; }), ReservationSystem::LIST_END);
+    EXPECT_EQ(bookings, 0);
+}
+
+TEST_F(ReservationSystemTest, VisitorsSeeEntitiesAndBookings) {
+    std::string error;
+    ASSERT_NE(rs.createBookingInternal("CUST0001", "FL101", "2B", error), nullptr) << error;
+
+    int flights = 0;
+    rs.forEachAirplane([&flights](const Airplane&) { ++flights; });
+    EXPECT_EQ(flights, 2);
+    int customerCount = 0;
+    rs.forEachCustomer([&customerCount](const Customer&) { ++customerCount; });
+    EXPECT_EQ(customerCount, 2);
+    int bookingCount = 0;
+    rs.forEachBooking([&bookingCount](const Booking&) { ++bookingCount; });
+    EXPECT_EQ(bookingCount, 1);
+
+    std::vector<const Booking*> seatBookings;
+    bool found = rs.visitFlight("FL101", seatBookings, [](const Airplane& plane, const std::vector<const Booking*>& bookings) {
+        ASSERT_EQ(bookings.size(), static_cast<size_t>(plane.getCapacity()));
+        EXPECT_NE(bookings[plane.seatIndexOf("2B")], nullptr);
+        EXPECT_EQ(bookings[plane.seatIndexOf("2A")], nullptr);
+    });
+    EXPECT_TRUE(found);
+    EXPECT_FALSE(rs.visitFlight("FL999", seatBookings, [](const Airplane&, const std::vector<const Booking*>&) {}));
+    EXPECT_TRUE(seatBookings.empty());
+
+    found = rs.visitCustomer("CUST0001", [](const Customer& customer, const std::vector<const Booking*>& bookings) {
+        EXPECT_EQ(customer.getPersonId(), "CUST0001");
+        ASSERT_EQ(bookings.size(), 1u);
+        EXPECT_EQ(bookings[0]->getSeatId(), "2B");
+    });
+    EXPECT_TRUE(found);
+    EXPECT_FALSE(rs.visitCustomer("CUST9999", [](const Customer&, const std::vector<const Booking*>&) {}));
+}
+
+TEST_F(ReservationSystemTest, ConcurrentBookingsOfSameSeatsHaveOneWinnerEach) {
+    // Every thread races for every seat of FL101; each seat must be sold exactly once
+    const int threadCount = 8;
+    std::vector<std::string> customerIds;
+    for (int t = 0; t < threadCount; ++t) {
+        customerIds.push_back(rs.addCustomerInternal("Racer", 30, 1000000.0, false)->getPersonId());
+    }
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL101");
+    std::vector<std::string> seatIds;
+    for (const Seat& seat : plane->getAllSeats()) {
+        seatIds.push_back(seat.getSeatId());
+    }
+
+    std::atomic<int> wins{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            std::string error;
+            for (size_t i = 0; i < seatIds.size(); ++i) {
+                // Threads walk the seats from different offsets to collide in different orders
+                const std::string& seatId = seatIds[(i + t * 7) % seatIds.size()];
+                if (rs.createBookingInternal(customerIds[t], "FL101", seatId, error)) {
+                    wins.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(wins.load(), plane->getCapacity());
+    EXPECT_EQ(plane->getBookedSeatsCount(), plane->getCapacity());
+    EXPECT_EQ(rs.getBookingsForTest().size(), static_cast<size_t>(plane->getCapacity()));
+    for (const std::string& seatId : seatIds) {
+        EXPECT_NE(rs.findBookingForSeat("FL101", seatId), nullptr) << seatId;
+    }
+
+    double spent = 0.0;
+    for (const std::string& customerId : customerIds) {
+        const Customer* customer = rs.findCustomerById(customerId);
+        double paid = 0.0;
+        for (const Booking* booking : rs.getBookingsForCustomer(customerId)) {
+            paid += plane->findSeat(booking->getSeatKey())->getPrice();
+        }
+        EXPECT_DOUBLE_EQ(customer->getMoney() + paid, 1000000.0);
+        spent += paid;
+    }
+    double fares = 0.0;
+    for (const Seat& seat : plane->getAllSeats()) {
+        fares += seat.getPrice();
+    }
+    EXPECT_DOUBLE_EQ(spent, fares);
+}
+
+TEST_F(ReservationSystemTest, ConcurrentBookAndCancelKeepsCountsConsistent) {
+    // Each thread books and cancels seats in its own rows while the other threads do the same
+    const int threadCount = 4;
+    std::vector<std::string> customerIds;
+    for (int t = 0; t < threadCount; ++t) {
+        customerIds.push_back(rs.addCustomerInternal("Churn", 30, 100000.0, false)->getPersonId());
+    }
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            std::string error;
+            for (int round = 0; round < 50; ++round) {
+                std::string seatId = std::to_string(t * 5 + round % 5 + 1) + "C";
+                Booking* booking = rs.createBookingInternal(customerIds[t], "FL202", seatId, error);
+                if (!booking) {
+                    failures.fetch_add(1);
+                    continue;
+                }
+                if (round % 2 == 0 && !rs.cancelBookingInternal(booking->getBookingId(), error)) {
+                    failures.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // Odd rounds keep their seat, so by the end every thread holds all five of its seats and
+    // later rounds on a held seat are refused
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL202");
+    int confirmed = 0;
+    for (const std::string& customerId : customerIds) {
+        confirmed += static_cast<int>(rs.getBookingsForCustomer(customerId, BookingStatus::CONFIRMED).size());
+    }
+    EXPECT_EQ(confirmed, threadCount * 5);
+    EXPECT_EQ(plane->getBookedSeatsCount(), confirmed);
+    int occupied = 0;
+    for (const Seat& seat : plane->getAllSeats()) {
+        if (seat.getIsBooked()) {
+            ++occupied;
+            EXPECT_NE(rs.findBookingForSeat("FL202", seat.getSeatId()), nullptr);
+        }
+    }
+    EXPECT_EQ(occupied, confirmed);
+    EXPECT_GT(failures.load(), 0);
+}
+
+TEST_F(ReservationSystemTest, CancelRefundsWhatTheBookingPaid) {
+    std::string error;
+    Customer* customer = rs.findCustomerById("CUST0001");
+    Cents before = customer->getBalanceCents();
+    Booking* booking = rs.createBookingInternal("CUST0001", "FL101", "2D", error);
+    ASSERT_NE(booking, nullptr);
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL101");
+    Cents paid = toCents(plane->getSeatPrice(plane->seatIndexOf("2D")));
+    EXPECT_EQ(booking->getPaidCents(), paid);
+    EXPECT_EQ(customer->getBalanceCents(), before - paid);
+    EXPECT_EQ(rs.getRevenueCents(), paid);
+
+    // A fare change after booking does not change the refund
+    ASSERT_TRUE(rs.setSeatPrice("FL101", plane->seatIndexOf("2D"), 999.99, error)) << error;
+    ASSERT_TRUE(rs.cancelBookingInternal(booking->getBookingId(), error));
+    EXPECT_EQ(customer->getBalanceCents(), before);
+    EXPECT_EQ(rs.getRevenueCents(), 0);
+}
+
+TEST_F(ReservationSystemTest, ConcurrentRandomBookAndCancelConservesMoney) {
+    // A million random book/cancel operations from several threads over a few shared customers
+    // with small balances, so seat races and insufficient-funds failures are both common
+    const int threadCount = 4;
+    const int opsPerThread = 250000;
+    std::vector<std::string> customerIds = {"CUST0001", "CUST0002"};
+    for (int i = 0; i < 6; ++i) {
+        customerIds.push_back(rs.addCustomerInternal("Stress", 30, 250.0 + 75.0 * i, false)->getPersonId());
+    }
+    const std::vector<std::string> flights = {"FL101", "FL202"};
+    Cents initialTotal = rs.getRevenueCents();
+    for (const std::string& customerId : customerIds) {
+        initialTotal += rs.findCustomerById(customerId)->getBalanceCents();
+    }
+
+    std::atomic<int> booked{0};
+    std::atomic<int> cancelled{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 gen(1234 + t);
+            std::string error;
+            std::vector<std::string> held; // This thread's confirmed bookings
+            int myBooked = 0, myCancelled = 0;
+            for (int op = 0; op < opsPerThread; ++op) {
+                if (!held.empty() && gen() % 2 == 0) {
+                    size_t pick = gen() % held.size();
+                    myCancelled += rs.cancelBookingInternal(held[pick], error);
+                    held[pick] = held.back();
+                    held.pop_back();
+                    continue;
+                }
+                const std::string& flight = flights[gen() % flights.size()];
+                std::string seatId = std::to_string(gen() % 15 + 1) + static_cast<char>('A' + gen() % 6);
+                Booking* booking = rs.createBookingInternal(customerIds[gen() % customerIds.size()], flight, seatId, error);
+                if (booking) {
+                    held.push_back(booking->getBookingId());
+                    ++myBooked;
+                }
+            }
+            booked.fetch_add(myBooked);
+            cancelled.fetch_add(myCancelled);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    Cents finalTotal = rs.getRevenueCents();
+    for (const std::string& customerId : customerIds) {
+        Cents balance = rs.findCustomerById(customerId)->getBalanceCents();
+        EXPECT_GE(balance, 0);
+        finalTotal += balance;
+    }
+    EXPECT_EQ(finalTotal, initialTotal);
+
+    Cents confirmedPaid = 0;
+    int confirmed = 0;
+    rs.forEachBooking([&](const Booking& booking) {
+        if (booking.getStatus() == BookingStatus::CONFIRMED) {
+            confirmedPaid += booking.getPaidCents();
+            ++confirmed;
+        }
+    });
+    EXPECT_EQ(confirmedPaid, rs.getRevenueCents());
+    EXPECT_EQ(confirmed, booked.load() - cancelled.load());
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL101")->getBookedSeatsCount() +
+              rs.findAirplaneByFlightNumber("FL202")->getBookedSeatsCount(), confirmed);
+    EXPECT_GT(cancelled.load(), 0);
+}
+
+TEST_F(ReservationSystemTest, ConcurrentCrossFlightSwapsKeepSeatsAndMoneyConsistent) {
+    // Random pairs across both flights and both classes, swapped from several threads while another
+    // thread cancels. Swaps in opposite directions between the same two flights must not deadlock,
+    // and two low-balance customers make some upgrades fail.
+    std::vector<std::string> customerIds;
+    for (int i = 0; i < 8; ++i) {
+        customerIds.push_back(rs.addCustomerInternal("Swapper", 30, i < 2 ? 260.0 : 1e6, false)->getPersonId());
+    }
+    Cents initialTotal = rs.getRevenueCents();
+    for (const std::string& customerId : customerIds) {
+        initialTotal += rs.findCustomerById(customerId)->getBalanceCents();
+    }
+
+    std::string error;
+    std::vector<std::string> bookingIds;
+    size_t nextCustomer = 0;
+    for (const char* flight : {"FL101", "FL202"}) {
+        for (int row = 1; row <= 7; ++row) {
+            for (char letter = 'A'; letter <= 'F'; ++letter) {
+                const std::string& customerId = customerIds[nextCustomer++ % customerIds.size()];
+                Booking* booking = rs.createBookingInternal(customerId, flight, std::to_string(row) + letter, error);
+                if (booking) bookingIds.push_back(booking->getBookingId());
+            }
+        }
+    }
+    ASSERT_GT(bookingIds.size(), 60u);
+
+    const int swapThreads = 4;
+    const int swapsPerThread = 5000;
+    std::atomic<int> swapped{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < swapThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 gen(99 + t);
+            std::string message;
+            int mine = 0;
+            for (int i = 0; i < swapsPerThread; ++i) {
+                mine += rs.swapSeatsInternal(bookingIds[gen() % bookingIds.size()], bookingIds[gen() % bookingIds.size()], message);
+            }
+            swapped.fetch_add(mine);
+        });
+    }
+    threads.emplace_back([&]() {
+        std::string message;
+        for (size_t i = 0; i < bookingIds.size(); i += 5) {
+            rs.cancelBookingInternal(bookingIds[i], message);
+            std::this_thread::yield();
+        }
+    });
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_GT(swapped.load(), 0);
+
+    Cents finalTotal = rs.getRevenueCents();
+    for (const std::string& customerId : customerIds) {
+        Cents balance = rs.findCustomerById(customerId)->getBalanceCents();
+        EXPECT_GE(balance, 0);
+        finalTotal += balance;
+    }
+    EXPECT_EQ(finalTotal, initialTotal);
+
+    // Every confirmed booking owns its seat in the index and paid exactly that seat's fare
+    int confirmed = 0;
+    for (const std::string& bookingId : bookingIds) {
+        Booking* booking = rs.findBookingById(bookingId);
+        if (booking->getStatus() != BookingStatus::CONFIRMED) continue;
+        ++confirmed;
+        Airplane* plane = rs.findAirplaneByFlightNumber(booking->getFlightNumber());
+        int seatIndex = plane->seatIndexOf(booking->getSeatKey());
+        EXPECT_TRUE(plane->isSeatBooked(seatIndex));
+        EXPECT_EQ(rs.findBookingForSeat(booking->getFlightNumber(), booking->getSeatId()), booking);
+        EXPECT_EQ(booking->getPaidCents(), toCents(plane->getSeatPrice(seatIndex)));
+    }
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL101")->getBookedSeatsCount() +
+              rs.findAirplaneByFlightNumber("FL202")->getBookedSeatsCount(), confirmed);
+}
+
+TEST_F(ReservationSystemTest, FlightSnapshotsFollowBookCancelAndSwap) {
+    auto versionOf = [this](const std::string& flight) {
+        std::uint64_t version = 0;
+        rs.readFlightSnapshot(flight, [&version](const FlightSnapshot& snapshot) { version = snapshot.version(); });
+        return version;
+    };
+    std::string error;
+    std::uint64_t initial = versionOf("FL101");
+    EXPECT_GE(initial, 1u);
+    Booking* first = rs.createBookingInternal("CUST0001", "FL101", "4A", error);
+    Booking* second = rs.createBookingInternal("CUST0002", "FL101", "4B", error);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(versionOf("FL101"), initial + 2);
+
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL101");
+    int seat4A = plane->seatIndexOf("4A");
+    int seat4B = plane->seatIndexOf("4B");
+    rs.readFlightSnapshot("FL101", [&](const FlightSnapshot& snapshot) {
+        EXPECT_EQ(snapshot.getBookedSeatsCount(), 2);
+        EXPECT_TRUE(snapshot.isSeatBooked(seat4A));
+        EXPECT_EQ(snapshot.getSeatOwner(seat4A).bookingNumber, first->getBookingNumber());
+        EXPECT_EQ(*snapshot.getSeatOwner(seat4A).customerId, "CUST0001");
+    });
+
+    ASSERT_TRUE(rs.swapSeatsInternal(first->getBookingId(), second->getBookingId(), error)) << error;
+    rs.readFlightSnapshot("FL101", [&](const FlightSnapshot& snapshot) {
+        EXPECT_EQ(*snapshot.getSeatOwner(seat4A).customerId, "CUST0002");
+        EXPECT_EQ(*snapshot.getSeatOwner(seat4B).customerId, "CUST0001");
+    });
+
+    ASSERT_TRUE(rs.cancelBookingInternal(first->getBookingId(), error)) << error;
+    rs.readFlightSnapshot("FL101", [&](const FlightSnapshot& snapshot) {
+        EXPECT_EQ(snapshot.getBookedSeatsCount(), 1);
+        EXPECT_FALSE(snapshot.isSeatBooked(seat4B));
+        EXPECT_EQ(snapshot.getSeatOwner(seat4B).bookingNumber, 0u);
+    });
+
+    int flights = 0;
+    rs.forEachFlightSnapshot([&flights](const FlightSnapshot&) { ++flights; });
+    EXPECT_EQ(flights, 2);
+    EXPECT_FALSE(rs.readFlightSnapshot("FL999", [](const FlightSnapshot&) {}));
+
+    std::string fareError;
+    EXPECT_TRUE(rs.setSeatPrice("FL101", 0, 321.0, fareError)) << fareError;
+    EXPECT_FALSE(rs.setSeatPrice("FL101", 0, -1.0, fareError));
+    EXPECT_FALSE(rs.setSeatPrice("FL999", 0, 321.0, fareError));
+    EXPECT_EQ(fareError, "Flight FL999 not found.");
+    std::size_t changed = 0;
+    EXPECT_TRUE(rs.repriceFlightInternal("FL101", [](const Airplane&, int seatIndex) { return seatIndex < 2 ? 50.0 : -1.0; }, changed, fareError));
+    EXPECT_EQ(changed, 2u);
+    EXPECT_FALSE(rs.repriceFlightInternal("FL999", [](const Airplane&, int) { return 1.0; }, changed, fareError));
+    rs.readFlightSnapshot("FL101", [](const FlightSnapshot& snapshot) {
+        EXPECT_DOUBLE_EQ(snapshot.getSeatPrice(0), 50.0);
+        EXPECT_DOUBLE_EQ(snapshot.getSeatPrice(1), 50.0);
+    });
+}
+
+TEST_F(ReservationSystemTest, SnapshotReadersSeeConsistentVersionsDuringBookings) {
+    // Readers check that every version they see is internally consistent and that versions
+    // never go backwards, while writers book and cancel on the same flight
+    const int writerCount = 3;
+    std::vector<std::string> customerIds;
+    for (int w = 0; w < writerCount; ++w) {
+        customerIds.push_back(rs.addCustomerInternal("Writer", 30, 1e9, false)->getPersonId());
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<int> inconsistent{0};
+    std::atomic<long> reads{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&]() {
+            std::uint64_t lastVersion = 0;
+            while (!stop.load()) {
+                rs.readFlightSnapshot("FL202", [&](const FlightSnapshot& snapshot) {
+                    int booked = 0;
+                    for (int i = 0; i < snapshot.getCapacity(); ++i) booked += snapshot.isSeatBooked(i);
+                    if (booked != snapshot.getBookedSeatsCount() || snapshot.version() < lastVersion) {
+                        inconsistent.fetch_add(1);
+                    }
+                    lastVersion = snapshot.version();
+                });
+                reads.fetch_add(1);
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int w = 0; w < writerCount; ++w) {
+        writers.emplace_back([&, w]() {
+            std::string error;
+            for (int round = 0; round < 200; ++round) {
+                std::string seatId = std::to_string(w * 6 + round % 6 + 1) + "D";
+                Booking* booking = rs.createBookingInternal(customerIds[w], "FL202", seatId, error);
+                if (booking && round % 3 != 0) rs.cancelBookingInternal(booking->getBookingId(), error);
+            }
+        });
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+    stop.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(inconsistent.load(), 0);
+    EXPECT_GT(reads.load(), 0);
+
+    // Once writers are done, the published version matches the live flight exactly
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL202");
+    rs.readFlightSnapshot("FL202", [&](const FlightSnapshot& snapshot) {
+        EXPECT_EQ(snapshot.getBookedSeatsCount(), plane->getBookedSeatsCount());
+        for (int i = 0; i < snapshot.getCapacity(); ++i) {
+            ASSERT_EQ(snapshot.isSeatBooked(i), plane->isSeatBooked(i)) << i;
+            const Booking* live = rs.findBookingForSeat("FL202", plane->getSeatId(i));
+            EXPECT_EQ(snapshot.getSeatOwner(i).bookingNumber, live ? live->getBookingNumber() : 0u) << i;
+        }
+    });
+}
+
+TEST_F(ReservationSystemTest, HoldConfirmAndRelease) {
+    std::string error;
+    Customer* customer = rs.findCustomerById("CUST0001");
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL101");
+    Cents before = customer->getBalanceCents();
+
+    Booking* hold = rs.holdSeatInternal("CUST0001", "FL101", "5A", std::chrono::minutes(10), error);
+    ASSERT_NE(hold, nullptr) << error;
+    EXPECT_EQ(hold->getStatus(), BookingStatus::PENDING);
+    EXPECT_TRUE(plane->isSeatBooked(plane->seatIndexOf("5A")));
+    EXPECT_EQ(customer->getBalanceCents(), before); // Nothing charged yet
+    EXPECT_EQ(rs.createBookingInternal("CUST0002", "FL101", "5A", error), nullptr);
+    EXPECT_EQ(error, "Seat is already booked.");
+
+    ASSERT_TRUE(rs.confirmHoldInternal(hold->getBookingId(), error)) << error;
+    EXPECT_EQ(hold->getStatus(), BookingStatus::CONFIRMED);
+    Cents fare = toCents(plane->getSeatPrice(plane->seatIndexOf("5A")));
+    EXPECT_EQ(customer->getBalanceCents(), before - fare);
+    EXPECT_EQ(hold->getPaidCents(), fare);
+    EXPECT_EQ(rs.getRevenueCents(), fare);
+    EXPECT_FALSE(rs.confirmHoldInternal(hold->getBookingId(), error));
+    EXPECT_NE(error.find("not an active hold"), std::string::npos);
+    EXPECT_FALSE(rs.releaseHoldInternal(hold->getBookingId(), error)); // Confirmed bookings are cancelled, not released
+
+    Booking* second = rs.holdSeatInternal("CUST0001", "FL101", "5B", std::chrono::minutes(10), error);
+    ASSERT_NE(second, nullptr);
+    ASSERT_TRUE(rs.releaseHoldInternal(second->getBookingId(), error)) << error;
+    EXPECT_EQ(second->getStatus(), BookingStatus::CANCELLED);
+    EXPECT_FALSE(plane->isSeatBooked(plane->seatIndexOf("5B")));
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "5B"), nullptr);
+    EXPECT_EQ(customer->getBalanceCents(), before - fare);
+
+    EXPECT_EQ(rs.holdSeatInternal("CUST0001", "FL101", "5C", std::chrono::milliseconds(0), error), nullptr);
+    EXPECT_FALSE(rs.confirmHoldInternal("BK0000000000000", error));
+    EXPECT_NE(error.find("not found"), std::string::npos);
+    rs.findCustomerById("CUST0002")->setMoney(1.0);
+    EXPECT_EQ(rs.holdSeatInternal("CUST0002", "FL101", "5C", std::chrono::minutes(1), error), nullptr);
+    EXPECT_EQ(error, "Insufficient funds.");
+}
+
+TEST_F(ReservationSystemTest, ExpiredHoldsFreeTheirSeats) {
+    std::string error;
+    auto start = std::chrono::steady_clock::now();
+    Booking* shortHold = rs.holdSeatInternal("CUST0001", "FL202", "3A", std::chrono::minutes(1), error);
+    Booking* longHold = rs.holdSeatInternal("CUST0002", "FL202", "3B", std::chrono::minutes(5), error);
+    ASSERT_NE(shortHold, nullptr);
+    ASSERT_NE(longHold, nullptr);
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL202");
+
+    EXPECT_EQ(rs.expireHolds(start + std::chrono::seconds(30)), 0u);
+    EXPECT_EQ(rs.expireHolds(start + std::chrono::minutes(2)), 1u);
+    EXPECT_EQ(shortHold->getStatus(), BookingStatus::CANCELLED);
+    EXPECT_FALSE(plane->isSeatBooked(plane->seatIndexOf("3A")));
+    EXPECT_FALSE(rs.confirmHoldInternal(shortHold->getBookingId(), error)); // Too late
+    EXPECT_EQ(longHold->getStatus(), BookingStatus::PENDING);
+
+    ASSERT_TRUE(rs.confirmHoldInternal(longHold->getBookingId(), error));
+    EXPECT_EQ(rs.expireHolds(start + std::chrono::minutes(10)), 0u); // Its timer fires but finds it confirmed
+    EXPECT_EQ(longHold->getStatus(), BookingStatus::CONFIRMED);
+    EXPECT_TRUE(plane->isSeatBooked(plane->seatIndexOf("3B")));
+}
+
+TEST_F(ReservationSystemTest, ThousandsOfHoldsExpireTogether) {
+    std::string error;
+    Airplane* plane = rs.addAirplaneInternal("HOLD600", 500, 6, error);
+    Customer* customer = rs.addCustomerInternal("Checkout", 30, 1e9, false);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < plane->getCapacity(); ++i) {
+        ASSERT_NE(rs.holdSeatInternal(customer->getPersonId(), "HOLD600", plane->getSeatId(i),
+                                      std::chrono::seconds(60 + i % 120), error), nullptr) << error;
+    }
+    EXPECT_TRUE(plane->isFull());
+    EXPECT_EQ(rs.expireHolds(start + std::chrono::seconds(59)), 0u);
+    EXPECT_EQ(rs.expireHolds(start + std::chrono::seconds(200)), static_cast<size_t>(plane->getCapacity()));
+    EXPECT_EQ(plane->getBookedSeatsCount(), 0);
+    EXPECT_EQ(customer->getBalanceCents(), toCents(1e9));
+}
+
+TEST_F(ReservationSystemTest, ExpiryThreadReleasesHoldsInTheBackground) {
+    std::string error;
+    Booking* hold = rs.holdSeatInternal("CUST0001", "FL101", "9F", std::chrono::milliseconds(50), error);
+    ASSERT_NE(hold, nullptr);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (hold->getStatus() == BookingStatus::PENDING && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_EQ(hold->getStatus(), BookingStatus::CANCELLED);
+    Airplane* plane = rs.findAirplaneByFlightNumber("FL101");
+    EXPECT_FALSE(plane->isSeatBooked(plane->seatIndexOf("9F")));
+}
+
+TEST_F(ReservationSystemTest, RepriceAllFlightsUpdatesFaresAndSnapshots) {
+    std::string error;
+    Booking* before = rs.createBookingInternal("CUST0001", "FL101", "5C", error);
+    ASSERT_NE(before, nullptr) << error;
+    Cents paidBefore = before->getPaidCents();
+    WorkStealingExecutor executor(3);
+
+    // Double every fare, except that FL202's seat 0 is asked for a negative price and keeps its fare
+    std::size_t changed = 0;
+    ASSERT_TRUE(rs.repriceAllFlightsInternal([](const Airplane& airplane, int seatIndex) {
+        if (airplane.getFlightNumber() == "FL202" && seatIndex == 0) return -1.0;
+        return airplane.getSeatPrice(seatIndex) * 2;
+    }, changed, error, executor)) << error;
+    EXPECT_EQ(changed, 15u * 6 + 20u * 6 - 1);
+
+    Airplane* fl101 = rs.findAirplaneByFlightNumber("FL101");
+    Airplane* fl202 = rs.findAirplaneByFlightNumber("FL202");
+    EXPECT_DOUBLE_EQ(fl101->getSeatPrice(fl101->seatIndexOf("1A")), 400.0); // Business
+    EXPECT_DOUBLE_EQ(fl101->getSeatPrice(fl101->seatIndexOf("5C")), 100.0); // Economy
+    EXPECT_DOUBLE_EQ(fl101->findSeat("5C")->getPrice(), 100.0);             // Seat mirror
+    EXPECT_DOUBLE_EQ(fl202->getSeatPrice(0), 200.0);
+    rs.readFlightSnapshot("FL101", [&](const FlightSnapshot& snapshot) {
+        EXPECT_DOUBLE_EQ(snapshot.getSeatPrice(fl101->seatIndexOf("5C")), 100.0);
+        EXPECT_TRUE(snapshot.isSeatBooked(fl101->seatIndexOf("5C"))); // Occupancy carried over
+    });
+
+    EXPECT_EQ(before->getPaidCents(), paidBefore); // Existing bookings keep their fare
+    Booking* after = rs.createBookingInternal("CUST0001", "FL101", "5D", error);
+    ASSERT_NE(after, nullptr) << error;
+    EXPECT_EQ(after->getPaidCents(), toCents(100.0));
+    ASSERT_TRUE(rs.repriceAllFlightsInternal([](const Airplane& airplane, int seatIndex) {
+        return airplane.getSeatPrice(seatIndex);
+    }, changed, error, executor));
+    EXPECT_EQ(changed, 0u);
+}
+
+TEST_F(ReservationSystemTest, CancelFlightBookingsInternalRefundsAndFreesSeats) {
+    std::string error;
+    Customer* alice = rs.findCustomerById("CUST0001");
+    Customer* bob = rs.findCustomerById("CUST0002");
+    Cents aliceBefore = alice->getBalanceCents();
+    Cents bobBefore = bob->getBalanceCents();
+    ASSERT_NE(rs.createBookingInternal("CUST0001", "FL101", "1A", error), nullptr);
+    ASSERT_NE(rs.createBookingInternal("CUST0002", "FL101", "7F", error), nullptr);
+    Booking* hold = rs.holdSeatInternal("CUST0002", "FL101", "8A", std::chrono::minutes(10), error);
+    ASSERT_NE(hold, nullptr) << error;
+    Booking* kept = rs.createBookingInternal("CUST0001", "FL202", "9B", error);
+    ASSERT_NE(kept, nullptr);
+    WorkStealingExecutor executor(2);
+
+    std::size_t cancelled = 99;
+    EXPECT_FALSE(rs.cancelFlightBookingsInternal({"FL101", "FL999"}, cancelled, error, executor));
+    EXPECT_EQ(error, "Flight FL999 not found.");
+    EXPECT_EQ(cancelled, 0u);
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL101")->getBookedSeatsCount(), 3);
+
+    ASSERT_TRUE(rs.cancelFlightBookingsInternal({"FL101", "FL101"}, cancelled, error, executor)) << error;
+    EXPECT_EQ(cancelled, 3u);
+    EXPECT_EQ(error, "Cancelled 3 booking(s) on 1 flight(s).");
+    EXPECT_EQ(hold->getStatus(), BookingStatus::CANCELLED);
+    EXPECT_FALSE(rs.confirmHoldInternal(hold->getBookingId(), error)); // Released, not confirmable
+    EXPECT_EQ(rs.findAirplaneByFlightNumber("FL101")->getBookedSeatsCount(), 0);
+    EXPECT_EQ(rs.findBookingForSeat("FL101", "1A"), nullptr);
+    rs.readFlightSnapshot("FL101", [](const FlightSnapshot& snapshot) { EXPECT_EQ(snapshot.getBookedSeatsCount(), 0); });
+    EXPECT_EQ(bob->getBalanceCents(), bobBefore);
+    EXPECT_EQ(alice->getBalanceCents(), aliceBefore - kept->getPaidCents());
+    EXPECT_EQ(rs.getRevenueCents(), kept->getPaidCents());
+    EXPECT_EQ(kept->getStatus(), BookingStatus::CONFIRMED);
+
+    ASSERT_TRUE(rs.cancelFlightBookingsInternal({"FL101"}, cancelled, error, executor));
+    EXPECT_EQ(cancelled, 0u);
+    ASSERT_NE(rs.createBookingInternal("CUST0002", "FL101", "1A", error), nullptr); // Seats are bookable again
+
+    std::atomic<int> airplanesSeen{0};
+    std::atomic<Cents> balances{0};
+    rs.parallelForEachAirplane([&](const Airplane&) { airplanesSeen.fetch_add(1); }, executor);
+    rs.parallelForEachCustomer([&](const Customer& customer) { balances.fetch_add(customer.getBalanceCents()); }, executor);
+    EXPECT_EQ(airplanesSeen.load(), 2);
+    EXPECT_EQ(balances.load(), alice->getBalanceCents() + bob->getBalanceCents());
+}
+
+TEST_F(ReservationSystemTest, BulkCancelAndRepriceAlongsideBookingsConserveMoney) {
+    // Threads book and swap while another thread keeps re-pricing the fleet and clearing flights
+    std::vector<std::string> customerIds;
+    for (int i = 0; i < 6; ++i) {
+        customerIds.push_back(rs.addCustomerInternal("Bulk", 30, 5000.0, false)->getPersonId());
+    }
+    Cents initialTotal = rs.getRevenueCents();
+    for (const std::string& customerId : customerIds) {
+        initialTotal += rs.findCustomerById(customerId)->getBalanceCents();
+    }
+    rs.findCustomerById("CUST0001")->setMoney(0.0); // Outside the money being tracked
+    rs.findCustomerById("CUST0002")->setMoney(0.0);
+    WorkStealingExecutor executor(3);
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> bookers;
+    for (int t = 0; t < 3; ++t) {
+        bookers.emplace_back([&, t]() {
+            std::mt19937 gen(99 + t);
+            std::string error;
+            std::vector<std::string> mine;
+            for (int op = 0; op < 20000; ++op) {
+                if (mine.size() >= 2 && gen() % 4 == 0) {
+                    rs.swapSeatsInternal(mine[gen() % mine.size()], mine[gen() % mine.size()], error);
+                    continue;
+                }
+                const char* flight = gen() % 2 ? "FL101" : "FL202";
+                std::string seatId = std::to_string(gen() % 15 + 1) + static_cast<char>('A' + gen() % 6);
+                if (Booking* booking = rs.createBookingInternal(customerIds[gen() % customerIds.size()], flight, seatId, error)) {
+                    mine.push_back(booking->getBookingId());
+                }
+            }
+        });
+    }
+    std::thread bulk([&]() {
+        std::string error;
+        std::size_t cancelled = 0;
+        std::size_t repriced = 0;
+        for (int round = 0; !done.load(); ++round) {
+            rs.repriceAllFlightsInternal([round](const Airplane&, int seatIndex) { return 20.0 + (seatIndex + round) % 7 * 10.0; }, repriced, error, executor);
+            rs.cancelFlightBookingsInternal({round % 2 ? "FL101" : "FL202"}, cancelled, error, executor);
+        }
+    });
+    for (std::thread& booker : bookers) {
+        booker.join();
+    }
+    done = true;
+    bulk.join();
+
+    Cents finalTotal = rs.getRevenueCents();
+    for (const std::string& customerId : customerIds) {
+        finalTotal += rs.findCustomerById(customerId)->getBalanceCents();
+    }
+    EXPECT_EQ(finalTotal, initialTotal);
+    Cents confirmedPaid = 0;
+    int confirmed = 0;
+    rs.forEachBooking([&](const Booking& booking) {
+        if (booking.getStatus() == BookingStatus::CONFIRMED) {
+            confirmedPaid += booking.getPaidCents();
+            ++confirmed;
+        }
+    });
+    EXPECT_EQ(confirmedPaid, rs.getRevenueCents());
+    int seatsBooked = 0;
+    for (const char* flight : {"FL101", "FL202"}) {
+        Airplane* plane = rs.findAirplaneByFlightNumber(flight);
+        seatsBooked += plane->getBookedSeatsCount();
+        for (int seatIndex = 0; seatIndex < plane->getCapacity(); ++seatIndex) {
+            const Booking* booking = rs.findBookingForSeat(flight, plane->getSeatId(seatIndex));
+            ASSERT_EQ(booking != nullptr, plane->isSeatBooked(seatIndex)) << flight << " seat " << seatIndex;
+        }
+        rs.readFlightSnapshot(flight, [&](const FlightSnapshot& snapshot) {
+            EXPECT_EQ(snapshot.getBookedSeatsCount(), plane->getBookedSeatsCount());
+        });
+    }
+    EXPECT_EQ(seatsBooked, confirmed);
+}
+
+namespace {
+
+struct BookingState {
+    std::string bookingId, customerId, flightNumber, seatId, status;
+    Cents paidCents;
+    bool operator==(const BookingState& other) const {
+        return bookingId == other.bookingId && customerId == other.customerId && flightNumber == other.flightNumber &&
+               seatId == other.seatId && status == other.status && paidCents == other.paidCents;
+    }
+};
+
+// Every booking that is not a pending or released hold, in booking-number order
+std::vector<BookingState> durableBookings(const ReservationSystem& system) {
+    std::vector<BookingState> states;
+    system.forEachBooking([&states](const Booking& booking) {
+        if (booking.getStatus() == BookingStatus::PENDING || (booking.getStatus() == BookingStatus::CANCELLED && booking.getPaidCents() == 0)) {
+            return;
+        }
+        states.push_back({booking.getBookingId(), booking.getCustomerId(), booking.getFlightNumber(), booking.getSeatId(),
+                          booking.getStatusString(), booking.getPaidCents()});
+    });
+    std::sort(states.begin(), states.end(), [](const BookingState& a, const BookingState& b) { return a.bookingId < b.bookingId; });
+    return states;
+}
+
+} // namespace
+
+TEST_F(ReservationSystemTest, WriteAheadLogRecoversCustomersBookingsCancelsAndSwaps) {
+    std::string path = ::testing::TempDir() + "reservation_system_test.wal";
+    std::remove(path.c_str());
+    std::string message;
+    ASSERT_TRUE(rs.openWriteAheadLog(path, WriteAheadLog::Options(), message)) << message;
+    EXPECT_EQ(message, "Recovered 0 record(s) from " + path + ".");
+
+    ASSERT_NE(rs.addAirplaneInternal("FL303", 4, 4, message), nullptr);
+    Customer* carol = rs.addCustomerInternal("Carol Danvers", 35, 900.0, false);
+    ASSERT_NE(carol, nullptr);
+    Booking* alice = rs.createBookingInternal("CUST0001", "FL101", "5A", message);
+    Booking* bob = rs.createBookingInternal("CUST0002", "FL202", "8C", message);
+    Booking* carolBooking = rs.createBookingInternal(carol->getPersonId(), "FL303", "1B", message);
+    ASSERT_TRUE(alice && bob && carolBooking);
+    std::string aliceId = alice->getBookingId(), bobId = bob->getBookingId();
+    ASSERT_TRUE(rs.cancelBookingInternal(bobId, message)) << message;
+    ASSERT_TRUE(rs.swapSeatsInternal(aliceId, carolBooking->getBookingId(), message)) << message; // Cross-flight, fares settled
+    Booking* bobRebook = rs.createBookingInternal("CUST0002", "FL202", "8C", message); // Same seat again after the cancel
+    ASSERT_NE(bobRebook, nullptr) << message;
+    Booking* hold = rs.holdSeatInternal("CUST0002", "FL101", "6C", std::chrono::minutes(5), message);
+    ASSERT_NE(hold, nullptr);
+    ASSERT_TRUE(rs.confirmHoldInternal(hold->getBookingId(), message)) << message;
+    ASSERT_NE(rs.holdSeatInternal("CUST0001", "FL101", "7A", std::chrono::minutes(5), message), nullptr); // Never confirmed
+
+    std::vector<BookingState> expectedBookings = durableBookings(rs);
+    EXPECT_EQ(expectedBookings.size(), 5u);
+    Cents expectedRevenue = rs.getRevenueCents();
+    std::vector<Cents> expectedBalances;
+    for (const char* id : {"CUST0001", "CUST0002", "CUST0003"}) {
+        expectedBalances.push_back(rs.findCustomerById(id)->getBalanceCents());
+    }
+    EXPECT_GE(rs.getWriteAheadLog()->getStats().records, 8u);
+
+    rs.resetSystemForTest(); // Closes the log and resets the customer ID counter, like a fresh process
+    ReservationSystem recovered(test_in, test_out);
+    ASSERT_TRUE(recovered.openWriteAheadLog(path, WriteAheadLog::Options(), message)) << message;
+    EXPECT_EQ(message, "Recovered 9 record(s) from " + path + ".");
+
+    EXPECT_EQ(durableBookings(recovered), expectedBookings);
+    EXPECT_EQ(recovered.getRevenueCents(), expectedRevenue);
+    EXPECT_EQ(recovered.findCustomerById("CUST0001")->getBalanceCents(), expectedBalances[0]);
+    EXPECT_EQ(recovered.findCustomerById("CUST0002")->getBalanceCents(), expectedBalances[1]);
+    EXPECT_EQ(recovered.findCustomerById("CUST0003")->getBalanceCents(), expectedBalances[2]);
+    EXPECT_EQ(recovered.findCustomerById("CUST0003")->getName(), "Carol Danvers");
+    EXPECT_EQ(recovered.findBookingForSeat("FL303", "1B")->getBookingId(), aliceId); // Swapped onto Carol's old seat
+    EXPECT_EQ(recovered.findBookingForSeat("FL101", "7A"), nullptr);                  // The unconfirmed hold is gone
+    std::uint64_t snapshotOwner = 0;
+    recovered.readFlightSnapshot("FL303", [&](const FlightSnapshot& snapshot) {
+        if (snapshot.isSeatBooked(1)) snapshotOwner = snapshot.getSeatOwner(1).bookingNumber; // 1B
+    });
+    EXPECT_EQ(snapshotOwner, recovered.findBookingById(aliceId)->getBookingNumber());
+
+    // New IDs continue past the recovered ones, and new mutations append to the same log
+    Customer* dave = recovered.addCustomerInternal("Dave", 50, 300.0, false);
+    ASSERT_NE(dave, nullptr);
+    EXPECT_EQ(dave->getPersonId(), "CUST0004");
+    Booking* daveBooking = recovered.createBookingInternal("CUST0004", "FL202", "9D", message);
+    ASSERT_NE(daveBooking, nullptr);
+    EXPECT_GT(daveBooking->getBookingId(), expectedBookings.back().bookingId);
+    recovered.resetSystemForTest();
+    ReservationSystem again(test_in, test_out);
+    ASSERT_TRUE(again.openWriteAheadLog(path, WriteAheadLog::Options(), message)) << message;
+    EXPECT_EQ(message, "Recovered 11 record(s) from " + path + ".");
+    EXPECT_NE(again.findBookingById(daveBooking->getBookingId()), nullptr);
+    again.resetSystemForTest();
+    std::remove(path.c_str());
+}
+
+TEST_F(ReservationSystemTest, ConcurrentMutationsUnderGroupCommitRecoverExactly) {
+    std::string path = ::testing::TempDir() + "reservation_system_concurrent_test.wal";
+    std::remove(path.c_str());
+    std::string message;
+    ASSERT_TRUE(rs.openWriteAheadLog(path, WriteAheadLog::Options(), message)) << message;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_NE(rs.addCustomerInternal("Traveller " + std::to_string(i), 30, 5000.0, false), nullptr);
+    }
+
+    constexpr int kThreads = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([this, t]() {
+            std::string error;
+            std::string customerId = "CUST000" + std::to_string(3 + t);
+            std::vector<std::string> mine;
+            for (int row = 4; row <= 20; ++row) {
+                for (char letter : {'A', 'B', 'C', 'D', 'E', 'F'}) {
+                    Booking* booking = rs.createBookingInternal(customerId, "FL202", std::to_string(row) + letter, error);
+                    if (booking) mine.push_back(booking->getBookingId()); // Threads race for the same seats
+                }
+            }
+            for (std::size_t i = 0; i < mine.size(); i += 3) {
+                rs.cancelBookingInternal(mine[i], error);
+            }
+            for (std::size_t i = 1; i + 1 < mine.size(); i += 3) {
+                rs.swapSeatsInternal(mine[i], mine[i + 1], error);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    WriteAheadLog::Stats stats = rs.getWriteAheadLog()->getStats();
+    EXPECT_LE(stats.syncs, stats.records);
+
+    std::vector<BookingState> expectedBookings = durableBookings(rs);
+    Cents expectedRevenue = rs.getRevenueCents();
+    std::vector<Cents> expectedBalances;
+    for (int i = 1; i <= 6; ++i) {
+        expectedBalances.push_back(rs.findCustomerById("CUST000" + std::to_string(i))->getBalanceCents());
+    }
+    int bookedSeats = rs.findAirplaneByFlightNumber("FL202")->getBookedSeatsCount();
+
+    rs.resetSystemForTest();
+    ReservationSystem recovered(test_in, test_out);
+    ASSERT_TRUE(recovered.openWriteAheadLog(path, WriteAheadLog::Options(), message)) << message;
+    EXPECT_EQ(durableBookings(recovered), expectedBookings);
+    EXPECT_EQ(recovered.getRevenueCents(), expectedRevenue);
+    for (int i = 1; i <= 6; ++i) {
+        EXPECT_EQ(recovered.findCustomerById("CUST000" + std::to_string(i))->getBalanceCents(), expectedBalances[i - 1]);
+    }
+    EXPECT_EQ(recovered.findAirplaneByFlightNumber("FL202")->getBookedSeatsCount(), bookedSeats);
+    recovered.resetSystemForTest();
+    std::remove(path.c_str());
+}
+
+TEST_F(ReservationSystemTest, WriteAheadLogRecoversFareChanges) {
+    std::string path = ::testing::TempDir() + "reservation_system_fares_test.wal";
+    std::remove(path.c_str());
+    std::string message;
+    ASSERT_TRUE(rs.openWriteAheadLog(path, WriteAheadLog::Options(), message)) << message;
+    ASSERT_NE(rs.addAirplaneInternal("FL303", 4, 4, message), nullptr);
+    ASSERT_TRUE(rs.setSeatPrice("FL303", 5, 321.0, message)) << message;
+    std::size_t changed = 0;
+    ASSERT_TRUE(rs.repriceFlightInternal("FL101", [](const Airplane& airplane, int seatIndex) {
+        return seatIndex % 3 == 0 ? airplane.getSeatPrice(seatIndex) + 10.5 : -1.0; // Keeps the others
+    }, changed, message)) << message;
+    EXPECT_GT(changed, 0u);
+    ASSERT_TRUE(rs.repriceAllFlightsInternal([](const Airplane& airplane, int seatIndex) {
+        return airplane.getFlightNumber() == "FL202" && seatIndex < 4 ? 77.25 : -1.0;
+    }, changed, message)) << message;
+    EXPECT_EQ(changed, 4u);
+    ASSERT_TRUE(rs.setSeatPrice("FL303", 5, 123.45, message)) << message; // The last fare wins
+
+    std::vector<std::vector<double>> expected;
+    for (const char* flight : {"FL101", "FL202", "FL303"}) {
+        Airplane* airplane = rs.findAirplaneByFlightNumber(flight);
+        std::vector<double> fares;
+        for (int i = 0; i < airplane->getCapacity(); ++i) fares.push_back(airplane->getSeatPrice(i));
+        expected.push_back(fares);
+    }
+
+    rs.resetSystemForTest();
+    ReservationSystem recovered(test_in, test_out);
+    ASSERT_TRUE(recovered.openWriteAheadLog(path, WriteAheadLog::Options(), message)) << message;
+    EXPECT_EQ(message, "Recovered 5 record(s) from " + path + ".");
+    int flightIndex = 0;
+    for (const char* flight : {"FL101", "FL202", "FL303"}) {
+        Airplane* airplane = recovered.findAirplaneByFlightNumber(flight);
+        ASSERT_NE(airplane, nullptr);
+        std::vector<double> fares;
+        for (int i = 0; i < airplane->getCapacity(); ++i) fares.push_back(airplane->getSeatPrice(i));
+        EXPECT_EQ(fares, expected[flightIndex++]) << flight;
+    }
+    double snapshotFare = 0;
+    recovered.readFlightSnapshot("FL303", [&](const FlightSnapshot& snapshot) { snapshotFare = snapshot.getSeatPrice(5); });
+    EXPECT_EQ(snapshotFare, 123.45);
+    recovered.resetSystemForTest();
+    std::remove(path.c_str());
+}
+
+TEST_F(ReservationSystemTest, OpenWriteAheadLogRejectsALogThatDoesNotFitTheState) {
+    std::string path = ::testing::TempDir() + "reservation_system_mismatch_test.wal";
+    std::remove(path.c_str());
+    {
+        std::string error;
+        auto log = WriteAheadLog::open(path, 0, WriteAheadLog::Options(), error);
+        ASSERT_NE(log, nullptr) << error;
+        log->append(WalRecord::book(12345, "CUST0001", "FL999", 0, 5000)); // No such flight
+    }
+    std::string message;
+    EXPECT_FALSE(rs.openWriteAheadLog(path, WriteAheadLog::Options(), message));
+    EXPECT_EQ(message, path + ": record 1: Booking references an unknown customer, flight or seat.");
+    EXPECT_EQ(rs.getWriteAheadLog(), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST_F(ReservationSystemTest, SnapshotRestoresBookingsFaresBalancesAndRevenue) {
+    std::string path = ::testing::TempDir() + "reservation_system_test.snap";
+    std::string message;
+    ASSERT_NE(rs.addAirplaneInternal("FL303", 4, 4, message), nullptr);
+    ASSERT_TRUE(rs.setSeatPrice("FL303", 5, 321.0, message)) << message;
+    Customer* carol = rs.addCustomerInternal("Carol Danvers", 35, 900.0, false);
+    ASSERT_NE(carol, nullptr);
+    Booking* alice = rs.createBookingInternal("CUST0001", "FL101", "5A", message);
+    Booking* bob = rs.createBookingInternal("CUST0002", "FL202", "8C", message);
+    Booking* carolBooking = rs.createBookingInternal(carol->getPersonId(), "FL303", "2B", message); // The re-priced seat
+    ASSERT_TRUE(alice && bob && carolBooking);
+    std::string aliceId = alice->getBookingId(), bobId = bob->getBookingId();
+    ASSERT_TRUE(rs.cancelBookingInternal(bobId, message)) << message;
+    ASSERT_TRUE(rs.swapSeatsInternal(aliceId, carolBooking->getBookingId(), message)) << message;
+    ASSERT_NE(rs.createBookingInternal("CUST0002", "FL202", "8C", message), nullptr) << message;
+    ASSERT_NE(rs.holdSeatInternal("CUST0001", "FL101", "7A", std::chrono::minutes(5), message), nullptr); // Left out
+
+    std::vector<BookingState> expectedBookings = durableBookings(rs);
+    Cents expectedRevenue = rs.getRevenueCents();
+    std::vector<Cents> expectedBalances;
+    for (const char* id : {"CUST0001", "CUST0002", "CUST0003"}) {
+        expectedBalances.push_back(rs.findCustomerById(id)->getBalanceCents());
+    }
+    ASSERT_TRUE(rs.saveSnapshot(path, message)) << message;
+    EXPECT_EQ(message, "Saved 3 airplane(s), 3 customer(s) and 4 booking(s) to " + path + ".");
+
+    rs.resetSystemForTest();
+    ReservationSystem restored(test_in, test_out);
+    ASSERT_TRUE(restored.loadSnapshot(path, message)) << message;
+    EXPECT_EQ(message, "Loaded 3 airplane(s), 3 customer(s) and 4 booking(s) from " + path + ".");
+    EXPECT_EQ(durableBookings(restored), expectedBookings);
+    EXPECT_EQ(restored.findBookingById(bobId)->getStatus(), BookingStatus::CANCELLED);
+    EXPECT_EQ(restored.getRevenueCents(), expectedRevenue);
+    EXPECT_EQ(restored.findCustomerById("CUST0001")->getBalanceCents(), expectedBalances[0]);
+    EXPECT_EQ(restored.findCustomerById("CUST0002")->getBalanceCents(), expectedBalances[1]);
+    EXPECT_EQ(restored.findCustomerById("CUST0003")->getBalanceCents(), expectedBalances[2]);
+    EXPECT_EQ(restored.findCustomerById("CUST0003")->getName(), "Carol Danvers");
+    EXPECT_DOUBLE_EQ(restored.findAirplaneByFlightNumber("FL303")->getSeatPrice(5), 321.0);
+    EXPECT_EQ(restored.findBookingForSeat("FL303", "2B")->getBookingId(), aliceId); // Swapped onto Carol's old seat
+    EXPECT_EQ(restored.findBookingForSeat("FL101", "7A"), nullptr);                  // The hold is gone
+    ASSERT_EQ(restored.getBookingsForCustomer("CUST0002").size(), 2u); // The cancelled one and the rebooking
+
+    // Seat maps are built on first read
+    std::uint64_t snapshotOwner = 0;
+    double snapshotPrice = 0;
+    restored.readFlightSnapshot("FL303", [&](const FlightSnapshot& snapshot) {
+        if (snapshot.isSeatBooked(5)) snapshotOwner = snapshot.getSeatOwner(5).bookingNumber;
+        snapshotPrice = snapshot.getSeatPrice(5);
+    });
+    EXPECT_EQ(snapshotOwner, restored.findBookingById(aliceId)->getBookingNumber());
+    EXPECT_DOUBLE_EQ(snapshotPrice, 321.0);
+
+    // Restored bookings change like any other; new IDs continue past the restored ones
+    ASSERT_TRUE(restored.cancelBookingInternal(aliceId, message)) << message;
+    EXPECT_EQ(restored.findBookingForSeat("FL303", "2B"), nullptr);
+    EXPECT_EQ(restored.getRevenueCents(), expectedRevenue - 32100);
+    Customer* dave = restored.addCustomerInternal("Dave", 50, 300.0, false);
+    ASSERT_NE(dave, nullptr);
+    EXPECT_EQ(dave->getPersonId(), "CUST0004");
+    Booking* carolAgain = restored.createBookingInternal("CUST0003", "FL303", "2B", message);
+    ASSERT_NE(carolAgain, nullptr) << message;
+    EXPECT_GT(carolAgain->getBookingId(), expectedBookings.back().bookingId);
+    std::vector<const Booking*> carolBookings = restored.getBookingsForCustomer("CUST0003");
+    ASSERT_EQ(carolBookings.size(), 2u);
+    EXPECT_EQ(carolBookings.back(), carolAgain); // After the restored one
+    restored.readFlightSnapshot("FL303", [&](const FlightSnapshot& snapshot) {
+        snapshotOwner = snapshot.isSeatBooked(5) ? snapshot.getSeatOwner(5).bookingNumber : 0;
+    });
+    EXPECT_EQ(snapshotOwner, carolAgain->getBookingNumber());
+    restored.resetSystemForTest();
+    std::remove(path.c_str());
+}
+
+TEST_F(ReservationSystemTest, LoadSnapshotKeepsTheStateOnAnUnreadableFileAndRefusesWhileLogging) {
+    std::string path = ::testing::TempDir() + "reservation_system_missing_test.snap";
+    std::remove(path.c_str());
+    std::string message;
+    EXPECT_FALSE(rs.loadSnapshot(path, message));
+    EXPECT_NE(rs.findAirplaneByFlightNumber("FL101"), nullptr);
+    EXPECT_NE(rs.findCustomerById("CUST0001"), nullptr);
+
+    std::string walPath = ::testing::TempDir() + "reservation_system_snapshot_test.wal";
+    std::remove(walPath.c_str());
+    ASSERT_TRUE(rs.saveSnapshot(path, message)) << message;
+    ASSERT_TRUE(rs.openWriteAheadLog(walPath, WriteAheadLog::Options(), message)) << message;
+    EXPECT_FALSE(rs.loadSnapshot(path, message));
+    EXPECT_EQ(message, "Load the snapshot before opening the write-ahead log.");
+    rs.resetSystemForTest();
+    std::remove(walPath.c_str());
+    std::remove(path.c_str());
+}
+
+TEST_F(ReservationSystemTest, RestoredSeatMapBuiltWhileBookingMatchesTheLiveSeats) {
+    std::string path = ::testing::TempDir() + "reservation_system_race_test.snap";
+    std::string message;
+    ASSERT_NE(rs.createBookingInternal("CUST0001", "FL202", "1A", message), nullptr) << message;
+    ASSERT_TRUE(rs.saveSnapshot(path, message)) << message;
+    rs.resetSystemForTest();
+    ReservationSystem restored(test_in, test_out);
+    ASSERT_TRUE(restored.loadSnapshot(path, message)) << message;
+
+    // The first reader and the first booking race to build FL202's seat map
+    std::atomic<bool> start{false};
+    std::thread reader([&]() {
+        while (!start.load()) {}
+        for (int i = 0; i < 50; ++i) {
+            restored.readFlightSnapshot("FL202", [](const FlightSnapshot& snapshot) { (void)snapshot.getBookedSeatsCount(); });
+        }
+    });
+    start = true;
+    for (const char* seat : {"2A", "2B", "2C", "3A"}) {
+        EXPECT_NE(restored.createBookingInternal("CUST0001", "FL202", seat, message), nullptr) << message;
+    }
+    reader.join();
+    const Airplane* airplane = restored.findAirplaneByFlightNumber("FL202");
+    restored.readFlightSnapshot("FL202", [&](const FlightSnapshot& snapshot) {
+        EXPECT_EQ(snapshot.getBookedSeatsCount(), 5);
+        for (int seatIndex = 0; seatIndex < airplane->getCapacity(); ++seatIndex) {
+            EXPECT_EQ(snapshot.isSeatBooked(seatIndex), airplane->isSeatBooked(seatIndex)) << seatIndex;
+        }
+    });
+    restored.resetSystemForTest();
+    std::remove(path.c_str());
+}
+
+TEST_F(ReservationSystemTest, CheckpointDuringConcurrentBookingsRecoversWithTheLogTail) {
+    std::string walPath = ::testing::TempDir() + "reservation_system_checkpoint_test.wal";
+    std::string snapPath = ::testing::TempDir() + "reservation_system_checkpoint_test.snap";
+    std::remove(walPath.c_str());
+    std::remove(WriteAheadLog::segmentPath(walPath, 0).c_str());
+    std::string message;
+    ASSERT_TRUE(rs.openWriteAheadLog(walPath, WriteAheadLog::Options(), message)) << message;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_NE(rs.addCustomerInternal("Traveller " + std::to_string(i), 30, 5000.0, false), nullptr);
+    }
+
+    // Threads book, cancel and swap while checkpoints cut the state out from under them
+    constexpr int kThreads = 3;
+    std::atomic<int> running{kThreads};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([this, t, &running]() {
+            std::string error;
+            std::string customerId = "CUST000" + std::to_string(3 + t);
+            std::vector<std::string> mine;
+            for (int row = 1; row <= 20; ++row) {
+                for (char letter : {'A', 'B', 'C', 'D', 'E', 'F'}) {
+                    Booking* booking = rs.createBookingInternal(customerId, "FL202", std::to_string(row) + letter, error);
+                    if (booking) mine.push_back(booking->getBookingId());
+                }
+                if (mine.size() >= 3) {
+                    rs.cancelBookingInternal(mine[mine.size() - 3], error);
+                    rs.swapSeatsInternal(mine[mine.size() - 2], mine[mine.size() - 1], error);
+                }
+            }
+            --running;
+        });
+    }
+    int checkpoints = 0;
+    do {
+        ASSERT_TRUE(rs.saveSnapshot(snapPath, message)) << message;
+        ++checkpoints;
+    } while (running.load() > 0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(rs.getWriteAheadLog()->getPosition().generation, static_cast<std::uint64_t>(checkpoints));
+    Booking* last = rs.createBookingInternal("CUST0001", "FL101", "9C", message); // Only in the log tail
+    ASSERT_NE(last, nullptr) << message;
+
+    std::vector<BookingState> expectedBookings = durableBookings(rs);
+    Cents expectedRevenue = rs.getRevenueCents();
+    std::vector<Cents> expectedBalances;
+    for (int i = 1; i <= 6; ++i) {
+        expectedBalances.push_back(rs.findCustomerById("CUST000" + std::to_string(i))->getBalanceCents());
+    }
+    int bookedSeats = rs.findAirplaneByFlightNumber("FL202")->getBookedSeatsCount();
+
+    rs.resetSystemForTest();
+    for (int generation = 0; generation < checkpoints; ++generation) { // Each checkpoint dropped the segments it covered
+        EXPECT_FALSE(std::ifstream(WriteAheadLog::segmentPath(walPath, generation)).good()) << generation;
+    }
+    ReservationSystem recovered(test_in, test_out);
+    ASSERT_TRUE(recovered.loadSnapshot(snapPath, message)) << message;
+    ASSERT_TRUE(recovered.openWriteAheadLog(walPath, WriteAheadLog::Options(), message)) << message;
+    EXPECT_EQ(durableBookings(recovered), expectedBookings);
+    EXPECT_EQ(recovered.getRevenueCents(), expectedRevenue);
+    for (int i = 1; i <= 6; ++i) {
+        EXPECT_EQ(recovered.findCustomerById("CUST000" + std::to_string(i))->getBalanceCents(), expectedBalances[i - 1]);
+    }
+    EXPECT_EQ(recovered.findAirplaneByFlightNumber("FL202")->getBookedSeatsCount(), bookedSeats);
+    EXPECT_EQ(recovered.findBookingForSeat("FL101", "9C")->getBookingId(), last->getBookingId());
+    recovered.resetSystemForTest();
+    std::remove(walPath.c_str());
+    std::remove(snapPath.c_str());
+}
+
+TEST_F(ReservationSystemTest, OpenWriteAheadLogReplaysSegmentsLeftByAFailedCheckpoint) {
+    std::string walPath = ::testing::TempDir() + "reservation_system_segment_test.wal";
+    std::remove(walPath.c_str());
+    std::string message;
+    ASSERT_TRUE(rs.openWriteAheadLog(walPath, WriteAheadLog::Options(), message)) << message;
+    ASSERT_NE(rs.createBookingInternal("CUST0001", "FL101", "1A", message), nullptr) << message;
+    EXPECT_FALSE(rs.saveSnapshot(::testing::TempDir() + "no_such_directory/checkpoint.snap", message)); // Rotates, then fails
+    EXPECT_EQ(rs.getWriteAheadLog()->getPosition().generation, 1u);
+    ASSERT_NE(rs.createBookingInternal("CUST0002", "FL101", "1B", message), nullptr) << message;
+    std::vector<BookingState> expectedBookings = durableBookings(rs);
+
+    rs.resetSystemForTest();
+    ReservationSystem recovered(test_in, test_out);
+    recovered.initializeSystem();
+    ASSERT_TRUE(recovered.openWriteAheadLog(walPath, WriteAheadLog::Options(), message)) << message;
+    EXPECT_EQ(message, "Recovered 2 record(s) from " + walPath + ".");
+    EXPECT_EQ(durableBookings(recovered), expectedBookings);
+    recovered.resetSystemForTest();
+
+    std::remove(WriteAheadLog::segmentPath(walPath, 0).c_str()); // A lost segment leaves a gap before the file
+    ReservationSystem gap(test_in, test_out);
+    gap.initializeSystem();
+    EXPECT_FALSE(gap.openWriteAheadLog(walPath, WriteAheadLog::Options(), message));
+    EXPECT_EQ(message, walPath + " does not continue from the snapshot and the log segments before it.");
+    gap.resetSystemForTest();
+    std::remove(walPath.c_str());
+}
+
+TEST_F(ReservationSystemTest, BackgroundCheckpointsSaveOnlyWhenTheLogMoved) {
+    std::string walPath = ::testing::TempDir() + "reservation_system_background_test.wal";
+    std::string snapPath = ::testing::TempDir() + "reservation_system_background_test.snap";
+    std::remove(walPath.c_str());
+    std::remove(snapPath.c_str());
+    std::string message;
+    ASSERT_TRUE(rs.openWriteAheadLog(walPath, WriteAheadLog::Options(), message)) << message;
+    ASSERT_NE(rs.createBookingInternal("CUST0001", "FL101", "2A", message), nullptr) << message;
+
+    std::mutex reportMutex;
+    std::vector<std::string> reports;
+    rs.startCheckpoints(snapPath, std::chrono::milliseconds(5), [&](bool saved, const std::string& report) {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        reports.push_back(saved ? report : "failed: " + report);
+    });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    auto reportCount = [&]() {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        return reports.size();
+    };
+    while (reportCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Several more intervals with nothing logged
+    rs.resetSystemForTest(); // Stops the checkpoint thread
+    {
+        std::lock_guard<std::mutex> lock(reportMutex);
+        ASSERT_EQ(reports.size(), 1u);
+        EXPECT_EQ(reports[0], "Saved 2 airplane(s), 2 customer(s) and 1 booking(s) to " + snapPath + ".");
+    }
+
+    ReservationSystem restored(test_in, test_out);
+    ASSERT_TRUE(restored.loadSnapshot(snapPath, message)) << message;
+    EXPECT_NE(restored.findBookingForSeat("FL101", "2A"), nullptr);
+    restored.resetSystemForTest();
+    std::remove(walPath.c_str());
+    std::remove(snapPath.c_str());
 }
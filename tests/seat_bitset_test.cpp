@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+#include "../src/SeatBitset.h"
+#include <vector>
+
+// Test set/reset/test and counting across word boundaries
+TEST(SeatBitsetTest, SetResetAndCount) {
+    SeatBitset bits(130); // Three words, last one partially used
+    EXPECT_EQ(bits.size(), 130);
+    EXPECT_EQ(bits.count(), 0);
+
+    bits.set(0);
+    bits.set(63);
+    bits.set(64);
+    bits.set(129);
+    EXPECT_TRUE(bits.test(63));
+    EXPECT_TRUE(bits.test(64));
+    EXPECT_FALSE(bits.test(65));
+    EXPECT_EQ(bits.count(), 4);
+
+    bits.reset(63);
+    EXPECT_FALSE(bits.test(63));
+    EXPECT_EQ(bits.count(), 3);
+
+    bits.resize(10);
+    EXPECT_EQ(bits.size(), 10);
+    EXPECT_EQ(bits.count(), 0);
+}
+
+// Test masked counts and searches
+TEST(SeatBitsetTest, MaskedQueries) {
+    SeatBitset occupied(100);
+    SeatBitset mask(100);
+    for (int i = 50; i < 100; ++i) {
+        mask.set(i);
+    }
+    occupied.set(10);
+    occupied.set(50);
+    occupied.set(51);
+
+    EXPECT_EQ(occupied.countAnd(mask), 2);
+    EXPECT_EQ(occupied.countAndNot(mask), 48);
+    EXPECT_EQ(occupied.findFirstClear(), 0);
+    EXPECT_EQ(occupied.findFirstClearIn(mask), 52);
+
+    std::vector<int> visited;
+    occupied.forEachClearIn(mask, [&](int index) { visited.push_back(index); });
+    ASSERT_EQ(visited.size(), 48u);
+    EXPECT_EQ(visited.front(), 52);
+    EXPECT_EQ(visited.back(), 99);
+}
+
+// Test that bits past the logical size are never reported as free
+TEST(SeatBitsetTest, FullSetHasNoClearBits) {
+    SeatBitset bits(70);
+    for (int i = 0; i < 70; ++i) {
+        bits.set(i);
+    }
+    EXPECT_EQ(bits.findFirstClear(), -1);
+    int visits = 0;
+    bits.forEachClear([&](int) { ++visits; });
+    EXPECT_EQ(visits, 0);
+
+    SeatBitset empty;
+    EXPECT_EQ(empty.findFirstClear(), -1);
+    EXPECT_EQ(empty.count(), 0);
+}
+
+// Test the portable bit helpers
+TEST(SeatBitsetTest, BitHelpers) {
+    EXPECT_EQ(SeatBitset::popcount(0), 0);
+    EXPECT_EQ(SeatBitset::popcount(~0ULL), 64);
+    EXPECT_EQ(SeatBitset::popcount(0xF0F0ULL), 8);
+    EXPECT_EQ(SeatBitset::countTrailingZeros(1ULL), 0);
+    EXPECT_EQ(SeatBitset::countTrailingZeros(1ULL << 40), 40);
+}
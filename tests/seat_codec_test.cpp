@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include "../src/SeatCodec.h"
+
+// Test parsing well-formed seat IDs
+TEST(SeatCodecTest, ParseValidIds) {
+    int row = 0;
+    int column = 0;
+    ASSERT_TRUE(SeatCodec::parse("1A", row, column));
+    EXPECT_EQ(row, 1);
+    EXPECT_EQ(column, 0);
+
+    ASSERT_TRUE(SeatCodec::parse("12F", row, column));
+    EXPECT_EQ(row, 12);
+    EXPECT_EQ(column, 5);
+
+    ASSERT_TRUE(SeatCodec::parse("600K", row, column));
+    EXPECT_EQ(row, 600);
+    EXPECT_EQ(column, 10);
+}
+
+// Test rejecting malformed seat IDs
+TEST(SeatCodecTest, ParseRejectsMalformedIds) {
+    int row = -1;
+    int column = -1;
+    EXPECT_FALSE(SeatCodec::parse("", row, column));
+    EXPECT_FALSE(SeatCodec::parse("A", row, column));
+    EXPECT_FALSE(SeatCodec::parse("12", row, column));   // No letter
+    EXPECT_FALSE(SeatCodec::parse("A1", row, column));   // Letter first
+    EXPECT_FALSE(SeatCodec::parse("01A", row, column));  // Leading zero
+    EXPECT_FALSE(SeatCodec::parse("0A", row, column));   // Row 0
+    EXPECT_FALSE(SeatCodec::parse("1@", row, column));   // Character before 'A'
+    EXPECT_FALSE(SeatCodec::parse("1 2A", row, column));
+    EXPECT_FALSE(SeatCodec::parse("123456789A", row, column)); // Too many digits
+    // Failed parses leave the outputs untouched
+    EXPECT_EQ(row, -1);
+    EXPECT_EQ(column, -1);
+}
+
+// Test key packing round trips
+TEST(SeatCodecTest, KeyRoundTrip) {
+    SeatKey key = SeatCodec::parseKey("27C");
+    ASSERT_NE(key, SeatCodec::INVALID_KEY);
+    EXPECT_EQ(SeatCodec::rowOf(key), 27);
+    EXPECT_EQ(SeatCodec::columnOf(key), 2);
+    EXPECT_EQ(SeatCodec::toSeatId(key), "27C");
+    EXPECT_EQ(SeatCodec::toKey(27, 2), key);
+
+    // Keys order by row first, then column
+    EXPECT_LT(SeatCodec::parseKey("2F"), SeatCodec::parseKey("3A"));
+    EXPECT_LT(SeatCodec::parseKey("3A"), SeatCodec::parseKey("3B"));
+}
+
+// Test invalid keys
+TEST(SeatCodecTest, InvalidKeys) {
+    EXPECT_EQ(SeatCodec::parseKey("bogus"), SeatCodec::INVALID_KEY);
+    EXPECT_EQ(SeatCodec::toKey(0, 0), SeatCodec::INVALID_KEY);
+    EXPECT_EQ(SeatCodec::toKey(1, -1), SeatCodec::INVALID_KEY);
+    EXPECT_EQ(SeatCodec::toKey(SeatCodec::MAX_ROW + 1, 0), SeatCodec::INVALID_KEY);
+    EXPECT_EQ(SeatCodec::toSeatId(SeatCodec::INVALID_KEY), "");
+}
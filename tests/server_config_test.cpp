@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+#include "../src/ServerConfig.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// parseArguments over string literals, with a dummy program name
+bool parse(ServerConfig& config, std::vector<std::string> arguments, std::string& error) {
+    arguments.insert(arguments.begin(), "airline_api_server");
+    std::vector<char*> argv;
+    for (std::string& argument : arguments) {
+        argv.push_back(&argument[0]);
+    }
+    return config.parseArguments(static_cast<int>(argv.size()), argv.data(), error);
+}
+
+} // namespace
+
+TEST(ServerConfigTest, DefaultsMatchThePreviousHardcodedServer) {
+    ServerConfig config;
+    std::string error;
+    EXPECT_TRUE(parse(config, {}, error));
+    EXPECT_EQ(config.host, "0.0.0.0");
+    EXPECT_EQ(config.port, 8080);
+    EXPECT_FALSE(config.pipelineMode);
+}
+
+TEST(ServerConfigTest, LoadsKeyValueLinesWithComments) {
+    std::istringstream in("# pool sizing\n"
+                          "port = 9090\n"
+                          "  mode=pipeline   # single writer\n"
+                          "\n"
+                          "min_workers = 2\nmax_workers = 8\nmax_queued = 32\n"
+                          "target_wait_ms = 5\nmax_wait_ms = 100\nadjust_interval_ms = 50\n"
+                          "shed_workers = 3\nmax_shed_queued = 0\nkeep_alive_timeout_s = 1\nhost = 127.0.0.1\nloop_threads = 4\n"
+                          "wal_path = data/reservations.wal\ndurability = async\nwal_flush_ms = 20\n");
+    std::istringstream snapshot("snapshot_path = data/reservations.snap\ncheckpoint_interval_s = 30\n");
+    ServerConfig config;
+    std::string error;
+    ASSERT_TRUE(config.load(in, error)) << error;
+    EXPECT_EQ(config.port, 9090);
+    EXPECT_TRUE(config.pipelineMode);
+    EXPECT_EQ(config.host, "127.0.0.1");
+    EXPECT_EQ(config.keepAliveTimeoutSec, 1);
+    EXPECT_EQ(config.loopThreads, 4);
+    EXPECT_EQ(config.pool.minWorkers, 2);
+    EXPECT_EQ(config.pool.maxWorkers, 8);
+    EXPECT_EQ(config.pool.maxQueued, 32u);
+    EXPECT_EQ(config.pool.targetWait.count(), 5);
+    EXPECT_EQ(config.pool.maxWait.count(), 100);
+    EXPECT_EQ(config.pool.adjustInterval.count(), 50);
+    EXPECT_EQ(config.pool.shedWorkers, 3);
+    EXPECT_EQ(config.pool.maxShedQueued, 0u);
+    EXPECT_EQ(config.walPath, "data/reservations.wal");
+    EXPECT_EQ(config.wal.durability, WriteAheadLog::Durability::ASYNC);
+    EXPECT_EQ(config.wal.asyncFlushInterval.count(), 20);
+
+    ServerConfig snapshotConfig;
+    ASSERT_TRUE(snapshotConfig.load(snapshot, error)) << error;
+    EXPECT_EQ(snapshotConfig.snapshotPath, "data/reservations.snap");
+    EXPECT_EQ(snapshotConfig.checkpointIntervalSec, 30);
+}
+
+TEST(ServerConfigTest, RejectsBadLinesWithTheirLineNumber) {
+    std::string error;
+    ServerConfig config;
+    std::istringstream unknown("port = 9090\nthreads = 4\n");
+    EXPECT_FALSE(config.load(unknown, error));
+    EXPECT_EQ(error, "Line 2: Unknown setting threads.");
+
+    std::istringstream noEquals("port 9090\n");
+    EXPECT_FALSE(config.load(noEquals, error));
+    EXPECT_EQ(error, "Line 1: expected key = value.");
+
+    for (const char* bad : {"durability = fsync\n", "port = 0\n", "port = 70000\n", "max_queued = -1\n", "min_workers = 2x\n", "mode = fast\n", "max_wait_ms =\n"}) {
+        std::istringstream in(bad);
+        EXPECT_FALSE(config.load(in, error)) << bad;
+    }
+}
+
+TEST(ServerConfigTest, FlagsOverrideTheConfigFile) {
+    std::string path = ::testing::TempDir() + "server_config_test.conf";
+    {
+        std::ofstream file(path);
+        file << "port = 9000\nmax_workers = 16\nmode = pipeline\n";
+    }
+    ServerConfig config;
+    std::string error;
+    ASSERT_TRUE(parse(config, {"--max-workers=32", "--config=" + path}, error)) << error;
+    EXPECT_EQ(config.port, 9000);             // From the file
+    EXPECT_EQ(config.pool.maxWorkers, 32);    // The flag wins although it comes first
+    EXPECT_TRUE(config.pipelineMode);
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(parse(config, {"--config=/nonexistent/server.conf"}, error));
+    EXPECT_EQ(error, "Cannot open config file /nonexistent/server.conf.");
+}
+
+TEST(ServerConfigTest, RejectsUnknownFlagsAndInconsistentLimits) {
+    std::string error;
+    ServerConfig unknown;
+    EXPECT_FALSE(parse(unknown, {"--threads=4"}, error));
+    EXPECT_EQ(error, "Unknown setting threads.");
+    ServerConfig positional;
+    EXPECT_FALSE(parse(positional, {"8080"}, error));
+    EXPECT_EQ(error, "Unexpected argument 8080.");
+
+    ServerConfig workers;
+    EXPECT_FALSE(parse(workers, {"--min-workers=10", "--max-workers=5"}, error));
+    EXPECT_EQ(error, "min_workers must not exceed max_workers.");
+    ServerConfig waits;
+    EXPECT_FALSE(parse(waits, {"--target_wait_ms=500", "--max_wait_ms=100"}, error));
+    EXPECT_EQ(error, "target_wait_ms must not exceed max_wait_ms.");
+    ServerConfig checkpoints;
+    EXPECT_FALSE(parse(checkpoints, {"--wal-path=a.wal", "--checkpoint-interval-s=60"}, error));
+    EXPECT_EQ(error, "checkpoint_interval_s needs snapshot_path.");
+    ServerConfig durable;
+    EXPECT_TRUE(parse(durable, {"--wal-path=a.wal", "--snapshot-path=a.snap", "--checkpoint-interval-s=60"}, error)) << error;
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "../src/SlotMap.h"
+#include <string>
+#include <vector>
+
+// Test that handles and pointers survive growth across many chunks
+TEST(SlotMapTest, HandlesAndPointersStableAcrossGrowth) {
+    SlotMap<std::string> map;
+    SlotMap<std::string>::Handle first = map.emplace("first");
+    std::string* firstPtr = map.get(first);
+    ASSERT_NE(firstPtr, nullptr);
+
+    std::vector<SlotMap<std::string>::Handle> handles;
+    for (int i = 0; i < 3 * static_cast<int>(SlotMap<std::string>::CHUNK_SIZE); ++i) {
+        handles.push_back(map.emplace(std::to_string(i)));
+    }
+
+    EXPECT_EQ(map.size(), handles.size() + 1);
+    EXPECT_EQ(map.get(first), firstPtr); // Element never moved
+    EXPECT_EQ(*firstPtr, "first");
+    EXPECT_EQ(*map.get(handles[5000]), "5000");
+}
+
+// Test that erased handles go stale and their slot is reused with a new generation
+TEST(SlotMapTest, EraseInvalidatesHandleAndReusesSlot) {
+    SlotMap<int> map;
+    SlotMap<int>::Handle a = map.emplace(1);
+    SlotMap<int>::Handle b = map.emplace(2);
+
+    EXPECT_TRUE(map.erase(a));
+    EXPECT_FALSE(map.erase(a));
+    EXPECT_EQ(map.get(a), nullptr);
+    EXPECT_FALSE(map.contains(a));
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_TRUE(map.handleAt(a.index()).isNull());
+    EXPECT_EQ(map.handleAt(b.index()), b);
+    EXPECT_TRUE(map.handleAt(2).isNull()); // Never used
+
+    SlotMap<int>::Handle c = map.emplace(3);
+    EXPECT_EQ(c.index(), a.index());
+    EXPECT_NE(c.generation(), a.generation());
+    EXPECT_NE(c, a);
+    EXPECT_EQ(map.get(a), nullptr);
+    EXPECT_EQ(*map.get(c), 3);
+    EXPECT_EQ(*map.get(b), 2);
+}
+
+// Test null handles, clear() and raw round-tripping
+TEST(SlotMapTest, NullClearAndRawHandles) {
+    SlotMap<int> map;
+    SlotMap<int>::Handle null;
+    EXPECT_TRUE(null.isNull());
+    EXPECT_FALSE(static_cast<bool>(null));
+    EXPECT_EQ(map.get(null), nullptr);
+
+    SlotMap<int>::Handle h = map.emplace(7);
+    EXPECT_FALSE(h.isNull());
+    EXPECT_EQ(SlotMap<int>::Handle::fromRaw(h.raw()), h);
+    EXPECT_EQ(sizeof(h), 4u);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get(h), nullptr);
+
+    SlotMap<int>::Handle again = map.emplace(8);
+    EXPECT_EQ(again.index(), h.index()); // Slots are reused from the start after clear()
+    EXPECT_EQ(map.get(h), nullptr);
+    EXPECT_EQ(*map.get(again), 8);
+}
+
+// Test that iteration skips erased slots and exposes each element's handle
+TEST(SlotMapTest, IterationSkipsErasedSlots) {
+    SlotMap<int> map;
+    std::vector<SlotMap<int>::Handle> handles;
+    for (int i = 0; i < 5; ++i) {
+        handles.push_back(map.emplace(i));
+    }
+    map.erase(handles[0]);
+    map.erase(handles[3]);
+
+    std::vector<int> seen;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        seen.push_back(*it);
+        EXPECT_EQ(map.get(it.handle()), &*it);
+    }
+    EXPECT_EQ(seen, (std::vector<int>{1, 2, 4}));
+    EXPECT_EQ(map.front(), 1);
+}
@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+#include "../src/SnapshotFile.h"
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+class SnapshotFileTest : public ::testing::Test {
+protected:
+    std::string path = ::testing::TempDir() + "snapshot_file_test.snap";
+
+    void SetUp() override { std::remove(path.c_str()); }
+    void TearDown() override { std::remove(path.c_str()); }
+
+    // FL1 (2x2) and FL2 (1x3); Bob's booking 7 on FL2 was cancelled, the others hold their seats
+    static SnapshotFile::Image sampleImage() {
+        SnapshotFile::Image image;
+        image.airplanes.push_back({image.addString("FL1"), 2, 2, 0});
+        image.airplanes.push_back({image.addString("FL2"), 1, 3, 4});
+        image.seatPrices = {200.0, 200.0, 50.0, 75.5, 100.0, 100.0, 100.0};
+        image.seatBookings = {0, 3, 0, 0, 0, 0, 1};
+        image.customers.push_back({image.addString("CUST0002"), image.addString("Bob"), 5000, 0, 2, 41});
+        image.customers.push_back({image.addString("CUST0001"), image.addString("Alice"), 12345, 2, 1, 30});
+        image.bookings.push_back({9, 10000, 0, 1, 2, 0, {}});  // Bob, FL2 1C
+        image.bookings.push_back({7, 0, 0, 1, 0, 1, {}});      // Bob, FL2 1A, cancelled
+        image.bookings.push_back({8, 20000, 1, 0, 1, 0, {}});  // Alice, FL1 1B
+        image.customerBookings = {1, 0, 2};
+        image.revenueCents = 30000;
+        image.nextCustomerNumber = 3;
+        image.logGeneration = 4;
+        image.logOffset = 1234;
+        return image;
+    }
+
+    void write(const SnapshotFile::Image& image) {
+        std::string error;
+        ASSERT_TRUE(SnapshotFile::write(path, image, error)) << error;
+    }
+
+    std::string openError() {
+        std::string error;
+        EXPECT_EQ(SnapshotFile::open(path, error), nullptr);
+        return error;
+    }
+
+    void patch(std::uint64_t offset, std::uint32_t value) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+};
+
+} // namespace
+
+TEST_F(SnapshotFileTest, RoundTripMapsRowsAndFindsByKey) {
+    write(sampleImage());
+    std::string error;
+    std::unique_ptr<SnapshotFile> file = SnapshotFile::open(path, error);
+    ASSERT_NE(file, nullptr) << error;
+
+    ASSERT_EQ(file->airplaneCount(), 2u);
+    ASSERT_EQ(file->seatCount(), 7u);
+    ASSERT_EQ(file->customerCount(), 2u);
+    ASSERT_EQ(file->bookingCount(), 3u);
+    EXPECT_EQ(file->text(file->airplanes()[1].flightNumber), "FL2");
+    EXPECT_EQ(file->airplanes()[1].firstSeat, 4u);
+    EXPECT_DOUBLE_EQ(file->seatPrices()[3], 75.5);
+    EXPECT_EQ(file->seatBookings()[6], 1u);
+    EXPECT_EQ(file->text(file->customers()[1].name), "Alice");
+    EXPECT_EQ(file->customers()[1].balanceCents, 12345);
+    EXPECT_EQ(file->customerBookings()[file->customers()[1].firstBooking], 2u);
+    EXPECT_EQ(file->bookings()[2].paidCents, 20000);
+    EXPECT_EQ(file->getRevenueCents(), 30000);
+    EXPECT_EQ(file->getNextCustomerNumber(), 3u);
+    EXPECT_EQ(file->getMaxBookingNumber(), 9u);
+    EXPECT_EQ(file->getLogGeneration(), 4u);
+    EXPECT_EQ(file->getLogOffset(), 1234u);
+
+    // Rows stay in image order; the lookups go through the sorted index sections
+    EXPECT_EQ(file->findCustomer("CUST0001"), 1);
+    EXPECT_EQ(file->findCustomer("CUST0002"), 0);
+    EXPECT_EQ(file->findCustomer("CUST0003"), -1);
+    EXPECT_EQ(file->findCustomer(""), -1);
+    EXPECT_EQ(file->findBooking(7), 1);
+    EXPECT_EQ(file->findBooking(9), 0);
+    EXPECT_EQ(file->findBooking(10), -1);
+}
+
+TEST_F(SnapshotFileTest, EmptyImageRoundTrips) {
+    write(SnapshotFile::Image());
+    std::string error;
+    std::unique_ptr<SnapshotFile> file = SnapshotFile::open(path, error);
+    ASSERT_NE(file, nullptr) << error;
+    EXPECT_EQ(file->airplaneCount() + file->customerCount() + file->bookingCount(), 0u);
+    EXPECT_EQ(file->findBooking(1), -1);
+}
+
+TEST_F(SnapshotFileTest, RejectsMissingForeignTruncatedAndOtherVersionFiles) {
+    EXPECT_EQ(openError().compare(0, 13 + path.size(), "Cannot open " + path + ":"), 0);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "customer,name\nCUST0001,Alice\nCUST0002,Bob\nCUST0003,Carol\n";
+    }
+    EXPECT_EQ(openError(), path + " is not a reservation snapshot.");
+
+    write(sampleImage());
+    patch(8, SnapshotFile::FORMAT_VERSION + 1);
+    EXPECT_EQ(openError(), path + " has snapshot format version 3; this build reads version 2.");
+    write(sampleImage());
+    patch(12, 0x04030201); // Byte order mark as the other byte order stores it
+    EXPECT_EQ(openError(), path + " was written on a host with the other byte order.");
+
+    write(sampleImage());
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 8));
+    }
+    EXPECT_EQ(openError(), path + " is truncated.");
+}
+
+TEST_F(SnapshotFileTest, RejectsRowsThatContradictEachOther) {
+    SnapshotFile::Image cancelledHolder = sampleImage();
+    cancelledHolder.seatBookings[4] = 2; // FL2 1A names the cancelled booking
+    write(cancelledHolder);
+    EXPECT_EQ(openError(), path + " is damaged (seat 0 of airplane 1).");
+
+    SnapshotFile::Image seatless = sampleImage();
+    seatless.seatBookings[1] = 0; // Alice's confirmed booking holds nothing
+    write(seatless);
+    EXPECT_EQ(openError(), path + " is damaged (confirmed bookings without a seat).");
+
+    SnapshotFile::Image duplicateId = sampleImage();
+    duplicateId.customers[1].id = duplicateId.customers[0].id;
+    write(duplicateId);
+    EXPECT_EQ(openError(), path + " is damaged (customer index).");
+
+    SnapshotFile::Image badSeat = sampleImage();
+    badSeat.bookings[2].seatIndex = 4; // FL1 has four seats
+    write(badSeat);
+    EXPECT_EQ(openError(), path + " is damaged (booking 2).");
+}
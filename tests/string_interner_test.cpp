@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include "../src/StringInterner.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+// Test that equal strings share one id and ids map back to their strings
+TEST(StringInternerTest, InternFindAndLookup) {
+    StringInterner interner;
+    InternedId a = interner.intern("CUST0001");
+    InternedId b = interner.intern("CUST0002");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(interner.intern(std::string("CUST0001")), a);
+    EXPECT_EQ(interner.size(), 2u);
+
+    EXPECT_EQ(interner.lookup(a), "CUST0001");
+    EXPECT_EQ(interner.lookup(b), "CUST0002");
+
+    InternedId found = 99;
+    EXPECT_TRUE(interner.find("CUST0002", found));
+    EXPECT_EQ(found, b);
+    EXPECT_FALSE(interner.find("CUST0003", found));
+}
+
+// Test that lookup references stay valid as the table grows
+TEST(StringInternerTest, ReferencesStableAcrossGrowth) {
+    StringInterner interner;
+    const std::string& first = interner.lookup(interner.intern("first"));
+    for (int i = 0; i < 10000; ++i) {
+        interner.intern("value" + std::to_string(i));
+    }
+    EXPECT_EQ(first, "first");
+    EXPECT_EQ(&interner.lookup(0), &first);
+}
+
+// Test concurrent interning of overlapping strings yields one id per string
+TEST(StringInternerTest, ConcurrentIntern) {
+    StringInterner interner;
+    std::vector<std::vector<InternedId>> results(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&interner, &results, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                results[t].push_back(interner.intern("FL" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(interner.size(), 1000u);
+    for (int t = 1; t < 4; ++t) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+}
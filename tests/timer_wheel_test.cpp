@@ -0,0 +1,94 @@
+#include "gtest/gtest.h"
+#include "../src/TimerWheel.h"
+#include <random>
+#include <vector>
+
+TEST(TimerWheelTest, FiresEachTimerOnItsTick) {
+    TimerWheel wheel;
+    wheel.schedule(5, 50);
+    wheel.schedule(64, 640);     // First level-1 boundary
+    wheel.schedule(4100, 41000); // Level 2
+    wheel.schedule(3, 30);
+    EXPECT_EQ(wheel.size(), 4u);
+
+    std::vector<std::uint64_t> expired;
+    wheel.advanceTo(4, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{30}));
+    expired.clear();
+    wheel.advanceTo(63, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{50}));
+    expired.clear();
+    wheel.advanceTo(64, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{640}));
+    expired.clear();
+    wheel.advanceTo(4099, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advanceTo(4100, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{41000}));
+    EXPECT_EQ(wheel.size(), 0u);
+    EXPECT_EQ(wheel.currentTick(), 4100u);
+}
+
+TEST(TimerWheelTest, PastAndFarDeadlines) {
+    TimerWheel wheel(1000);
+    std::vector<std::uint64_t> expired;
+    wheel.schedule(10, 1);   // Already past: fires on the next tick
+    wheel.schedule(1000, 2); // Now: same
+    wheel.advanceTo(1001, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{1, 2}));
+
+    // Beyond the 2^24-tick span of the wheel
+    const std::uint64_t far = 1001 + (1ull << 26) + 12345;
+    wheel.schedule(far, 3);
+    expired.clear();
+    wheel.advanceTo(far - 1, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advanceTo(far, expired);
+    EXPECT_EQ(expired, (std::vector<std::uint64_t>{3}));
+}
+
+TEST(TimerWheelTest, RandomTimersFireExactlyAtTheirDeadline) {
+    std::mt19937_64 gen(7);
+    TimerWheel wheel(123);
+    std::vector<std::uint64_t> deadlines;
+    for (std::uint64_t i = 0; i < 20000; ++i) {
+        std::uint64_t deadline = 124 + gen() % (1u << 20);
+        deadlines.push_back(deadline);
+        wheel.schedule(deadline, i);
+    }
+
+    std::vector<std::uint64_t> expired;
+    std::vector<bool> fired(deadlines.size(), false);
+    std::uint64_t tick = 123;
+    while (wheel.size() > 0) {
+        std::uint64_t from = tick;
+        tick += 1 + gen() % 5000;
+        expired.clear();
+        wheel.advanceTo(tick, expired);
+        std::uint64_t previous = 0;
+        for (std::uint64_t payload : expired) {
+            ASSERT_FALSE(fired[payload]);
+            fired[payload] = true;
+            EXPECT_GT(deadlines[payload], from);
+            EXPECT_LE(deadlines[payload], tick);
+            EXPECT_GE(deadlines[payload], previous); // Deadline order within one advance
+            previous = deadlines[payload];
+        }
+    }
+    for (bool f : fired) {
+        EXPECT_TRUE(f);
+    }
+}
+
+TEST(TimerWheelTest, ClearDropsTimers) {
+    TimerWheel wheel;
+    for (std::uint64_t i = 1; i <= 100; ++i) {
+        wheel.schedule(i * 97, i);
+    }
+    wheel.clear();
+    EXPECT_EQ(wheel.size(), 0u);
+    std::vector<std::uint64_t> expired;
+    wheel.advanceTo(100000, expired);
+    EXPECT_TRUE(expired.empty());
+    EXPECT_EQ(wheel.currentTick(), 100000u);
+}
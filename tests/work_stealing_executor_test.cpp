@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include "../src/WorkStealingExecutor.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(WorkStealingExecutorTest, ParallelForVisitsEveryIndexOnce) {
+    WorkStealingExecutor executor(4);
+    EXPECT_EQ(executor.getWorkerCount(), 4);
+    for (std::size_t grain : {1u, 7u, 100000u}) {
+        const std::size_t count = 10000;
+        std::unique_ptr<std::atomic<int>[]> visits(new std::atomic<int>[count]);
+        for (std::size_t i = 0; i < count; ++i) {
+            visits[i] = 0;
+        }
+        executor.parallelFor(0, count, grain, [&](std::size_t i) { visits[i].fetch_add(1); });
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(visits[i].load(), 1) << "index " << i << ", grain " << grain;
+        }
+    }
+
+    int calls = 0;
+    executor.parallelFor(5, 5, 1, [&](std::size_t) { ++calls; });
+    executor.parallelFor(7, 3, 1, [&](std::size_t) { ++calls; });
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(WorkStealingExecutorTest, IdleWorkersStealFromABusyOne) {
+    // Every task sleeps, so the range only finishes quickly if several workers share it
+    WorkStealingExecutor executor(4);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    executor.parallelFor(0, 64, 1, [&](std::size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST(WorkStealingExecutorTest, NestedWaitsDoNotStarveThePool) {
+    // More outer tasks than workers, each waiting on an inner parallelFor: the waits must run
+    // queued work rather than block, or every worker would end up waiting on tasks nobody runs
+    WorkStealingExecutor executor(2);
+    std::atomic<int> inner{0};
+    WorkStealingExecutor::TaskGroup group(executor);
+    for (int outer = 0; outer < 8; ++outer) {
+        group.run([&]() {
+            executor.parallelFor(0, 100, 1, [&](std::size_t) { inner.fetch_add(1); });
+        });
+    }
+    group.wait();
+    EXPECT_EQ(inner.load(), 800);
+}
+
+TEST(WorkStealingExecutorTest, FirstExceptionIsRethrownAndLaterWorkSkipped) {
+    WorkStealingExecutor executor(2);
+    std::atomic<int> ran{0};
+    EXPECT_THROW(executor.parallelFor(0, 100000, 1, [&](std::size_t i) {
+        ran.fetch_add(1);
+        if (i == 0) throw std::runtime_error("item failed");
+    }), std::runtime_error);
+    EXPECT_LT(ran.load(), 100000);
+
+    // The group is usable again after wait() has reported the failure
+    WorkStealingExecutor::TaskGroup group(executor);
+    group.run([]() { throw std::logic_error("first"); });
+    EXPECT_THROW(group.wait(), std::logic_error);
+    std::atomic<int> after{0};
+    group.run([&]() { after = 1; });
+    group.wait();
+    EXPECT_EQ(after.load(), 1);
+}
+
+TEST(WorkStealingExecutorTest, DestructorRunsQueuedTasks) {
+    std::atomic<int> ran{0};
+    {
+        WorkStealingExecutor executor(1);
+        WorkStealingExecutor::TaskGroup group(executor);
+        for (int i = 0; i < 100; ++i) {
+            group.run([&]() { ran.fetch_add(1); });
+        }
+    } // The group's destructor waits; the executor's then joins its idle worker
+    EXPECT_EQ(ran.load(), 100);
+    EXPECT_GE(WorkStealingExecutor::global().getWorkerCount(), 1);
+}
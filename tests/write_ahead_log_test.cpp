@@ -0,0 +1,299 @@
+#include "gtest/gtest.h"
+#include "../src/WriteAheadLog.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class WriteAheadLogTest : public ::testing::Test {
+protected:
+    std::string path = ::testing::TempDir() + "write_ahead_log_test.wal";
+
+    void SetUp() override { std::remove(path.c_str()); }
+    void TearDown() override { std::remove(path.c_str()); }
+
+    std::unique_ptr<WriteAheadLog> openLog(WriteAheadLog::Durability durability, std::uint64_t validLength = 0) {
+        WriteAheadLog::Options options;
+        options.durability = durability;
+        options.asyncFlushInterval = std::chrono::milliseconds(5);
+        std::string error;
+        std::unique_ptr<WriteAheadLog> log = WriteAheadLog::open(path, validLength, options, error);
+        EXPECT_NE(log, nullptr) << error;
+        return log;
+    }
+
+    std::vector<WalRecord> replayAll(std::uint64_t* validLength = nullptr) {
+        std::vector<WalRecord> records;
+        std::uint64_t count = 0, length = 0;
+        std::string error;
+        EXPECT_TRUE(WriteAheadLog::replay(path, [&records](const WalRecord& record, std::string&) {
+            records.push_back(record);
+            return true;
+        }, count, length, error)) << error;
+        EXPECT_EQ(count, records.size());
+        if (validLength) *validLength = length;
+        return records;
+    }
+
+    std::uint64_t fileSize() {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        return static_cast<std::uint64_t>(in.tellg());
+    }
+};
+
+} // namespace
+
+TEST_F(WriteAheadLogTest, ReplaysEveryRecordTypeInOrder) {
+    {
+        auto log = openLog(WriteAheadLog::Durability::GROUP);
+        log->append(WalRecord::addCustomer("CUST0003", "Carol Danvers", 35, 123456));
+        log->append(WalRecord::addAirplane("FL303", 12, 4));
+        log->append(WalRecord::book(42, "CUST0003", "FL303", 7, 5000));
+        log->append(WalRecord::swap(42, 43, 20000, -1));
+        log->append(WalRecord::cancel(42));
+        WriteAheadLog::Lsn last = log->append(WalRecord::setFares("FL303", 3, {99.5, 0.0, 1234.25}));
+        EXPECT_EQ(last, 6u);
+        EXPECT_TRUE(log->awaitDurable(last));
+    }
+    std::vector<WalRecord> records = replayAll();
+    ASSERT_EQ(records.size(), 6u);
+    EXPECT_EQ(records[0].type, WalRecord::Type::ADD_CUSTOMER);
+    EXPECT_EQ(records[0].customerId, "CUST0003");
+    EXPECT_EQ(records[0].name, "Carol Danvers");
+    EXPECT_EQ(records[0].age, 35);
+    EXPECT_EQ(records[0].cents, 123456);
+    EXPECT_EQ(records[1].type, WalRecord::Type::ADD_AIRPLANE);
+    EXPECT_EQ(records[1].flightNumber, "FL303");
+    EXPECT_EQ(records[1].rows, 12);
+    EXPECT_EQ(records[1].seatsPerRow, 4);
+    EXPECT_EQ(records[2].type, WalRecord::Type::BOOK);
+    EXPECT_EQ(records[2].bookingNumber, 42u);
+    EXPECT_EQ(records[2].customerId, "CUST0003");
+    EXPECT_EQ(records[2].flightNumber, "FL303");
+    EXPECT_EQ(records[2].seatIndex, 7);
+    EXPECT_EQ(records[2].cents, 5000);
+    EXPECT_EQ(records[3].type, WalRecord::Type::SWAP);
+    EXPECT_EQ(records[3].otherBookingNumber, 43u);
+    EXPECT_EQ(records[3].cents, 20000);
+    EXPECT_EQ(records[3].otherCents, -1);
+    EXPECT_EQ(records[4].type, WalRecord::Type::CANCEL);
+    EXPECT_EQ(records[4].bookingNumber, 42u);
+    EXPECT_EQ(records[5].type, WalRecord::Type::SET_FARES);
+    EXPECT_EQ(records[5].flightNumber, "FL303");
+    EXPECT_EQ(records[5].seatIndex, 3);
+    EXPECT_EQ(records[5].fares, (std::vector<double>{99.5, 0.0, 1234.25}));
+}
+
+TEST_F(WriteAheadLogTest, TornTailIsIgnoredAndCutOffOnReopen) {
+    {
+        auto log = openLog(WriteAheadLog::Durability::GROUP);
+        for (int i = 1; i <= 3; ++i) {
+            log->append(WalRecord::cancel(i));
+        }
+        ASSERT_TRUE(log->flush());
+    }
+    std::uint64_t intactSize = fileSize();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("\x15\x00\x00\x00\xde\xad", 6); // A record header cut short by a crash
+    }
+    std::uint64_t validLength = 0;
+    EXPECT_EQ(replayAll(&validLength).size(), 3u);
+    EXPECT_EQ(validLength, intactSize);
+
+    {
+        auto log = openLog(WriteAheadLog::Durability::GROUP, validLength);
+        log->append(WalRecord::cancel(4));
+    } // Destructor flushes
+    std::vector<WalRecord> records = replayAll();
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[3].bookingNumber, 4u);
+}
+
+TEST_F(WriteAheadLogTest, CorruptRecordEndsReplay) {
+    {
+        auto log = openLog(WriteAheadLog::Durability::PER_OP);
+        log->append(WalRecord::cancel(1));
+        log->append(WalRecord::cancel(2));
+    }
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(fileSize() - 1));
+        file.put('\x7f'); // Last byte of the second record's booking number
+    }
+    std::vector<WalRecord> records = replayAll();
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].bookingNumber, 1u);
+}
+
+TEST_F(WriteAheadLogTest, MissingFileIsEmptyAndForeignFileIsRejected) {
+    EXPECT_TRUE(replayAll().empty());
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "customer,name\nCUST0001,Alice\n";
+    }
+    std::uint64_t count = 0, validLength = 0;
+    std::string error;
+    EXPECT_FALSE(WriteAheadLog::replay(path, [](const WalRecord&, std::string&) { return true; }, count, validLength, error));
+    EXPECT_EQ(error, path + " is not a reservation write-ahead log.");
+}
+
+TEST_F(WriteAheadLogTest, ApplyFailureNamesTheRecord) {
+    {
+        auto log = openLog(WriteAheadLog::Durability::GROUP);
+        log->append(WalRecord::cancel(1));
+        log->append(WalRecord::cancel(2));
+    }
+    std::uint64_t count = 0, validLength = 0;
+    std::string error;
+    EXPECT_FALSE(WriteAheadLog::replay(path, [](const WalRecord& record, std::string& applyError) {
+        applyError = "Unknown booking.";
+        return record.bookingNumber != 2;
+    }, count, validLength, error));
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(error, path + ": record 2: Unknown booking.");
+}
+
+TEST_F(WriteAheadLogTest, PerOpSyncsEveryRecordAndGroupSyncsABatchOnce) {
+    {
+        auto log = openLog(WriteAheadLog::Durability::PER_OP);
+        for (int i = 1; i <= 5; ++i) {
+            log->append(WalRecord::cancel(i));
+        }
+        EXPECT_EQ(log->getStats().syncs, 5u);
+    }
+    std::remove(path.c_str());
+    {
+        auto log = openLog(WriteAheadLog::Durability::GROUP);
+        WriteAheadLog::Lsn last = 0;
+        for (int i = 1; i <= 5; ++i) {
+            last = log->append(WalRecord::cancel(i));
+        }
+        EXPECT_EQ(log->getStats().syncs, 0u); // Only buffered so far
+        EXPECT_TRUE(log->awaitDurable(2));    // Leads a sync that takes all five along
+        EXPECT_TRUE(log->awaitDurable(last));
+        WriteAheadLog::Stats stats = log->getStats();
+        EXPECT_EQ(stats.records, 5u);
+        EXPECT_EQ(stats.syncs, 1u);
+    }
+    EXPECT_EQ(replayAll().size(), 5u);
+}
+
+TEST_F(WriteAheadLogTest, ConcurrentWaitersAllBecomeDurable) {
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 200;
+    {
+        auto log = openLog(WriteAheadLog::Durability::GROUP);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&log, t]() {
+                for (int i = 0; i < kPerThread; ++i) {
+                    EXPECT_TRUE(log->awaitDurable(log->append(WalRecord::cancel(t * kPerThread + i + 1))));
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        WriteAheadLog::Stats stats = log->getStats();
+        EXPECT_EQ(stats.records, static_cast<std::uint64_t>(kThreads * kPerThread));
+        EXPECT_LE(stats.syncs, stats.records);
+    }
+    EXPECT_EQ(replayAll().size(), static_cast<std::size_t>(kThreads * kPerThread));
+}
+
+TEST_F(WriteAheadLogTest, AsyncModeSyncsInTheBackground) {
+    auto log = openLog(WriteAheadLog::Durability::ASYNC);
+    EXPECT_TRUE(log->awaitDurable(log->append(WalRecord::cancel(7)))); // Returns without waiting
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (log->getStats().syncs == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(log->getStats().syncs, 1u);
+    std::vector<WalRecord> records = replayAll(); // Readable while the log is still open
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_EQ(records[0].bookingNumber, 7u);
+}
+
+TEST_F(WriteAheadLogTest, ParsesDurabilityNames) {
+    WriteAheadLog::Durability durability = WriteAheadLog::Durability::GROUP;
+    EXPECT_TRUE(WriteAheadLog::parseDurability("per-op", durability));
+    EXPECT_EQ(durability, WriteAheadLog::Durability::PER_OP);
+    EXPECT_TRUE(WriteAheadLog::parseDurability("async", durability));
+    EXPECT_EQ(durability, WriteAheadLog::Durability::ASYNC);
+    EXPECT_TRUE(WriteAheadLog::parseDurability("group", durability));
+    EXPECT_EQ(durability, WriteAheadLog::Durability::GROUP);
+    EXPECT_FALSE(WriteAheadLog::parseDurability("fsync", durability));
+}
+
+TEST_F(WriteAheadLogTest, RotateMovesTheFileToASegmentAndCarriesOnInTheNext) {
+    WriteAheadLog::Position mid{};
+    {
+        auto log = openLog(WriteAheadLog::Durability::GROUP);
+        log->append(WalRecord::cancel(1));
+        log->append(WalRecord::cancel(2));
+        std::string error;
+        ASSERT_TRUE(log->rotate(error)) << error;
+        EXPECT_EQ(log->getPosition().generation, 1u);
+        log->append(WalRecord::cancel(3));
+        mid = log->getPosition();
+        log->append(WalRecord::cancel(4));
+        EXPECT_TRUE(log->flush());
+    }
+    std::string segment = WriteAheadLog::segmentPath(path, 0);
+    EXPECT_EQ(segment, path + ".0");
+
+    std::vector<std::uint64_t> seen;
+    std::uint64_t count = 0, validLength = 0, generation = 99;
+    std::string error;
+    auto collect = [&seen](const WalRecord& record, std::string&) {
+        seen.push_back(record.bookingNumber);
+        return true;
+    };
+    ASSERT_TRUE(WriteAheadLog::replay(segment, collect, count, validLength, error, WriteAheadLog::Position(), &generation)) << error;
+    EXPECT_EQ(generation, 0u);
+    EXPECT_EQ(seen, (std::vector<std::uint64_t>{1, 2}));
+    ASSERT_TRUE(WriteAheadLog::replay(path, collect, count, validLength, error, mid, &generation)) << error;
+    EXPECT_EQ(generation, 1u);
+    EXPECT_EQ(count, 1u); // Record 3 lies before mid
+    EXPECT_EQ(seen, (std::vector<std::uint64_t>{1, 2, 4}));
+
+    // Reopening keeps the generation replay reported
+    {
+        std::unique_ptr<WriteAheadLog> log = WriteAheadLog::open(path, validLength, WriteAheadLog::Options(), error, generation);
+        ASSERT_NE(log, nullptr) << error;
+        EXPECT_EQ(log->getPosition().generation, 1u);
+        EXPECT_EQ(log->getPosition().offset, validLength);
+    }
+    WriteAheadLog::removeSegments(path, 1);
+    EXPECT_FALSE(std::ifstream(segment).good());
+}
+
+TEST_F(WriteAheadLogTest, ReadsAVersionOneLogAsGenerationZero) {
+    {
+        auto log = openLog(WriteAheadLog::Durability::GROUP);
+        log->append(WalRecord::cancel(5));
+    }
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "ARSWAL01"; // The old header: magic only
+        out.write(bytes.data() + 16, static_cast<std::streamsize>(bytes.size() - 16));
+    }
+    std::uint64_t count = 0, validLength = 0, generation = 99;
+    std::string error;
+    ASSERT_TRUE(WriteAheadLog::replay(path, [](const WalRecord& record, std::string&) { return record.bookingNumber == 5; },
+                                      count, validLength, error, WriteAheadLog::Position(), &generation)) << error;
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(generation, 0u);
+    EXPECT_EQ(validLength, bytes.size() - 8);
+}